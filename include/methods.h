@@ -0,0 +1,841 @@
+#ifndef METHODS_H
+#define METHODS_H
+
+#include <atomic>
+
+// Общие объявления для всех модулей программы app.
+// Реализация базовых AVL/RBT деревьев находится в src/main.cpp,
+// дополнительные структуры и тесты - в отдельных файлах src/.
+//
+// TREE_ORDER_STATISTICS (опция CMake, по умолчанию включена) добавляет
+// в узлы AVL/RBT размер поддерева: он поддерживается при вставке,
+// поворотах и join/split и дает rank/select за O(log n).
+
+// ========== AVL ДЕРЕВО ==========
+
+struct AVLNode {
+    int key;
+    int height;
+#ifdef TREE_ORDER_STATISTICS
+    int size; // число узлов в поддереве
+#endif
+    struct AVLNode* left;
+    struct AVLNode* right;
+};
+
+int avl_height(struct AVLNode* node);
+int avl_balance(struct AVLNode* node);
+struct AVLNode* avl_rotate_right(struct AVLNode* y);
+struct AVLNode* avl_rotate_left(struct AVLNode* x);
+struct AVLNode* avl_insert(struct AVLNode* node, int key, int* rotations);
+struct AVLNode* avl_search(struct AVLNode* node, int key);
+struct AVLNode* avl_delete(struct AVLNode* node, int key, int* rotations);
+void free_avl_tree(struct AVLNode* root);
+int count_avl_nodes(struct AVLNode* root);
+#ifdef TREE_ORDER_STATISTICS
+int avl_size(struct AVLNode* node);
+void avl_update_size(struct AVLNode* node);
+#endif
+
+// ========== RBT ДЕРЕВО ==========
+
+enum Color { RED, BLACK };
+
+struct RBNode {
+    int key;
+    enum Color color;
+#ifdef TREE_ORDER_STATISTICS
+    int size;
+#endif
+    struct RBNode* left;
+    struct RBNode* right;
+    struct RBNode* parent;
+};
+
+struct RBNode* rbt_create_node(int key);
+void rbt_rotate_left(struct RBNode** root, struct RBNode* x, int* rotations);
+void rbt_rotate_right(struct RBNode** root, struct RBNode* y, int* rotations);
+void rbt_fix_violation(struct RBNode** root, struct RBNode* z, int* recolorings);
+struct RBNode* rbt_insert(struct RBNode* root, int key, int* rotations, int* recolorings);
+struct RBNode* rbt_search(struct RBNode* root, int key);
+struct RBNode* rbt_delete(struct RBNode* root, int key, int* rotations, int* recolorings);
+void free_rbt_tree(struct RBNode* root);
+int count_rbt_nodes(struct RBNode* root);
+#ifdef TREE_ORDER_STATISTICS
+int rbt_size(struct RBNode* node);
+void rbt_update_size(struct RBNode* node);
+#endif
+
+// ========== ОБЩИЕ УТИЛИТЫ ==========
+
+// Монотонное "настенное" время в миллисекундах.
+// clock() считает процессорное время всех потоков, поэтому для
+// многопоточных тестов используется это время.
+double wall_time_ms();
+
+// ========== JOIN/SPLIT И ПАРАЛЛЕЛЬНЫЕ ОПЕРАЦИИ НАД МНОЖЕСТВАМИ ==========
+// (src/tree_join.cpp)
+
+// Пул потоков для fork-join рекурсии. Поток, ожидающий задачу,
+// сам выполняет задачи из очереди, поэтому пул без рабочих потоков
+// (workers = 0) корректно работает в однопоточном режиме.
+struct ThreadPool;
+
+struct PoolTask {
+    void (*run)(struct PoolTask* task);
+    std::atomic<int> done;
+};
+
+struct ThreadPool* thread_pool_create(int workers);
+void thread_pool_destroy(struct ThreadPool* pool);
+void thread_pool_fork(struct ThreadPool* pool, struct PoolTask* task);
+void thread_pool_join(struct ThreadPool* pool, struct PoolTask* task);
+
+// join(L, k, R): все ключи L < k->key < все ключи R. Узел k переиспользуется.
+struct AVLNode* avl_join(struct AVLNode* left, struct AVLNode* k, struct AVLNode* right);
+// split(T, key): T разбивается на L (< key) и R (> key).
+// Возвращает отсоединенный узел с ключом key или NULL.
+struct AVLNode* avl_split(struct AVLNode* root, int key,
+                          struct AVLNode** left, struct AVLNode** right);
+
+struct RBNode* rbt_join(struct RBNode* left, struct RBNode* k, struct RBNode* right);
+struct RBNode* rbt_split(struct RBNode* root, int key,
+                         struct RBNode** left, struct RBNode** right);
+
+// Операции над множествами разрушают оба входных дерева:
+// узлы переиспользуются в результате или освобождаются.
+// pool == NULL - последовательное выполнение.
+struct AVLNode* avl_union(struct ThreadPool* pool, struct AVLNode* a, struct AVLNode* b);
+struct AVLNode* avl_intersection(struct ThreadPool* pool, struct AVLNode* a, struct AVLNode* b);
+struct AVLNode* avl_difference(struct ThreadPool* pool, struct AVLNode* a, struct AVLNode* b);
+struct AVLNode* avl_build_parallel(struct ThreadPool* pool, const int* keys, int n);
+
+struct RBNode* rbt_union(struct ThreadPool* pool, struct RBNode* a, struct RBNode* b);
+struct RBNode* rbt_intersection(struct ThreadPool* pool, struct RBNode* a, struct RBNode* b);
+struct RBNode* rbt_difference(struct ThreadPool* pool, struct RBNode* a, struct RBNode* b);
+struct RBNode* rbt_build_parallel(struct ThreadPool* pool, const int* keys, int n);
+
+// Проверка инвариантов (порядок ключей, баланс/цвета, родители).
+int avl_is_valid(struct AVLNode* root);
+int rbt_is_valid(struct RBNode* root);
+
+void test_set_operations();
+
+// ========== НЕИЗМЕНЯЕМЫЙ СНИМОК AVL (EYTZINGER) ==========
+// (src/avl_snapshot.cpp)
+
+struct AVLSnapshot {
+    int* keys;    // keys[1..n] в порядке обхода в ширину, выровнено на 64 байта
+    int n;
+    int capacity;
+};
+
+struct AVLSnapshot* avl_snapshot_build(struct AVLNode* root);
+// Пересобирает снимок из живого дерева, переиспользуя буфер
+void avl_snapshot_rebuild(struct AVLSnapshot* snapshot, struct AVLNode* root);
+void avl_snapshot_free(struct AVLSnapshot* snapshot);
+// Индекс первого ключа >= key в массиве keys или 0, если такого нет
+int avl_snapshot_lower_bound(const struct AVLSnapshot* snapshot, int key);
+int avl_snapshot_contains(const struct AVLSnapshot* snapshot, int key);
+
+void test_avl_snapshot();
+
+// ========== ПЕРЕРАСКЛАДКА ЖИВОГО ДЕРЕВА (DFS / vEB) ==========
+// (src/tree_relayout.cpp)
+// Узлы переносятся в общие блоки памяти, зарегистрированные в хранилище
+// узлов (node_storage_register_block): tree_node_free возвращает узел блоку,
+// поэтому после прохода с деревом работают как обычно - удаление, join/split,
+// free_avl_tree/free_rbt_tree. Между шагами незавершенного прохода можно
+// искать и вставлять, но не удалять: в стеке заданий лежат ссылки на узлы.
+
+enum RelayoutOrder { RELAYOUT_DFS, RELAYOUT_VEB };
+
+struct TreeRelayout;
+
+// root - адрес переменной с корнем, которую продолжает обновлять вызывающий код
+struct TreeRelayout* avl_relayout_create(struct AVLNode** root, enum RelayoutOrder order);
+struct TreeRelayout* rbt_relayout_create(struct RBNode** root, enum RelayoutOrder order);
+void tree_relayout_start(struct TreeRelayout* relayout);
+// Переносит не больше max_steps узлов; возвращает 1, когда проход завершен
+int tree_relayout_step(struct TreeRelayout* relayout, int max_steps);
+// Полный проход без перерывов
+void tree_relayout_run(struct TreeRelayout* relayout);
+long long tree_relayout_moved(struct TreeRelayout* relayout);
+// Освобождает дерево (если корень не NULL) и оставшиеся блоки. Дерево,
+// уже освобожденное через free_*_tree, должно иметь корень NULL
+void tree_relayout_destroy(struct TreeRelayout* relayout);
+
+void test_tree_relayout();
+
+// ========== ПАКЕТНЫЙ ПОИСК С ПРЕДВЫБОРКОЙ ==========
+// (src/batch_search.cpp)
+// results[i] - найденный узел для keys[i] или NULL.
+// group - сколько поисков идут одновременно (1..64).
+
+void avl_search_batch(struct AVLNode* root, const int* keys, int count,
+                      struct AVLNode** results, int group);
+void rbt_search_batch(struct RBNode* root, const int* keys, int count,
+                      struct RBNode** results, int group);
+
+void test_batch_search();
+
+// ========== SIMD-ПОИСК ВНУТРИ УЗЛА И B+ ДЕРЕВО ==========
+// (src/bplus_tree.cpp)
+
+// Число ключей в узле по умолчанию: 4 вектора SIMD (AVX2 - 8 ключей, SSE - 4).
+// Можно задать при сборке: cmake -DBTREE_NODE_KEYS=64 (кратно 8). Для узлов
+// этого размера SIMD-ядра используют развернутый цикл с числом итераций,
+// известным при сборке; узлы другого размера ищутся общим циклом.
+#ifndef BTREE_NODE_KEYS
+#if defined(__AVX2__)
+#define BTREE_NODE_KEYS 32
+#else
+#define BTREE_NODE_KEYS 16
+#endif
+#endif
+
+// Ранг key в узле: число ключей < key. keys выровнены на 16/32 байта,
+// ключи с count по capacity заполнены INT_MAX.
+typedef int (*node_search_fn)(const int* keys, int count, int capacity, int key);
+
+int node_search_scalar(const int* keys, int count, int capacity, int key);
+int node_search_sse(const int* keys, int count, int capacity, int key);
+int node_search_avx2(const int* keys, int count, int capacity, int key);
+int node_search_has_sse();
+int node_search_has_avx2();
+// Лучшее доступное ядро для текущего процессора (выбор во время выполнения)
+node_search_fn node_search_select();
+
+struct BPlusNode;
+
+struct BPlusTree {
+    int fanout;            // ключей в узле, кратно 8
+    int height;
+    int count;             // ключей в дереве
+    node_search_fn search;
+    struct BPlusNode* root;
+};
+
+// search == NULL - выбрать ядро автоматически
+struct BPlusTree* bplus_create(int fanout, node_search_fn search);
+void bplus_free(struct BPlusTree* tree);
+// 1 - ключ вставлен, 0 - уже был
+int bplus_insert(struct BPlusTree* tree, int key);
+int bplus_contains(struct BPlusTree* tree, int key);
+// Ключи из [lo, hi] по возрастанию (не больше max_out в out); возвращает их число
+int bplus_range(struct BPlusTree* tree, int lo, int hi, int* out, int max_out);
+
+void test_node_search();
+
+// ========== ХЕШ-ТАБЛИЦА SWISS TABLE ==========
+// (src/swiss_table.cpp)
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct SwissTable {
+    int8_t* ctrl;       // capacity + 16 управляющих байт
+    int* keys;
+    size_t capacity;    // степень двойки, не меньше 16
+    size_t size;
+    size_t tombstones;  // удаленные слоты, мешающие пробированию
+    size_t growth_left; // сколько пустых слотов можно занять до рехеша
+    int rehashes;
+};
+
+struct SwissTable* swiss_create(size_t capacity_hint);
+void swiss_free(struct SwissTable* table);
+// 1 - ключ вставлен, 0 - уже был
+int swiss_insert(struct SwissTable* table, int key);
+int swiss_contains(struct SwissTable* table, int key);
+// 1 - ключ удален, 0 - не найден
+int swiss_erase(struct SwissTable* table, int key);
+size_t swiss_memory_bytes(struct SwissTable* table);
+
+void test_swiss_table();
+
+// ========== SPLAY ДЕРЕВО И ДЕКАРТОВО ДЕРЕВО ==========
+// (src/splay_treap.cpp)
+
+struct SplayNode {
+    int key;
+    struct SplayNode* left;
+    struct SplayNode* right;
+};
+
+struct TreapNode {
+    int key;
+    unsigned int priority; // куча по максимуму
+    struct TreapNode* left;
+    struct TreapNode* right;
+};
+
+// Все операции splay-дерева перестраивают его и возвращают новый корень;
+// после splay_search ключ найден, если root != NULL && root->key == key
+struct SplayNode* splay_search(struct SplayNode* root, int key, int* rotations);
+struct SplayNode* splay_insert(struct SplayNode* root, int key, int* rotations);
+struct SplayNode* splay_delete(struct SplayNode* root, int key, int* rotations);
+void free_splay_tree(struct SplayNode* root);
+
+struct TreapNode* treap_insert(struct TreapNode* node, int key, int* rotations);
+struct TreapNode* treap_delete(struct TreapNode* node, int key, int* rotations);
+struct TreapNode* treap_search(struct TreapNode* node, int key);
+void free_treap(struct TreapNode* root);
+
+void test_splay_treap();
+
+// ========== ПОРЯДКОВЫЕ СТАТИСТИКИ ==========
+// (src/order_statistics.cpp)
+
+#ifdef TREE_ORDER_STATISTICS
+// Число ключей меньше key
+int avl_rank(struct AVLNode* root, int key);
+int rbt_rank(struct RBNode* root, int key);
+// k-й по возрастанию узел (с нуля) или NULL, если k вне [0, size)
+struct AVLNode* avl_select(struct AVLNode* root, int k);
+struct RBNode* rbt_select(struct RBNode* root, int k);
+// Число ключей в [lo, hi]
+int avl_range_count(struct AVLNode* root, int lo, int hi);
+int rbt_range_count(struct RBNode* root, int lo, int hi);
+#endif
+
+void test_order_statistics();
+
+// ========== ПЕРСИСТЕНТНОЕ AVL ДЕРЕВО ==========
+// (src/persistent_avl.cpp)
+
+struct PAVLNode {
+    int key;
+    int height;
+    int refcount; // ссылки от родителей и от корней версий
+    struct PAVLNode* left;
+    struct PAVLNode* right;
+};
+
+// Снимок: новая ссылка на ту же версию. Снимок неизменяем и читается,
+// пока его не отпустят pavl_release.
+struct PAVLNode* pavl_snapshot(struct PAVLNode* root);
+// Забирают ссылку на root и возвращают корень новой версии. Копируются
+// только узлы пути, разделенные со снимками.
+// Счетчики ссылок не атомарные: читать снимки можно из любых потоков,
+// но изменять и отпускать версии - только в потоке писателя.
+struct PAVLNode* pavl_insert(struct PAVLNode* root, int key);
+struct PAVLNode* pavl_delete(struct PAVLNode* root, int key);
+struct PAVLNode* pavl_search(struct PAVLNode* node, int key);
+void pavl_release(struct PAVLNode* root);
+// Число узлов во всех живых версиях
+long pavl_live_nodes();
+
+void test_persistent_avl();
+
+// ========== ВСТАВКА С ПОДСКАЗКОЙ И ПРАВЫЙ ПАЛЕЦ ==========
+// (src/finger_insert.cpp)
+
+// Высота AVL дерева не больше 1.44 * log2(n), для int-ключей хватает 64
+#define AVL_FINGER_MAX_HEIGHT 64
+
+struct AVLFingerTree {
+    struct AVLNode* root;
+    struct AVLNode* spine[AVL_FINGER_MAX_HEIGHT]; // путь от корня до максимума
+    int spine_len;
+};
+
+struct RBFingerTree {
+    struct RBNode* root;
+    struct RBNode* rightmost;
+};
+
+void avl_finger_init(struct AVLFingerTree* tree);
+void avl_finger_insert(struct AVLFingerTree* tree, int key, int* rotations);
+void rbt_finger_init(struct RBFingerTree* tree);
+void rbt_finger_insert(struct RBFingerTree* tree, int key, int* rotations, int* recolorings);
+// Как std::map::emplace_hint: если key встает сразу перед или сразу после
+// hint, спуска от корня нет. В *inserted (если не NULL) - узел с key,
+// его удобно передать подсказкой для следующей вставки.
+struct RBNode* rbt_insert_hint(struct RBNode* root, struct RBNode* hint, int key,
+                               int* rotations, int* recolorings, struct RBNode** inserted);
+
+void test_finger_insert();
+
+// ========== LSM-ИНДЕКС ==========
+// (src/lsm_tree.cpp)
+
+struct LSMTree;
+
+struct LSMStats {
+    long long flushes;      // выгрузок memtable в прогоны
+    long long flushed_keys;
+    long long merges;
+    long long merged_keys;  // ключей, записанных слияниями
+    long long stalls;       // ожиданий писателя из-за отставания слияний
+};
+
+// background != 0 - слияния в отдельном потоке. Вставки и поиск
+// вызываются из одного потока.
+struct LSMTree* lsm_create(int memtable_limit, int fanout, int background);
+void lsm_free(struct LSMTree* tree);
+void lsm_insert(struct LSMTree* tree, int key);
+int lsm_contains(struct LSMTree* tree, int key);
+// Дождаться, пока фоновые слияния догонят записи
+void lsm_wait_merges(struct LSMTree* tree);
+void lsm_get_stats(struct LSMTree* tree, struct LSMStats* stats, int* runs);
+
+void test_lsm_tree();
+
+// ========== ФИЛЬТР БЛУМА ПЕРЕД ДЕРЕВОМ ==========
+// (src/bloom_filter.cpp)
+
+// Блочный фильтр: все пробы ключа - в одной 64-байтной кеш-линии.
+// counting != 0 - 4-битные счетчики вместо бит, поддерживает удаление.
+struct BlockedBloom {
+    uint64_t* blocks;   // по 8 слов на блок
+    size_t num_blocks;
+    int k;              // проб на ключ
+    int counting;
+};
+
+struct BlockedBloom* bloom_create(size_t expected_keys, int bits_per_key, int counting);
+void bloom_free(struct BlockedBloom* filter);
+void bloom_add(struct BlockedBloom* filter, int key);
+// 0 - фильтр не счетный, удалить нельзя (ключ остается "возможно есть")
+int bloom_remove(struct BlockedBloom* filter, int key);
+int bloom_may_contain(struct BlockedBloom* filter, int key);
+size_t bloom_memory_bytes(struct BlockedBloom* filter);
+
+// Операции над деревом, синхронно обновляющие фильтр. Поиск отсутствующего
+// ключа, отсеянного фильтром, не обращается к дереву.
+struct AVLNode* avl_insert_filtered(struct BlockedBloom* filter, struct AVLNode* root,
+                                    int key, int* rotations);
+struct AVLNode* avl_delete_filtered(struct BlockedBloom* filter, struct AVLNode* root,
+                                    int key, int* rotations);
+struct AVLNode* avl_search_filtered(struct BlockedBloom* filter, struct AVLNode* root, int key);
+struct RBNode* rbt_insert_filtered(struct BlockedBloom* filter, struct RBNode* root,
+                                   int key, int* rotations, int* recolorings);
+struct RBNode* rbt_delete_filtered(struct BlockedBloom* filter, struct RBNode* root,
+                                   int key, int* rotations, int* recolorings);
+struct RBNode* rbt_search_filtered(struct BlockedBloom* filter, struct RBNode* root, int key);
+
+void test_bloom_filter();
+
+// ========== КЕШ СЕССИЙ ==========
+// (src/session_cache.cpp)
+
+struct SessionCache;
+
+struct SessionCacheStats {
+    long long hits;
+    long long misses;
+    long long inserts;
+    long long removes;
+    long long evictions;  // вытеснено по LRU при полном кеше
+    long long expired;    // удалено по TTL
+    long long rotations;  // повороты в обоих индексах
+};
+
+// Не больше max_entries записей, память выделяется сразу. ttl - время
+// жизни с последнего обращения в единицах now; 0 - без истечения.
+struct SessionCache* session_cache_create(int max_entries, int ttl);
+void session_cache_free(struct SessionCache* cache);
+// 1 - попадание (сессия продлевается), 0 - нет или истекла
+int session_cache_get(struct SessionCache* cache, int session_id, int now);
+// Вставка или продление; при полном кеше вытесняет самую давнюю
+void session_cache_put(struct SessionCache* cache, int session_id, int now);
+int session_cache_remove(struct SessionCache* cache, int session_id);
+// Удаляет все записи с истекшим сроком, возвращает их число
+int session_cache_expire(struct SessionCache* cache, int now);
+int session_cache_size(struct SessionCache* cache);
+size_t session_cache_memory_bytes(struct SessionCache* cache);
+void session_cache_get_stats(struct SessionCache* cache, struct SessionCacheStats* stats);
+
+void test_session_cache();
+
+// ========== АДАПТИВНОЕ RADIX ДЕРЕВО (ART) ==========
+// (src/art_tree.cpp)
+
+struct ARTNode;
+
+struct ARTree {
+    struct ARTNode* root;  // узел или лист (ключ в указателе с меткой)
+    int count;
+    size_t memory_bytes;   // все узлы плюс заголовок
+    int nodes[4];          // число узлов Node4/16/48/256
+};
+
+struct ARTree* art_create();
+void art_free(struct ARTree* tree);
+// 1 - ключ вставлен, 0 - уже был
+int art_insert(struct ARTree* tree, int key);
+// 1 - ключ удален, 0 - не найден
+int art_delete(struct ARTree* tree, int key);
+int art_contains(struct ARTree* tree, int key);
+// Ключи из [lo, hi] по возрастанию (не больше max_out в out); возвращает их число
+int art_range(struct ARTree* tree, int lo, int hi, int* out, int max_out);
+size_t art_memory_bytes(struct ARTree* tree);
+
+void test_art();
+
+// ========== WAVL ДЕРЕВО ==========
+// (src/wavl_tree.cpp)
+
+struct WAVLNode {
+    int key;
+    int rank; // разность с рангом сына 1 или 2; у листа 0
+    struct WAVLNode* left;
+    struct WAVLNode* right;
+};
+
+struct WAVLNode* wavl_insert(struct WAVLNode* node, int key, int* rotations);
+struct WAVLNode* wavl_delete(struct WAVLNode* node, int key, int* rotations);
+struct WAVLNode* wavl_search(struct WAVLNode* node, int key);
+// Настоящая высота (обход); после удалений может быть больше ранга
+int wavl_height(struct WAVLNode* node);
+void free_wavl_tree(struct WAVLNode* root);
+int count_wavl_nodes(struct WAVLNode* root);
+int wavl_is_valid(struct WAVLNode* root);
+
+void test_wavl_tree();
+
+// ========== B+ ДЕРЕВО В ФАЙЛЕ (mmap) ==========
+// (src/disk_bplus.cpp)
+
+// Размер страницы по умолчанию; степень двойки, кратная странице ОС
+#ifndef DISK_BPLUS_PAGE_SIZE
+#define DISK_BPLUS_PAGE_SIZE 4096
+#endif
+
+struct DiskBPlusTree;
+
+// Открывает файл дерева или создает новый; у существующего файла размер
+// страницы из метаданных должен быть равен page_size. NULL - ошибка
+struct DiskBPlusTree* disk_bplus_open(const char* path, int page_size);
+// Контрольная точка и закрытие; 0 - успех, -1 - ошибка ввода-вывода
+int disk_bplus_close(struct DiskBPlusTree* tree);
+// msync + fsync: после возврата 0 дерево на диске согласовано
+int disk_bplus_checkpoint(struct DiskBPlusTree* tree);
+// Выбросить страницы дерева из памяти (модель данных больше RAM)
+void disk_bplus_drop_cache(struct DiskBPlusTree* tree);
+// 1 - ключ вставлен, 0 - уже был
+int disk_bplus_insert(struct DiskBPlusTree* tree, int key);
+// 1 - ключ удален, 0 - не найден
+int disk_bplus_delete(struct DiskBPlusTree* tree, int key);
+int disk_bplus_contains(struct DiskBPlusTree* tree, int key);
+// Ключи из [lo, hi] по возрастанию (не больше max_out в out); возвращает их число
+int disk_bplus_range(struct DiskBPlusTree* tree, int lo, int hi, int* out, int max_out);
+long long disk_bplus_count(struct DiskBPlusTree* tree);
+int disk_bplus_height(struct DiskBPlusTree* tree);
+size_t disk_bplus_file_bytes(struct DiskBPlusTree* tree);
+int disk_bplus_free_pages(struct DiskBPlusTree* tree);
+
+void test_disk_bplus();
+
+// ========== СОХРАНЕНИЕ И ЗАГРУЗКА AVL/RBT ==========
+// (src/tree_serialize.cpp)
+
+// Компактный файл (5 байт на узел) с формой дерева и высотами/цветами;
+// 0 - успех, -1 - ошибка ввода-вывода
+int avl_save(struct AVLNode* root, const char* path);
+int rbt_save(struct RBNode* root, const char* path);
+// Линейная загрузка без поворотов; возвращает число узлов или -1
+int avl_load(const char* path, struct AVLNode** root);
+int rbt_load(const char* path, struct RBNode** root);
+
+void test_tree_serialize();
+
+// ========== AVL/RBT СО СТРОКОВЫМИ КЛЮЧАМИ ==========
+// (src/string_tree.cpp)
+
+#define STR_KEY_MAX 255 // длина ключа в байтах (доменное имя - до 253)
+
+struct StrAVLTree;
+struct StrRBTree;
+
+struct StrTreeStats {
+    int count;
+    long long compares;       // сравнений ключей с момента создания
+    long long full_compares;  // из них не решенных префиксом в узле
+    size_t node_bytes;
+    size_t arena_bytes;       // байты ключей (с заголовками кодирования)
+};
+
+// front_coding = 1 - ключи в арене хранятся относительно соседнего ключа
+struct StrAVLTree* str_avl_create(int front_coding);
+void str_avl_free(struct StrAVLTree* tree);
+// 1 - вставлен, 0 - уже был, -1 - ключ длиннее STR_KEY_MAX
+int str_avl_insert(struct StrAVLTree* tree, const char* key, int len);
+int str_avl_contains(struct StrAVLTree* tree, const char* key, int len);
+int str_avl_height(struct StrAVLTree* tree);
+void str_avl_get_stats(struct StrAVLTree* tree, struct StrTreeStats* stats);
+int str_avl_is_valid(struct StrAVLTree* tree);
+
+struct StrRBTree* str_rbt_create(int front_coding);
+void str_rbt_free(struct StrRBTree* tree);
+int str_rbt_insert(struct StrRBTree* tree, const char* key, int len);
+int str_rbt_contains(struct StrRBTree* tree, const char* key, int len);
+int str_rbt_height(struct StrRBTree* tree);
+void str_rbt_get_stats(struct StrRBTree* tree, struct StrTreeStats* stats);
+int str_rbt_is_valid(struct StrRBTree* tree);
+
+void test_string_tree();
+
+// ========== САМОНАСТРАИВАЮЩЕЕСЯ МНОЖЕСТВО (AVL <-> RBT) ==========
+// (src/adaptive_tree.cpp)
+
+enum AdaptiveKind { ADAPTIVE_AVL, ADAPTIVE_RBT };
+
+struct AdaptiveTree;
+
+// Закрепить одно дерево при любой доле изменений
+#define ADAPTIVE_ALWAYS_RBT (-1.0)
+#define ADAPTIVE_ALWAYS_AVL 2.0
+
+// crossover - доля изменений (0..1), выше которой выгоднее RBT,
+// или ADAPTIVE_ALWAYS_RBT / ADAPTIVE_ALWAYS_AVL
+struct AdaptiveTree* adaptive_create(double crossover);
+void adaptive_free(struct AdaptiveTree* tree);
+void adaptive_insert(struct AdaptiveTree* tree, int key);
+void adaptive_delete(struct AdaptiveTree* tree, int key);
+int adaptive_contains(struct AdaptiveTree* tree, int key);
+enum AdaptiveKind adaptive_kind(struct AdaptiveTree* tree);
+int adaptive_migrations(struct AdaptiveTree* tree);
+int adaptive_is_valid(struct AdaptiveTree* tree);
+
+// Линейная сборка из отсортированного массива без повторов (без поворотов)
+struct AVLNode* avl_build_sorted(const int* keys, int n);
+struct RBNode* rbt_build_sorted(const int* keys, int n);
+
+void test_adaptive_tree();
+
+// ========== МАЛОЕ МНОЖЕСТВО: МАССИВ В КЕШ-ЛИНИИ ИЛИ ДЕРЕВО ==========
+// (src/small_set.cpp)
+
+// Ключей в массиве: вместе с count и kind ровно одна кеш-линия
+#define SMALL_SET_CAPACITY 15
+// Дерево возвращается в массив, когда в нем остается столько ключей
+#define SMALL_SET_DEMOTE 8
+
+enum SmallSetKind { SMALL_SET_AVL, SMALL_SET_RBT };
+
+// Встраивается в чужие структуры по значению; массивы - через aligned_alloc(64, ...)
+struct alignas(64) SmallSet {
+    int keys[SMALL_SET_CAPACITY]; // отсортированы; в режиме дерева - корень и размер
+    short count;                  // ключей в массиве, -1 - режим дерева
+    short kind;                   // во что превращаться: SMALL_SET_AVL / SMALL_SET_RBT
+};
+
+void small_set_init(struct SmallSet* set, enum SmallSetKind kind);
+// Освобождает дерево (если есть) и очищает набор
+void small_set_clear(struct SmallSet* set);
+// 1 - ключ вставлен, 0 - уже был
+int small_set_insert(struct SmallSet* set, int key);
+// 1 - ключ удален, 0 - не найден
+int small_set_delete(struct SmallSet* set, int key);
+int small_set_contains(const struct SmallSet* set, int key);
+int small_set_size(const struct SmallSet* set);
+int small_set_is_tree(const struct SmallSet* set);
+// Узлы дерева вне структуры (0 в режиме массива)
+size_t small_set_heap_bytes(const struct SmallSet* set);
+
+void test_small_set();
+
+// ========== ХРАНИЛИЩЕ УЗЛОВ НА БОЛЬШИХ СТРАНИЦАХ ==========
+// (src/node_storage.cpp)
+
+// Откуда берутся узлы AVLNode/RBNode
+enum NodeStorage {
+    NODE_STORAGE_MALLOC,   // malloc/free (по умолчанию)
+    NODE_STORAGE_ARENA_4K, // арена на обычных страницах (MADV_NOHUGEPAGE)
+    NODE_STORAGE_THP,      // арена с madvise(MADV_HUGEPAGE)
+    NODE_STORAGE_HUGETLB   // арена на MAP_HUGETLB
+};
+
+// Переключает хранилище; capacity - байт под узлы. Недоступный режим
+// откатывается: HUGETLB -> THP -> ARENA_4K -> MALLOC. Возвращает выбранный.
+// Узлы прежней арены к этому моменту должны быть освобождены.
+enum NodeStorage node_storage_set(enum NodeStorage mode, size_t capacity);
+enum NodeStorage node_storage_mode();
+// Единственный путь создания и освобождения узлов деревьев
+void* tree_node_alloc(size_t size);
+void tree_node_free(void* node, size_t size);
+// Байт арены, реально лежащих на 2-МиБ страницах
+size_t node_storage_huge_bytes();
+
+// Чужие блоки узлов: модуль, сам нарезающий узлы в блоки по
+// NODE_STORAGE_BLOCK_BYTES (выровненные на размер), регистрирует их, и
+// tree_node_free отдает такие узлы владельцу через release, а не в free().
+// Так деревья из этих блоков остаются обычными: delete, join/split, free_*_tree
+#define NODE_STORAGE_BLOCK_BYTES (2 * 1024 * 1024)
+typedef void (*NodeBlockRelease)(void* owner, void* node);
+void node_storage_register_block(void* base, void* owner, NodeBlockRelease release);
+void node_storage_unregister_block(void* base);
+
+void test_node_storage();
+
+// ========== МНОГОПОТОЧНЫЙ ПРОГОН НЕЗАВИСИМЫХ ДЕРЕВЬЕВ ==========
+// (src/parallel_runner.cpp)
+
+enum ParallelWorkload {
+    PARALLEL_INSERT, // вставка случайных ключей в пустое дерево
+    PARALLEL_SEARCH, // поиск существующих ключей в заполненном дереве
+    PARALLEL_MIXED   // 50% поиск, 25% вставка, 25% удаление
+};
+
+// Ядра из маски sched_getaffinity
+int parallel_core_count();
+// threads потоков, у каждого свое дерево (AVL или RBT) и keys операций;
+// поток i привязан к i-му доступному ядру (по кругу). Возвращает суммарные
+// Mops/s; per_thread_mops (threads элементов) и pinned - по желанию
+double parallel_run(enum ParallelWorkload workload, int is_rbt, int threads, int keys,
+                    double* per_thread_mops, int* pinned);
+// Режим командной строки: app --parallel <insert|search|mixed> [K] [операций]
+int parallel_runner_main(int argc, char** argv);
+
+void test_parallel_scaling();
+
+// ========== ПРОФИЛЬ НАГРУЗКИ ПО ЖУРНАЛУ ОПЕРАЦИЙ ==========
+// (src/trace_profile.cpp)
+
+// Перекос: доля обращений к этому проценту самых частых ключей
+#define TRACE_HOT_KEYS_PERCENT 10
+
+enum TraceOpType { TRACE_SEARCH, TRACE_INSERT, TRACE_DELETE, TRACE_RANGE };
+
+struct TraceOp {
+    int key;  // для диапазона - нижняя граница
+    int hi;   // верхняя граница диапазона
+    int type; // TraceOpType
+};
+
+struct TraceProfile {
+    long long ops;
+    long long counts[4];     // по TraceOpType
+    long long bad_lines;     // строки, не разобранные как операция
+    int min_key;
+    int max_key;
+    double avg_range_width;
+    double distinct_keys;    // оценка HyperLogLog
+    double working_set_keys; // наибольшее число живых ключей (по выборке)
+    double insert_monotonic; // доля вставок с ключом не меньше предыдущего
+    double hot_keys_share;   // доля обращений к TRACE_HOT_KEYS_PERCENT% частых ключей
+    double sample_rate;      // доля ключей в выборке
+    long long sample_ops;
+};
+
+// Операции ключей с хешем не выше threshold, в порядке журнала
+struct TraceSample {
+    struct TraceOp* ops;
+    long long count;
+    long long capacity;
+    unsigned threshold;
+};
+
+struct TraceReplayResult {
+    const char* name;    // как в списке кандидатов choose_struct
+    int supported;       // 0 - структура не умеет операций журнала
+    const char* missing; // каких именно
+    double ns_per_op;
+    long long checksum;  // найдено поиском + ключей в диапазонах
+};
+
+// Один проход по журналу; выборка - не больше max_sample_ops операций.
+// 0 - успех, -1 - файл не открылся
+int trace_profile_file(const char* path, long long max_sample_ops, struct TraceProfile* profile,
+                       struct TraceSample** sample);
+void trace_sample_free(struct TraceSample* sample);
+// Проигрывает выборку на каждой структуре; возвращает число результатов
+int trace_replay(const struct TraceSample* sample, const struct TraceProfile* profile,
+                 struct TraceReplayResult* results, int max_results);
+// Индекс самой быстрой из поддерживающих журнал структур, -1 - таких нет
+int trace_measured_winner(const struct TraceReplayResult* results, int count);
+
+void test_trace_profile();
+
+// ========== ИНДЕКС НА БЛОКАХ С ДЕЛЬТАМИ ==========
+// (src/delta_index.cpp)
+// Упорядоченное множество для временных рядов: отсортированные блоки до
+// DELTA_BLOCK_KEYS ключей, каждый хранит наименьший ключ и дельты от него,
+// упакованные по ширине наибольшей дельты. Распаковка - SSE2.
+
+#define DELTA_BLOCK_KEYS 128
+
+struct DeltaIndex;
+
+struct DeltaIndex* delta_index_create();
+void delta_index_free(struct DeltaIndex* index);
+// 1 - ключ добавлен, 0 - уже был
+int delta_index_insert(struct DeltaIndex* index, int key);
+// 1 - ключ удален, 0 - его не было
+int delta_index_delete(struct DeltaIndex* index, int key);
+int delta_index_contains(struct DeltaIndex* index, int key);
+// Ключи из [lo, hi] по возрастанию, не больше max_out; возвращает их число
+int delta_index_range(struct DeltaIndex* index, int lo, int hi, int* out, int max_out);
+long long delta_index_count(struct DeltaIndex* index);
+int delta_index_block_count(struct DeltaIndex* index);
+// Блоки и каталог, без заголовков malloc
+size_t delta_index_memory_bytes(struct DeltaIndex* index);
+int delta_index_is_valid(struct DeltaIndex* index);
+
+void test_delta_index();
+
+// ========== СЕРВЕР ДЕРЕВА НА UNIX-СОКЕТЕ ==========
+// (src/tree_server.cpp)
+// Запрос - struct TreeRequest как есть (12 байт). Ответы идут в порядке
+// запросов, клиент может слать следующие не дожидаясь (конвейер): на поиск,
+// вставку и удаление - int 0/1, на диапазон - int n и n ключей по
+// возрастанию (не больше TREE_SERVER_MAX_RANGE), на неизвестную операцию - -1.
+
+#define TREE_SERVER_MAX_RANGE 256
+
+enum TreeServerOp { TREE_OP_SEARCH, TREE_OP_INSERT, TREE_OP_DELETE, TREE_OP_RANGE };
+
+struct TreeRequest {
+    int op;  // TreeServerOp
+    int key; // для диапазона - нижняя граница
+    int hi;  // верхняя граница диапазона
+};
+
+struct TreeServer;
+
+// Слушает сокет path (старый сокет удаляется, другой файл по этому пути -
+// ошибка EEXIST); NULL - ошибка, причина в errno
+struct TreeServer* tree_server_create(const char* path, int is_rbt, int max_batch);
+// Цикл обработки; возвращается после tree_server_stop (из другого потока или сигнала)
+void tree_server_run(struct TreeServer* server);
+void tree_server_stop(struct TreeServer* server);
+// Счетчики с момента создания: пакетов и запросов в них
+void tree_server_stats(struct TreeServer* server, long long* batches, long long* requests);
+void tree_server_free(struct TreeServer* server);
+
+struct LoadConfig {
+    const char* path;
+    int clients;        // по соединению и потоку на клиента
+    int batch;          // запросов в одной отправке
+    int ops_per_client;
+    int open_loop;      // 0 - замкнутый цикл, 1 - открытый по расписанию
+    double rate;        // открытый цикл: запросов/с на всех клиентов
+    int key_range;      // ключи 0..key_range-1
+};
+
+struct LoadResult {
+    long long requests;
+    double seconds;
+    double throughput; // запросов/с
+    double p50_us;
+    double p99_us;
+    double p999_us;
+    double max_us;
+    int errors;        // клиентов, потерявших соединение или получивших чужой ответ
+};
+
+// 0 - все клиенты получили все ответы
+int load_run(const struct LoadConfig* config, struct LoadResult* result);
+// Оставляет в 0..2*keys-1 ровно четные ключи и проверяет ответы поиска и диапазона.
+// 0 - ок, 1 - неверный ответ, -1 - нет соединения
+int load_prefill(const char* path, int keys);
+// app --serve <сокет> [avl|rbt] [макс. пакет]
+int tree_server_main(int argc, char** argv);
+// app --load <сокет> <closed|open> [клиентов] [пакет] [запросов на клиента] [запросов/с] [ключей]
+int load_generator_main(int argc, char** argv);
+
+void test_tree_server();
+
+#endif
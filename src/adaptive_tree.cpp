@@ -0,0 +1,410 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "methods.h"
+
+// ========== САМОНАСТРАИВАЮЩЕЕСЯ МНОЖЕСТВО (AVL <-> RBT) ==========
+// Доля изменений (вставки + удаления) считается по скользящему окну из
+// ADAPTIVE_WINDOW_BLOCKS блоков по ADAPTIVE_BLOCK_OPS операций. Если в
+// конце ADAPTIVE_CONFIRM_BLOCKS блоков подряд окно говорит в пользу
+// другого дерева (с запасом ADAPTIVE_HYSTERESIS от точки перехода),
+// ключи переносятся обходом по порядку и линейной сборкой нового
+// дерева - без сравнений и поворотов.
+// Переход стоит O(n), поэтому следующий разрешен не раньше, чем после
+// n операций: на одну операцию приходится O(1) работы переноса.
+
+#define ADAPTIVE_BLOCK_OPS 1024
+#define ADAPTIVE_WINDOW_BLOCKS 16
+#define ADAPTIVE_CONFIRM_BLOCKS 4
+#define ADAPTIVE_HYSTERESIS 0.05
+
+struct AdaptiveTree {
+    enum AdaptiveKind kind;
+    struct AVLNode* avl;
+    struct RBNode* rbt;
+    double crossover;            // доля изменений, выше которой выгоднее RBT
+    int block_ops;
+    int block_writes;
+    int window[ADAPTIVE_WINDOW_BLOCKS];  // изменений в каждом блоке окна
+    int window_pos;
+    int window_blocks;
+    int window_writes;
+    int streak;                  // блоков подряд в пользу другого дерева
+    int last_size;               // размер при последнем переносе
+    long long ops_since_migration;
+    long long ops;
+    int migrations;
+};
+
+struct AdaptiveTree* adaptive_create(double crossover) {
+    struct AdaptiveTree* tree = (struct AdaptiveTree*)calloc(1, sizeof(struct AdaptiveTree));
+    // Пока окно пустое, считаем нагрузку читающей (закрепленное RBT - сразу RBT)
+    tree->kind = crossover < 0 ? ADAPTIVE_RBT : ADAPTIVE_AVL;
+    tree->crossover = crossover;
+    return tree;
+}
+
+void adaptive_free(struct AdaptiveTree* tree) {
+    if (tree == NULL)
+        return;
+    free_avl_tree(tree->avl);
+    free_rbt_tree(tree->rbt);
+    free(tree);
+}
+
+static int adaptive_collect_avl(struct AVLNode* node, int* out, int pos) {
+    if (node == NULL)
+        return pos;
+    pos = adaptive_collect_avl(node->left, out, pos);
+    out[pos++] = node->key;
+    return adaptive_collect_avl(node->right, out, pos);
+}
+
+static int adaptive_collect_rbt(struct RBNode* node, int* out, int pos) {
+    if (node == NULL)
+        return pos;
+    pos = adaptive_collect_rbt(node->left, out, pos);
+    out[pos++] = node->key;
+    return adaptive_collect_rbt(node->right, out, pos);
+}
+
+// Идеально сбалансированное AVL из отсортированного массива
+struct AVLNode* avl_build_sorted(const int* keys, int n) {
+    if (n <= 0)
+        return NULL;
+    int mid = n / 2;
+    struct AVLNode* node = (struct AVLNode*)tree_node_alloc(sizeof(struct AVLNode));
+    node->key = keys[mid];
+    node->left = avl_build_sorted(keys, mid);
+    node->right = avl_build_sorted(keys + mid + 1, n - mid - 1);
+    int hl = avl_height(node->left);
+    int hr = avl_height(node->right);
+    node->height = 1 + (hl > hr ? hl : hr);
+#ifdef TREE_ORDER_STATISTICS
+    node->size = n;
+#endif
+    return node;
+}
+
+// Та же форма для RBT: при делении пополам листья лежат на двух
+// соседних уровнях, поэтому нижний уровень красный, остальные черные
+static struct RBNode* adaptive_build_rbt(const int* keys, int n, int depth, int red_depth,
+                                         struct RBNode* parent) {
+    if (n <= 0)
+        return NULL;
+    int mid = n / 2;
+    struct RBNode* node = (struct RBNode*)tree_node_alloc(sizeof(struct RBNode));
+    node->key = keys[mid];
+    node->color = depth == red_depth ? RED : BLACK;
+    node->parent = parent;
+    node->left = adaptive_build_rbt(keys, mid, depth + 1, red_depth, node);
+    node->right = adaptive_build_rbt(keys + mid + 1, n - mid - 1, depth + 1, red_depth, node);
+#ifdef TREE_ORDER_STATISTICS
+    node->size = n;
+#endif
+    return node;
+}
+
+struct RBNode* rbt_build_sorted(const int* keys, int n) {
+    int red_depth = 0;
+    while ((2 << red_depth) <= n)
+        red_depth++;
+    struct RBNode* root = adaptive_build_rbt(keys, n, 0, red_depth, NULL);
+    if (root != NULL)
+        root->color = BLACK;
+    return root;
+}
+
+static void adaptive_migrate(struct AdaptiveTree* tree, enum AdaptiveKind kind) {
+    int n = tree->kind == ADAPTIVE_AVL ? count_avl_nodes(tree->avl) : count_rbt_nodes(tree->rbt);
+    int* keys = (int*)malloc((n > 0 ? n : 1) * sizeof(int));
+    if (tree->kind == ADAPTIVE_AVL) {
+        adaptive_collect_avl(tree->avl, keys, 0);
+        free_avl_tree(tree->avl);
+        tree->avl = NULL;
+    } else {
+        adaptive_collect_rbt(tree->rbt, keys, 0);
+        free_rbt_tree(tree->rbt);
+        tree->rbt = NULL;
+    }
+
+    if (kind == ADAPTIVE_AVL)
+        tree->avl = avl_build_sorted(keys, n);
+    else
+        tree->rbt = rbt_build_sorted(keys, n);
+    free(keys);
+
+    tree->kind = kind;
+    tree->last_size = n;
+    tree->ops_since_migration = 0;
+    tree->streak = 0;
+    tree->migrations++;
+}
+
+static void adaptive_end_block(struct AdaptiveTree* tree) {
+    if (tree->window_blocks == ADAPTIVE_WINDOW_BLOCKS)
+        tree->window_writes -= tree->window[tree->window_pos];
+    else
+        tree->window_blocks++;
+    tree->window[tree->window_pos] = tree->block_writes;
+    tree->window_writes += tree->block_writes;
+    tree->window_pos = (tree->window_pos + 1) % ADAPTIVE_WINDOW_BLOCKS;
+    tree->block_ops = 0;
+    tree->block_writes = 0;
+
+    double share = (double)tree->window_writes / (tree->window_blocks * ADAPTIVE_BLOCK_OPS);
+    enum AdaptiveKind want = tree->kind;
+    if (share > tree->crossover + ADAPTIVE_HYSTERESIS)
+        want = ADAPTIVE_RBT;
+    else if (share < tree->crossover - ADAPTIVE_HYSTERESIS)
+        want = ADAPTIVE_AVL;
+
+    tree->streak = want != tree->kind ? tree->streak + 1 : 0;
+    if (tree->streak >= ADAPTIVE_CONFIRM_BLOCKS && tree->window_blocks == ADAPTIVE_WINDOW_BLOCKS &&
+        tree->ops_since_migration >= tree->last_size)
+        adaptive_migrate(tree, want);
+}
+
+static void adaptive_record(struct AdaptiveTree* tree, int is_write) {
+    tree->ops++;
+    tree->ops_since_migration++;
+    tree->block_writes += is_write;
+    if (++tree->block_ops == ADAPTIVE_BLOCK_OPS)
+        adaptive_end_block(tree);
+}
+
+void adaptive_insert(struct AdaptiveTree* tree, int key) {
+    int rotations = 0;
+    int recolorings = 0;
+    if (tree->kind == ADAPTIVE_AVL)
+        tree->avl = avl_insert(tree->avl, key, &rotations);
+    else
+        tree->rbt = rbt_insert(tree->rbt, key, &rotations, &recolorings);
+    adaptive_record(tree, 1);
+}
+
+void adaptive_delete(struct AdaptiveTree* tree, int key) {
+    int rotations = 0;
+    int recolorings = 0;
+    if (tree->kind == ADAPTIVE_AVL)
+        tree->avl = avl_delete(tree->avl, key, &rotations);
+    else
+        tree->rbt = rbt_delete(tree->rbt, key, &rotations, &recolorings);
+    adaptive_record(tree, 1);
+}
+
+int adaptive_contains(struct AdaptiveTree* tree, int key) {
+    int found = tree->kind == ADAPTIVE_AVL ? avl_search(tree->avl, key) != NULL
+                                           : rbt_search(tree->rbt, key) != NULL;
+    adaptive_record(tree, 0);
+    return found;
+}
+
+enum AdaptiveKind adaptive_kind(struct AdaptiveTree* tree) {
+    return tree->kind;
+}
+
+int adaptive_migrations(struct AdaptiveTree* tree) {
+    return tree->migrations;
+}
+
+int adaptive_is_valid(struct AdaptiveTree* tree) {
+    return tree->kind == ADAPTIVE_AVL ? tree->rbt == NULL && avl_is_valid(tree->avl)
+                                      : tree->avl == NULL && rbt_is_valid(tree->rbt);
+}
+
+// ==================== ТЕСТ 26: AVL <-> RBT ПО НАБЛЮДАЕМОЙ НАГРУЗКЕ ====================
+
+// 0 - поиск, 1 - вставка, 2 - удаление; write_percent - доля изменений
+static void adaptive_make_ops(int* ops, int* op_keys, int count, int write_percent, int key_range) {
+    for (int i = 0; i < count; i++) {
+        int r = rand() % 100;
+        ops[i] = r < write_percent ? 1 + (rand() & 1) : 0;
+        op_keys[i] = (int)(((long long)rand() * RAND_MAX + rand()) % key_range);
+    }
+}
+
+static double adaptive_run_avl(struct AVLNode** root, const int* ops, const int* op_keys, int count,
+                               long long* found) {
+    int rotations = 0;
+    clock_t start = clock();
+    for (int i = 0; i < count; i++) {
+        if (ops[i] == 0)
+            *found += avl_search(*root, op_keys[i]) != NULL;
+        else if (ops[i] == 1)
+            *root = avl_insert(*root, op_keys[i], &rotations);
+        else
+            *root = avl_delete(*root, op_keys[i], &rotations);
+    }
+    return (double)(clock() - start) * 1000 / CLOCKS_PER_SEC;
+}
+
+static double adaptive_run_rbt(struct RBNode** root, const int* ops, const int* op_keys, int count,
+                               long long* found) {
+    int rotations = 0;
+    int recolorings = 0;
+    clock_t start = clock();
+    for (int i = 0; i < count; i++) {
+        if (ops[i] == 0)
+            *found += rbt_search(*root, op_keys[i]) != NULL;
+        else if (ops[i] == 1)
+            *root = rbt_insert(*root, op_keys[i], &rotations, &recolorings);
+        else
+            *root = rbt_delete(*root, op_keys[i], &rotations, &recolorings);
+    }
+    return (double)(clock() - start) * 1000 / CLOCKS_PER_SEC;
+}
+
+static double adaptive_run(struct AdaptiveTree* tree, const int* ops, const int* op_keys, int count,
+                           long long* found) {
+    clock_t start = clock();
+    for (int i = 0; i < count; i++) {
+        if (ops[i] == 0)
+            *found += adaptive_contains(tree, op_keys[i]);
+        else if (ops[i] == 1)
+            adaptive_insert(tree, op_keys[i]);
+        else
+            adaptive_delete(tree, op_keys[i]);
+    }
+    return (double)(clock() - start) * 1000 / CLOCKS_PER_SEC;
+}
+
+void test_adaptive_tree() {
+    printf("=== ТЕСТ 26: Самонастраивающееся множество AVL <-> RBT на меняющейся нагрузке ===\n\n");
+
+    const int N = 1000000;
+    const int KEY_RANGE = N * 2;   // вставка и удаление удаются примерно поровну
+    const int CALIBRATION_OPS = 300000;
+    const int PHASE_OPS = 2000000;
+    const int PHASES[] = {5, 90, 10, 80, 5, 95};  // % изменений в фазе
+    const int NUM_PHASES = sizeof(PHASES) / sizeof(PHASES[0]);
+
+    srand(time(NULL));
+
+    int* keys = (int*)malloc(N * sizeof(int));
+    for (int i = 0; i < N; i++)
+        keys[i] = (int)(((long long)rand() * RAND_MAX + rand()) % KEY_RANGE);
+    int* ops = (int*)malloc(PHASE_OPS * sizeof(int));
+    int* op_keys = (int*)malloc(PHASE_OPS * sizeof(int));
+
+    // ---------- Калибровка: где RBT начинает обгонять AVL ----------
+    int rotations = 0;
+    int recolorings = 0;
+    struct AVLNode* avl_root = NULL;
+    struct RBNode* rbt_root = NULL;
+    for (int i = 0; i < N; i++) {
+        avl_root = avl_insert(avl_root, keys[i], &rotations);
+        rbt_root = rbt_insert(rbt_root, keys[i], &rotations, &recolorings);
+    }
+    long long found = 0;
+    adaptive_make_ops(ops, op_keys, CALIBRATION_OPS, 0, KEY_RANGE);
+    double avl_read = adaptive_run_avl(&avl_root, ops, op_keys, CALIBRATION_OPS, &found);
+    double rbt_read = adaptive_run_rbt(&rbt_root, ops, op_keys, CALIBRATION_OPS, &found);
+    adaptive_make_ops(ops, op_keys, CALIBRATION_OPS, 100, KEY_RANGE);
+    double avl_write = adaptive_run_avl(&avl_root, ops, op_keys, CALIBRATION_OPS, &found);
+    double rbt_write = adaptive_run_rbt(&rbt_root, ops, op_keys, CALIBRATION_OPS, &found);
+    free_avl_tree(avl_root);
+    free_rbt_tree(rbt_root);
+
+    // Стоимость смеси с долей изменений w линейна по w: RBT выгоднее, когда
+    // (1 - w) * read_gap < w * write_gap. Переключение имеет смысл, только если
+    // AVL быстрее на поиске, а RBT на изменениях; иначе одно дерево закрепляется
+    double read_gap = rbt_read - avl_read;     // > 0: AVL быстрее на поиске
+    double write_gap = avl_write - rbt_write;  // > 0: RBT быстрее на изменениях
+    double crossover;
+    const char* pinned_reason = NULL;
+    if (read_gap >= 0 && write_gap >= 0) {
+        crossover = read_gap + write_gap > 0 ? read_gap / (read_gap + write_gap) : 0.5;
+    } else if (read_gap >= 0) {
+        crossover = ADAPTIVE_ALWAYS_AVL;
+        pinned_reason = "AVL не медленнее и на поиске, и на изменениях";
+    } else if (write_gap >= 0) {
+        crossover = ADAPTIVE_ALWAYS_RBT;
+        pinned_reason = "RBT не медленнее и на поиске, и на изменениях";
+    } else {
+        // RBT быстрее на поиске, AVL - на изменениях: выгода была бы при
+        // обратном переключении; берем дерево, лучшее на смеси 50/50
+        crossover = read_gap < write_gap ? ADAPTIVE_ALWAYS_RBT : ADAPTIVE_ALWAYS_AVL;
+        pinned_reason = "RBT быстрее на поиске, AVL на изменениях - выбрано лучшее на смеси 50/50";
+    }
+    char crossover_text[64];
+    if (pinned_reason == NULL)
+        snprintf(crossover_text, sizeof(crossover_text), "%.0f%% изменений", crossover * 100);
+    else
+        snprintf(crossover_text, sizeof(crossover_text), "нет, всегда %s",
+                 crossover < 0 ? "RBT" : "AVL");
+
+    printf("Калибровка на %d ключах (ns/оп):\n", N);
+    printf("  поиск:     AVL %.0f, RBT %.0f\n", avl_read * 1e6 / CALIBRATION_OPS,
+           rbt_read * 1e6 / CALIBRATION_OPS);
+    printf("  изменения: AVL %.0f, RBT %.0f\n", avl_write * 1e6 / CALIBRATION_OPS,
+           rbt_write * 1e6 / CALIBRATION_OPS);
+    printf("  точка перехода: %s (тест 7 оценивает ее в ~70%%)\n", crossover_text);
+    if (pinned_reason != NULL)
+        printf("  %s\n", pinned_reason);
+    printf("\n");
+
+    // ---------- Фазы нагрузки ----------
+    avl_root = NULL;
+    rbt_root = NULL;
+    for (int i = 0; i < N; i++) {
+        avl_root = avl_insert(avl_root, keys[i], &rotations);
+        rbt_root = rbt_insert(rbt_root, keys[i], &rotations, &recolorings);
+    }
+    struct AdaptiveTree* adaptive = adaptive_create(crossover);
+    for (int i = 0; i < N; i++)
+        adaptive_insert(adaptive, keys[i]);
+
+    printf("Фаза | Изменений | AVL мс  | RBT мс  | Адапт. мс | Дерево после | Переносов\n");
+    printf("-----|-----------|---------|---------|-----------|--------------|----------\n");
+
+    double total_avl = 0;
+    double total_rbt = 0;
+    double total_adaptive = 0;
+    int all_ok = 1;
+    for (int p = 0; p < NUM_PHASES; p++) {
+        adaptive_make_ops(ops, op_keys, PHASE_OPS, PHASES[p], KEY_RANGE);
+        long long avl_found = 0;
+        long long rbt_found = 0;
+        long long adaptive_found = 0;
+        double avl_ms = adaptive_run_avl(&avl_root, ops, op_keys, PHASE_OPS, &avl_found);
+        double rbt_ms = adaptive_run_rbt(&rbt_root, ops, op_keys, PHASE_OPS, &rbt_found);
+        int migrations_before = adaptive_migrations(adaptive);
+        double adaptive_ms = adaptive_run(adaptive, ops, op_keys, PHASE_OPS, &adaptive_found);
+        all_ok &= avl_found == rbt_found && avl_found == adaptive_found;
+
+        total_avl += avl_ms;
+        total_rbt += rbt_ms;
+        total_adaptive += adaptive_ms;
+        printf("%4d | %8d%% | %7.0f | %7.0f | %9.0f | %-12s | %d\n",
+               p + 1, PHASES[p], avl_ms, rbt_ms, adaptive_ms,
+               adaptive_kind(adaptive) == ADAPTIVE_AVL ? "AVL" : "RBT",
+               adaptive_migrations(adaptive) - migrations_before);
+    }
+    all_ok &= adaptive_is_valid(adaptive);
+    printf("Итого|           | %7.0f | %7.0f | %9.0f |              | %d\n",
+           total_avl, total_rbt, total_adaptive, adaptive_migrations(adaptive));
+    printf("\nПроверка (результаты поиска совпадают, инварианты дерева): %s\n\n",
+           all_ok ? "ok" : "ОШИБКА");
+
+    double best_fixed = total_avl < total_rbt ? total_avl : total_rbt;
+    printf("ВЫВОД:\n");
+    printf("• Точка перехода измеряется на месте (%s), а не берется из теста 7:\n",
+           crossover_text);
+    printf("  она зависит от размера дерева, кешей и реализации удаления\n");
+    printf("• Адаптивное множество: %.0f мс против %.0f (AVL) и %.0f (RBT) -\n",
+           total_adaptive, total_avl, total_rbt);
+    printf("  %s лучшего фиксированного дерева на меняющейся нагрузке\n",
+           total_adaptive < best_fixed ? "быстрее" : "не быстрее");
+    printf("• Перенос - обход по порядку и линейная сборка (%d раз за %d операций);\n",
+           adaptive_migrations(adaptive), NUM_PHASES * PHASE_OPS);
+    printf("  гистерезис и подтверждение несколькими блоками не дают метаться на границе\n\n");
+
+    free_avl_tree(avl_root);
+    free_rbt_tree(rbt_root);
+    adaptive_free(adaptive);
+    free(keys);
+    free(ops);
+    free(op_keys);
+}
@@ -0,0 +1,208 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "methods.h"
+
+// ========== НЕИЗМЕНЯЕМЫЙ СНИМОК AVL (EYTZINGER) ==========
+// Ключи лежат в одном массиве в порядке обхода в ширину:
+// потомки узла k - это 2k и 2k+1 (индекс 0 не используется).
+// Поиск не ходит по указателям, и 16 потомков на 4 уровня ниже
+// занимают одну кеш-линию, которую можно заранее подгрузить.
+
+#define SNAPSHOT_ALIGN 64
+#define SNAPSHOT_PREFETCH_STRIDE 16 // 64 байта / sizeof(int)
+
+static int snapshot_fill_sorted(struct AVLNode* node, int* out, int pos) {
+    if (node == NULL)
+        return pos;
+    pos = snapshot_fill_sorted(node->left, out, pos);
+    out[pos++] = node->key;
+    return snapshot_fill_sorted(node->right, out, pos);
+}
+
+// Раскладывает отсортированный массив в порядок Eytzinger
+static int snapshot_fill_eytzinger(const int* sorted, int* keys, int n, int pos, int k) {
+    if (k <= n) {
+        pos = snapshot_fill_eytzinger(sorted, keys, n, pos, 2 * k);
+        keys[k] = sorted[pos++];
+        pos = snapshot_fill_eytzinger(sorted, keys, n, pos, 2 * k + 1);
+    }
+    return pos;
+}
+
+void avl_snapshot_rebuild(struct AVLSnapshot* snapshot, struct AVLNode* root) {
+    int n = count_avl_nodes(root);
+
+    if (n + 1 > snapshot->capacity) {
+        free(snapshot->keys);
+        // Запас, чтобы при росте дерева не перевыделять память на каждой пересборке
+        int capacity = n + 1 + n / 4;
+        size_t bytes = ((size_t)capacity * sizeof(int) + SNAPSHOT_ALIGN - 1) /
+                       SNAPSHOT_ALIGN * SNAPSHOT_ALIGN;
+        snapshot->keys = (int*)aligned_alloc(SNAPSHOT_ALIGN, bytes);
+        snapshot->capacity = capacity;
+    }
+
+    int* sorted = (int*)malloc((n > 0 ? n : 1) * sizeof(int));
+    snapshot_fill_sorted(root, sorted, 0);
+    snapshot_fill_eytzinger(sorted, snapshot->keys, n, 0, 1);
+    free(sorted);
+
+    snapshot->n = n;
+}
+
+struct AVLSnapshot* avl_snapshot_build(struct AVLNode* root) {
+    struct AVLSnapshot* snapshot = (struct AVLSnapshot*)malloc(sizeof(struct AVLSnapshot));
+    snapshot->keys = NULL;
+    snapshot->n = 0;
+    snapshot->capacity = 0;
+    avl_snapshot_rebuild(snapshot, root);
+    return snapshot;
+}
+
+void avl_snapshot_free(struct AVLSnapshot* snapshot) {
+    if (snapshot == NULL)
+        return;
+    free(snapshot->keys);
+    free(snapshot);
+}
+
+int avl_snapshot_lower_bound(const struct AVLSnapshot* snapshot, int key) {
+    const int* keys = snapshot->keys;
+    int n = snapshot->n;
+    int k = 1;
+
+    // Без ветвлений: направление спуска - результат сравнения
+    while (k <= n) {
+        __builtin_prefetch(keys + (size_t)k * SNAPSHOT_PREFETCH_STRIDE);
+        k = 2 * k + (keys[k] < key);
+    }
+    // Снимаем "правые" шаги после последнего поворота налево
+    k >>= __builtin_ffs(~k);
+    return k;
+}
+
+int avl_snapshot_contains(const struct AVLSnapshot* snapshot, int key) {
+    int k = avl_snapshot_lower_bound(snapshot, key);
+    return k != 0 && snapshot->keys[k] == key;
+}
+
+// ==================== ТЕСТ 9: СНИМОК EYTZINGER vs avl_search ====================
+
+static long sysconf_or(int name, long fallback) {
+    long value = sysconf(name);
+    return value > 0 ? value : fallback;
+}
+
+void test_avl_snapshot() {
+    printf("=== ТЕСТ 9: Неизменяемый снимок AVL (Eytzinger) vs avl_search ===\n\n");
+
+    long l1 = sysconf_or(_SC_LEVEL1_DCACHE_SIZE, 32 * 1024);
+    long l2 = sysconf_or(_SC_LEVEL2_CACHE_SIZE, 1024 * 1024);
+    long l3 = sysconf_or(_SC_LEVEL3_CACHE_SIZE, 32 * 1024 * 1024);
+    printf("Кеши: L1d=%ld KB, L2=%ld KB, LLC=%ld KB\n\n", l1 / 1024, l2 / 1024, l3 / 1024);
+
+    // Размеры дерева: примерно половина уровня кеша (по узлам AVLNode).
+    // Для DRAM берем дерево не меньше 4M узлов, для LLC - не больше 1M.
+    long llc_nodes = l3 / 2 / (long)sizeof(struct AVLNode);
+    if (llc_nodes > (1 << 20))
+        llc_nodes = 1 << 20;
+    const int SIZES[] = {
+        (int)(l1 / 2 / (long)sizeof(struct AVLNode)),
+        (int)(l2 / 2 / (long)sizeof(struct AVLNode)),
+        (int)llc_nodes,
+        1 << 22
+    };
+    const char* LEVELS[] = {"L1", "L2", "LLC", "DRAM"};
+    const int NUM_SIZES = sizeof(SIZES) / sizeof(SIZES[0]);
+    const int NUM_LOOKUPS = 2000000;
+
+    printf("%-5s | %-9s | %-10s | %-16s | %-16s | %-8s | %s\n",
+           "Уров.", "Ключей", "Дерево MB", "avl_search (ns)", "Снимок (ns)", "Ускор.", "Совпадение");
+    printf("------|-----------|------------|------------------|------------------|----------|-----------\n");
+
+    srand(time(NULL));
+    int* queries = (int*)malloc(NUM_LOOKUPS * sizeof(int));
+
+    for (int s = 0; s < NUM_SIZES; s++) {
+        int n = SIZES[s];
+        int key_range = n * 2; // примерно половина запросов - промахи
+
+        struct AVLNode* root = NULL;
+        int rotations = 0;
+        for (int i = 0; i < n; i++)
+            root = avl_insert(root, rand() % key_range, &rotations);
+        struct AVLSnapshot* snapshot = avl_snapshot_build(root);
+
+        for (int i = 0; i < NUM_LOOKUPS; i++)
+            queries[i] = rand() % key_range;
+
+        clock_t start = clock();
+        int avl_found = 0;
+        for (int i = 0; i < NUM_LOOKUPS; i++)
+            avl_found += avl_search(root, queries[i]) != NULL;
+        double avl_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / NUM_LOOKUPS;
+
+        start = clock();
+        int snap_found = 0;
+        for (int i = 0; i < NUM_LOOKUPS; i++)
+            snap_found += avl_snapshot_contains(snapshot, queries[i]);
+        double snap_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / NUM_LOOKUPS;
+
+        printf("%-5s | %-9d | %-10.1f | %-16.1f | %-16.1f | %-8.2f | %s\n",
+               LEVELS[s], snapshot->n,
+               (double)snapshot->n * sizeof(struct AVLNode) / (1024 * 1024),
+               avl_ns, snap_ns, snap_ns > 0 ? avl_ns / snap_ns : 0.0,
+               avl_found == snap_found ? "OK" : "ОШИБКА");
+
+        avl_snapshot_free(snapshot);
+        free_avl_tree(root);
+    }
+
+    // Профиль DNS-кеша: чтения идут в снимок, обновления - в живое дерево,
+    // снимок периодически пересобирается
+    printf("\nПрофиль DNS-кеша (90%% поиск по снимку, 10%% вставки, пересборка каждые 25000 вставок):\n");
+    int n = 1 << 20;
+    struct AVLNode* root = NULL;
+    int rotations = 0;
+    for (int i = 0; i < n; i++)
+        root = avl_insert(root, rand() % (n * 2), &rotations);
+    struct AVLSnapshot* snapshot = avl_snapshot_build(root);
+
+    const int OPS = 1000000;
+    const int REBUILD_EVERY = 25000;
+    int pending = 0;
+    int rebuilds = 0;
+    int found = 0;
+    double rebuild_ms = 0;
+
+    clock_t start = clock();
+    for (int i = 0; i < OPS; i++) {
+        if (i % 10 == 0) {
+            root = avl_insert(root, rand() % (n * 2), &rotations);
+            if (++pending == REBUILD_EVERY) {
+                clock_t rebuild_start = clock();
+                avl_snapshot_rebuild(snapshot, root);
+                rebuild_ms += (double)(clock() - rebuild_start) * 1000 / CLOCKS_PER_SEC;
+                pending = 0;
+                rebuilds++;
+            }
+        } else {
+            found += avl_snapshot_contains(snapshot, rand() % (n * 2));
+        }
+    }
+    double total_ms = (double)(clock() - start) * 1000 / CLOCKS_PER_SEC;
+
+    printf("Всего: %.3f ms, пересборок: %d (%.3f ms, %.1f%% времени), найдено: %d\n",
+           total_ms, rebuilds, rebuild_ms, total_ms > 0 ? rebuild_ms / total_ms * 100 : 0.0, found);
+
+    avl_snapshot_free(snapshot);
+    free_avl_tree(root);
+    free(queries);
+
+    printf("\nВЫВОД: снимок убирает зависимые переходы по указателям из поиска;\n");
+    printf("       выигрыш растет, когда дерево перестает помещаться в кеш\n\n");
+}
@@ -0,0 +1,206 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "methods.h"
+
+// ========== ПАКЕТНЫЙ ПОИСК С ПРЕДВЫБОРКОЙ ==========
+// Один поиск - цепочка зависимых промахов кеша. Здесь одновременно
+// "в полете" держится group поисков: за один проход по слотам каждый
+// поиск делает шаг вниз и запрашивает (prefetch) следующий узел, а к
+// моменту возврата к этому слоту узел уже в кеше. Завершившийся поиск
+// сразу заменяется следующим ключом из пакета (AMAC).
+//
+// Вариант с корутинами C++20 здесь не используется: проект собирается
+// как C++17, а ручная машина состояний делает то же без накладных расходов.
+
+#define SEARCH_BATCH_MAX_GROUP 64
+
+void avl_search_batch(struct AVLNode* root, const int* keys, int count,
+                      struct AVLNode** results, int group) {
+    struct AVLNode* cursor[SEARCH_BATCH_MAX_GROUP];
+    int index[SEARCH_BATCH_MAX_GROUP];
+
+    if (group < 1)
+        group = 1;
+    if (group > SEARCH_BATCH_MAX_GROUP)
+        group = SEARCH_BATCH_MAX_GROUP;
+
+    int next = 0;
+    int active = 0;
+    for (int s = 0; s < group; s++) {
+        if (next < count) {
+            cursor[s] = root;
+            index[s] = next++;
+            active++;
+        } else {
+            index[s] = -1;
+        }
+    }
+
+    while (active > 0) {
+        for (int s = 0; s < group; s++) {
+            if (index[s] < 0)
+                continue;
+            struct AVLNode* node = cursor[s];
+            int key = keys[index[s]];
+
+            if (node == NULL || node->key == key) {
+                results[index[s]] = node;
+                if (next < count) {
+                    cursor[s] = root;
+                    index[s] = next++;
+                } else {
+                    index[s] = -1;
+                    active--;
+                }
+                continue;
+            }
+
+            node = key < node->key ? node->left : node->right;
+            __builtin_prefetch(node);
+            cursor[s] = node;
+        }
+    }
+}
+
+void rbt_search_batch(struct RBNode* root, const int* keys, int count,
+                      struct RBNode** results, int group) {
+    struct RBNode* cursor[SEARCH_BATCH_MAX_GROUP];
+    int index[SEARCH_BATCH_MAX_GROUP];
+
+    if (group < 1)
+        group = 1;
+    if (group > SEARCH_BATCH_MAX_GROUP)
+        group = SEARCH_BATCH_MAX_GROUP;
+
+    int next = 0;
+    int active = 0;
+    for (int s = 0; s < group; s++) {
+        if (next < count) {
+            cursor[s] = root;
+            index[s] = next++;
+            active++;
+        } else {
+            index[s] = -1;
+        }
+    }
+
+    while (active > 0) {
+        for (int s = 0; s < group; s++) {
+            if (index[s] < 0)
+                continue;
+            struct RBNode* node = cursor[s];
+            int key = keys[index[s]];
+
+            if (node == NULL || node->key == key) {
+                results[index[s]] = node;
+                if (next < count) {
+                    cursor[s] = root;
+                    index[s] = next++;
+                } else {
+                    index[s] = -1;
+                    active--;
+                }
+                continue;
+            }
+
+            node = key < node->key ? node->left : node->right;
+            __builtin_prefetch(node);
+            cursor[s] = node;
+        }
+    }
+}
+
+// ==================== ТЕСТ 11: ПАКЕТНЫЙ ПОИСК ====================
+
+void test_batch_search() {
+    printf("=== ТЕСТ 11: Пакетный поиск с чередованием и предвыборкой ===\n\n");
+
+    // Дерево должно быть в несколько раз больше LLC: берем степень двойки
+    // не меньше 4 * LLC / размер узла. В виртуальных машинах LLC часто
+    // завышен, поэтому ограничиваем размер 4M узлов (и не меньше 1M)
+    long llc = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    int N = 1 << 20;
+    if (llc <= 0)
+        N = 1 << 22;
+    while (N < (1 << 22) && (long)N * (long)sizeof(struct AVLNode) < 4 * llc)
+        N <<= 1;
+    const int NUM_LOOKUPS = 2000000;
+    const int GROUPS[] = {1, 2, 4, 8, 16, 32, 64};
+    const int NUM_GROUPS = sizeof(GROUPS) / sizeof(GROUPS[0]);
+
+    srand(time(NULL));
+
+    struct AVLNode* avl_root = NULL;
+    struct RBNode* rbt_root = NULL;
+    int rotations = 0;
+    int recolorings = 0;
+    for (int i = 0; i < N; i++) {
+        int key = rand() % (N * 2);
+        avl_root = avl_insert(avl_root, key, &rotations);
+        rbt_root = rbt_insert(rbt_root, key, &rotations, &recolorings);
+    }
+
+    double avl_mb = (double)count_avl_nodes(avl_root) * sizeof(struct AVLNode) / (1024 * 1024);
+    double rbt_mb = (double)count_rbt_nodes(rbt_root) * sizeof(struct RBNode) / (1024 * 1024);
+    printf("AVL: %.1f MB, RBT: %.1f MB, LLC: %.1f MB%s\n\n", avl_mb, rbt_mb,
+           llc > 0 ? (double)llc / (1024 * 1024) : 0.0,
+           llc > 0 && avl_mb * 1024 * 1024 < llc ? " (деревья меньше LLC!)" : "");
+
+    int* queries = (int*)malloc(NUM_LOOKUPS * sizeof(int));
+    for (int i = 0; i < NUM_LOOKUPS; i++)
+        queries[i] = rand() % (N * 2);
+    struct AVLNode** avl_results = (struct AVLNode**)malloc(NUM_LOOKUPS * sizeof(struct AVLNode*));
+    struct RBNode** rbt_results = (struct RBNode**)malloc(NUM_LOOKUPS * sizeof(struct RBNode*));
+
+    // Последовательный поиск - базовая линия
+    clock_t start = clock();
+    int avl_found = 0;
+    for (int i = 0; i < NUM_LOOKUPS; i++)
+        avl_found += avl_search(avl_root, queries[i]) != NULL;
+    double avl_seq_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / NUM_LOOKUPS;
+
+    start = clock();
+    int rbt_found = 0;
+    for (int i = 0; i < NUM_LOOKUPS; i++)
+        rbt_found += rbt_search(rbt_root, queries[i]) != NULL;
+    double rbt_seq_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / NUM_LOOKUPS;
+
+    printf("Последовательно: AVL %.1f ns/поиск, RBT %.1f ns/поиск\n\n", avl_seq_ns, rbt_seq_ns);
+    printf("%-6s | %-12s | %-8s | %-12s | %-8s | %s\n",
+           "Группа", "AVL (ns)", "Ускор.", "RBT (ns)", "Ускор.", "Проверка");
+    printf("-------|--------------|----------|--------------|----------|---------\n");
+
+    for (int g = 0; g < NUM_GROUPS; g++) {
+        start = clock();
+        avl_search_batch(avl_root, queries, NUM_LOOKUPS, avl_results, GROUPS[g]);
+        double avl_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / NUM_LOOKUPS;
+
+        start = clock();
+        rbt_search_batch(rbt_root, queries, NUM_LOOKUPS, rbt_results, GROUPS[g]);
+        double rbt_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / NUM_LOOKUPS;
+
+        int avl_batch_found = 0;
+        int rbt_batch_found = 0;
+        for (int i = 0; i < NUM_LOOKUPS; i++) {
+            avl_batch_found += avl_results[i] != NULL;
+            rbt_batch_found += rbt_results[i] != NULL;
+        }
+
+        printf("%-6d | %-12.1f | %-8.2f | %-12.1f | %-8.2f | %s\n",
+               GROUPS[g], avl_ns, avl_ns > 0 ? avl_seq_ns / avl_ns : 0.0,
+               rbt_ns, rbt_ns > 0 ? rbt_seq_ns / rbt_ns : 0.0,
+               avl_batch_found == avl_found && rbt_batch_found == rbt_found ? "OK" : "ОШИБКА");
+    }
+
+    free(queries);
+    free(avl_results);
+    free(rbt_results);
+    free_avl_tree(avl_root);
+    free_rbt_tree(rbt_root);
+
+    printf("\nВЫВОД: при нескольких поисках в полете промахи кеша перекрываются;\n");
+    printf("       выигрыш растет до насыщения буферов промахов (обычно 8-16 поисков)\n\n");
+}
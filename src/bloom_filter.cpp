@@ -0,0 +1,333 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "methods.h"
+
+// ========== БЛОЧНЫЙ ФИЛЬТР БЛУМА ==========
+// Все k проб одного ключа попадают в один блок размером с кеш-линию,
+// поэтому проверка стоит одного промаха кеша вместо k. Плата - немного
+// более высокая доля ложных срабатываний, чем у классического фильтра.
+//
+// Счетный вариант хранит в блоке 128 четырехбитных счетчиков вместо
+// 512 бит: в 4 раза больше памяти на ту же точность, зато ключи можно
+// удалять. Насыщенный счетчик (15) больше не уменьшается - это дает
+// лишние срабатывания, но никогда не ложный отказ.
+
+#define BLOOM_BLOCK_WORDS 8
+#define BLOOM_BLOCK_BITS 512
+#define BLOOM_BLOCK_COUNTERS 128
+#define BLOOM_MAX_K 16
+
+static uint64_t bloom_hash(int key) {
+    // Финализатор MurmurHash3
+    uint64_t h = (uint64_t)(uint32_t)key;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+struct BlockedBloom* bloom_create(size_t expected_keys, int bits_per_key, int counting) {
+    struct BlockedBloom* filter = (struct BlockedBloom*)malloc(sizeof(struct BlockedBloom));
+    if (expected_keys < 1)
+        expected_keys = 1;
+    if (bits_per_key < 1)
+        bits_per_key = 1;
+
+    size_t bits = expected_keys * (size_t)bits_per_key;
+    filter->num_blocks = (bits + BLOOM_BLOCK_BITS - 1) / BLOOM_BLOCK_BITS;
+    filter->counting = counting != 0;
+
+    // Оптимальное k = (ячеек на ключ) * ln 2
+    double slots_per_key = counting ? bits_per_key / 4.0 : (double)bits_per_key;
+    int k = (int)(slots_per_key * 0.693 + 0.5);
+    filter->k = k < 1 ? 1 : (k > BLOOM_MAX_K ? BLOOM_MAX_K : k);
+
+    size_t bytes = filter->num_blocks * BLOOM_BLOCK_WORDS * sizeof(uint64_t);
+    filter->blocks = (uint64_t*)aligned_alloc(64, bytes);
+    memset(filter->blocks, 0, bytes);
+    return filter;
+}
+
+void bloom_free(struct BlockedBloom* filter) {
+    if (filter == NULL)
+        return;
+    free(filter->blocks);
+    free(filter);
+}
+
+size_t bloom_memory_bytes(struct BlockedBloom* filter) {
+    return filter->num_blocks * BLOOM_BLOCK_WORDS * sizeof(uint64_t);
+}
+
+// Блок и параметры двойного хеширования внутри блока
+static uint64_t* bloom_block(struct BlockedBloom* filter, int key, uint32_t* h1, uint32_t* h2) {
+    uint64_t h = bloom_hash(key);
+    size_t block = (size_t)(((h >> 32) * filter->num_blocks) >> 32);
+    *h1 = (uint32_t)h;
+    *h2 = ((uint32_t)h >> 16) | 1; // нечетный шаг - все k позиций разные
+    return filter->blocks + block * BLOOM_BLOCK_WORDS;
+}
+
+void bloom_add(struct BlockedBloom* filter, int key) {
+    uint32_t h1, h2;
+    uint64_t* block = bloom_block(filter, key, &h1, &h2);
+    for (int i = 0; i < filter->k; i++) {
+        uint32_t pos = h1 + i * h2;
+        if (!filter->counting) {
+            pos &= BLOOM_BLOCK_BITS - 1;
+            block[pos >> 6] |= 1ULL << (pos & 63);
+        } else {
+            pos &= BLOOM_BLOCK_COUNTERS - 1;
+            int shift = (pos & 15) * 4;
+            uint64_t counter = (block[pos >> 4] >> shift) & 15;
+            if (counter < 15)
+                block[pos >> 4] += 1ULL << shift;
+        }
+    }
+}
+
+int bloom_remove(struct BlockedBloom* filter, int key) {
+    if (!filter->counting)
+        return 0;
+    uint32_t h1, h2;
+    uint64_t* block = bloom_block(filter, key, &h1, &h2);
+    for (int i = 0; i < filter->k; i++) {
+        uint32_t pos = (h1 + i * h2) & (BLOOM_BLOCK_COUNTERS - 1);
+        int shift = (pos & 15) * 4;
+        uint64_t counter = (block[pos >> 4] >> shift) & 15;
+        if (counter > 0 && counter < 15)
+            block[pos >> 4] -= 1ULL << shift;
+    }
+    return 1;
+}
+
+int bloom_may_contain(struct BlockedBloom* filter, int key) {
+    uint32_t h1, h2;
+    uint64_t* block = bloom_block(filter, key, &h1, &h2);
+    for (int i = 0; i < filter->k; i++) {
+        uint32_t pos = h1 + i * h2;
+        if (!filter->counting) {
+            pos &= BLOOM_BLOCK_BITS - 1;
+            if (!(block[pos >> 6] & (1ULL << (pos & 63))))
+                return 0;
+        } else {
+            pos &= BLOOM_BLOCK_COUNTERS - 1;
+            if (!((block[pos >> 4] >> ((pos & 15) * 4)) & 15))
+                return 0;
+        }
+    }
+    return 1;
+}
+
+// ---------- Фильтр перед деревом ----------
+// Отрицательный ответ фильтра точен, поэтому отсутствующий ключ
+// возвращается без обращения к дереву. Вставка добавляет ключ в фильтр
+// только если его не было - иначе счетчики разошлись бы с деревом.
+
+struct AVLNode* avl_insert_filtered(struct BlockedBloom* filter, struct AVLNode* root,
+                                    int key, int* rotations) {
+    if (bloom_may_contain(filter, key) && avl_search(root, key) != NULL)
+        return root;
+    bloom_add(filter, key);
+    return avl_insert(root, key, rotations);
+}
+
+struct AVLNode* avl_delete_filtered(struct BlockedBloom* filter, struct AVLNode* root,
+                                    int key, int* rotations) {
+    if (!bloom_may_contain(filter, key) || avl_search(root, key) == NULL)
+        return root;
+    bloom_remove(filter, key);
+    return avl_delete(root, key, rotations);
+}
+
+struct AVLNode* avl_search_filtered(struct BlockedBloom* filter, struct AVLNode* root, int key) {
+    if (!bloom_may_contain(filter, key))
+        return NULL;
+    return avl_search(root, key);
+}
+
+struct RBNode* rbt_insert_filtered(struct BlockedBloom* filter, struct RBNode* root,
+                                   int key, int* rotations, int* recolorings) {
+    if (bloom_may_contain(filter, key) && rbt_search(root, key) != NULL)
+        return root;
+    bloom_add(filter, key);
+    return rbt_insert(root, key, rotations, recolorings);
+}
+
+struct RBNode* rbt_delete_filtered(struct BlockedBloom* filter, struct RBNode* root,
+                                   int key, int* rotations, int* recolorings) {
+    if (!bloom_may_contain(filter, key) || rbt_search(root, key) == NULL)
+        return root;
+    bloom_remove(filter, key);
+    return rbt_delete(root, key, rotations, recolorings);
+}
+
+struct RBNode* rbt_search_filtered(struct BlockedBloom* filter, struct RBNode* root, int key) {
+    if (!bloom_may_contain(filter, key))
+        return NULL;
+    return rbt_search(root, key);
+}
+
+// ==================== ТЕСТ 19: ФИЛЬТР БЛУМА ПЕРЕД ДЕРЕВОМ ====================
+
+void test_bloom_filter() {
+    printf("=== ТЕСТ 19: Фильтр Блума перед деревом для отсутствующих ключей ===\n\n");
+
+    const int N = 1000000;
+    const int NUM_LOOKUPS = 1000000;
+    const int BITS_PER_KEY = 10;
+    const int COUNTING_BITS_PER_KEY = 32;
+    const int MISS_PERCENTS[] = {0, 25, 50, 75, 90, 99};
+    const int NUM_RATIOS = sizeof(MISS_PERCENTS) / sizeof(MISS_PERCENTS[0]);
+
+    srand(time(NULL));
+
+    // Уникальные четные ключи в случайном порядке, промахи - нечетные
+    int* keys = (int*)malloc(N * sizeof(int));
+    for (int i = 0; i < N; i++)
+        keys[i] = i * 2;
+    for (int i = N - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        int tmp = keys[i];
+        keys[i] = keys[j];
+        keys[j] = tmp;
+    }
+
+    struct BlockedBloom* filter = bloom_create(N, BITS_PER_KEY, 0);
+    struct BlockedBloom* counting = bloom_create(N, COUNTING_BITS_PER_KEY, 1);
+    struct AVLNode* avl_root = NULL;
+    struct RBNode* rbt_root = NULL;
+    struct AVLNode* avl_counted = NULL;
+    int rotations = 0;
+    int recolorings = 0;
+
+    clock_t start = clock();
+    for (int i = 0; i < N; i++)
+        avl_root = avl_insert(avl_root, keys[i], &rotations);
+    double avl_insert_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / N;
+
+    // Тот же набор в RBT; фильтр общий, т.к. ключи одни и те же
+    start = clock();
+    for (int i = 0; i < N; i++)
+        rbt_root = rbt_insert_filtered(filter, rbt_root, keys[i], &rotations, &recolorings);
+    double rbt_insert_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / N;
+
+    for (int i = 0; i < N; i++)
+        avl_counted = avl_insert_filtered(counting, avl_counted, keys[i], &rotations);
+
+    printf("Вставка %d ключей: avl_insert %.1f ns, rbt_insert + фильтр %.1f ns\n\n",
+           N, avl_insert_ns, rbt_insert_ns);
+
+    int* queries = (int*)malloc(NUM_LOOKUPS * sizeof(int));
+
+    printf("Промахи %% | AVL (ns)   | AVL+Блум   | RBT (ns)   | RBT+Блум   | Ложных %%   | Проверка\n");
+    printf("----------|------------|------------|------------|------------|------------|---------\n");
+
+    for (int r = 0; r < NUM_RATIOS; r++) {
+        int misses = 0;
+        for (int i = 0; i < NUM_LOOKUPS; i++) {
+            if (rand() % 100 < MISS_PERCENTS[r]) {
+                queries[i] = (rand() % N) * 2 + 1;
+                misses++;
+            } else {
+                queries[i] = keys[rand() % N];
+            }
+        }
+
+        start = clock();
+        int avl_found = 0;
+        for (int i = 0; i < NUM_LOOKUPS; i++)
+            avl_found += avl_search(avl_root, queries[i]) != NULL;
+        double avl_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / NUM_LOOKUPS;
+
+        start = clock();
+        int avl_filtered_found = 0;
+        for (int i = 0; i < NUM_LOOKUPS; i++)
+            avl_filtered_found += avl_search_filtered(filter, avl_root, queries[i]) != NULL;
+        double avl_filtered_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / NUM_LOOKUPS;
+
+        start = clock();
+        int rbt_found = 0;
+        for (int i = 0; i < NUM_LOOKUPS; i++)
+            rbt_found += rbt_search(rbt_root, queries[i]) != NULL;
+        double rbt_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / NUM_LOOKUPS;
+
+        start = clock();
+        int rbt_filtered_found = 0;
+        for (int i = 0; i < NUM_LOOKUPS; i++)
+            rbt_filtered_found += rbt_search_filtered(filter, rbt_root, queries[i]) != NULL;
+        double rbt_filtered_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / NUM_LOOKUPS;
+
+        int false_positives = 0;
+        for (int i = 0; i < NUM_LOOKUPS; i++)
+            if ((queries[i] & 1) && bloom_may_contain(filter, queries[i]))
+                false_positives++;
+
+        printf("%-9d | %-10.1f | %-10.1f | %-10.1f | %-10.1f | %-10.2f | %s\n",
+               MISS_PERCENTS[r], avl_ns, avl_filtered_ns, rbt_ns, rbt_filtered_ns,
+               misses > 0 ? 100.0 * false_positives / misses : 0.0,
+               avl_found == avl_filtered_found && rbt_found == rbt_filtered_found &&
+               avl_found == rbt_found ? "OK" : "ОШИБКА");
+    }
+
+    // Память и удаление
+    int probes = 0;
+    int counting_fp = 0;
+    for (int i = 0; i < NUM_LOOKUPS; i++) {
+        int miss = (rand() % N) * 2 + 1;
+        counting_fp += bloom_may_contain(counting, miss);
+        probes++;
+    }
+
+    printf("\nФильтр                    | Бит/ключ | k  | Ложных %%\n");
+    printf("--------------------------|----------|----|---------\n");
+    printf("блочный (биты)            | %-8.1f | %-2d | см. выше\n",
+           (double)bloom_memory_bytes(filter) * 8 / N, filter->k);
+    printf("блочный счетный (4 бита)  | %-8.1f | %-2d | %.2f\n",
+           (double)bloom_memory_bytes(counting) * 8 / N, counting->k,
+           100.0 * counting_fp / probes);
+    printf("Для сравнения: узел AVL %d байт = %d бит на ключ\n",
+           (int)sizeof(struct AVLNode), (int)sizeof(struct AVLNode) * 8);
+
+    // Удаляем половину ключей: счетный фильтр их забывает, битовый - нет
+    for (int i = 0; i < N / 2; i++) {
+        avl_counted = avl_delete_filtered(counting, avl_counted, keys[i], &rotations);
+        rbt_root = rbt_delete_filtered(filter, rbt_root, keys[i], &rotations, &recolorings);
+    }
+    int counting_stale = 0;
+    int bits_stale = 0;
+    int lost = 0;
+    for (int i = 0; i < N / 2; i++) {
+        lost += avl_search(avl_counted, keys[i]) != NULL || rbt_search(rbt_root, keys[i]) != NULL;
+        counting_stale += bloom_may_contain(counting, keys[i]);
+        bits_stale += bloom_may_contain(filter, keys[i]);
+    }
+    for (int i = N / 2; i < N; i++) {
+        if (avl_search_filtered(counting, avl_counted, keys[i]) == NULL ||
+            rbt_search_filtered(filter, rbt_root, keys[i]) == NULL)
+            lost++;
+    }
+
+    printf("\nПосле удаления %d ключей фильтр пропускает к дереву удаленные:\n", N / 2);
+    printf("  счетный: %.2f%%, битовый: %.2f%% (нужна перестройка)\n",
+           100.0 * counting_stale / (N / 2), 100.0 * bits_stale / (N / 2));
+    printf("Проверка после удаления: %s\n",
+           lost == 0 && avl_is_valid(avl_counted) && rbt_is_valid(rbt_root) &&
+           count_avl_nodes(avl_counted) == count_rbt_nodes(rbt_root) ? "OK" : "ОШИБКА");
+
+    free(keys);
+    free(queries);
+    bloom_free(filter);
+    bloom_free(counting);
+    free_avl_tree(avl_root);
+    free_avl_tree(avl_counted);
+    free_rbt_tree(rbt_root);
+
+    printf("\nВЫВОД: при большой доле промахов фильтр отвечает за один промах кеша\n");
+    printf("       вместо спуска по дереву; для удалений нужен счетный вариант\n\n");
+}
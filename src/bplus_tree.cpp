@@ -0,0 +1,477 @@
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define NODE_SEARCH_X86 1
+#endif
+
+#include "methods.h"
+
+// ========== ПОИСК КЛЮЧА ВНУТРИ УЗЛА ==========
+// Все ядра возвращают ранг ключа: число ключей узла, меньших key.
+// SIMD-ядра сравнивают весь узел целиком (capacity ключей), поэтому
+// хвост узла после count должен быть заполнен INT_MAX.
+
+int node_search_scalar(const int* keys, int count, int capacity, int key) {
+    (void)capacity;
+    // Обычный бинарный поиск по занятой части узла
+    int lo = 0;
+    int hi = count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (keys[mid] < key)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+#ifdef NODE_SEARCH_X86
+
+static_assert(BTREE_NODE_KEYS % 8 == 0 && BTREE_NODE_KEYS >= 8, "BTREE_NODE_KEYS: кратно 8");
+
+// Узел размера BTREE_NODE_KEYS (по умолчанию у B+ дерева) - число итераций
+// известно при сборке, цикл разворачивается целиком, без счетчика и ветвления
+template <int CAPACITY>
+static inline int node_search_sse_fixed(const int* keys, int key) {
+    __m128i needle = _mm_set1_epi32(key);
+    int rank = 0;
+    for (int i = 0; i < CAPACITY; i += 4) {
+        __m128i block = _mm_load_si128((const __m128i*)(keys + i));
+        __m128i less = _mm_cmpgt_epi32(needle, block);
+        rank += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(less)));
+    }
+    return rank;
+}
+
+template <int CAPACITY>
+__attribute__((target("avx2")))
+static inline int node_search_avx2_fixed(const int* keys, int key) {
+    __m256i needle = _mm256_set1_epi32(key);
+    int rank = 0;
+    for (int i = 0; i < CAPACITY; i += 8) {
+        __m256i block = _mm256_load_si256((const __m256i*)(keys + i));
+        __m256i less = _mm256_cmpgt_epi32(needle, block);
+        rank += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(less)));
+    }
+    return rank;
+}
+
+int node_search_sse(const int* keys, int count, int capacity, int key) {
+    (void)count;
+    if (capacity == BTREE_NODE_KEYS)
+        return node_search_sse_fixed<BTREE_NODE_KEYS>(keys, key);
+    __m128i needle = _mm_set1_epi32(key);
+    int rank = 0;
+    for (int i = 0; i < capacity; i += 4) {
+        __m128i block = _mm_load_si128((const __m128i*)(keys + i));
+        __m128i less = _mm_cmpgt_epi32(needle, block);
+        rank += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(less)));
+    }
+    return rank;
+}
+
+__attribute__((target("avx2")))
+int node_search_avx2(const int* keys, int count, int capacity, int key) {
+    (void)count;
+    if (capacity == BTREE_NODE_KEYS)
+        return node_search_avx2_fixed<BTREE_NODE_KEYS>(keys, key);
+    __m256i needle = _mm256_set1_epi32(key);
+    int rank = 0;
+    for (int i = 0; i < capacity; i += 8) {
+        __m256i block = _mm256_load_si256((const __m256i*)(keys + i));
+        __m256i less = _mm256_cmpgt_epi32(needle, block);
+        rank += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(less)));
+    }
+    return rank;
+}
+
+#else
+
+// Без x86 SIMD векторные ядра сводятся к скалярному
+int node_search_sse(const int* keys, int count, int capacity, int key) {
+    return node_search_scalar(keys, count, capacity, key);
+}
+
+int node_search_avx2(const int* keys, int count, int capacity, int key) {
+    return node_search_scalar(keys, count, capacity, key);
+}
+
+#endif
+
+int node_search_has_sse() {
+#ifdef NODE_SEARCH_X86
+    return __builtin_cpu_supports("sse2");
+#else
+    return 0;
+#endif
+}
+
+int node_search_has_avx2() {
+#ifdef NODE_SEARCH_X86
+    return __builtin_cpu_supports("avx2");
+#else
+    return 0;
+#endif
+}
+
+node_search_fn node_search_select() {
+    if (node_search_has_avx2())
+        return node_search_avx2;
+    if (node_search_has_sse())
+        return node_search_sse;
+    return node_search_scalar;
+}
+
+// ========== B+ ДЕРЕВО В ПАМЯТИ ==========
+// Разделитель keys[i] внутреннего узла - максимальный ключ поддерева
+// children[i], поэтому и в листьях, и во внутренних узлах нужен один и
+// тот же ранг (число ключей < key).
+
+#define BPLUS_MAX_FANOUT 256
+#define BPLUS_ALIGN 64
+
+struct BPlusNode {
+    int count;   // ключей в листе / разделителей во внутреннем узле
+    int is_leaf;
+    struct BPlusNode* next;       // следующий лист (для диапазонов)
+    int* keys;                    // fanout ключей, выровнено на 64 байта
+    struct BPlusNode** children;  // fanout + 1 потомков (только внутренние)
+};
+
+static struct BPlusNode* bplus_create_node(struct BPlusTree* tree, int is_leaf) {
+    // Узел, ключи и потомки - одно выделение памяти
+    size_t header = (sizeof(struct BPlusNode) + BPLUS_ALIGN - 1) / BPLUS_ALIGN * BPLUS_ALIGN;
+    size_t keys_bytes = (tree->fanout * sizeof(int) + BPLUS_ALIGN - 1) / BPLUS_ALIGN * BPLUS_ALIGN;
+    size_t children_bytes = is_leaf ? 0 : (tree->fanout + 1) * sizeof(struct BPlusNode*);
+    size_t total = (header + keys_bytes + children_bytes + BPLUS_ALIGN - 1) / BPLUS_ALIGN * BPLUS_ALIGN;
+
+    char* memory = (char*)aligned_alloc(BPLUS_ALIGN, total);
+    struct BPlusNode* node = (struct BPlusNode*)memory;
+    node->count = 0;
+    node->is_leaf = is_leaf;
+    node->next = NULL;
+    node->keys = (int*)(memory + header);
+    node->children = is_leaf ? NULL : (struct BPlusNode**)(memory + header + keys_bytes);
+    for (int i = 0; i < tree->fanout; i++)
+        node->keys[i] = INT_MAX;
+    return node;
+}
+
+struct BPlusTree* bplus_create(int fanout, node_search_fn search) {
+    // Размер узла кратен ширине AVX2-вектора
+    fanout = (fanout + 7) / 8 * 8;
+    if (fanout < 8)
+        fanout = 8;
+    if (fanout > BPLUS_MAX_FANOUT)
+        fanout = BPLUS_MAX_FANOUT;
+
+    struct BPlusTree* tree = (struct BPlusTree*)malloc(sizeof(struct BPlusTree));
+    tree->fanout = fanout;
+    tree->search = search != NULL ? search : node_search_select();
+    tree->count = 0;
+    tree->height = 1;
+    tree->root = bplus_create_node(tree, 1);
+    return tree;
+}
+
+static void bplus_free_node(struct BPlusNode* node) {
+    if (!node->is_leaf)
+        for (int i = 0; i <= node->count; i++)
+            bplus_free_node(node->children[i]);
+    free(node);
+}
+
+void bplus_free(struct BPlusTree* tree) {
+    if (tree == NULL)
+        return;
+    bplus_free_node(tree->root);
+    free(tree);
+}
+
+static int bplus_rank(struct BPlusTree* tree, struct BPlusNode* node, int key) {
+    return tree->search(node->keys, node->count, tree->fanout, key);
+}
+
+static struct BPlusNode* bplus_find_leaf(struct BPlusTree* tree, int key) {
+    struct BPlusNode* node = tree->root;
+    while (!node->is_leaf) {
+        int i = bplus_rank(tree, node, key);
+        node = node->children[i];
+    }
+    return node;
+}
+
+int bplus_contains(struct BPlusTree* tree, int key) {
+    struct BPlusNode* leaf = bplus_find_leaf(tree, key);
+    int pos = bplus_rank(tree, leaf, key);
+    return pos < leaf->count && leaf->keys[pos] == key;
+}
+
+int bplus_range(struct BPlusTree* tree, int lo, int hi, int* out, int max_out) {
+    struct BPlusNode* leaf = bplus_find_leaf(tree, lo);
+    int pos = bplus_rank(tree, leaf, lo);
+    int found = 0;
+
+    while (leaf != NULL) {
+        for (; pos < leaf->count; pos++) {
+            if (leaf->keys[pos] > hi)
+                return found;
+            if (out != NULL && found < max_out)
+                out[found] = leaf->keys[pos];
+            found++;
+        }
+        leaf = leaf->next;
+        pos = 0;
+    }
+    return found;
+}
+
+// Вставка в узел с результатом разделения: 0 - ключ уже есть,
+// 1 - вставлен, 2 - вставлен и узел разделился (sep, right)
+static int bplus_insert_rec(struct BPlusTree* tree, struct BPlusNode* node, int key,
+                            int* sep, struct BPlusNode** right) {
+    int fanout = tree->fanout;
+    int pos = bplus_rank(tree, node, key);
+
+    if (node->is_leaf) {
+        if (pos < node->count && node->keys[pos] == key)
+            return 0;
+
+        if (node->count < fanout) {
+            memmove(node->keys + pos + 1, node->keys + pos, (node->count - pos) * sizeof(int));
+            node->keys[pos] = key;
+            node->count++;
+            return 1;
+        }
+
+        // Лист полон: половину ключей переносим в новый лист
+        struct BPlusNode* sibling = bplus_create_node(tree, 1);
+        int half = fanout / 2;
+        sibling->count = fanout - half;
+        memcpy(sibling->keys, node->keys + half, sibling->count * sizeof(int));
+        for (int i = half; i < fanout; i++)
+            node->keys[i] = INT_MAX;
+        node->count = half;
+        sibling->next = node->next;
+        node->next = sibling;
+
+        struct BPlusNode* target = key <= node->keys[half - 1] ? node : sibling;
+        int tpos = bplus_rank(tree, target, key);
+        memmove(target->keys + tpos + 1, target->keys + tpos, (target->count - tpos) * sizeof(int));
+        target->keys[tpos] = key;
+        target->count++;
+
+        *sep = node->keys[node->count - 1];
+        *right = sibling;
+        return 2;
+    }
+
+    int child_sep;
+    struct BPlusNode* child_right;
+    int result = bplus_insert_rec(tree, node->children[pos], key, &child_sep, &child_right);
+    if (result != 2)
+        return result;
+
+    if (node->count < fanout) {
+        memmove(node->keys + pos + 1, node->keys + pos, (node->count - pos) * sizeof(int));
+        memmove(node->children + pos + 2, node->children + pos + 1,
+                (node->count - pos) * sizeof(struct BPlusNode*));
+        node->keys[pos] = child_sep;
+        node->children[pos + 1] = child_right;
+        node->count++;
+        return 1;
+    }
+
+    // Внутренний узел полон: собираем fanout + 1 разделителей и делим
+    int keys[BPLUS_MAX_FANOUT + 1];
+    struct BPlusNode* children[BPLUS_MAX_FANOUT + 2];
+    memcpy(keys, node->keys, pos * sizeof(int));
+    keys[pos] = child_sep;
+    memcpy(keys + pos + 1, node->keys + pos, (fanout - pos) * sizeof(int));
+    memcpy(children, node->children, (pos + 1) * sizeof(struct BPlusNode*));
+    children[pos + 1] = child_right;
+    memcpy(children + pos + 2, node->children + pos + 1, (fanout - pos) * sizeof(struct BPlusNode*));
+
+    int total = fanout + 1;
+    int mid = total / 2;
+    struct BPlusNode* sibling = bplus_create_node(tree, 0);
+
+    node->count = mid;
+    memcpy(node->keys, keys, mid * sizeof(int));
+    memcpy(node->children, children, (mid + 1) * sizeof(struct BPlusNode*));
+    for (int i = mid; i < fanout; i++)
+        node->keys[i] = INT_MAX;
+
+    sibling->count = total - mid - 1;
+    memcpy(sibling->keys, keys + mid + 1, sibling->count * sizeof(int));
+    memcpy(sibling->children, children + mid + 1, (sibling->count + 1) * sizeof(struct BPlusNode*));
+
+    *sep = keys[mid];
+    *right = sibling;
+    return 2;
+}
+
+int bplus_insert(struct BPlusTree* tree, int key) {
+    int sep;
+    struct BPlusNode* right;
+    int result = bplus_insert_rec(tree, tree->root, key, &sep, &right);
+    if (result == 0)
+        return 0;
+
+    if (result == 2) {
+        struct BPlusNode* root = bplus_create_node(tree, 0);
+        root->count = 1;
+        root->keys[0] = sep;
+        root->children[0] = tree->root;
+        root->children[1] = right;
+        tree->root = root;
+        tree->height++;
+    }
+    tree->count++;
+    return 1;
+}
+
+// ==================== ТЕСТ 12: SIMD-ПОИСК ВНУТРИ УЗЛОВ ====================
+
+static double node_kernel_ns(node_search_fn search, const int* nodes, const int* counts,
+                             int fanout, const int* node_ids, const int* queries, int count,
+                             long long* checksum) {
+    clock_t start = clock();
+    long long sum = 0;
+    for (int i = 0; i < count; i++) {
+        const int* keys = nodes + (size_t)node_ids[i] * fanout;
+        sum += search(keys, counts[node_ids[i]], fanout, queries[i]);
+    }
+    *checksum = sum;
+    return (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / count;
+}
+
+void test_node_search() {
+    printf("=== ТЕСТ 12: SIMD-поиск ключа внутри узлов B-дерева/B+ дерева ===\n\n");
+
+    const int FANOUTS[] = {8, 16, 32, 64};
+    const int NUM_FANOUTS = sizeof(FANOUTS) / sizeof(FANOUTS[0]);
+    const int NUM_NODES = 1 << 14;
+    const int NUM_QUERIES = 4000000;
+    const int N = 1000000;
+
+    int has_sse = node_search_has_sse();
+    int has_avx2 = node_search_has_avx2();
+    printf("Поддержка: SSE2=%s, AVX2=%s; BTREE_NODE_KEYS=%d (размер узла по умолчанию,\n"
+           "ядра SSE/AVX2 для него развернуты при сборке)\n\n",
+           has_sse ? "да" : "нет", has_avx2 ? "да" : "нет", BTREE_NODE_KEYS);
+
+    srand(time(NULL));
+
+    // Часть 1: сами ядра на наборе отдельных узлов
+    printf("Поиск внутри узла (%d узлов, %d запросов), ns/поиск:\n", NUM_NODES, NUM_QUERIES);
+    printf("%-7s | %-14s | %-10s | %-10s | %s\n", "Ключей", "Скаляр (бин.)", "SSE", "AVX2", "Проверка");
+    printf("--------|----------------|------------|------------|---------\n");
+
+    int* node_ids = (int*)malloc(NUM_QUERIES * sizeof(int));
+    int* queries = (int*)malloc(NUM_QUERIES * sizeof(int));
+    int* counts = (int*)malloc(NUM_NODES * sizeof(int));
+
+    for (int f = 0; f < NUM_FANOUTS; f++) {
+        int fanout = FANOUTS[f];
+        int* nodes = (int*)aligned_alloc(64, (size_t)NUM_NODES * fanout * sizeof(int));
+        for (int n = 0; n < NUM_NODES; n++) {
+            int* keys = nodes + (size_t)n * fanout;
+            // Узлы заполнены на 50..100%, как в B-дереве
+            counts[n] = fanout / 2 + rand() % (fanout / 2 + 1);
+            int key = rand() % 16;
+            for (int i = 0; i < counts[n]; i++) {
+                keys[i] = key;
+                key += 1 + rand() % 16;
+            }
+            for (int i = counts[n]; i < fanout; i++)
+                keys[i] = INT_MAX;
+        }
+        for (int i = 0; i < NUM_QUERIES; i++) {
+            node_ids[i] = rand() % NUM_NODES;
+            queries[i] = rand() % (fanout * 16);
+        }
+
+        long long scalar_sum = 0, sse_sum = 0, avx2_sum = 0;
+        double scalar_ns = node_kernel_ns(node_search_scalar, nodes, counts, fanout,
+                                          node_ids, queries, NUM_QUERIES, &scalar_sum);
+        double sse_ns = has_sse ? node_kernel_ns(node_search_sse, nodes, counts, fanout,
+                                                 node_ids, queries, NUM_QUERIES, &sse_sum) : 0.0;
+        double avx2_ns = has_avx2 ? node_kernel_ns(node_search_avx2, nodes, counts, fanout,
+                                                   node_ids, queries, NUM_QUERIES, &avx2_sum) : 0.0;
+        int ok = (!has_sse || sse_sum == scalar_sum) && (!has_avx2 || avx2_sum == scalar_sum);
+
+        printf("%-7d | %-14.2f | %-10.2f | %-10.2f | %s\n",
+               fanout, scalar_ns, sse_ns, avx2_ns, ok ? "OK" : "ОШИБКА");
+        free(nodes);
+    }
+
+    // Часть 2: целое B+ дерево с разными размерами узлов и ядрами
+    printf("\nB+ дерево, %d случайных ключей, поиск ns/операция (AVL для сравнения):\n", N);
+
+    int* keys = (int*)malloc(N * sizeof(int));
+    for (int i = 0; i < N; i++)
+        keys[i] = rand() % (N * 2);
+    for (int i = 0; i < NUM_QUERIES; i++)
+        queries[i] = rand() % (N * 2);
+
+    struct AVLNode* avl_root = NULL;
+    int rotations = 0;
+    for (int i = 0; i < N; i++)
+        avl_root = avl_insert(avl_root, keys[i], &rotations);
+    clock_t start = clock();
+    int avl_found = 0;
+    for (int i = 0; i < NUM_QUERIES; i++)
+        avl_found += avl_search(avl_root, queries[i]) != NULL;
+    double avl_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / NUM_QUERIES;
+    printf("AVL avl_search: %.1f ns\n\n", avl_ns);
+
+    printf("%-7s | %-6s | %-12s | %-14s | %-10s | %-10s | %s\n",
+           "Ключей", "Высота", "Вставка (ms)", "Скаляр (бин.)", "SSE", "AVX2", "Проверка");
+    printf("--------|--------|--------------|----------------|------------|------------|---------\n");
+
+    node_search_fn kernels[] = {node_search_scalar, node_search_sse, node_search_avx2};
+    int kernel_ok[] = {1, has_sse, has_avx2};
+
+    for (int f = 0; f < NUM_FANOUTS; f++) {
+        struct BPlusTree* tree = bplus_create(FANOUTS[f], NULL);
+        start = clock();
+        for (int i = 0; i < N; i++)
+            bplus_insert(tree, keys[i]);
+        double insert_ms = (double)(clock() - start) * 1000 / CLOCKS_PER_SEC;
+
+        double kernel_ns[3] = {0, 0, 0};
+        int ok = tree->count == count_avl_nodes(avl_root);
+        for (int k = 0; k < 3; k++) {
+            if (!kernel_ok[k])
+                continue;
+            tree->search = kernels[k];
+            start = clock();
+            int found = 0;
+            for (int i = 0; i < NUM_QUERIES; i++)
+                found += bplus_contains(tree, queries[i]);
+            kernel_ns[k] = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / NUM_QUERIES;
+            ok = ok && found == avl_found;
+        }
+
+        printf("%-7d | %-6d | %-12.3f | %-14.1f | %-10.1f | %-10.1f | %s\n",
+               FANOUTS[f], tree->height, insert_ms, kernel_ns[0], kernel_ns[1], kernel_ns[2],
+               ok ? "OK" : "ОШИБКА");
+        bplus_free(tree);
+    }
+
+    free_avl_tree(avl_root);
+    free(keys);
+    free(node_ids);
+    free(queries);
+    free(counts);
+
+    printf("\nВЫВОД: SIMD сравнивает весь узел за несколько инструкций без ветвлений;\n");
+    printf("       для узлов 16-32 ключа это быстрее бинарного поиска с промахами предсказания\n\n");
+}
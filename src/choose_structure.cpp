@@ -1,6 +1,12 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+#include "methods.h"
+
+// Максимальное число кандидатов в детальном анализе
+#define MAX_CANDIDATES 16
+
 // Требования системы (что нужно нашей программе)
 struct SystemRequirements {
     const char* system_name; // Название системы
@@ -109,16 +115,20 @@ void analyze_smart_home(struct StructureCandidate candidates[], int count) {
 
     printf("РАСЧЕТ БАЛЛОВ:\n");
 
-    // Рассчитываем баллы для каждой структуры
-    int scores[5] = {0};
-    const char* names[5];
+    // Рассчитываем баллы для каждой структуры; вклад каждого требования
+    // сохраняем, чтобы объяснение строилось по баллам самого кандидата
+    const char* criteria[4] = {"поиск", "вставки", "диапазоны", "память"};
+    int contributions[MAX_CANDIDATES][4];
+    int scores[MAX_CANDIDATES] = {0};
+    int order[MAX_CANDIDATES];
 
     for (int i = 0; i < count; i++) {
-        names[i] = candidates[i].name;
-        scores[i] = candidates[i].search_speed * smart_home.search_frequency +
-                    candidates[i].insert_speed * smart_home.update_frequency +
-                    candidates[i].range_query_speed * smart_home.range_queries_needed +
-                    candidates[i].memory_efficiency * smart_home.memory_limited;
+        order[i] = i;
+        contributions[i][0] = candidates[i].search_speed * smart_home.search_frequency;
+        contributions[i][1] = candidates[i].insert_speed * smart_home.update_frequency;
+        contributions[i][2] = candidates[i].range_query_speed * smart_home.range_queries_needed;
+        contributions[i][3] = candidates[i].memory_efficiency * smart_home.memory_limited;
+        scores[i] = contributions[i][0] + contributions[i][1] + contributions[i][2] + contributions[i][3];
 
         // Бонусы для memory-систем
         if (strstr(candidates[i].name, "AVL") != NULL) scores[i] += 10;
@@ -137,17 +147,13 @@ void analyze_smart_home(struct StructureCandidate candidates[], int count) {
         printf(" = %d\n", scores[i]);
     }
 
-    // Сортируем результаты
+    // Сортируем индексы кандидатов по баллам
     for (int i = 0; i < count - 1; i++) {
         for (int j = i + 1; j < count; j++) {
-            if (scores[j] > scores[i]) {
-                int temp_score = scores[i];
-                scores[i] = scores[j];
-                scores[j] = temp_score;
-
-                const char* temp_name = names[i];
-                names[i] = names[j];
-                names[j] = temp_name;
+            if (scores[order[j]] > scores[order[i]]) {
+                int temp = order[i];
+                order[i] = order[j];
+                order[j] = temp;
             }
         }
     }
@@ -156,22 +162,97 @@ void analyze_smart_home(struct StructureCandidate candidates[], int count) {
     printf("Система           | 1 место      | 2 место        | 3 место\n");
     printf("------------------|--------------|----------------|-------------\n");
     printf("Умный дом         | %-12s | %-14s | %s\n",
-           names[0], names[1], names[2]);
+           count > 0 ? candidates[order[0]].name : "-",
+           count > 1 ? candidates[order[1]].name : "-",
+           count > 2 ? candidates[order[2]].name : "-");
 
     printf("\nОБЪЯСНЕНИЕ ВЫБОРА:\n");
-    printf("• %s - лучшая эффективность памяти + оптимальна для частых вставок\n", names[0]);
-    printf("• %s - сбалансированная производительность для смешанных нагрузок\n", names[1]);
-    printf("• %s - хорош для частых обновлений, но менее эффективен по памяти\n", names[2]);
-    printf("• %s - не подходит из-за слишком частых вставок (90%% операций)\n", names[3]);
-    printf("• %s - учебная структура, не оптимальна для production-систем\n", names[4]);
+    for (int k = 0; k < count; k++) {
+        int i = order[k];
+        int strongest = 0;
+        int weakest = 0;
+        for (int c = 1; c < 4; c++) {
+            if (contributions[i][c] > contributions[i][strongest]) strongest = c;
+            if (contributions[i][c] < contributions[i][weakest]) weakest = c;
+        }
+        printf("• %s (%d) - больше всего баллов: %s (%d), меньше всего: %s (%d)\n",
+               candidates[i].name, scores[i], criteria[strongest], contributions[i][strongest],
+               criteria[weakest], contributions[i][weakest]);
+        printf("  подходит: %s; не подходит: %s\n",
+               candidates[i].best_use_case, candidates[i].worst_use_case);
+    }
 
     printf("\nРЕКОМЕНДАЦИИ ДЛЯ УМНОГО ДОМА:\n");
-    printf("1. %s - для хранения показаний сенсоров и быстрого доступа\n", names[0]);
-    printf("2. %s - для управления устройствами и их состоянием\n", names[1]);
-    printf("3. %s - для кеширования часто изменяемых данных\n", names[2]);
+    for (int k = 0; k < count && k < 3; k++)
+        printf("%d. %s - %s\n", k + 1, candidates[order[k]].name, candidates[order[k]].best_use_case);
+}
+
+// Доля операций -> шкала 1-10 требований системы
+static int trace_share_to_scale(long long part, long long total) {
+    int scale = total > 0 ? (int)(10.0 * part / total + 0.5) : 0;
+    return scale < 1 ? 1 : (scale > 10 ? 10 : scale);
 }
 
-int main() {
+// Требования по журналу операций: оценка баллами и замер на выборке
+static int choose_from_trace(const char* path, long long max_sample,
+                             struct StructureCandidate candidates[], int count) {
+    struct TraceProfile profile;
+    struct TraceSample* sample = NULL;
+    if (trace_profile_file(path, max_sample, &profile, &sample) != 0) {
+        fprintf(stderr, "Не удалось открыть журнал %s\n", path);
+        return 1;
+    }
+
+    double ops = profile.ops > 0 ? (double)profile.ops : 1;
+    printf("=== ПРОФИЛЬ ЖУРНАЛА: %s ===\n", path);
+    printf("Операций: %lld (ошибочных строк: %lld)\n", profile.ops, profile.bad_lines);
+    printf("Поиск: %.1f%%, вставка: %.1f%%, удаление: %.1f%%, диапазон: %.1f%% (ширина %.0f)\n",
+           100.0 * profile.counts[TRACE_SEARCH] / ops, 100.0 * profile.counts[TRACE_INSERT] / ops,
+           100.0 * profile.counts[TRACE_DELETE] / ops, 100.0 * profile.counts[TRACE_RANGE] / ops,
+           profile.avg_range_width);
+    printf("Ключи: %d..%d, различных ~%.0f, рабочий набор ~%.0f ключей\n",
+           profile.min_key, profile.max_key, profile.distinct_keys, profile.working_set_keys);
+    printf("Монотонность вставок: %.1f%%, на %d%% самых частых ключей: %.1f%% обращений\n",
+           100.0 * profile.insert_monotonic, TRACE_HOT_KEYS_PERCENT, 100.0 * profile.hot_keys_share);
+    printf("Выборка для замера: %lld операций (%.2f%% ключей)\n\n",
+           profile.sample_ops, 100.0 * profile.sample_rate);
+
+    // Память журнал не описывает - средняя оценка
+    struct SystemRequirements traced;
+    traced.system_name = "Система по журналу операций";
+    traced.search_frequency = trace_share_to_scale(profile.counts[TRACE_SEARCH], profile.ops);
+    traced.update_frequency = trace_share_to_scale(
+        profile.counts[TRACE_INSERT] + profile.counts[TRACE_DELETE], profile.ops);
+    traced.range_queries_needed = trace_share_to_scale(profile.counts[TRACE_RANGE], profile.ops);
+    traced.memory_limited = 5;
+    traced.storage_type = "memory";
+    compare_for_system(traced, candidates, count);
+
+    struct TraceReplayResult results[MAX_CANDIDATES];
+    int n = trace_replay(sample, &profile, results, MAX_CANDIDATES);
+    printf("=== ЗАМЕР НА ВЫБОРКЕ ===\n");
+    for (int i = 0; i < n; i++) {
+        if (results[i].supported)
+            printf("%s: %.1f нс/операция\n", results[i].name, results[i].ns_per_op);
+        else
+            printf("%s: не подходит (%s)\n", results[i].name, results[i].missing);
+    }
+    int winner = trace_measured_winner(results, n);
+    if (winner >= 0)
+        printf("\n🏆 ИЗМЕРЕННЫЙ ПОБЕДИТЕЛЬ: %s (%.1f нс/операция)\n",
+               results[winner].name, results[winner].ns_per_op);
+    else
+        printf("\nНи одна структура не поддерживает все операции журнала\n");
+
+    if (profile.insert_monotonic > 0.9)
+        printf("• Вставки почти монотонны: помогут вставка с правым пальцем и блоки с дельтами\n");
+    if (profile.hot_keys_share > 0.5)
+        printf("• Сильный перекос: горячие ключи держит кеш или splay-дерево\n");
+    trace_sample_free(sample);
+    return 0;
+}
+
+int main(int argc, char** argv) {
     printf("=== АРХИТЕКТУРНЫЙ БАТТЛ: Выбор структуры данных ===\n\n");
 
     // Наши кандидаты (структуры данных)
@@ -225,6 +306,46 @@ int main() {
             6,  // Средняя эффективность памяти
             "Учебные проекты, простые системы",
             "Высоконагруженные production-системы"
+        },
+        // Hash table (Swiss table, src/swiss_table.cpp)
+        {
+            "Hash table (Swiss)",
+            10, // Отличный поиск: O(1), группа из 16 слотов за одно SIMD-сравнение
+            9,  // Быстрые вставки без балансировки
+            1,  // Диапазонные запросы не поддерживаются
+            9,  // ~6 байт на ключ против 24-32 у узлов деревьев
+            "Точечные запросы: DNS-кеши, кеши сессий",
+            "Диапазонные запросы и упорядоченный обход"
+        },
+        // LSM-индекс (memtable + отсортированные прогоны, src/lsm_tree.cpp)
+        {
+            "LSM index",
+            5,  // Поиск проверяет memtable и несколько прогонов
+            10, // Вставка в маленький memtable, слияния последовательные
+            7,  // Диапазон - слияние отсортированных прогонов
+            8,  // Прогоны - плотные массивы без указателей
+            "Журналы, метрики, потоки событий с редким чтением",
+            "Нагрузки с частым точечным поиском"
+        },
+        // Адаптивное radix дерево (src/art_tree.cpp)
+        {
+            "ART",
+            10, // Поиск без сравнений ключей: байт ключа - индекс в узле
+            9,  // Вставка без балансировки, узлы растут 4 -> 16 -> 48 -> 256
+            8,  // Упорядоченный обход по байтам ключа
+            7,  // ~8 байт на плотный id, но редко заполненные узлы дороже
+            "Плотные целые id: сессии, сенсоры, счетчики",
+            "Разреженные ключи, мелкими группами по всему диапазону"
+        },
+        // Блоки с дельтами от наименьшего ключа (src/delta_index.cpp)
+        {
+            "Delta index",
+            7,  // Двоичный поиск по каталогу + SIMD-сравнение внутри блока
+            8,  // Показание за последним ключом дописывается за O(1)
+            9,  // Блок распаковывается SSE2 по 4 ключа
+            10, // 1-2 байта на метку времени против 24-32 у узлов деревьев
+            "Временные ряды: показания сенсоров, метрики с метками времени",
+            "Случайные ключи: широкие дельты и перепаковка блока при вставке"
         }
     };
 
@@ -280,6 +401,11 @@ int main() {
     int num_candidates = sizeof(candidates) / sizeof(candidates[0]);
     int num_systems = sizeof(systems) / sizeof(systems[0]);
 
+    // choose_struct --trace <журнал> [операций в выборке]: вместо ответов 1-10
+    if (argc >= 3 && strcmp(argv[1], "--trace") == 0)
+        return choose_from_trace(argv[2], argc >= 4 ? atoll(argv[3]) : 2000000,
+                                 candidates, num_candidates);
+
     // Сравниваем для каждой системы
     for (int i = 0; i < num_systems; i++) {
         compare_for_system(systems[i], candidates, num_candidates);
@@ -317,6 +443,11 @@ int main() {
     printf("• B-tree: для дисковых систем, минимизирует I/O операции\n");
     printf("• B+ tree: король баз данных и range queries\n");
     printf("• 2-3 Tree: учебная структура, редко используется на практике\n");
+    printf("• Hash table (Swiss): лучший выбор для точечных запросов без диапазонов\n");
+    printf("• LSM index: для потоков записи (логи), платит за это скоростью поиска\n");
+    printf("• ART (adaptive radix tree): быстрый поиск и диапазоны на плотных целых ключах\n");
+    printf("• Delta index: почти монотонные метки времени в 1-2 байтах на ключ\n");
+    printf("• AVL/RBT на строках (арена + префикс в узле): доменные имена без std::string\n");
 
     return 0;
 }
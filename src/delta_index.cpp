@@ -0,0 +1,648 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "methods.h"
+
+// ========== УПОРЯДОЧЕННЫЙ ИНДЕКС НА БЛОКАХ С ДЕЛЬТАМИ (FOR) ==========
+// Ключи лежат отсортированными блоками до DELTA_BLOCK_KEYS штук. Блок
+// хранит base - наименьший ключ - и дельты key - base, упакованные по bits
+// бит (frame-of-reference): метки времени одного сенсора отличаются на
+// единицы-сотни, и 128 ключей занимают 9-10 бит каждый вместо 24-32 байт
+// узла AVL/RBT.
+//
+// Упаковка "вертикальная", как в SIMD-BP128: ключ j идет в дорожку j % 4,
+// каждая дорожка - свой поток слов, и слова четырех дорожек чередуются.
+// Тогда одна SSE2-операция сдвига и маски распаковывает сразу 4 дельты,
+// при любом bits и без перестановок.
+//
+// Каталог - отсортированный массив первых ключей блоков и указателей на
+// блоки, ищется двоичным поиском. Вставка за последний ключ последнего
+// блока (поток показаний) дописывает дельту на место за O(1); вставка в
+// середину распаковывает блок, вставляет и упаковывает заново.
+
+struct DeltaBlock {
+    int base;               // наименьший ключ блока
+    unsigned short count;
+    unsigned short capacity; // 16, 32, 64 или DELTA_BLOCK_KEYS
+    unsigned char bits;     // ширина дельты, 0..32
+    // далее - rows * 4 слова uint32_t
+};
+
+struct DeltaIndex {
+    int* firsts;                 // первые ключи блоков
+    struct DeltaBlock** blocks;
+    int block_count;
+    int block_capacity;
+    long long count;
+};
+
+static uint32_t* delta_words(struct DeltaBlock* block) {
+    return (uint32_t*)(block + 1);
+}
+
+static const uint32_t* delta_words_const(const struct DeltaBlock* block) {
+    return (const uint32_t*)(block + 1);
+}
+
+// Строк по 4 слова (по слову на дорожку) для capacity дельт по bits бит
+static int delta_rows(int capacity, int bits) {
+    return (capacity / 4 * bits + 31) / 32;
+}
+
+static int delta_bits_for(uint32_t max_delta) {
+    return max_delta == 0 ? 0 : 32 - __builtin_clz(max_delta);
+}
+
+static size_t delta_block_bytes(int capacity, int bits) {
+    return sizeof(struct DeltaBlock) + (size_t)delta_rows(capacity, bits) * 4 * sizeof(uint32_t);
+}
+
+// Упаковать отсортированные keys[0..n) в новый блок
+static struct DeltaBlock* delta_encode(const int* keys, int n, int capacity) {
+    uint32_t max_delta = (uint32_t)keys[n - 1] - (uint32_t)keys[0];
+    int bits = delta_bits_for(max_delta);
+    size_t bytes = delta_block_bytes(capacity, bits);
+    struct DeltaBlock* block = (struct DeltaBlock*)calloc(1, bytes);
+    block->base = keys[0];
+    block->count = (unsigned short)n;
+    block->capacity = (unsigned short)capacity;
+    block->bits = (unsigned char)bits;
+    uint32_t* words = delta_words(block);
+    for (int j = 1; j < n; j++) {
+        uint32_t delta = (uint32_t)keys[j] - (uint32_t)keys[0];
+        int lane = j & 3;
+        int bit = (j >> 2) * bits;
+        words[(bit >> 5) * 4 + lane] |= delta << (bit & 31);
+        if ((bit & 31) + bits > 32)
+            words[((bit >> 5) + 1) * 4 + lane] |= delta >> (32 - (bit & 31));
+    }
+    return block;
+}
+
+// Распаковать все ключи блока в out (не меньше count + 3 элементов)
+static void delta_decode(const struct DeltaBlock* block, int* out) {
+    int bits = block->bits;
+    int per_lane = (block->count + 3) / 4;
+    if (bits == 0) {
+        for (int j = 0; j < block->count; j++)
+            out[j] = block->base;
+        return;
+    }
+    const uint32_t* words = delta_words_const(block);
+#if defined(__SSE2__)
+    const __m128i* rows = (const __m128i*)words;
+    __m128i mask = _mm_set1_epi32(bits == 32 ? -1 : (int)((1u << bits) - 1));
+    __m128i base = _mm_set1_epi32(block->base);
+    __m128i current = _mm_loadu_si128(rows);
+    int shift = 0;
+    for (int k = 0; k < per_lane; k++) {
+        __m128i value = _mm_srl_epi32(current, _mm_cvtsi32_si128(shift));
+        shift += bits;
+        // Дельта на стыке слов берет старшие биты из следующей строки;
+        // ровно исчерпанная строка меняется, только если дальше есть дельты
+        if (shift > 32 || (shift == 32 && k + 1 < per_lane)) {
+            shift -= 32;
+            current = _mm_loadu_si128(++rows);
+            if (shift > 0)
+                value = _mm_or_si128(value, _mm_sll_epi32(current, _mm_cvtsi32_si128(bits - shift)));
+        }
+        value = _mm_add_epi32(_mm_and_si128(value, mask), base);
+        _mm_storeu_si128((__m128i*)(out + 4 * k), value);
+    }
+#else
+    uint32_t mask = bits == 32 ? 0xFFFFFFFFu : (1u << bits) - 1;
+    for (int k = 0; k < per_lane; k++) {
+        int bit = k * bits;
+        for (int lane = 0; lane < 4; lane++) {
+            uint32_t value = words[(bit >> 5) * 4 + lane] >> (bit & 31);
+            if ((bit & 31) + bits > 32)
+                value |= words[((bit >> 5) + 1) * 4 + lane] << (32 - (bit & 31));
+            out[4 * k + lane] = (int)((value & mask) + (uint32_t)block->base);
+        }
+    }
+#endif
+}
+
+// Есть ли дельта delta в блоке: распаковка и сравнение не покидают регистров.
+// Пустые хвостовые слоты распаковываются в 0, а дельта 0 - это сам base
+static int delta_block_contains(const struct DeltaBlock* block, uint32_t delta) {
+    int bits = block->bits;
+    if (bits < 32 && (delta >> bits) != 0)
+        return 0;
+    if (bits == 0)
+        return 1;
+    int per_lane = (block->count + 3) / 4;
+    const uint32_t* words = delta_words_const(block);
+#if defined(__SSE2__)
+    const __m128i* rows = (const __m128i*)words;
+    __m128i mask = _mm_set1_epi32(bits == 32 ? -1 : (int)((1u << bits) - 1));
+    __m128i target = _mm_set1_epi32((int)delta);
+    __m128i hits = _mm_setzero_si128();
+    __m128i current = _mm_loadu_si128(rows);
+    int shift = 0;
+    for (int k = 0; k < per_lane; k++) {
+        __m128i value = _mm_srl_epi32(current, _mm_cvtsi32_si128(shift));
+        shift += bits;
+        // Дельта на стыке слов берет старшие биты из следующей строки;
+        // ровно исчерпанная строка меняется, только если дальше есть дельты
+        if (shift > 32 || (shift == 32 && k + 1 < per_lane)) {
+            shift -= 32;
+            current = _mm_loadu_si128(++rows);
+            if (shift > 0)
+                value = _mm_or_si128(value, _mm_sll_epi32(current, _mm_cvtsi32_si128(bits - shift)));
+        }
+        hits = _mm_or_si128(hits, _mm_cmpeq_epi32(_mm_and_si128(value, mask), target));
+    }
+    return _mm_movemask_epi8(hits) != 0;
+#else
+    uint32_t mask = bits == 32 ? 0xFFFFFFFFu : (1u << bits) - 1;
+    int found = 0;
+    for (int k = 0; k < per_lane; k++) {
+        int bit = k * bits;
+        for (int lane = 0; lane < 4; lane++) {
+            uint32_t value = words[(bit >> 5) * 4 + lane] >> (bit & 31);
+            if ((bit & 31) + bits > 32)
+                value |= words[((bit >> 5) + 1) * 4 + lane] << (32 - (bit & 31));
+            found |= (value & mask) == delta;
+        }
+    }
+    return found;
+#endif
+}
+
+// Последний ключ блока без распаковки всего блока
+static int delta_block_last(const struct DeltaBlock* block) {
+    int j = block->count - 1;
+    int bits = block->bits;
+    if (bits == 0)
+        return block->base;
+    const uint32_t* words = delta_words_const(block);
+    int lane = j & 3;
+    int bit = (j >> 2) * bits;
+    uint32_t value = words[(bit >> 5) * 4 + lane] >> (bit & 31);
+    if ((bit & 31) + bits > 32)
+        value |= words[((bit >> 5) + 1) * 4 + lane] << (32 - (bit & 31));
+    uint32_t mask = bits == 32 ? 0xFFFFFFFFu : (1u << bits) - 1;
+    return (int)((value & mask) + (uint32_t)block->base);
+}
+
+// Номер блока, которому принадлежит key: последний с firsts[i] <= key, иначе 0
+static int delta_find_block(const struct DeltaIndex* index, int key) {
+    int lo = 0;
+    int hi = index->block_count - 1;
+    while (lo < hi) {
+        int mid = (lo + hi + 1) / 2;
+        if (index->firsts[mid] <= key)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+    return lo;
+}
+
+static void delta_directory_insert(struct DeltaIndex* index, int at, struct DeltaBlock* block) {
+    if (index->block_count == index->block_capacity) {
+        index->block_capacity = index->block_capacity ? index->block_capacity * 2 : 16;
+        index->firsts = (int*)realloc(index->firsts, index->block_capacity * sizeof(int));
+        index->blocks = (struct DeltaBlock**)realloc(index->blocks,
+                                                     index->block_capacity * sizeof(struct DeltaBlock*));
+    }
+    int tail = index->block_count - at;
+    memmove(index->firsts + at + 1, index->firsts + at, tail * sizeof(int));
+    memmove(index->blocks + at + 1, index->blocks + at, tail * sizeof(struct DeltaBlock*));
+    index->firsts[at] = block->base;
+    index->blocks[at] = block;
+    index->block_count++;
+}
+
+static void delta_directory_remove(struct DeltaIndex* index, int at) {
+    int tail = index->block_count - at - 1;
+    memmove(index->firsts + at, index->firsts + at + 1, tail * sizeof(int));
+    memmove(index->blocks + at, index->blocks + at + 1, tail * sizeof(struct DeltaBlock*));
+    index->block_count--;
+}
+
+// Заменить блок at новой упаковкой keys[0..n)
+static void delta_replace(struct DeltaIndex* index, int at, const int* keys, int n, int capacity) {
+    free(index->blocks[at]);
+    index->blocks[at] = delta_encode(keys, n, capacity);
+    index->firsts[at] = keys[0];
+}
+
+static int delta_capacity_for(int n) {
+    int capacity = 16;
+    while (capacity < n)
+        capacity *= 2;
+    return capacity;
+}
+
+struct DeltaIndex* delta_index_create() {
+    struct DeltaIndex* index = (struct DeltaIndex*)calloc(1, sizeof(struct DeltaIndex));
+    return index;
+}
+
+void delta_index_free(struct DeltaIndex* index) {
+    for (int i = 0; i < index->block_count; i++)
+        free(index->blocks[i]);
+    free(index->firsts);
+    free(index->blocks);
+    free(index);
+}
+
+int delta_index_contains(struct DeltaIndex* index, int key) {
+    if (index->block_count == 0)
+        return 0;
+    int at = delta_find_block(index, key);
+    const struct DeltaBlock* block = index->blocks[at];
+    if (key < block->base)
+        return 0;
+    return delta_block_contains(block, (uint32_t)key - (uint32_t)block->base);
+}
+
+int delta_index_insert(struct DeltaIndex* index, int key) {
+    if (index->block_count == 0) {
+        delta_directory_insert(index, 0, delta_encode(&key, 1, 16));
+        index->count++;
+        return 1;
+    }
+    int at = delta_find_block(index, key);
+    struct DeltaBlock* block = index->blocks[at];
+    if (key >= block->base && delta_block_contains(block, (uint32_t)key - (uint32_t)block->base))
+        return 0;
+
+    // Поток показаний: ключ за последним, дельта влезает в ширину - дописать
+    int last = delta_block_last(block);
+    uint32_t delta = (uint32_t)key - (uint32_t)block->base;
+    if (key > last && block->count < block->capacity &&
+        (block->bits == 32 || (delta >> block->bits) == 0)) {
+        uint32_t* words = delta_words(block);
+        int j = block->count;
+        int bits = block->bits;
+        int lane = j & 3;
+        int bit = (j >> 2) * bits;
+        if (bits > 0) {
+            words[(bit >> 5) * 4 + lane] |= delta << (bit & 31);
+            if ((bit & 31) + bits > 32)
+                words[((bit >> 5) + 1) * 4 + lane] |= delta >> (32 - (bit & 31));
+        }
+        block->count++;
+        index->count++;
+        return 1;
+    }
+
+    // Полный последний блок и ключ за его концом - новый блок, старый остается полным
+    if (key > last && block->count == DELTA_BLOCK_KEYS && at == index->block_count - 1) {
+        delta_directory_insert(index, at + 1, delta_encode(&key, 1, 16));
+        index->count++;
+        return 1;
+    }
+
+    int keys[DELTA_BLOCK_KEYS + 4];
+    delta_decode(block, keys);
+    int n = block->count;
+    int pos = 0;
+    while (pos < n && keys[pos] < key)
+        pos++;
+    memmove(keys + pos + 1, keys + pos, (n - pos) * sizeof(int));
+    keys[pos] = key;
+    n++;
+
+    if (n <= DELTA_BLOCK_KEYS) {
+        // Емкость не меньше прежней: растущий блок не перепаковывается на каждой вставке
+        int capacity = delta_capacity_for(n);
+        if (capacity < block->capacity)
+            capacity = block->capacity;
+        delta_replace(index, at, keys, n, capacity);
+    } else {
+        // Последний блок делится неровно: дальше в него пойдут только новые показания
+        int half = at == index->block_count - 1 ? n - DELTA_BLOCK_KEYS / 8 : n / 2;
+        delta_replace(index, at, keys, half, delta_capacity_for(half));
+        delta_directory_insert(index, at + 1,
+                               delta_encode(keys + half, n - half, delta_capacity_for(n - half)));
+    }
+    index->count++;
+    return 1;
+}
+
+int delta_index_delete(struct DeltaIndex* index, int key) {
+    if (index->block_count == 0)
+        return 0;
+    int at = delta_find_block(index, key);
+    struct DeltaBlock* block = index->blocks[at];
+    if (key < block->base || !delta_block_contains(block, (uint32_t)key - (uint32_t)block->base))
+        return 0;
+
+    // Место и под соседний блок: маленькие блоки сливаются со следующим
+    int keys[2 * DELTA_BLOCK_KEYS + 4];
+    delta_decode(block, keys);
+    int n = block->count;
+    int pos = 0;
+    while (keys[pos] != key)
+        pos++;
+    memmove(keys + pos, keys + pos + 1, (n - pos - 1) * sizeof(int));
+    n--;
+    index->count--;
+
+    if (n == 0) {
+        free(block);
+        delta_directory_remove(index, at);
+        return 1;
+    }
+    if (at + 1 < index->block_count &&
+        n + index->blocks[at + 1]->count <= DELTA_BLOCK_KEYS * 3 / 4) {
+        struct DeltaBlock* next = index->blocks[at + 1];
+        delta_decode(next, keys + n);
+        n += next->count;
+        free(next);
+        delta_directory_remove(index, at + 1);
+    }
+    delta_replace(index, at, keys, n, delta_capacity_for(n));
+    return 1;
+}
+
+int delta_index_range(struct DeltaIndex* index, int lo, int hi, int* out, int max_out) {
+    if (index->block_count == 0 || lo > hi)
+        return 0;
+    int found = 0;
+    int keys[DELTA_BLOCK_KEYS + 4];
+    for (int at = delta_find_block(index, lo); at < index->block_count && found < max_out; at++) {
+        if (index->firsts[at] > hi)
+            break;
+        const struct DeltaBlock* block = index->blocks[at];
+        delta_decode(block, keys);
+        for (int j = 0; j < block->count && found < max_out; j++) {
+            if (keys[j] > hi)
+                break;
+            if (keys[j] >= lo)
+                out[found++] = keys[j];
+        }
+    }
+    return found;
+}
+
+long long delta_index_count(struct DeltaIndex* index) {
+    return index->count;
+}
+
+size_t delta_index_memory_bytes(struct DeltaIndex* index) {
+    size_t bytes = sizeof(struct DeltaIndex) +
+                   (size_t)index->block_capacity * (sizeof(int) + sizeof(struct DeltaBlock*));
+    for (int i = 0; i < index->block_count; i++)
+        bytes += delta_block_bytes(index->blocks[i]->capacity, index->blocks[i]->bits);
+    return bytes;
+}
+
+int delta_index_block_count(struct DeltaIndex* index) {
+    return index->block_count;
+}
+
+int delta_index_is_valid(struct DeltaIndex* index) {
+    long long total = 0;
+    int keys[DELTA_BLOCK_KEYS + 4];
+    for (int i = 0; i < index->block_count; i++) {
+        const struct DeltaBlock* block = index->blocks[i];
+        if (block->count == 0 || block->count > block->capacity || block->capacity > DELTA_BLOCK_KEYS)
+            return 0;
+        if (index->firsts[i] != block->base)
+            return 0;
+        delta_decode(block, keys);
+        if (keys[0] != block->base)
+            return 0;
+        for (int j = 1; j < block->count; j++)
+            if (keys[j] <= keys[j - 1])
+                return 0;
+        if (i > 0 && delta_block_last(index->blocks[i - 1]) >= block->base)
+            return 0;
+        total += block->count;
+    }
+    return total == index->count;
+}
+
+// ==================== ТЕСТ 31: ИНДЕКС ВРЕМЕННЫХ РЯДОВ НА ДЕЛЬТАХ ====================
+
+static int delta_avl_collect(struct AVLNode* node, int lo, int hi, int* out, int found, int max_out) {
+    if (node == NULL || found >= max_out)
+        return found;
+    if (node->key > lo)
+        found = delta_avl_collect(node->left, lo, hi, out, found, max_out);
+    if (node->key >= lo && node->key <= hi && found < max_out)
+        out[found++] = node->key;
+    if (node->key < hi)
+        found = delta_avl_collect(node->right, lo, hi, out, found, max_out);
+    return found;
+}
+
+static int delta_rbt_collect(struct RBNode* node, int lo, int hi, int* out, int found, int max_out) {
+    if (node == NULL || found >= max_out)
+        return found;
+    if (node->key > lo)
+        found = delta_rbt_collect(node->left, lo, hi, out, found, max_out);
+    if (node->key >= lo && node->key <= hi && found < max_out)
+        out[found++] = node->key;
+    if (node->key < hi)
+        found = delta_rbt_collect(node->right, lo, hi, out, found, max_out);
+    return found;
+}
+
+// Заголовок блока malloc в glibc - как в тестах 24 и 27
+#define DELTA_MALLOC_HEADER 16
+
+void test_delta_index() {
+    printf("=== ТЕСТ 31: Индекс временных рядов на блоках с дельтами против AVL/RBT ===\n\n");
+
+    const int N = 10000000;
+    const int RANDOM_N = 2000000;
+    const int LOOKUPS = 2000000;
+    const int RANGES = 20000;
+    const int WINDOW = 1000; // "показания за период": примерно столько ключей
+
+    srand(time(NULL));
+    int* keys = (int*)malloc(N * sizeof(int));
+    int* queries = (int*)malloc(LOOKUPS * sizeof(int));
+    int* range_lo = (int*)malloc(RANGES * sizeof(int));
+    int* out = (int*)malloc((N + 1) * sizeof(int));
+    int* remaining = (int*)malloc((N + 1) * sizeof(int)); // содержимое индекса после удалений
+
+    printf("Память: для AVL/RBT - узел + заголовок malloc (%d байт); для индекса -\n", DELTA_MALLOC_HEADER);
+    printf("блоки + заголовки malloc + каталог. Блок - до %d ключей\n\n", DELTA_BLOCK_KEYS);
+
+    const char* datasets[] = {"метки времени сенсоров", "случайные 31-битные ключи"};
+    double delta_bytes[2] = {0, 0};
+    double avl_bytes = 0;
+    double rbt_bytes = 0;
+    double lookup_ns[2][3];
+    double scan_ns[2][3];
+    double insert_ns[2][3];
+    double delete_ns[2][3];
+    int all_ok = 1;
+    for (int d = 0; d < 2; d++) {
+        int n = d == 0 ? N : RANDOM_N;
+        // Показания приходят почти по порядку: шаг 1-3, опоздание до 8
+        int now = 1000000;
+        for (int i = 0; i < n; i++) {
+            if (d == 0) {
+                now += 1 + rand() % 3;
+                keys[i] = now - rand() % 8;
+            } else {
+                keys[i] = rand();
+            }
+        }
+        int span_lo = d == 0 ? 1000000 : 0;
+        int span = d == 0 ? now - 1000000 : 0x7fffffff;
+        for (int i = 0; i < LOOKUPS; i++)
+            queries[i] = i % 2 == 0 ? keys[rand() % n] : span_lo + (int)(((long long)rand() << 15 ^ rand()) % span);
+        // Окно шириной ~WINDOW ключей: по плотности ключей в диапазоне
+        long long width = (long long)span * WINDOW / n;
+        for (int i = 0; i < RANGES; i++)
+            range_lo[i] = span_lo + (int)(((long long)rand() << 15 ^ rand()) % (span - width));
+
+        printf("Данные: %s, вставок %d\n", datasets[d], n);
+        printf("Структура      | Вставка ns | Поиск ns | Скан окна, ns/ключ | Удаление ns | Байт/ключ\n");
+        printf("---------------|------------|----------|--------------------|-------------|----------\n");
+
+        long long expected_found = -1;
+        long long expected_scanned = -1;
+        int remaining_count = 0;
+        for (int s = 0; s < 3; s++) {
+            struct DeltaIndex* index = s == 0 ? delta_index_create() : NULL;
+            struct AVLNode* avl = NULL;
+            struct RBNode* rbt = NULL;
+            int rotations = 0;
+            int recolorings = 0;
+
+            clock_t start = clock();
+            for (int i = 0; i < n; i++) {
+                if (s == 0)
+                    delta_index_insert(index, keys[i]);
+                else if (s == 1)
+                    avl = avl_insert(avl, keys[i], &rotations);
+                else
+                    rbt = rbt_insert(rbt, keys[i], &rotations, &recolorings);
+            }
+            insert_ns[d][s] = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / n;
+
+            long long unique;
+            double bytes;
+            if (s == 0) {
+                unique = delta_index_count(index);
+                bytes = delta_index_memory_bytes(index) +
+                        (double)delta_index_block_count(index) * DELTA_MALLOC_HEADER;
+            } else if (s == 1) {
+                unique = count_avl_nodes(avl);
+                bytes = (double)unique * (sizeof(struct AVLNode) + DELTA_MALLOC_HEADER);
+            } else {
+                unique = count_rbt_nodes(rbt);
+                bytes = (double)unique * (sizeof(struct RBNode) + DELTA_MALLOC_HEADER);
+            }
+            double per_key = bytes / unique;
+            if (s == 0)
+                delta_bytes[d] = per_key;
+            else if (s == 1)
+                avl_bytes = per_key;
+            else
+                rbt_bytes = per_key;
+
+            long long found = 0;
+            start = clock();
+            for (int i = 0; i < LOOKUPS; i++) {
+                if (s == 0)
+                    found += delta_index_contains(index, queries[i]);
+                else if (s == 1)
+                    found += avl_search(avl, queries[i]) != NULL;
+                else
+                    found += rbt_search(rbt, queries[i]) != NULL;
+            }
+            lookup_ns[d][s] = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / LOOKUPS;
+
+            long long scanned = 0;
+            start = clock();
+            for (int i = 0; i < RANGES; i++) {
+                int lo = range_lo[i];
+                int hi = (int)(lo + width);
+                if (s == 0)
+                    scanned += delta_index_range(index, lo, hi, out, n);
+                else if (s == 1)
+                    scanned += delta_avl_collect(avl, lo, hi, out, 0, n);
+                else
+                    scanned += delta_rbt_collect(rbt, lo, hi, out, 0, n);
+            }
+            scan_ns[d][s] = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / (scanned > 0 ? scanned : 1);
+
+            // Удаление по сроку хранения: старейшая половина показаний
+            int deletes = n / 2;
+            start = clock();
+            for (int i = 0; i < deletes; i++) {
+                if (s == 0)
+                    delta_index_delete(index, keys[i]);
+                else if (s == 1)
+                    avl = avl_delete(avl, keys[i], &rotations);
+                else
+                    rbt = rbt_delete(rbt, keys[i], &rotations, &recolorings);
+            }
+            delete_ns[d][s] = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / deletes;
+
+            int ok = 1;
+            if (expected_found < 0) {
+                expected_found = found;
+                expected_scanned = scanned;
+            }
+            ok &= found == expected_found && scanned == expected_scanned;
+            // Содержимое после удалений: упорядоченный обход сравнивается поэлементно
+            if (s == 0) {
+                ok &= delta_index_is_valid(index);
+                remaining_count = delta_index_range(index, 0, 0x7fffffff, remaining, n);
+                ok &= remaining_count == delta_index_count(index);
+            } else {
+                int left = s == 1 ? delta_avl_collect(avl, 0, 0x7fffffff, out, 0, n)
+                                  : delta_rbt_collect(rbt, 0, 0x7fffffff, out, 0, n);
+                ok &= left == remaining_count && memcmp(out, remaining, left * sizeof(int)) == 0;
+            }
+            all_ok &= ok;
+
+            const char* labels[] = {"Дельта-индекс ", "AVL           ", "RBT           "};
+            printf("%s | %10.1f | %8.1f | %18.2f | %11.1f | %9.1f%s\n", labels[s], insert_ns[d][s],
+                   lookup_ns[d][s], scan_ns[d][s], delete_ns[d][s], per_key, ok ? "" : "  ОШИБКА");
+
+            if (s == 0)
+                delta_index_free(index);
+            free_avl_tree(avl);
+            free_rbt_tree(rbt);
+        }
+        printf("\n");
+    }
+
+    printf("Проверка (поиск, сканы и содержимое после удалений совпадают): %s\n\n",
+           all_ok ? "ok" : "ОШИБКА");
+
+    printf("ВЫВОД:\n");
+    printf("• Метки времени: %.1f байт на ключ против %.1f (AVL) и %.1f (RBT), x%.0f;\n",
+           delta_bytes[0], avl_bytes, rbt_bytes, avl_bytes / delta_bytes[0]);
+    printf("  ради этого профиля (memory_limited=8) индекс и нужен\n");
+    printf("• Скан окна: %.2f нс на ключ против %.2f (AVL) - блок распаковывается SSE2\n",
+           scan_ns[0][0], scan_ns[0][1]);
+    printf("  по 4 ключа, без перехода по указателям\n");
+    printf("• На случайных ключах дельты шире (%.1f байт на ключ), вставка в середину\n", delta_bytes[1]);
+    if (insert_ns[1][0] < insert_ns[1][1])
+        printf("  перепаковывает блок, но 128 ключей в кеше дешевле промахов по узлам AVL\n");
+    else
+        printf("  перепаковывает блок: здесь вставка AVL быстрее, выигрыш остается за памятью\n");
+    // Удаление ключа по одному распаковывает и упаковывает блок целиком
+    if (delete_ns[0][0] > delete_ns[0][1])
+        printf("• Удаление по сроку хранения (%.0f нс против %.0f у AVL) перепаковывает блок\n"
+               "  на каждый ключ: старые показания выгоднее отрезать целыми блоками\n",
+               delete_ns[0][0], delete_ns[0][1]);
+    printf("\n");
+
+    free(keys);
+    free(queries);
+    free(range_lo);
+    free(out);
+    free(remaining);
+}
@@ -0,0 +1,785 @@
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "methods.h"
+
+// ========== B+ ДЕРЕВО В ФАЙЛЕ (mmap) ==========
+// Файл - массив страниц page_size байт, отображенный в память целиком.
+// Страница 0 - метаданные, номер 0 заодно служит "нет страницы" в ссылках.
+// Узлы ссылаются друг на друга номерами страниц, а не указателями: при
+// росте файла отображение может переехать, поэтому после каждого
+// выделения страницы указатели на узлы берутся заново.
+// Журнала нет: согласованное состояние на диске гарантируется только
+// в точках disk_bplus_checkpoint (и при закрытии).
+
+#define DISK_BPLUS_MAGIC 0x534C5042u  // "BPLS"
+#define DISK_BPLUS_VERSION 1
+#define DISK_BPLUS_INITIAL_PAGES 64
+#define DISK_PAGE_FREE 2              // is_leaf у страницы в списке свободных
+
+struct DiskMeta {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t page_size;
+    uint32_t root;
+    uint32_t height;
+    uint32_t num_pages;   // занято страниц в файле (с мета и свободными)
+    uint32_t free_head;   // первая свободная страница, 0 - список пуст
+    uint32_t free_count;
+    uint64_t count;
+    uint64_t checkpoints;
+};
+
+struct DiskPage {
+    uint32_t is_leaf;
+    uint32_t count;  // ключей в листе / разделителей во внутреннем узле
+    uint32_t prev;   // соседние листья; у свободной страницы next - следующая свободная
+    uint32_t next;
+    // далее ключи, у внутреннего узла после них номера потомков
+};
+
+struct DiskBPlusTree {
+    int fd;
+    char* map;
+    size_t map_bytes;
+    uint32_t page_size;
+    int leaf_cap;
+    int inner_cap;
+    int* split_keys;           // буферы для деления внутреннего узла
+    uint32_t* split_children;
+};
+
+static struct DiskMeta* dbp_meta(struct DiskBPlusTree* tree) {
+    return (struct DiskMeta*)tree->map;
+}
+
+static struct DiskPage* dbp_page(struct DiskBPlusTree* tree, uint32_t id) {
+    return (struct DiskPage*)(tree->map + (size_t)id * tree->page_size);
+}
+
+static int* dbp_keys(struct DiskPage* page) {
+    return (int*)(page + 1);
+}
+
+static uint32_t* dbp_children(struct DiskBPlusTree* tree, struct DiskPage* page) {
+    return (uint32_t*)(dbp_keys(page) + tree->inner_cap);
+}
+
+// Разделитель keys[i] - максимальный ключ поддерева children[i], как в
+// B+ дереве в памяти: и в листе, и во внутреннем узле нужен ранг
+// (число ключей < key)
+static int dbp_rank(const int* keys, int count, int key) {
+    int lo = 0;
+    int hi = count;
+    while (lo < hi) {
+        int mid = (lo + hi) >> 1;
+        if (keys[mid] < key)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+static int dbp_map(struct DiskBPlusTree* tree, size_t bytes) {
+    void* map = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, tree->fd, 0);
+    if (map == MAP_FAILED) {
+        perror("disk_bplus: mmap");
+        return -1;
+    }
+    // Поиск в B+ дереве читает страницы вразнобой: упреждающее чтение
+    // соседних страниц только вытесняло бы полезные
+    madvise(map, bytes, MADV_RANDOM);
+    tree->map = (char*)map;
+    tree->map_bytes = bytes;
+    return 0;
+}
+
+// Удваивает файл и отображение; старые указатели на страницы после этого недействительны
+static void dbp_grow(struct DiskBPlusTree* tree) {
+    size_t bytes = tree->map_bytes * 2;
+    munmap(tree->map, tree->map_bytes);
+    if (ftruncate(tree->fd, bytes) != 0 || dbp_map(tree, bytes) != 0) {
+        perror("disk_bplus: не удалось увеличить файл");
+        exit(1);
+    }
+}
+
+static uint32_t dbp_alloc_page(struct DiskBPlusTree* tree, int is_leaf) {
+    struct DiskMeta* meta = dbp_meta(tree);
+    uint32_t id;
+    if (meta->free_head != 0) {
+        id = meta->free_head;
+        meta->free_head = dbp_page(tree, id)->next;
+        meta->free_count--;
+    } else {
+        if ((size_t)(meta->num_pages + 1) * tree->page_size > tree->map_bytes) {
+            dbp_grow(tree);
+            meta = dbp_meta(tree);
+        }
+        id = meta->num_pages++;
+    }
+
+    struct DiskPage* page = dbp_page(tree, id);
+    page->is_leaf = is_leaf;
+    page->count = 0;
+    page->prev = 0;
+    page->next = 0;
+    return id;
+}
+
+static void dbp_free_page(struct DiskBPlusTree* tree, uint32_t id) {
+    struct DiskMeta* meta = dbp_meta(tree);
+    struct DiskPage* page = dbp_page(tree, id);
+    page->is_leaf = DISK_PAGE_FREE;
+    page->count = 0;
+    page->prev = 0;
+    page->next = meta->free_head;
+    meta->free_head = id;
+    meta->free_count++;
+}
+
+static void dbp_set_caps(struct DiskBPlusTree* tree) {
+    size_t body = tree->page_size - sizeof(struct DiskPage);
+    tree->leaf_cap = (int)(body / sizeof(int));
+    // inner_cap ключей и inner_cap + 1 потомков
+    tree->inner_cap = (int)((body - sizeof(uint32_t)) / (sizeof(int) + sizeof(uint32_t)));
+    tree->split_keys = (int*)malloc((tree->inner_cap + 1) * sizeof(int));
+    tree->split_children = (uint32_t*)malloc((tree->inner_cap + 2) * sizeof(uint32_t));
+}
+
+struct DiskBPlusTree* disk_bplus_open(const char* path, int page_size) {
+    if (page_size < 256 || (page_size & (page_size - 1)) != 0 || page_size % getpagesize() != 0) {
+        fprintf(stderr, "disk_bplus: размер страницы %d должен быть степенью двойки и кратен %d\n",
+                page_size, getpagesize());
+        return NULL;
+    }
+
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        perror("disk_bplus: open");
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        perror("disk_bplus: fstat");
+        close(fd);
+        return NULL;
+    }
+
+    struct DiskBPlusTree* tree = (struct DiskBPlusTree*)malloc(sizeof(struct DiskBPlusTree));
+    tree->fd = fd;
+
+    if (st.st_size == 0) {
+        // Новый файл: мета-страница и пустой лист-корень
+        size_t bytes = (size_t)DISK_BPLUS_INITIAL_PAGES * page_size;
+        if (ftruncate(fd, bytes) != 0 || dbp_map(tree, bytes) != 0) {
+            close(fd);
+            free(tree);
+            return NULL;
+        }
+        tree->page_size = page_size;
+        dbp_set_caps(tree);
+
+        struct DiskMeta* meta = dbp_meta(tree);
+        memset(meta, 0, page_size);
+        meta->magic = DISK_BPLUS_MAGIC;
+        meta->version = DISK_BPLUS_VERSION;
+        meta->page_size = page_size;
+        meta->num_pages = 1;
+        meta->height = 1;
+        meta->root = dbp_alloc_page(tree, 1);
+        return tree;
+    }
+
+    // Существующий файл: размер страницы в метаданных должен совпасть с ожидаемым
+    struct DiskMeta header;
+    if (pread(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header) ||
+        header.magic != DISK_BPLUS_MAGIC || header.version != DISK_BPLUS_VERSION ||
+        (size_t)header.num_pages * header.page_size > (size_t)st.st_size) {
+        fprintf(stderr, "disk_bplus: %s - не файл B+ дерева или файл поврежден\n", path);
+        close(fd);
+        free(tree);
+        return NULL;
+    }
+    if (header.page_size != (uint32_t)page_size || st.st_size % page_size != 0) {
+        fprintf(stderr, "disk_bplus: %s - страница файла %u байт, ожидалась %d\n", path,
+                header.page_size, page_size);
+        close(fd);
+        free(tree);
+        return NULL;
+    }
+    if (dbp_map(tree, st.st_size) != 0) {
+        close(fd);
+        free(tree);
+        return NULL;
+    }
+    tree->page_size = header.page_size;
+    dbp_set_caps(tree);
+    return tree;
+}
+
+int disk_bplus_checkpoint(struct DiskBPlusTree* tree) {
+    dbp_meta(tree)->checkpoints++;
+    if (msync(tree->map, tree->map_bytes, MS_SYNC) != 0 || fsync(tree->fd) != 0) {
+        perror("disk_bplus: checkpoint");
+        return -1;
+    }
+    return 0;
+}
+
+int disk_bplus_close(struct DiskBPlusTree* tree) {
+    if (tree == NULL)
+        return 0;
+    int result = disk_bplus_checkpoint(tree);
+    // Хвост, выделенный удвоением "про запас", файлу не нужен
+    size_t used = (size_t)dbp_meta(tree)->num_pages * tree->page_size;
+    munmap(tree->map, tree->map_bytes);
+    if (ftruncate(tree->fd, used) != 0)
+        result = -1;
+    close(tree->fd);
+    free(tree->split_keys);
+    free(tree->split_children);
+    free(tree);
+    return result;
+}
+
+void disk_bplus_drop_cache(struct DiskBPlusTree* tree) {
+    // Грязные страницы сначала на диск, затем выбросить их и из
+    // отображения, и из страничного кеша ядра
+    msync(tree->map, tree->map_bytes, MS_SYNC);
+    madvise(tree->map, tree->map_bytes, MADV_DONTNEED);
+    posix_fadvise(tree->fd, 0, 0, POSIX_FADV_DONTNEED);
+}
+
+static uint32_t dbp_find_leaf(struct DiskBPlusTree* tree, int key) {
+    uint32_t id = dbp_meta(tree)->root;
+    struct DiskPage* page = dbp_page(tree, id);
+    while (!page->is_leaf) {
+        int i = dbp_rank(dbp_keys(page), page->count, key);
+        id = dbp_children(tree, page)[i];
+        page = dbp_page(tree, id);
+    }
+    return id;
+}
+
+int disk_bplus_contains(struct DiskBPlusTree* tree, int key) {
+    struct DiskPage* leaf = dbp_page(tree, dbp_find_leaf(tree, key));
+    int* keys = dbp_keys(leaf);
+    int pos = dbp_rank(keys, leaf->count, key);
+    return pos < (int)leaf->count && keys[pos] == key;
+}
+
+int disk_bplus_range(struct DiskBPlusTree* tree, int lo, int hi, int* out, int max_out) {
+    uint32_t id = dbp_find_leaf(tree, lo);
+    struct DiskPage* leaf = dbp_page(tree, id);
+    int pos = dbp_rank(dbp_keys(leaf), leaf->count, lo);
+    int found = 0;
+
+    while (id != 0) {
+        leaf = dbp_page(tree, id);
+        int* keys = dbp_keys(leaf);
+        for (; pos < (int)leaf->count; pos++) {
+            if (keys[pos] > hi)
+                return found;
+            if (out != NULL && found < max_out)
+                out[found] = keys[pos];
+            found++;
+        }
+        id = leaf->next;
+        pos = 0;
+    }
+    return found;
+}
+
+// Вставка с результатом разделения, как в B+ дереве в памяти:
+// 0 - ключ уже есть, 1 - вставлен, 2 - вставлен и узел разделился
+static int dbp_insert_rec(struct DiskBPlusTree* tree, uint32_t id, int key,
+                          int* sep, uint32_t* right) {
+    struct DiskPage* node = dbp_page(tree, id);
+    int* keys = dbp_keys(node);
+    int count = node->count;
+    int pos = dbp_rank(keys, count, key);
+
+    if (node->is_leaf) {
+        if (pos < count && keys[pos] == key)
+            return 0;
+
+        if (count < tree->leaf_cap) {
+            memmove(keys + pos + 1, keys + pos, (count - pos) * sizeof(int));
+            keys[pos] = key;
+            node->count++;
+            return 1;
+        }
+
+        // Лист полон: половину ключей переносим в новую страницу
+        uint32_t sibling_id = dbp_alloc_page(tree, 1);
+        node = dbp_page(tree, id);
+        keys = dbp_keys(node);
+        struct DiskPage* sibling = dbp_page(tree, sibling_id);
+        int* sibling_keys = dbp_keys(sibling);
+
+        int half = count / 2;
+        sibling->count = count - half;
+        memcpy(sibling_keys, keys + half, sibling->count * sizeof(int));
+        node->count = half;
+        sibling->next = node->next;
+        sibling->prev = id;
+        if (node->next != 0)
+            dbp_page(tree, node->next)->prev = sibling_id;
+        node->next = sibling_id;
+
+        struct DiskPage* target = key <= keys[half - 1] ? node : sibling;
+        int* target_keys = dbp_keys(target);
+        int tpos = dbp_rank(target_keys, target->count, key);
+        memmove(target_keys + tpos + 1, target_keys + tpos, (target->count - tpos) * sizeof(int));
+        target_keys[tpos] = key;
+        target->count++;
+
+        *sep = keys[node->count - 1];
+        *right = sibling_id;
+        return 2;
+    }
+
+    int child_sep;
+    uint32_t child_right;
+    int result = dbp_insert_rec(tree, dbp_children(tree, node)[pos], key, &child_sep, &child_right);
+    if (result != 2)
+        return result;
+
+    // Потомок мог выделить страницу - отображение могло переехать
+    node = dbp_page(tree, id);
+    keys = dbp_keys(node);
+    uint32_t* children = dbp_children(tree, node);
+
+    if (count < tree->inner_cap) {
+        memmove(keys + pos + 1, keys + pos, (count - pos) * sizeof(int));
+        memmove(children + pos + 2, children + pos + 1, (count - pos) * sizeof(uint32_t));
+        keys[pos] = child_sep;
+        children[pos + 1] = child_right;
+        node->count++;
+        return 1;
+    }
+
+    // Внутренний узел полон: собираем inner_cap + 1 разделителей и делим
+    int* all_keys = tree->split_keys;
+    uint32_t* all_children = tree->split_children;
+    memcpy(all_keys, keys, pos * sizeof(int));
+    all_keys[pos] = child_sep;
+    memcpy(all_keys + pos + 1, keys + pos, (count - pos) * sizeof(int));
+    memcpy(all_children, children, (pos + 1) * sizeof(uint32_t));
+    all_children[pos + 1] = child_right;
+    memcpy(all_children + pos + 2, children + pos + 1, (count - pos) * sizeof(uint32_t));
+
+    int total = count + 1;
+    int mid = total / 2;
+    uint32_t sibling_id = dbp_alloc_page(tree, 0);
+    node = dbp_page(tree, id);
+    struct DiskPage* sibling = dbp_page(tree, sibling_id);
+
+    node->count = mid;
+    memcpy(dbp_keys(node), all_keys, mid * sizeof(int));
+    memcpy(dbp_children(tree, node), all_children, (mid + 1) * sizeof(uint32_t));
+
+    sibling->count = total - mid - 1;
+    memcpy(dbp_keys(sibling), all_keys + mid + 1, sibling->count * sizeof(int));
+    memcpy(dbp_children(tree, sibling), all_children + mid + 1, (sibling->count + 1) * sizeof(uint32_t));
+
+    *sep = all_keys[mid];
+    *right = sibling_id;
+    return 2;
+}
+
+int disk_bplus_insert(struct DiskBPlusTree* tree, int key) {
+    int sep;
+    uint32_t right;
+    int result = dbp_insert_rec(tree, dbp_meta(tree)->root, key, &sep, &right);
+    if (result == 0)
+        return 0;
+
+    if (result == 2) {
+        uint32_t root_id = dbp_alloc_page(tree, 0);
+        struct DiskMeta* meta = dbp_meta(tree);
+        struct DiskPage* root = dbp_page(tree, root_id);
+        root->count = 1;
+        dbp_keys(root)[0] = sep;
+        dbp_children(tree, root)[0] = meta->root;
+        dbp_children(tree, root)[1] = right;
+        meta->root = root_id;
+        meta->height++;
+    }
+    dbp_meta(tree)->count++;
+    return 1;
+}
+
+// Удаление без слияния соседей: опустевший лист возвращается в список
+// свободных страниц, а его ссылка и разделитель уходят из родителя.
+// 0 - ключа нет, 1 - удален; *emptied - узел опустел и должен быть освобожден
+static int dbp_delete_rec(struct DiskBPlusTree* tree, uint32_t id, int key, int* emptied) {
+    struct DiskPage* node = dbp_page(tree, id);
+    int* keys = dbp_keys(node);
+    int count = node->count;
+    int pos = dbp_rank(keys, count, key);
+    *emptied = 0;
+
+    if (node->is_leaf) {
+        if (pos >= count || keys[pos] != key)
+            return 0;
+        memmove(keys + pos, keys + pos + 1, (count - pos - 1) * sizeof(int));
+        node->count--;
+        *emptied = node->count == 0;
+        return 1;
+    }
+
+    uint32_t* children = dbp_children(tree, node);
+    uint32_t child_id = children[pos];
+    int child_emptied;
+    if (!dbp_delete_rec(tree, child_id, key, &child_emptied))
+        return 0;
+    if (!child_emptied)
+        return 1;
+
+    struct DiskPage* child = dbp_page(tree, child_id);
+    if (child->is_leaf) {
+        if (child->prev != 0)
+            dbp_page(tree, child->prev)->next = child->next;
+        if (child->next != 0)
+            dbp_page(tree, child->next)->prev = child->prev;
+    }
+    dbp_free_page(tree, child_id);
+
+    if (count == 0) {
+        // Это был единственный потомок
+        *emptied = 1;
+        return 1;
+    }
+    // Последний потомок забирает диапазон у предыдущего разделителя
+    int key_pos = pos < count ? pos : pos - 1;
+    memmove(keys + key_pos, keys + key_pos + 1, (count - key_pos - 1) * sizeof(int));
+    memmove(children + pos, children + pos + 1, (count - pos) * sizeof(uint32_t));
+    node->count--;
+    return 1;
+}
+
+int disk_bplus_delete(struct DiskBPlusTree* tree, int key) {
+    int emptied;
+    if (!dbp_delete_rec(tree, dbp_meta(tree)->root, key, &emptied))
+        return 0;
+
+    struct DiskMeta* meta = dbp_meta(tree);
+    meta->count--;
+    struct DiskPage* root = dbp_page(tree, meta->root);
+    if (emptied && !root->is_leaf) {
+        // Опустело все дерево: корнем снова становится пустой лист
+        dbp_free_page(tree, meta->root);
+        meta->root = dbp_alloc_page(tree, 1);
+        meta->height = 1;
+        return 1;
+    }
+    // Корень с единственным потомком не нужен
+    while (!root->is_leaf && root->count == 0) {
+        uint32_t old = meta->root;
+        meta->root = dbp_children(tree, root)[0];
+        meta->height--;
+        dbp_free_page(tree, old);
+        root = dbp_page(tree, meta->root);
+    }
+    return 1;
+}
+
+long long disk_bplus_count(struct DiskBPlusTree* tree) {
+    return (long long)dbp_meta(tree)->count;
+}
+
+int disk_bplus_height(struct DiskBPlusTree* tree) {
+    return (int)dbp_meta(tree)->height;
+}
+
+size_t disk_bplus_file_bytes(struct DiskBPlusTree* tree) {
+    return (size_t)dbp_meta(tree)->num_pages * tree->page_size;
+}
+
+int disk_bplus_free_pages(struct DiskBPlusTree* tree) {
+    return (int)dbp_meta(tree)->free_count;
+}
+
+// ==================== ТЕСТ 23: B+ ДЕРЕВО НА ДИСКЕ ====================
+
+struct FaultCounter {
+    long minor;
+    long major;
+};
+
+static struct FaultCounter faults_now() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    struct FaultCounter result = {usage.ru_minflt, usage.ru_majflt};
+    return result;
+}
+
+static double faults_per_op(struct FaultCounter before, int ops) {
+    struct FaultCounter after = faults_now();
+    return (double)(after.minor - before.minor + after.major - before.major) / ops;
+}
+
+static double major_per_op(struct FaultCounter before, int ops) {
+    return (double)(faults_now().major - before.major) / ops;
+}
+
+static void disk_bplus_path(char* path, size_t size, int page_size) {
+    const char* dir = getenv("TMPDIR");
+    if (dir == NULL || dir[0] == '\0')
+        dir = "/tmp";
+    snprintf(path, size, "%s/disk_bplus_%d_%d.db", dir, (int)getpid(), page_size);
+}
+
+void test_disk_bplus() {
+    printf("=== ТЕСТ 23: B+ дерево в файле (mmap) против деревьев в памяти ===\n\n");
+
+    const int N = 4000000;
+    const int LOOKUPS = 1000000;
+    const int COLD_LOOKUPS = 20000;
+    const int RANGES = 10000;
+    const int RANGE_WIDTH = 4000;
+    // "Данные больше RAM": выбрасываем страницы дерева из памяти каждые
+    // BUDGET_OPS поисков, так что почти каждый поиск читает диск
+    const int BUDGET_OPS = 1000;
+    const int PAGE_SIZES[] = {DISK_BPLUS_PAGE_SIZE, DISK_BPLUS_PAGE_SIZE * 4};
+    const int NUM_PAGE_SIZES = sizeof(PAGE_SIZES) / sizeof(PAGE_SIZES[0]);
+
+    srand(time(NULL));
+
+    int* keys = (int*)malloc(N * sizeof(int));
+    for (int i = 0; i < N; i++)
+        keys[i] = i * 2;
+    for (int i = N - 1; i > 0; i--) {
+        int j = (int)(((long long)rand() * RAND_MAX + rand()) % (i + 1));
+        int t = keys[i];
+        keys[i] = keys[j];
+        keys[j] = t;
+    }
+    int* queries = (int*)malloc(LOOKUPS * sizeof(int));
+    for (int i = 0; i < LOOKUPS; i++)
+        queries[i] = (int)(((long long)rand() * RAND_MAX + rand()) % (N * 2));
+
+    printf("Ключей: %d, поисков: %d (холодных: %d), диапазонов: %d по ~%d ключей\n",
+           N, LOOKUPS, COLD_LOOKUPS, RANGES, RANGE_WIDTH / 2);
+    printf("Время - настенное (включает ожидание диска), ошибки страниц - getrusage\n\n");
+
+    // ---------- Деревья в памяти ----------
+    int rotations = 0;
+    int recolorings = 0;
+    struct AVLNode* avl_root = NULL;
+    double start = wall_time_ms();
+    struct FaultCounter before = faults_now();
+    for (int i = 0; i < N; i++)
+        avl_root = avl_insert(avl_root, keys[i], &rotations);
+    double avl_insert_ns = (wall_time_ms() - start) * 1e6 / N;
+    double avl_insert_faults = faults_per_op(before, N);
+
+    struct RBNode* rbt_root = NULL;
+    start = wall_time_ms();
+    before = faults_now();
+    for (int i = 0; i < N; i++)
+        rbt_root = rbt_insert(rbt_root, keys[i], &rotations, &recolorings);
+    double rbt_insert_ns = (wall_time_ms() - start) * 1e6 / N;
+    double rbt_insert_faults = faults_per_op(before, N);
+
+    struct BPlusTree* mem_bplus = bplus_create(BTREE_NODE_KEYS, NULL);
+    start = wall_time_ms();
+    before = faults_now();
+    for (int i = 0; i < N; i++)
+        bplus_insert(mem_bplus, keys[i]);
+    double mem_insert_ns = (wall_time_ms() - start) * 1e6 / N;
+    double mem_insert_faults = faults_per_op(before, N);
+
+    long long found = 0;
+    start = wall_time_ms();
+    before = faults_now();
+    for (int i = 0; i < LOOKUPS; i++)
+        found += avl_search(avl_root, queries[i]) != NULL;
+    double avl_lookup_ns = (wall_time_ms() - start) * 1e6 / LOOKUPS;
+    double avl_lookup_faults = faults_per_op(before, LOOKUPS);
+    long long expected_found = found;
+
+    found = 0;
+    start = wall_time_ms();
+    before = faults_now();
+    for (int i = 0; i < LOOKUPS; i++)
+        found += rbt_search(rbt_root, queries[i]) != NULL;
+    double rbt_lookup_ns = (wall_time_ms() - start) * 1e6 / LOOKUPS;
+    double rbt_lookup_faults = faults_per_op(before, LOOKUPS);
+    int all_ok = found == expected_found;
+
+    found = 0;
+    start = wall_time_ms();
+    before = faults_now();
+    for (int i = 0; i < LOOKUPS; i++)
+        found += bplus_contains(mem_bplus, queries[i]);
+    double mem_lookup_ns = (wall_time_ms() - start) * 1e6 / LOOKUPS;
+    double mem_lookup_faults = faults_per_op(before, LOOKUPS);
+    all_ok &= found == expected_found;
+
+    long long mem_range_total = 0;
+    start = wall_time_ms();
+    for (int i = 0; i < RANGES; i++)
+        mem_range_total += bplus_range(mem_bplus, queries[i], queries[i] + RANGE_WIDTH, NULL, 0);
+    double mem_range_us = (wall_time_ms() - start) * 1e3 / RANGES;
+
+    printf("Структура        | Вставка ns | ош.стр/вст | Поиск ns | ош.стр/поиск | Диапазон мкс\n");
+    printf("-----------------|------------|------------|----------|--------------|-------------\n");
+    printf("AVL (память)     | %10.1f | %10.4f | %8.1f | %12.4f | %12s\n",
+           avl_insert_ns, avl_insert_faults, avl_lookup_ns, avl_lookup_faults, "-");
+    printf("RBT (память)     | %10.1f | %10.4f | %8.1f | %12.4f | %12s\n",
+           rbt_insert_ns, rbt_insert_faults, rbt_lookup_ns, rbt_lookup_faults, "-");
+    printf("B+ (память, %3d) | %10.1f | %10.4f | %8.1f | %12.4f | %12.2f\n",
+           mem_bplus->fanout, mem_insert_ns, mem_insert_faults, mem_lookup_ns, mem_lookup_faults,
+           mem_range_us);
+
+    free_avl_tree(avl_root);
+    free_rbt_tree(rbt_root);
+    bplus_free(mem_bplus);
+
+    // ---------- B+ дерево в файле ----------
+    double disk_warm_ns[NUM_PAGE_SIZES];
+    double disk_cold_ns[NUM_PAGE_SIZES];
+    double disk_cold_major[NUM_PAGE_SIZES];
+    for (int p = 0; p < NUM_PAGE_SIZES; p++) {
+        char path[256];
+        disk_bplus_path(path, sizeof(path), PAGE_SIZES[p]);
+        unlink(path);
+        struct DiskBPlusTree* tree = disk_bplus_open(path, PAGE_SIZES[p]);
+        if (tree == NULL) {
+            printf("Не удалось открыть %s - тест пропущен\n", path);
+            free(keys);
+            free(queries);
+            return;
+        }
+
+        start = wall_time_ms();
+        before = faults_now();
+        for (int i = 0; i < N; i++)
+            disk_bplus_insert(tree, keys[i]);
+        double insert_ns = (wall_time_ms() - start) * 1e6 / N;
+        double insert_faults = faults_per_op(before, N);
+
+        start = wall_time_ms();
+        int checkpoint_ok = disk_bplus_checkpoint(tree) == 0;
+        double checkpoint_ms = wall_time_ms() - start;
+
+        found = 0;
+        start = wall_time_ms();
+        before = faults_now();
+        for (int i = 0; i < LOOKUPS; i++)
+            found += disk_bplus_contains(tree, queries[i]);
+        disk_warm_ns[p] = (wall_time_ms() - start) * 1e6 / LOOKUPS;
+        double warm_faults = faults_per_op(before, LOOKUPS);
+        all_ok &= found == expected_found;
+
+        // Холодные поиски: страницы выбрасываются каждые BUDGET_OPS операций
+        found = 0;
+        long long cold_expected = 0;
+        for (int i = 0; i < COLD_LOOKUPS; i++)
+            cold_expected += (queries[i] & 1) == 0;
+        start = wall_time_ms();
+        before = faults_now();
+        for (int i = 0; i < COLD_LOOKUPS; i++) {
+            if (i % BUDGET_OPS == 0)
+                disk_bplus_drop_cache(tree);
+            found += disk_bplus_contains(tree, queries[i]);
+        }
+        disk_cold_ns[p] = (wall_time_ms() - start) * 1e6 / COLD_LOOKUPS;
+        double cold_faults = faults_per_op(before, COLD_LOOKUPS);
+        disk_cold_major[p] = major_per_op(before, COLD_LOOKUPS);
+        all_ok &= found == cold_expected;
+
+        long long range_total = 0;
+        disk_bplus_drop_cache(tree);
+        start = wall_time_ms();
+        for (int i = 0; i < RANGES; i++)
+            range_total += disk_bplus_range(tree, queries[i], queries[i] + RANGE_WIDTH, NULL, 0);
+        double range_us = (wall_time_ms() - start) * 1e3 / RANGES;
+        all_ok &= range_total == mem_range_total;
+
+        printf("B+ файл (%2d КиБ) | %10.1f | %10.4f | %8.1f | %12.4f | %12.2f\n",
+               PAGE_SIZES[p] / 1024, insert_ns, insert_faults, disk_warm_ns[p], warm_faults, range_us);
+        printf("  холодный поиск: %.1f ns, ошибок страниц %.3f/оп (с диска: %.3f/оп)\n",
+               disk_cold_ns[p], cold_faults, disk_cold_major[p]);
+        printf("  файл: %.1f МБ, высота %d, контрольная точка %.1f мс (%s)\n",
+               disk_bplus_file_bytes(tree) / (1024.0 * 1024.0), disk_bplus_height(tree),
+               checkpoint_ms, checkpoint_ok ? "ok" : "ОШИБКА");
+
+        if (p == 0) {
+            // Удаление нижней половины диапазона: листья пустеют, их страницы
+            // уходят в список свободных и снова используются при вставке
+            for (int i = 0; i < N; i++)
+                if (keys[i] < N)
+                    disk_bplus_delete(tree, keys[i]);
+            int free_after_delete = disk_bplus_free_pages(tree);
+            size_t file_after_delete = disk_bplus_file_bytes(tree);
+            for (int i = 0; i < N; i++)
+                if (keys[i] < N)
+                    disk_bplus_insert(tree, keys[i]);
+            int free_after_reinsert = disk_bplus_free_pages(tree);
+            printf("  удалено %d ключей подряд: свободных страниц %d; после повторной вставки %d, "
+                   "файл %s\n", N / 2, free_after_delete, free_after_reinsert,
+                   disk_bplus_file_bytes(tree) == file_after_delete ? "не вырос" : "вырос");
+
+            // Переоткрытие: дерево читается с диска без перестроения
+            all_ok &= disk_bplus_close(tree) == 0;
+            start = wall_time_ms();
+            tree = disk_bplus_open(path, PAGE_SIZES[p]);
+            double reopen_ms = wall_time_ms() - start;
+            int reopen_ok = tree != NULL && disk_bplus_count(tree) == N;
+            if (reopen_ok) {
+                found = 0;
+                for (int i = 0; i < LOOKUPS; i++)
+                    found += disk_bplus_contains(tree, queries[i]);
+                reopen_ok = found == expected_found;
+            }
+            printf("  закрыт и открыт заново за %.2f мс: %s\n", reopen_ms,
+                   reopen_ok ? "все ключи на месте" : "ОШИБКА");
+            all_ok &= reopen_ok;
+        }
+
+        disk_bplus_close(tree);
+        unlink(path);
+    }
+
+    printf("\nХолодный поиск: страницы дерева выбрасываются из памяти (msync + MADV_DONTNEED\n");
+    printf("+ POSIX_FADV_DONTNEED) каждые %d поисков - модель данных, не влезающих в RAM.\n",
+           BUDGET_OPS);
+    printf("Проверка (совпадение с деревьями в памяти): %s\n\n", all_ok ? "ok" : "ОШИБКА");
+
+    printf("ВЫВОД:\n");
+    printf("• Пока файл в страничном кеше, B+ дерево на mmap ищет за %.0f ns - на уровне\n",
+           disk_warm_ns[0]);
+    printf("  деревьев в памяти (AVL %.0f ns): страница %d КиБ вмещает ~%d ключей,\n",
+           avl_lookup_ns, PAGE_SIZES[0] / 1024, (PAGE_SIZES[0] - 16) / 4);
+    printf("  поэтому путь от корня короткий и почти весь в кеше процессора\n");
+    printf("• Когда данные не помещаются в RAM, каждый поиск - %.2f чтений с диска\n",
+           disk_cold_major[0]);
+    printf("  (%.0f ns/оп); AVL и RBT в такой ситуации пришлось бы читать по узлу на уровень\n",
+           disk_cold_ns[0]);
+    printf("• Страница %d КиБ: %.2f чтений/оп и %.0f ns - высота меньше,\n",
+           PAGE_SIZES[1] / 1024, disk_cold_major[1], disk_cold_ns[1]);
+    if (disk_cold_ns[1] < disk_cold_ns[0])
+        printf("  и это перевешивает лишние страницы ОС внутри узла: для случайных поисков\n"
+               "  здесь лучше %d КиБ\n", PAGE_SIZES[1] / 1024);
+    else
+        printf("  но двоичный поиск внутри узла задевает несколько страниц ОС: для случайных\n"
+               "  поисков здесь лучше %d КиБ\n", PAGE_SIZES[0] / 1024);
+    printf("• Данные переживают перезапуск: после контрольной точки файл открывается\n");
+    printf("  без перестроения дерева, а удаленные страницы используются повторно\n\n");
+
+    free(keys);
+    free(queries);
+}
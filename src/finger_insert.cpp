@@ -0,0 +1,373 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "methods.h"
+
+// ========== ВСТАВКА С ПОДСКАЗКОЙ И ПРАВЫЙ ПАЛЕЦ ==========
+// Ключи журналов и временных рядов почти всегда больше текущего максимума.
+// Вместо спуска от корня поиск начинается с максимального узла ("правого
+// пальца") и поднимается по правому краю дерева ровно настолько, насколько
+// ключ отстал от максимума: дописывание в конец стоит O(1) сравнений,
+// а опоздавший на d позиций ключ - O(log d).
+//
+// С TREE_ORDER_STATISTICS размеры предков все равно обновляются до корня,
+// но это проход по уже закешированному пути без сравнений ключей.
+
+// ---------- RBT ----------
+
+static struct RBNode* rbt_successor(struct RBNode* node) {
+    if (node->right != NULL) {
+        node = node->right;
+        while (node->left != NULL)
+            node = node->left;
+        return node;
+    }
+    while (node->parent != NULL && node == node->parent->right)
+        node = node->parent;
+    return node->parent;
+}
+
+static struct RBNode* rbt_predecessor(struct RBNode* node) {
+    if (node->left != NULL) {
+        node = node->left;
+        while (node->right != NULL)
+            node = node->right;
+        return node;
+    }
+    while (node->parent != NULL && node == node->parent->left)
+        node = node->parent;
+    return node->parent;
+}
+
+// Подвешивает новый ключ к parent (слот должен быть свободен) и балансирует
+static struct RBNode* rbt_attach(struct RBNode* root, struct RBNode* parent, int key,
+                                 int* recolorings, struct RBNode** inserted) {
+    struct RBNode* z = rbt_create_node(key);
+    z->parent = parent;
+    if (key < parent->key)
+        parent->left = z;
+    else
+        parent->right = z;
+
+#ifdef TREE_ORDER_STATISTICS
+    for (struct RBNode* p = parent; p != NULL; p = p->parent)
+        p->size++;
+#endif
+
+    if (inserted != NULL)
+        *inserted = z;
+    rbt_fix_violation(&root, z, recolorings);
+    return root;
+}
+
+// Спуск от node до свободного слота; при совпадении ключа - NULL и *found
+static struct RBNode* rbt_descend(struct RBNode* node, int key, struct RBNode** found) {
+    struct RBNode* parent = NULL;
+    while (node != NULL) {
+        if (key == node->key) {
+            *found = node;
+            return NULL;
+        }
+        parent = node;
+        node = key < node->key ? node->left : node->right;
+    }
+    return parent;
+}
+
+struct RBNode* rbt_insert_hint(struct RBNode* root, struct RBNode* hint, int key,
+                               int* rotations, int* recolorings, struct RBNode** inserted) {
+    struct RBNode* found = NULL;
+    if (root == NULL) {
+        root = rbt_insert(NULL, key, rotations, recolorings);
+        if (inserted != NULL)
+            *inserted = root;
+        return root;
+    }
+
+    if (hint != NULL) {
+        if (key == hint->key) {
+            if (inserted != NULL)
+                *inserted = hint;
+            return root;
+        }
+        // Ключ сразу после hint: свободен либо hint->right, либо левый
+        // слот преемника
+        if (key > hint->key) {
+            struct RBNode* next = rbt_successor(hint);
+            if (next == NULL || key < next->key) {
+                struct RBNode* parent = hint->right == NULL ? hint : next;
+                return rbt_attach(root, parent, key, recolorings, inserted);
+            }
+        } else {
+            struct RBNode* prev = rbt_predecessor(hint);
+            if (prev == NULL || key > prev->key) {
+                struct RBNode* parent = hint->left == NULL ? hint : prev;
+                return rbt_attach(root, parent, key, recolorings, inserted);
+            }
+        }
+    }
+
+    // Подсказка не подошла - обычный спуск от корня
+    struct RBNode* parent = rbt_descend(root, key, &found);
+    if (parent == NULL) {
+        if (inserted != NULL)
+            *inserted = found;
+        return root;
+    }
+    return rbt_attach(root, parent, key, recolorings, inserted);
+}
+
+void rbt_finger_init(struct RBFingerTree* tree) {
+    tree->root = NULL;
+    tree->rightmost = NULL;
+}
+
+void rbt_finger_insert(struct RBFingerTree* tree, int key, int* rotations, int* recolorings) {
+    struct RBNode* max = tree->rightmost;
+    if (max == NULL) {
+        tree->root = rbt_insert(NULL, key, rotations, recolorings);
+        tree->rightmost = tree->root;
+        return;
+    }
+
+    // Новый максимум: правый слот максимума всегда свободен, а повороты
+    // не меняют порядок, поэтому новый узел остается максимумом
+    if (key > max->key) {
+        tree->root = rbt_attach(tree->root, max, key, recolorings, &tree->rightmost);
+        return;
+    }
+
+    // Подъем по правому краю до первого ключа меньше key
+    struct RBNode* v = max;
+    while (v != NULL && v->key > key)
+        v = v->parent;
+    if (v != NULL && v->key == key)
+        return;
+
+    struct RBNode* found = NULL;
+    struct RBNode* parent = rbt_descend(v != NULL ? v->right : tree->root, key, &found);
+    if (parent != NULL)
+        tree->root = rbt_attach(tree->root, parent, key, recolorings, NULL);
+}
+
+// ---------- AVL ----------
+// Родителей в AVLNode нет, поэтому палец - это явный стек правого края
+// (путь от корня до максимума). Вставка собирает путь, продолжая спуск
+// с узла правого края, и балансирует снизу вверх по этому пути.
+
+void avl_finger_init(struct AVLFingerTree* tree) {
+    tree->root = NULL;
+    tree->spine_len = 0;
+}
+
+static void avl_finger_rebuild_spine(struct AVLFingerTree* tree, int from, struct AVLNode* node) {
+    int k = from;
+    for (; node != NULL; node = node->right)
+        tree->spine[k++] = node;
+    tree->spine_len = k;
+}
+
+void avl_finger_insert(struct AVLFingerTree* tree, int key, int* rotations) {
+    if (tree->root == NULL) {
+        tree->root = avl_insert(NULL, key, rotations);
+        avl_finger_rebuild_spine(tree, 0, tree->root);
+        return;
+    }
+
+    // Ближайший снизу узел правого края с ключом меньше key
+    int i = tree->spine_len - 1;
+    while (i >= 0 && tree->spine[i]->key > key)
+        i--;
+    if (i >= 0 && tree->spine[i]->key == key)
+        return;
+
+    struct AVLNode* path[AVL_FINGER_MAX_HEIGHT];
+    int depth = i + 1;
+    memcpy(path, tree->spine, depth * sizeof(struct AVLNode*));
+    struct AVLNode* node = i >= 0 ? tree->spine[i]->right : tree->root;
+    while (node != NULL) {
+        if (key == node->key)
+            return;
+        path[depth++] = node;
+        node = key < node->key ? node->left : node->right;
+    }
+
+    // Первые on_spine узлов пути лежат на правом краю
+    int on_spine = i + 2 < tree->spine_len ? i + 2 : tree->spine_len;
+
+    struct AVLNode* leaf = avl_insert(NULL, key, rotations);
+    struct AVLNode* parent = path[depth - 1];
+    if (key < parent->key)
+        parent->left = leaf;
+    else
+        parent->right = leaf;
+    int appended = parent == tree->spine[tree->spine_len - 1] && key > parent->key;
+
+    int balanced = 0;
+    for (int j = depth - 1; j >= 0; j--) {
+        struct AVLNode* n = path[j];
+        if (balanced) {
+#ifdef TREE_ORDER_STATISTICS
+            n->size++;
+            continue;
+#else
+            break;
+#endif
+        }
+
+        int old_height = n->height;
+        n->height = 1 + (avl_height(n->left) > avl_height(n->right) ?
+                         avl_height(n->left) : avl_height(n->right));
+#ifdef TREE_ORDER_STATISTICS
+        avl_update_size(n);
+#endif
+        int balance = avl_balance(n);
+        struct AVLNode* sub = n;
+
+        if (balance > 1 && key < n->left->key) {
+            (*rotations)++;
+            sub = avl_rotate_right(n);
+        } else if (balance < -1 && key > n->right->key) {
+            (*rotations)++;
+            sub = avl_rotate_left(n);
+        } else if (balance > 1) {
+            (*rotations) += 2;
+            n->left = avl_rotate_left(n->left);
+            sub = avl_rotate_right(n);
+        } else if (balance < -1) {
+            (*rotations) += 2;
+            n->right = avl_rotate_right(n->right);
+            sub = avl_rotate_left(n);
+        } else {
+            if (n->height == old_height)
+                balanced = 1;
+            continue;
+        }
+
+        // После поворота высота поддерева прежняя - выше ничего не меняется
+        if (j == 0)
+            tree->root = sub;
+        else if (path[j - 1]->left == n)
+            path[j - 1]->left = sub;
+        else
+            path[j - 1]->right = sub;
+        balanced = 1;
+        if (j < on_spine) {
+            avl_finger_rebuild_spine(tree, j, sub);
+            appended = 0;
+        }
+    }
+
+    if (appended)
+        tree->spine[tree->spine_len++] = leaf;
+}
+
+// ==================== ТЕСТ 17: ВСТАВКА С ПАЛЬЦЕМ ====================
+
+// Временные метки: строго возрастают (late_percent == 0) или часть
+// событий опаздывает на случайное число позиций, не больше max_delay
+static void make_timestamps(int* keys, int n, int late_percent, int max_delay) {
+    for (int i = 0; i < n; i++)
+        keys[i] = i * 8 + rand() % 8;
+    if (late_percent == 0)
+        return;
+    for (int i = n - 1; i > 0; i--) {
+        if (rand() % 100 >= late_percent)
+            continue;
+        int j = i - 1 - rand() % max_delay;
+        if (j < 0)
+            j = 0;
+        int tmp = keys[i];
+        keys[i] = keys[j];
+        keys[j] = tmp;
+    }
+}
+
+void test_finger_insert() {
+    printf("=== ТЕСТ 17: Вставка с подсказкой и правым пальцем ===\n\n");
+
+    const int N = 1000000;
+    const char* names[] = {"Метки времени по порядку", "Почти отсортированные (5%)",
+                           "Почти отсортированные (30%)", "Случайные ключи"};
+    const int late[] = {0, 5, 30, -1};
+    const int NUM_STREAMS = 4;
+
+    srand(time(NULL));
+    int* keys = (int*)malloc(N * sizeof(int));
+
+    printf("%-28s | %-10s | %-10s | %-10s | %-10s | %-10s | %s\n", "Поток (ns/вставка)",
+           "AVL", "AVL палец", "RBT", "RBT палец", "RBT hint", "Проверка");
+    printf("-----------------------------|------------|------------|------------|------------|------------|---------\n");
+
+    for (int s = 0; s < NUM_STREAMS; s++) {
+        if (late[s] >= 0) {
+            make_timestamps(keys, N, late[s], 1000);
+        } else {
+            for (int i = 0; i < N; i++)
+                keys[i] = rand() % (N * 8);
+        }
+
+        int rotations = 0;
+        int recolorings = 0;
+
+        struct AVLNode* avl_root = NULL;
+        clock_t start = clock();
+        for (int i = 0; i < N; i++)
+            avl_root = avl_insert(avl_root, keys[i], &rotations);
+        double avl_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / N;
+
+        struct AVLFingerTree avl_finger;
+        avl_finger_init(&avl_finger);
+        start = clock();
+        for (int i = 0; i < N; i++)
+            avl_finger_insert(&avl_finger, keys[i], &rotations);
+        double avl_finger_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / N;
+
+        struct RBNode* rbt_root = NULL;
+        start = clock();
+        for (int i = 0; i < N; i++)
+            rbt_root = rbt_insert(rbt_root, keys[i], &rotations, &recolorings);
+        double rbt_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / N;
+
+        struct RBFingerTree rbt_finger;
+        rbt_finger_init(&rbt_finger);
+        start = clock();
+        for (int i = 0; i < N; i++)
+            rbt_finger_insert(&rbt_finger, keys[i], &rotations, &recolorings);
+        double rbt_finger_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / N;
+
+        // Подсказка - предыдущий вставленный узел (как emplace_hint с end())
+        struct RBNode* rbt_hinted = NULL;
+        struct RBNode* hint = NULL;
+        start = clock();
+        for (int i = 0; i < N; i++)
+            rbt_hinted = rbt_insert_hint(rbt_hinted, hint, keys[i], &rotations, &recolorings, &hint);
+        double rbt_hint_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / N;
+
+        int count = count_avl_nodes(avl_root);
+        struct AVLNode* max = avl_finger.spine[avl_finger.spine_len - 1];
+        int ok = avl_is_valid(avl_finger.root) && rbt_is_valid(rbt_finger.root) &&
+                 rbt_is_valid(rbt_hinted) && count_avl_nodes(avl_finger.root) == count &&
+                 count_rbt_nodes(rbt_finger.root) == count && count_rbt_nodes(rbt_hinted) == count &&
+                 max->right == NULL && rbt_finger.rightmost->right == NULL &&
+                 max->key == rbt_finger.rightmost->key;
+
+        printf("%-28s | %-10.1f | %-10.1f | %-10.1f | %-10.1f | %-10.1f | %s\n", names[s],
+               avl_ns, avl_finger_ns, rbt_ns, rbt_finger_ns, rbt_hint_ns, ok ? "OK" : "ОШИБКА");
+
+        free_avl_tree(avl_root);
+        free_avl_tree(avl_finger.root);
+        free_rbt_tree(rbt_root);
+        free_rbt_tree(rbt_finger.root);
+        free_rbt_tree(rbt_hinted);
+    }
+
+    free(keys);
+
+    printf("\nВЫВОД: для дописывания в конец палец убирает спуск от корня; опоздавшие\n");
+    printf("       ключи ищутся от максимума за O(log d), на случайных ключах выигрыша нет.\n");
+    printf("       Подсказка без пальца на чистом дописывании не помогает: проверка\n");
+    printf("       преемника максимума поднимается до корня\n\n");
+}
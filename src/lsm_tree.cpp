@@ -0,0 +1,370 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "methods.h"
+
+// ========== LSM-ИНДЕКС ==========
+// Запись идет в небольшое RBT дерево (memtable), которое целиком лежит
+// в кеше. Заполненный memtable выгружается в неизменяемый отсортированный
+// массив (run) на уровне 0. Политика слияния - многоуровневая (tiered):
+// когда на уровне набирается fanout прогонов, самые старые fanout
+// сливаются в один прогон следующего уровня. Поиск идет от новых данных
+// к старым: memtable, затем уровни сверху вниз, внутри уровня - с конца.
+//
+// В фоновом режиме слияния делает отдельный поток; писатель ждет его
+// только если уровень 0 переполнен вдвое (обратное давление).
+
+#define LSM_MAX_LEVELS 24
+#define LSM_MAX_FANOUT 16
+#define LSM_MAX_RUNS (2 * LSM_MAX_FANOUT)
+
+struct LSMRun {
+    int* keys;
+    int count;
+};
+
+struct LSMTree {
+    struct RBNode* memtable;
+    int memtable_size;
+    int memtable_limit;
+    int fanout;
+
+    // Внутри уровня прогоны от старых к новым
+    struct LSMRun* runs[LSM_MAX_LEVELS][LSM_MAX_RUNS];
+    int run_count[LSM_MAX_LEVELS];
+
+    struct LSMStats stats;
+
+    bool background;
+    bool stop;
+    std::thread merger;
+    std::mutex mutex;
+    std::condition_variable changed;
+};
+
+static void lsm_memtable_to_array(struct RBNode* node, int* out, int* pos) {
+    while (node != NULL) {
+        lsm_memtable_to_array(node->left, out, pos);
+        out[(*pos)++] = node->key;
+        node = node->right;
+    }
+}
+
+static int lsm_run_contains(struct LSMRun* run, int key) {
+    int lo = 0;
+    int hi = run->count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (run->keys[mid] < key)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo < run->count && run->keys[lo] == key;
+}
+
+// k-путевое слияние отсортированных прогонов с удалением повторов
+static struct LSMRun* lsm_merge_runs(struct LSMRun** inputs, int count) {
+    int total = 0;
+    for (int i = 0; i < count; i++)
+        total += inputs[i]->count;
+
+    struct LSMRun* out = (struct LSMRun*)malloc(sizeof(struct LSMRun));
+    out->keys = (int*)malloc((total > 0 ? total : 1) * sizeof(int));
+    out->count = 0;
+
+    int pos[LSM_MAX_RUNS] = {0};
+    for (;;) {
+        int best = -1;
+        for (int i = 0; i < count; i++) {
+            if (pos[i] < inputs[i]->count &&
+                (best < 0 || inputs[i]->keys[pos[i]] < inputs[best]->keys[pos[best]]))
+                best = i;
+        }
+        if (best < 0)
+            break;
+        int key = inputs[best]->keys[pos[best]++];
+        if (out->count == 0 || out->keys[out->count - 1] != key)
+            out->keys[out->count++] = key;
+    }
+    return out;
+}
+
+static void lsm_free_run(struct LSMRun* run) {
+    free(run->keys);
+    free(run);
+}
+
+// Уровень для слияния: самый глубокий с fanout прогонами, чтобы нижний
+// уровень освободился раньше, чем в него придет новый прогон
+static int lsm_pick_level(struct LSMTree* tree) {
+    for (int level = LSM_MAX_LEVELS - 2; level >= 0; level--)
+        if (tree->run_count[level] >= tree->fanout)
+            return level;
+    return -1;
+}
+
+// Сливает старейшие fanout прогонов уровня. Входные прогоны неизменяемы,
+// поэтому само слияние идет без блокировки; под ней - только подмена.
+static void lsm_merge_level(struct LSMTree* tree, int level, std::unique_lock<std::mutex>* lock) {
+    struct LSMRun* inputs[LSM_MAX_RUNS];
+    int count = tree->fanout;
+    for (int i = 0; i < count; i++)
+        inputs[i] = tree->runs[level][i];
+
+    if (lock != NULL)
+        lock->unlock();
+    struct LSMRun* merged = lsm_merge_runs(inputs, count);
+    if (lock != NULL)
+        lock->lock();
+
+    int rest = tree->run_count[level] - count;
+    for (int i = 0; i < rest; i++)
+        tree->runs[level][i] = tree->runs[level][i + count];
+    tree->run_count[level] = rest;
+    tree->runs[level + 1][tree->run_count[level + 1]++] = merged;
+    tree->stats.merges++;
+    tree->stats.merged_keys += merged->count;
+
+    // Старые прогоны больше не видны: поиск идет под той же блокировкой
+    for (int i = 0; i < count; i++)
+        lsm_free_run(inputs[i]);
+}
+
+static void lsm_merger(struct LSMTree* tree) {
+    std::unique_lock<std::mutex> lock(tree->mutex);
+    for (;;) {
+        int level;
+        tree->changed.wait(lock, [tree, &level] {
+            level = lsm_pick_level(tree);
+            return tree->stop || level >= 0;
+        });
+        if (level < 0)
+            return;
+        lsm_merge_level(tree, level, &lock);
+        tree->changed.notify_all();
+    }
+}
+
+static void lsm_flush(struct LSMTree* tree) {
+    struct LSMRun* run = (struct LSMRun*)malloc(sizeof(struct LSMRun));
+    run->keys = (int*)malloc(tree->memtable_size * sizeof(int));
+    run->count = 0;
+    lsm_memtable_to_array(tree->memtable, run->keys, &run->count);
+    free_rbt_tree(tree->memtable);
+    tree->memtable = NULL;
+    tree->memtable_size = 0;
+    tree->stats.flushes++;
+    tree->stats.flushed_keys += run->count;
+
+    if (!tree->background) {
+        tree->runs[0][tree->run_count[0]++] = run;
+        int level;
+        while ((level = lsm_pick_level(tree)) >= 0)
+            lsm_merge_level(tree, level, NULL);
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(tree->mutex);
+    if (tree->run_count[0] >= 2 * tree->fanout) {
+        tree->stats.stalls++;
+        tree->changed.wait(lock, [tree] { return tree->run_count[0] < 2 * tree->fanout; });
+    }
+    tree->runs[0][tree->run_count[0]++] = run;
+    tree->changed.notify_all();
+}
+
+struct LSMTree* lsm_create(int memtable_limit, int fanout, int background) {
+    struct LSMTree* tree = new LSMTree();
+    tree->memtable = NULL;
+    tree->memtable_size = 0;
+    tree->memtable_limit = memtable_limit > 0 ? memtable_limit : 1;
+    tree->fanout = fanout < 2 ? 2 : (fanout > LSM_MAX_FANOUT ? LSM_MAX_FANOUT : fanout);
+    for (int level = 0; level < LSM_MAX_LEVELS; level++)
+        tree->run_count[level] = 0;
+    tree->stats.flushes = 0;
+    tree->stats.flushed_keys = 0;
+    tree->stats.merges = 0;
+    tree->stats.merged_keys = 0;
+    tree->stats.stalls = 0;
+    tree->background = background != 0;
+    tree->stop = false;
+    if (tree->background)
+        tree->merger = std::thread(lsm_merger, tree);
+    return tree;
+}
+
+void lsm_free(struct LSMTree* tree) {
+    if (tree->background) {
+        {
+            std::lock_guard<std::mutex> lock(tree->mutex);
+            tree->stop = true;
+        }
+        tree->changed.notify_all();
+        tree->merger.join();
+    }
+    free_rbt_tree(tree->memtable);
+    for (int level = 0; level < LSM_MAX_LEVELS; level++)
+        for (int i = 0; i < tree->run_count[level]; i++)
+            lsm_free_run(tree->runs[level][i]);
+    delete tree;
+}
+
+void lsm_insert(struct LSMTree* tree, int key) {
+    int rotations = 0;
+    int recolorings = 0;
+    // Повтор ключа в memtable не увеличивает его размер
+    if (rbt_search(tree->memtable, key) != NULL)
+        return;
+    tree->memtable = rbt_insert(tree->memtable, key, &rotations, &recolorings);
+    if (++tree->memtable_size >= tree->memtable_limit)
+        lsm_flush(tree);
+}
+
+int lsm_contains(struct LSMTree* tree, int key) {
+    if (rbt_search(tree->memtable, key) != NULL)
+        return 1;
+
+    std::unique_lock<std::mutex> lock(tree->mutex, std::defer_lock);
+    if (tree->background)
+        lock.lock();
+    for (int level = 0; level < LSM_MAX_LEVELS; level++)
+        for (int i = tree->run_count[level] - 1; i >= 0; i--)
+            if (lsm_run_contains(tree->runs[level][i], key))
+                return 1;
+    return 0;
+}
+
+void lsm_wait_merges(struct LSMTree* tree) {
+    if (!tree->background)
+        return;
+    std::unique_lock<std::mutex> lock(tree->mutex);
+    tree->changed.wait(lock, [tree] { return lsm_pick_level(tree) < 0; });
+}
+
+void lsm_get_stats(struct LSMTree* tree, struct LSMStats* stats, int* runs) {
+    std::unique_lock<std::mutex> lock(tree->mutex, std::defer_lock);
+    if (tree->background)
+        lock.lock();
+    *stats = tree->stats;
+    *runs = 0;
+    for (int level = 0; level < LSM_MAX_LEVELS; level++)
+        *runs += tree->run_count[level];
+}
+
+// ==================== ТЕСТ 18: LSM-ИНДЕКС ====================
+
+void test_lsm_tree() {
+    printf("=== ТЕСТ 18: LSM-индекс для нагрузки с преобладанием записи ===\n\n");
+
+    const int N = 2000000;
+    const int NUM_LOOKUPS = 500000;
+    const int MEMTABLE = 32768;
+    const int FANOUT = 4;
+
+    srand(time(NULL));
+
+    int* keys = (int*)malloc(N * sizeof(int));
+    for (int i = 0; i < N; i++)
+        keys[i] = rand() % (N * 4);
+    int* queries = (int*)malloc(NUM_LOOKUPS * sizeof(int));
+    for (int i = 0; i < NUM_LOOKUPS; i++)
+        queries[i] = rand() % (N * 4);
+
+    printf("memtable %d ключей (RBT), fanout %d, %d вставок\n\n", MEMTABLE, FANOUT, N);
+    printf("%-22s | %-12s | %-12s | %-14s | %-8s | %s\n",
+           "Структура", "Вставка (ns)", "Поиск (ns)", "Логи 90/10 (ns)", "Прогонов", "Запись x");
+    printf("-----------------------|--------------|--------------|----------------|----------|---------\n");
+
+    // Базовая линия: одно RBT дерево
+    struct RBNode* rbt_root = NULL;
+    int rotations = 0;
+    int recolorings = 0;
+    clock_t start = clock();
+    for (int i = 0; i < N; i++)
+        rbt_root = rbt_insert(rbt_root, keys[i], &rotations, &recolorings);
+    double insert_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / N;
+
+    start = clock();
+    int rbt_found = 0;
+    for (int i = 0; i < NUM_LOOKUPS; i++)
+        rbt_found += rbt_search(rbt_root, queries[i]) != NULL;
+    double search_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / NUM_LOOKUPS;
+
+    // Смешанная нагрузка сценария "логирование": 90% вставок, 10% поиска
+    start = clock();
+    for (int i = 0; i < NUM_LOOKUPS; i++) {
+        if (i % 10 == 9)
+            rbt_found += rbt_search(rbt_root, queries[i]) != NULL;
+        else
+            rbt_root = rbt_insert(rbt_root, N * 4 + i, &rotations, &recolorings);
+    }
+    double mixed_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / NUM_LOOKUPS;
+    printf("%-22s | %-12.1f | %-12.1f | %-14.1f | %-8s | %s\n",
+           "rbt_insert", insert_ns, search_ns, mixed_ns, "-", "1.0");
+
+    const char* names[] = {"LSM, слияние в потоке", "LSM, фоновое слияние"};
+    int ok = 1;
+    for (int mode = 0; mode < 2; mode++) {
+        struct LSMTree* tree = lsm_create(MEMTABLE, FANOUT, mode);
+
+        // Время фоновых слияний в однопоточном clock() не видно,
+        // поэтому здесь настенное время
+        double t0 = wall_time_ms();
+        for (int i = 0; i < N; i++)
+            lsm_insert(tree, keys[i]);
+        lsm_wait_merges(tree);
+        insert_ns = (wall_time_ms() - t0) * 1e6 / N;
+
+        t0 = wall_time_ms();
+        int lsm_found = 0;
+        for (int i = 0; i < NUM_LOOKUPS; i++)
+            lsm_found += lsm_contains(tree, queries[i]);
+        search_ns = (wall_time_ms() - t0) * 1e6 / NUM_LOOKUPS;
+        int expected = 0;
+        for (int i = 0; i < NUM_LOOKUPS; i++)
+            expected += rbt_search(rbt_root, queries[i]) != NULL;
+        ok = ok && lsm_found == expected;
+
+        t0 = wall_time_ms();
+        for (int i = 0; i < NUM_LOOKUPS; i++) {
+            if (i % 10 == 9)
+                lsm_found += lsm_contains(tree, queries[i]);
+            else
+                lsm_insert(tree, N * 4 + i);
+        }
+        lsm_wait_merges(tree);
+        mixed_ns = (wall_time_ms() - t0) * 1e6 / NUM_LOOKUPS;
+
+        struct LSMStats stats;
+        int runs;
+        lsm_get_stats(tree, &stats, &runs);
+        // Усиление записи: сколько раз ключ в среднем переписан при выгрузках и слияниях
+        double amplification = (double)(stats.flushed_keys + stats.merged_keys) / stats.flushed_keys;
+        printf("%-22s | %-12.1f | %-12.1f | %-14.1f | %-8d | %.1f\n",
+               names[mode], insert_ns, search_ns, mixed_ns, runs, amplification);
+        if (stats.stalls > 0)
+            printf("  (писатель ждал слияния %lld раз)\n", stats.stalls);
+
+        // Все ключи второй фазы видны
+        for (int i = 0; i < NUM_LOOKUPS; i += 101)
+            if (i % 10 != 9 && !lsm_contains(tree, N * 4 + i))
+                ok = 0;
+        lsm_free(tree);
+    }
+
+    printf("\nПроверка: %s\n", ok ? "OK" : "ОШИБКА");
+
+    free(keys);
+    free(queries);
+    free_rbt_tree(rbt_root);
+
+    printf("\nВЫВОД: LSM переносит стоимость записи в последовательные слияния и\n");
+    printf("       вставляет быстрее одного большого RBT, но поиск проверяет\n");
+    printf("       несколько прогонов и стоит дороже\n\n");
+}
@@ -1,17 +1,13 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <math.h>
 
-// ========== AVL ДЕРЕВО ==========
+#include "methods.h"
 
+// ========== AVL ДЕРЕВО ==========
 
-struct AVLNode {
-    int key;
-    int height;
-    struct AVLNode* left;
-    struct AVLNode* right;
-};
 
 int avl_height(struct AVLNode* node) {
     return node ? node->height : 0;
@@ -21,6 +17,16 @@ int avl_balance(struct AVLNode* node) {
     return node ? avl_height(node->left) - avl_height(node->right) : 0;
 }
 
+#ifdef TREE_ORDER_STATISTICS
+int avl_size(struct AVLNode* node) {
+    return node ? node->size : 0;
+}
+
+void avl_update_size(struct AVLNode* node) {
+    node->size = 1 + avl_size(node->left) + avl_size(node->right);
+}
+#endif
+
 struct AVLNode* avl_rotate_right(struct AVLNode* y) {
     struct AVLNode* x = y->left;
     struct AVLNode* T2 = x->right;
@@ -33,6 +39,11 @@ struct AVLNode* avl_rotate_right(struct AVLNode* y) {
     x->height = 1 + (avl_height(x->left) > avl_height(x->right) ?
                     avl_height(x->left) : avl_height(x->right));
 
+#ifdef TREE_ORDER_STATISTICS
+    avl_update_size(y);
+    avl_update_size(x);
+#endif
+
     return x;
 }
 
@@ -48,14 +59,22 @@ struct AVLNode* avl_rotate_left(struct AVLNode* x) {
     y->height = 1 + (avl_height(y->left) > avl_height(y->right) ?
                     avl_height(y->left) : avl_height(y->right));
 
+#ifdef TREE_ORDER_STATISTICS
+    avl_update_size(x);
+    avl_update_size(y);
+#endif
+
     return y;
 }
 
 struct AVLNode* avl_insert(struct AVLNode* node, int key, int* rotations) {
     if (node == NULL) {
-        struct AVLNode* new_node = (struct AVLNode*)malloc(sizeof(struct AVLNode));
+        struct AVLNode* new_node = (struct AVLNode*)tree_node_alloc(sizeof(struct AVLNode));
         new_node->key = key;
         new_node->height = 1;
+#ifdef TREE_ORDER_STATISTICS
+        new_node->size = 1;
+#endif
         new_node->left = new_node->right = NULL;
         return new_node;
     }
@@ -69,6 +88,9 @@ struct AVLNode* avl_insert(struct AVLNode* node, int key, int* rotations) {
 
     node->height = 1 + (avl_height(node->left) > avl_height(node->right) ?
                        avl_height(node->left) : avl_height(node->right));
+#ifdef TREE_ORDER_STATISTICS
+    avl_update_size(node);
+#endif
 
     int balance = avl_balance(node);
 
@@ -101,26 +123,87 @@ struct AVLNode* avl_insert(struct AVLNode* node, int key, int* rotations) {
     return node;
 }
 
-// ========== RBT ДЕРЕВО ==========
+struct AVLNode* avl_search(struct AVLNode* node, int key) {
+    while (node != NULL && node->key != key)
+        node = key < node->key ? node->left : node->right;
+    return node;
+}
 
-enum Color { RED, BLACK };
+struct AVLNode* avl_delete(struct AVLNode* node, int key, int* rotations) {
+    if (node == NULL)
+        return NULL;
+
+    if (key < node->key) {
+        node->left = avl_delete(node->left, key, rotations);
+    } else if (key > node->key) {
+        node->right = avl_delete(node->right, key, rotations);
+    } else if (node->left == NULL || node->right == NULL) {
+        struct AVLNode* child = node->left ? node->left : node->right;
+        tree_node_free(node, sizeof(struct AVLNode));
+        return child;
+    } else {
+        // Два сына: ключ заменяется минимальным из правого поддерева
+        struct AVLNode* min = node->right;
+        while (min->left != NULL)
+            min = min->left;
+        node->key = min->key;
+        node->right = avl_delete(node->right, min->key, rotations);
+    }
 
-struct RBNode {
-    int key;
-    enum Color color;
-    struct RBNode* left;
-    struct RBNode* right;
-    struct RBNode* parent;
-};
+    node->height = 1 + (avl_height(node->left) > avl_height(node->right) ?
+                       avl_height(node->left) : avl_height(node->right));
+#ifdef TREE_ORDER_STATISTICS
+    avl_update_size(node);
+#endif
+
+    int balance = avl_balance(node);
+
+    if (balance > 1) {
+        if (avl_balance(node->left) < 0) {
+            (*rotations) += 2;
+            node->left = avl_rotate_left(node->left);
+        } else {
+            (*rotations)++;
+        }
+        return avl_rotate_right(node);
+    }
+
+    if (balance < -1) {
+        if (avl_balance(node->right) > 0) {
+            (*rotations) += 2;
+            node->right = avl_rotate_right(node->right);
+        } else {
+            (*rotations)++;
+        }
+        return avl_rotate_left(node);
+    }
+
+    return node;
+}
+
+// ========== RBT ДЕРЕВО ==========
 
 struct RBNode* rbt_create_node(int key) {
-    struct RBNode* node = (struct RBNode*)malloc(sizeof(struct RBNode));
+    struct RBNode* node = (struct RBNode*)tree_node_alloc(sizeof(struct RBNode));
     node->key = key;
     node->color = RED;
+#ifdef TREE_ORDER_STATISTICS
+    node->size = 1;
+#endif
     node->left = node->right = node->parent = NULL;
     return node;
 }
 
+#ifdef TREE_ORDER_STATISTICS
+int rbt_size(struct RBNode* node) {
+    return node ? node->size : 0;
+}
+
+void rbt_update_size(struct RBNode* node) {
+    node->size = 1 + rbt_size(node->left) + rbt_size(node->right);
+}
+#endif
+
 void rbt_rotate_left(struct RBNode** root, struct RBNode* x, int* rotations) {
     (*rotations)++;
     struct RBNode* y = x->right;
@@ -140,6 +223,12 @@ void rbt_rotate_left(struct RBNode** root, struct RBNode* x, int* rotations) {
 
     y->left = x;
     x->parent = y;
+
+#ifdef TREE_ORDER_STATISTICS
+    // y занимает место x целиком, x теряет правое поддерево y
+    y->size = x->size;
+    rbt_update_size(x);
+#endif
 }
 
 void rbt_rotate_right(struct RBNode** root, struct RBNode* y, int* rotations) {
@@ -161,6 +250,11 @@ void rbt_rotate_right(struct RBNode** root, struct RBNode* y, int* rotations) {
 
     x->right = y;
     y->parent = x;
+
+#ifdef TREE_ORDER_STATISTICS
+    x->size = y->size;
+    rbt_update_size(y);
+#endif
 }
 
 void rbt_fix_violation(struct RBNode** root, struct RBNode* z, int* recolorings) {
@@ -218,18 +312,20 @@ void rbt_fix_violation(struct RBNode** root, struct RBNode* z, int* recolorings)
 }
 
 struct RBNode* rbt_insert(struct RBNode* root, int key, int* rotations, int* recolorings) {
-    struct RBNode* z = rbt_create_node(key);
     struct RBNode* y = NULL;
     struct RBNode* x = root;
 
     while (x != NULL) {
         y = x;
-        if (z->key < x->key)
+        if (key < x->key)
             x = x->left;
-        else
+        else if (key > x->key)
             x = x->right;
+        else
+            return root; // Дубликаты не вставляем (как и в AVL)
     }
 
+    struct RBNode* z = rbt_create_node(key);
     z->parent = y;
 
     if (y == NULL)
@@ -239,11 +335,175 @@ struct RBNode* rbt_insert(struct RBNode* root, int key, int* rotations, int* rec
     else
         y->right = z;
 
+#ifdef TREE_ORDER_STATISTICS
+    for (struct RBNode* p = y; p != NULL; p = p->parent)
+        p->size++;
+#endif
+
     rbt_fix_violation(&root, z, recolorings);
 
     return root;
 }
 
+struct RBNode* rbt_search(struct RBNode* root, int key) {
+    while (root != NULL && root->key != key)
+        root = key < root->key ? root->left : root->right;
+    return root;
+}
+
+static void rbt_transplant(struct RBNode** root, struct RBNode* u, struct RBNode* v) {
+    if (u->parent == NULL)
+        *root = v;
+    else if (u == u->parent->left)
+        u->parent->left = v;
+    else
+        u->parent->right = v;
+    if (v != NULL)
+        v->parent = u->parent;
+}
+
+// x - узел на месте удаленного черного (NULL считается черным листом),
+// parent - его родитель, нужен когда x == NULL
+static void rbt_delete_fixup(struct RBNode** root, struct RBNode* x, struct RBNode* parent,
+                             int* rotations, int* recolorings) {
+    while (x != *root && (x == NULL || x->color == BLACK)) {
+        if (x == parent->left) {
+            struct RBNode* w = parent->right;
+
+            // Case 1: брат красный
+            if (w->color == RED) {
+                (*recolorings) += 2;
+                w->color = BLACK;
+                parent->color = RED;
+                rbt_rotate_left(root, parent, rotations);
+                w = parent->right;
+            }
+
+            // Case 2: оба сына брата черные
+            if ((w->left == NULL || w->left->color == BLACK) &&
+                (w->right == NULL || w->right->color == BLACK)) {
+                (*recolorings)++;
+                w->color = RED;
+                x = parent;
+                parent = x->parent;
+            } else {
+                // Case 3: дальний сын брата черный
+                if (w->right == NULL || w->right->color == BLACK) {
+                    (*recolorings) += 2;
+                    w->left->color = BLACK;
+                    w->color = RED;
+                    rbt_rotate_right(root, w, rotations);
+                    w = parent->right;
+                }
+
+                // Case 4
+                (*recolorings) += 3;
+                w->color = parent->color;
+                parent->color = BLACK;
+                w->right->color = BLACK;
+                rbt_rotate_left(root, parent, rotations);
+                x = *root;
+            }
+        } else {
+            // Mirror cases
+            struct RBNode* w = parent->left;
+
+            if (w->color == RED) {
+                (*recolorings) += 2;
+                w->color = BLACK;
+                parent->color = RED;
+                rbt_rotate_right(root, parent, rotations);
+                w = parent->left;
+            }
+
+            if ((w->left == NULL || w->left->color == BLACK) &&
+                (w->right == NULL || w->right->color == BLACK)) {
+                (*recolorings)++;
+                w->color = RED;
+                x = parent;
+                parent = x->parent;
+            } else {
+                if (w->left == NULL || w->left->color == BLACK) {
+                    (*recolorings) += 2;
+                    w->right->color = BLACK;
+                    w->color = RED;
+                    rbt_rotate_left(root, w, rotations);
+                    w = parent->left;
+                }
+
+                (*recolorings) += 3;
+                w->color = parent->color;
+                parent->color = BLACK;
+                w->left->color = BLACK;
+                rbt_rotate_right(root, parent, rotations);
+                x = *root;
+            }
+        }
+    }
+
+    if (x != NULL)
+        x->color = BLACK;
+}
+
+struct RBNode* rbt_delete(struct RBNode* root, int key, int* rotations, int* recolorings) {
+    struct RBNode* z = rbt_search(root, key);
+    if (z == NULL)
+        return root;
+
+    struct RBNode* x;
+    struct RBNode* x_parent;
+    enum Color removed_color = z->color;
+
+    if (z->left == NULL) {
+        x = z->right;
+        x_parent = z->parent;
+        rbt_transplant(&root, z, z->right);
+    } else if (z->right == NULL) {
+        x = z->left;
+        x_parent = z->parent;
+        rbt_transplant(&root, z, z->left);
+    } else {
+        // Два сына: на место z встает преемник y
+        struct RBNode* y = z->right;
+        while (y->left != NULL)
+            y = y->left;
+        removed_color = y->color;
+        x = y->right;
+        if (y->parent == z) {
+            x_parent = y;
+        } else {
+            x_parent = y->parent;
+            rbt_transplant(&root, y, y->right);
+            y->right = z->right;
+            y->right->parent = y;
+        }
+        rbt_transplant(&root, z, y);
+        y->left = z->left;
+        y->left->parent = y;
+        y->color = z->color;
+#ifdef TREE_ORDER_STATISTICS
+        y->size = z->size;
+#endif
+    }
+
+#ifdef TREE_ORDER_STATISTICS
+    for (struct RBNode* p = x_parent; p != NULL; p = p->parent)
+        p->size--;
+#endif
+
+    tree_node_free(z, sizeof(struct RBNode));
+    if (removed_color == BLACK)
+        rbt_delete_fixup(&root, x, x_parent, rotations, recolorings);
+    return root;
+}
+
+// Монотонное время в миллисекундах (для многопоточных тестов)
+double wall_time_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
 // ==================== НОВЫЕ ТЕСТОВЫЕ ФУНКЦИИ ====================
 
 // Функция для освобождения памяти AVL дерева
@@ -251,7 +511,7 @@ void free_avl_tree(struct AVLNode* root) {
     if (root == NULL) return;
     free_avl_tree(root->left);
     free_avl_tree(root->right);
-    free(root);
+    tree_node_free(root, sizeof(struct AVLNode));
 }
 
 // Функция для освобождения памяти RBT дерева
@@ -259,7 +519,7 @@ void free_rbt_tree(struct RBNode* root) {
     if (root == NULL) return;
     free_rbt_tree(root->left);
     free_rbt_tree(root->right);
-    free(root);
+    tree_node_free(root, sizeof(struct RBNode));
 }
 
 // Подсчет узлов в AVL дереве
@@ -280,9 +540,11 @@ void test_sorted_data_comparison() {
 
     struct AVLNode* avl_root = NULL;
     struct RBNode* rbt_root = NULL;
+    struct WAVLNode* wavl_root = NULL;
     int avl_rotations = 0;
     int rbt_rotations = 0;
     int rbt_recolorings = 0;
+    int wavl_rotations = 0;
 
     int sorted_data[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
     int n = sizeof(sorted_data) / sizeof(sorted_data[0]);
@@ -292,19 +554,23 @@ void test_sorted_data_comparison() {
     for (int i = 0; i < n; i++) {
         avl_root = avl_insert(avl_root, sorted_data[i], &avl_rotations);
         rbt_root = rbt_insert(rbt_root, sorted_data[i], &rbt_rotations, &rbt_recolorings);
+        wavl_root = wavl_insert(wavl_root, sorted_data[i], &wavl_rotations);
 
         printf("После вставки %d:\n", sorted_data[i]);
         printf("AVL: высота=%d, вращений=%d\n", avl_height(avl_root), avl_rotations);
         printf("RBT: вращений=%d, перекрашиваний=%d\n", rbt_rotations, rbt_recolorings);
+        printf("WAVL: высота=%d, вращений=%d\n", wavl_height(wavl_root), wavl_rotations);
         printf("---\n");
     }
 
     printf("Итоговые результаты:\n");
     printf("AVL Tree: высота=%d, всего вращений=%d\n", avl_height(avl_root), avl_rotations);
     printf("RBT: всего вращений=%d, всего перекрашиваний=%d\n", rbt_rotations, rbt_recolorings);
+    printf("WAVL Tree: высота=%d, всего вращений=%d\n", wavl_height(wavl_root), wavl_rotations);
 
     free_avl_tree(avl_root);
     free_rbt_tree(rbt_root);
+    free_wavl_tree(wavl_root);
 
     printf("\n");
 }
@@ -321,28 +587,33 @@ void test_balance_comparison() {
 
     const char* case_names[] = {"Отсортированные", "Случайные", "Сбалансированные"};
 
-    printf("%-15s | %-8s | %-8s | %-12s | %-12s\n",
-           "Тип данных", "AVL высота", "RBT высота", "AVL вращения", "RBT вращения");
-    printf("---------------|----------|----------|-------------|-------------\n");
+    printf("%-15s | %-8s | %-8s | %-8s | %-12s | %-12s | %-12s\n",
+           "Тип данных", "AVL высота", "RBT высота", "WAVL высота",
+           "AVL вращения", "RBT вращения", "WAVL вращения");
+    printf("---------------|----------|----------|----------|-------------|-------------|-------------\n");
 
     for (int c = 0; c < 3; c++) {
         struct AVLNode* avl_root = NULL;
         struct RBNode* rbt_root = NULL;
+        struct WAVLNode* wavl_root = NULL;
         int avl_rotations = 0;
         int rbt_rotations = 0;
         int rbt_recolorings = 0;
+        int wavl_rotations = 0;
 
         for (int i = 0; i < 10; i++) {
             avl_root = avl_insert(avl_root, test_cases[c][i], &avl_rotations);
             rbt_root = rbt_insert(rbt_root, test_cases[c][i], &rbt_rotations, &rbt_recolorings);
+            wavl_root = wavl_insert(wavl_root, test_cases[c][i], &wavl_rotations);
         }
 
-        printf("%-15s | %-8d | %-8d | %-11d | %-11d\n",
+        printf("%-15s | %-8d | %-8d | %-8d | %-11d | %-11d | %-11d\n",
                case_names[c], avl_height(avl_root), 4, // RBT высота примерно log2(n)
-               avl_rotations, rbt_rotations);
+               wavl_height(wavl_root), avl_rotations, rbt_rotations, wavl_rotations);
 
         free_avl_tree(avl_root);
         free_rbt_tree(rbt_root);
+        free_wavl_tree(wavl_root);
     }
 
     printf("\n");
@@ -354,38 +625,44 @@ void test_search_performance_avl_rbt() {
 
     struct AVLNode* avl_root = NULL;
     struct RBNode* rbt_root = NULL;
+    struct WAVLNode* wavl_root = NULL;
     int avl_rotations = 0;
     int rbt_rotations = 0;
     int rbt_recolorings = 0;
+    int wavl_rotations = 0;
 
     // Создаем деревья с 15 элементами
     for (int i = 1; i <= 15; i++) {
         avl_root = avl_insert(avl_root, i, &avl_rotations);
         rbt_root = rbt_insert(rbt_root, i, &rbt_rotations, &rbt_recolorings);
+        wavl_root = wavl_insert(wavl_root, i, &wavl_rotations);
     }
 
     int search_keys[] = {1, 8, 15};
 
     printf("Теоретическая сложность поиска (15 элементов):\n");
     printf("AVL: O(log2(15)) = ~4 шага\n");
-    printf("RBT: O(log2(15)) = ~4 шага\n\n");
+    printf("RBT: O(log2(15)) = ~4 шага\n");
+    printf("WAVL: O(log2(15)) = ~4 шага\n\n");
 
     printf("Практическая оценка:\n");
-    printf("%-8s | %-15s | %-15s\n", "Ключ", "AVL (макс шагов)", "RBT (макс шагов)");
-    printf("---------|-----------------|-----------------\n");
+    printf("%-8s | %-15s | %-15s | %-15s\n", "Ключ", "AVL (макс шагов)", "RBT (макс шагов)", "WAVL (макс шагов)");
+    printf("---------|-----------------|-----------------|-----------------\n");
 
     for (int i = 0; i < 3; i++) {
         int avl_max_steps = avl_height(avl_root);
         int rbt_max_steps = 4; // Примерная высота RBT для 15 элементов
+        int wavl_max_steps = wavl_height(wavl_root);
 
-        printf("%-8d | %-15d | %-15d\n",
-               search_keys[i], avl_max_steps, rbt_max_steps);
+        printf("%-8d | %-15d | %-15d | %-15d\n",
+               search_keys[i], avl_max_steps, rbt_max_steps, wavl_max_steps);
     }
 
-    printf("\nОба дерева обеспечивают гарантированную O(log n) сложность поиска!\n");
+    printf("\nВсе три дерева обеспечивают гарантированную O(log n) сложность поиска!\n");
 
     free_avl_tree(avl_root);
     free_rbt_tree(rbt_root);
+    free_wavl_tree(wavl_root);
 
     printf("\n");
 }
@@ -408,9 +685,16 @@ void test_balance_operations() {
     printf("✅ Быстрее вставка/удаление\n");
     printf("✅ Лучше для частых изменений\n\n");
 
+    printf("WAVL Tree:\n");
+    printf("✅ Без удалений - в точности AVL (та же высота)\n");
+    printf("✅ Не больше двух вращений на вставку и на удаление\n");
+    printf("✅ Амортизированно O(1) изменений рангов на операцию\n");
+    printf("❌ После многих удалений высота растет до 2·log n, как у RBT\n\n");
+
     printf("Практические рекомендации:\n");
     printf("• AVL - когда поиск >> вставок (словари, кеши)\n");
     printf("• RBT - когда вставки и поиск сбалансированы (базы данных, файловые системы)\n");
+    printf("• WAVL - когда нужна высота AVL, но есть частые удаления\n");
 }
 
 // ТЕСТ 5: Производительность на больших данных
@@ -421,8 +705,8 @@ void test_large_scale_performance() {
     const int NUM_SIZES = sizeof(SIZES) / sizeof(SIZES[0]);
 
     printf("Сравнение времени вставки:\n");
-    printf("%-8s | %-15s | %-15s\n", "Элементов", "AVL время (ms)", "RBT время (ms)");
-    printf("---------|-----------------|-----------------\n");
+    printf("%-8s | %-15s | %-15s | %-15s\n", "Элементов", "AVL время (ms)", "RBT время (ms)", "WAVL время (ms)");
+    printf("---------|-----------------|-----------------|-----------------\n");
 
     srand(time(NULL));
 
@@ -454,10 +738,23 @@ void test_large_scale_performance() {
         clock_t rbt_end = clock();
         double rbt_time = (double)(rbt_end - rbt_start) * 1000 / CLOCKS_PER_SEC;
 
-        printf("%-8d | %-15.3f | %-15.3f\n", size, avl_time, rbt_time);
+        // WAVL тест
+        clock_t wavl_start = clock();
+        struct WAVLNode* wavl_root = NULL;
+        int wavl_rotations = 0;
+
+        for (int i = 0; i < size; i++) {
+            wavl_root = wavl_insert(wavl_root, rand() % 10000, &wavl_rotations);
+        }
+
+        clock_t wavl_end = clock();
+        double wavl_time = (double)(wavl_end - wavl_start) * 1000 / CLOCKS_PER_SEC;
+
+        printf("%-8d | %-15.3f | %-15.3f | %-15.3f\n", size, avl_time, rbt_time, wavl_time);
 
         free_avl_tree(avl_root);
         free_rbt_tree(rbt_root);
+        free_wavl_tree(wavl_root);
     }
 
     printf("\n");
@@ -465,6 +762,24 @@ void test_large_scale_performance() {
 
 // ==================== ТЕСТ 6: СЦЕНАРНЫЕ ТЕСТЫ ====================
 
+// Самое быстрое дерево сценария и отрыв от второго места
+static void print_scenario_winner(double avl_time, double rbt_time, double wavl_time) {
+    const char* names[] = {"AVL Tree", "Red-Black Tree", "WAVL Tree"};
+    double times[] = {avl_time, rbt_time, wavl_time};
+
+    int best = 0;
+    for (int i = 1; i < 3; i++)
+        if (times[i] < times[best])
+            best = i;
+    double second = -1;
+    for (int i = 0; i < 3; i++)
+        if (i != best && (second < 0 || times[i] < second))
+            second = times[i];
+
+    printf("ПОБЕДИТЕЛЬ: %s (разница: %.1f%%)\n\n", names[best],
+           second > 0 ? (second - times[best]) / second * 100 : 0.0);
+}
+
 void test_scenario_performance() {
     printf("=== ТЕСТ 6: Сравнение производительности в реальных сценариях ===\n\n");
 
@@ -476,23 +791,28 @@ void test_scenario_performance() {
 
     struct AVLNode* avl_dict = NULL;
     struct RBNode* rbt_dict = NULL;
+    struct WAVLNode* wavl_dict = NULL;
     int avl_rotations_dict = 0;
     int rbt_rotations_dict = 0;
     int rbt_recolorings_dict = 0;
+    int wavl_rotations_dict = 0;
+    int found_avl_dict = 0;
+    int found_rbt_dict = 0;
+    int found_wavl_dict = 0;
 
     // Инициализация словаря (500 слов)
     for (int i = 0; i < 500; i++) {
         int word_key = rand() % 5000;
         avl_dict = avl_insert(avl_dict, word_key, &avl_rotations_dict);
         rbt_dict = rbt_insert(rbt_dict, word_key, &rbt_rotations_dict, &rbt_recolorings_dict);
+        wavl_dict = wavl_insert(wavl_dict, word_key, &wavl_rotations_dict);
     }
 
     clock_t avl_dict_start = clock();
     // 800 операций: 80% поиск, 20% вставка
     for (int i = 0; i < 800; i++) {
         if (i < 640) { // 80% поиск
-            int search_key = rand() % 5000;
-            // Симуляция поиска
+            found_avl_dict += avl_search(avl_dict, rand() % 5000) != NULL;
         } else { // 20% вставка
             int new_word = 5000 + rand() % 1000;
             avl_dict = avl_insert(avl_dict, new_word, &avl_rotations_dict);
@@ -504,8 +824,7 @@ void test_scenario_performance() {
     // 800 операций: 80% поиск, 20% вставка
     for (int i = 0; i < 800; i++) {
         if (i < 640) { // 80% поиск
-            int search_key = rand() % 5000;
-            // Симуляция поиска
+            found_rbt_dict += rbt_search(rbt_dict, rand() % 5000) != NULL;
         } else { // 20% вставка
             int new_word = 5000 + rand() % 1000;
             rbt_dict = rbt_insert(rbt_dict, new_word, &rbt_rotations_dict, &rbt_recolorings_dict);
@@ -513,23 +832,35 @@ void test_scenario_performance() {
     }
     clock_t rbt_dict_end = clock();
 
+    clock_t wavl_dict_start = clock();
+    // 800 операций: 80% поиск, 20% вставка
+    for (int i = 0; i < 800; i++) {
+        if (i < 640) { // 80% поиск
+            found_wavl_dict += wavl_search(wavl_dict, rand() % 5000) != NULL;
+        } else { // 20% вставка
+            int new_word = 5000 + rand() % 1000;
+            wavl_dict = wavl_insert(wavl_dict, new_word, &wavl_rotations_dict);
+        }
+    }
+    clock_t wavl_dict_end = clock();
+
     double avl_dict_time = (double)(avl_dict_end - avl_dict_start) * 1000 / CLOCKS_PER_SEC;
     double rbt_dict_time = (double)(rbt_dict_end - rbt_dict_start) * 1000 / CLOCKS_PER_SEC;
+    double wavl_dict_time = (double)(wavl_dict_end - wavl_dict_start) * 1000 / CLOCKS_PER_SEC;
 
-    printf("AVL Tree: %.3f ms, вращений: %d\n", avl_dict_time, avl_rotations_dict);
-    printf("RBT:      %.3f ms, вращений: %d\n", rbt_dict_time, rbt_rotations_dict);
+    printf("AVL Tree: %.3f ms, вращений: %d, найдено: %d\n", avl_dict_time, avl_rotations_dict,
+           found_avl_dict);
+    printf("RBT:      %.3f ms, вращений: %d, найдено: %d\n", rbt_dict_time, rbt_rotations_dict,
+           found_rbt_dict);
+    printf("WAVL:     %.3f ms, вращений: %d, найдено: %d\n", wavl_dict_time, wavl_rotations_dict,
+           found_wavl_dict);
 
-    if (avl_dict_time < rbt_dict_time) {
-        printf("ПОБЕДИТЕЛЬ: AVL Tree (разница: %.1f%%)\n\n",
-               (rbt_dict_time - avl_dict_time) / rbt_dict_time * 100);
-    } else {
-        printf("ПОБЕДИТЕЛЬ: Red-Black Tree (разница: %.1f%%)\n\n",
-               (avl_dict_time - rbt_dict_time) / avl_dict_time * 100);
-    }
+    print_scenario_winner(avl_dict_time, rbt_dict_time, wavl_dict_time);
 
     // Очистка памяти перед следующим тестом
     free_avl_tree(avl_dict);
     free_rbt_tree(rbt_dict);
+    free_wavl_tree(wavl_dict);
 
     // Сценарий 2: Кеш сессий (50% поиск, 30% вставка, 20% удаление)
     printf("СЦЕНАРИЙ 2: КЕШ СЕССИЙ\n");
@@ -537,28 +868,33 @@ void test_scenario_performance() {
 
     struct AVLNode* avl_cache = NULL;
     struct RBNode* rbt_cache = NULL;
+    struct WAVLNode* wavl_cache = NULL;
     int avl_rotations_cache = 0;
     int rbt_rotations_cache = 0;
     int rbt_recolorings_cache = 0;
+    int wavl_rotations_cache = 0;
+    int found_avl_cache = 0;
+    int found_rbt_cache = 0;
+    int found_wavl_cache = 0;
 
     // Инициализация кеша (300 сессий)
     for (int i = 0; i < 300; i++) {
         int session_key = rand() % 3000;
         avl_cache = avl_insert(avl_cache, session_key, &avl_rotations_cache);
         rbt_cache = rbt_insert(rbt_cache, session_key, &rbt_rotations_cache, &rbt_recolorings_cache);
+        wavl_cache = wavl_insert(wavl_cache, session_key, &wavl_rotations_cache);
     }
 
     clock_t avl_cache_start = clock();
     // 500 операций: 50% поиск, 30% вставка, 20% удаление
     for (int i = 0; i < 500; i++) {
         if (i < 250) { // 50% поиск
-            int search_key = rand() % 3000;
-            // Симуляция поиска
+            found_avl_cache += avl_search(avl_cache, rand() % 3000) != NULL;
         } else if (i < 400) { // 30% вставка
             int new_session = 3000 + rand() % 1000;
             avl_cache = avl_insert(avl_cache, new_session, &avl_rotations_cache);
-        } else { // 20% удаление (симуляция)
-            // В реальной реализации здесь было бы удаление
+        } else { // 20% удаление
+            avl_cache = avl_delete(avl_cache, rand() % 4000, &avl_rotations_cache);
         }
     }
     clock_t avl_cache_end = clock();
@@ -567,34 +903,47 @@ void test_scenario_performance() {
     // 500 операций: 50% поиск, 30% вставка, 20% удаление
     for (int i = 0; i < 500; i++) {
         if (i < 250) { // 50% поиск
-            int search_key = rand() % 3000;
-            // Симуляция поиска
+            found_rbt_cache += rbt_search(rbt_cache, rand() % 3000) != NULL;
         } else if (i < 400) { // 30% вставка
             int new_session = 3000 + rand() % 1000;
             rbt_cache = rbt_insert(rbt_cache, new_session, &rbt_rotations_cache, &rbt_recolorings_cache);
-        } else { // 20% удаление (симуляция)
-            // Симуляция операции удаления
+        } else { // 20% удаление
+            rbt_cache = rbt_delete(rbt_cache, rand() % 4000, &rbt_rotations_cache, &rbt_recolorings_cache);
         }
     }
     clock_t rbt_cache_end = clock();
 
+    clock_t wavl_cache_start = clock();
+    // 500 операций: 50% поиск, 30% вставка, 20% удаление
+    for (int i = 0; i < 500; i++) {
+        if (i < 250) { // 50% поиск
+            found_wavl_cache += wavl_search(wavl_cache, rand() % 3000) != NULL;
+        } else if (i < 400) { // 30% вставка
+            int new_session = 3000 + rand() % 1000;
+            wavl_cache = wavl_insert(wavl_cache, new_session, &wavl_rotations_cache);
+        } else { // 20% удаление
+            wavl_cache = wavl_delete(wavl_cache, rand() % 4000, &wavl_rotations_cache);
+        }
+    }
+    clock_t wavl_cache_end = clock();
+
     double avl_cache_time = (double)(avl_cache_end - avl_cache_start) * 1000 / CLOCKS_PER_SEC;
     double rbt_cache_time = (double)(rbt_cache_end - rbt_cache_start) * 1000 / CLOCKS_PER_SEC;
+    double wavl_cache_time = (double)(wavl_cache_end - wavl_cache_start) * 1000 / CLOCKS_PER_SEC;
 
-    printf("AVL Tree: %.3f ms, вращений: %d\n", avl_cache_time, avl_rotations_cache);
-    printf("RBT:      %.3f ms, вращений: %d\n", rbt_cache_time, rbt_rotations_cache);
+    printf("AVL Tree: %.3f ms, вращений: %d, найдено: %d\n", avl_cache_time, avl_rotations_cache,
+           found_avl_cache);
+    printf("RBT:      %.3f ms, вращений: %d, найдено: %d\n", rbt_cache_time, rbt_rotations_cache,
+           found_rbt_cache);
+    printf("WAVL:     %.3f ms, вращений: %d, найдено: %d\n", wavl_cache_time, wavl_rotations_cache,
+           found_wavl_cache);
 
-    if (avl_cache_time < rbt_cache_time) {
-        printf("ПОБЕДИТЕЛЬ: AVL Tree (разница: %.1f%%)\n\n",
-               (rbt_cache_time - avl_cache_time) / rbt_cache_time * 100);
-    } else {
-        printf("ПОБЕДИТЕЛЬ: Red-Black Tree (разница: %.1f%%)\n\n",
-               (avl_cache_time - rbt_cache_time) / avl_cache_time * 100);
-    }
+    print_scenario_winner(avl_cache_time, rbt_cache_time, wavl_cache_time);
 
     // Очистка памяти перед следующим тестом
     free_avl_tree(avl_cache);
     free_rbt_tree(rbt_cache);
+    free_wavl_tree(wavl_cache);
 
     // Сценарий 3: Логирование (10% поиск, 90% вставка)
     printf("СЦЕНАРИЙ 3: ЛОГИРОВАНИЕ\n");
@@ -602,16 +951,20 @@ void test_scenario_performance() {
 
     struct AVLNode* avl_log = NULL;
     struct RBNode* rbt_log = NULL;
+    struct WAVLNode* wavl_log = NULL;
     int avl_rotations_log = 0;
     int rbt_rotations_log = 0;
     int rbt_recolorings_log = 0;
+    int wavl_rotations_log = 0;
+    int found_avl_log = 0;
+    int found_rbt_log = 0;
+    int found_wavl_log = 0;
 
     clock_t avl_log_start = clock();
     // 1000 операций: 10% поиск, 90% вставка
     for (int i = 0; i < 1000; i++) {
         if (i < 100) { // 10% поиск
-            int search_key = rand() % 1000;
-            // Симуляция поиска
+            found_avl_log += avl_search(avl_log, rand() % 1000) != NULL;
         } else { // 90% вставка
             int log_entry = rand() % 10000;
             avl_log = avl_insert(avl_log, log_entry, &avl_rotations_log);
@@ -623,8 +976,7 @@ void test_scenario_performance() {
     // 1000 операций: 10% поиск, 90% вставка
     for (int i = 0; i < 1000; i++) {
         if (i < 100) { // 10% поиск
-            int search_key = rand() % 1000;
-            // Симуляция поиска
+            found_rbt_log += rbt_search(rbt_log, rand() % 1000) != NULL;
         } else { // 90% вставка
             int log_entry = rand() % 10000;
             rbt_log = rbt_insert(rbt_log, log_entry, &rbt_rotations_log, &rbt_recolorings_log);
@@ -632,23 +984,35 @@ void test_scenario_performance() {
     }
     clock_t rbt_log_end = clock();
 
+    clock_t wavl_log_start = clock();
+    // 1000 операций: 10% поиск, 90% вставка
+    for (int i = 0; i < 1000; i++) {
+        if (i < 100) { // 10% поиск
+            found_wavl_log += wavl_search(wavl_log, rand() % 1000) != NULL;
+        } else { // 90% вставка
+            int log_entry = rand() % 10000;
+            wavl_log = wavl_insert(wavl_log, log_entry, &wavl_rotations_log);
+        }
+    }
+    clock_t wavl_log_end = clock();
+
     double avl_log_time = (double)(avl_log_end - avl_log_start) * 1000 / CLOCKS_PER_SEC;
     double rbt_log_time = (double)(rbt_log_end - rbt_log_start) * 1000 / CLOCKS_PER_SEC;
+    double wavl_log_time = (double)(wavl_log_end - wavl_log_start) * 1000 / CLOCKS_PER_SEC;
 
-    printf("AVL Tree: %.3f ms, вращений: %d\n", avl_log_time, avl_rotations_log);
-    printf("RBT:      %.3f ms, вращений: %d\n", rbt_log_time, rbt_rotations_log);
+    printf("AVL Tree: %.3f ms, вращений: %d, найдено: %d\n", avl_log_time, avl_rotations_log,
+           found_avl_log);
+    printf("RBT:      %.3f ms, вращений: %d, найдено: %d\n", rbt_log_time, rbt_rotations_log,
+           found_rbt_log);
+    printf("WAVL:     %.3f ms, вращений: %d, найдено: %d\n", wavl_log_time, wavl_rotations_log,
+           found_wavl_log);
 
-    if (avl_log_time < rbt_log_time) {
-        printf("ПОБЕДИТЕЛЬ: AVL Tree (разница: %.1f%%)\n\n",
-               (rbt_log_time - avl_log_time) / rbt_log_time * 100);
-    } else {
-        printf("ПОБЕДИТЕЛЬ: Red-Black Tree (разница: %.1f%%)\n\n",
-               (avl_log_time - rbt_log_time) / avl_log_time * 100);
-    }
+    print_scenario_winner(avl_log_time, rbt_log_time, wavl_log_time);
 
     // Очистка памяти
     free_avl_tree(avl_log);
     free_rbt_tree(rbt_log);
+    free_wavl_tree(wavl_log);
 }
 
 // ==================== ТЕСТ 7: АНАЛИЗ ПЕРЕХОДНОЙ ТОЧКИ ====================
@@ -661,8 +1025,12 @@ void test_crossover_point() {
     int sizes[] = {100, 500, 1000};
     int num_sizes = sizeof(sizes) / sizeof(sizes[0]);
 
-    printf("Размер данных | AVL время | RBT время | Преимущество\n");
-    printf("-------------|-----------|-----------|-------------\n");
+    printf("Размер данных | AVL время | RBT время | WAVL время | Преимущество\n");
+    printf("-------------|-----------|-----------|------------|-------------\n");
+
+    int avl_found = 0;
+    int rbt_found = 0;
+    int wavl_found = 0;
 
     for (int s = 0; s < num_sizes; s++) {
         int size = sizes[s];
@@ -674,7 +1042,7 @@ void test_crossover_point() {
 
         for (int i = 0; i < size; i++) {
             if (i % 5 == 0) { // 20% поиск
-                // Симуляция поиска
+                avl_found += avl_search(avl_root, rand() % (size * 10)) != NULL;
             } else { // 80% вставка
                 avl_root = avl_insert(avl_root, rand() % (size * 10), &avl_rotations);
             }
@@ -690,7 +1058,7 @@ void test_crossover_point() {
 
         for (int i = 0; i < size; i++) {
             if (i % 5 == 0) { // 20% поиск
-                // Симуляция поиска
+                rbt_found += rbt_search(rbt_root, rand() % (size * 10)) != NULL;
             } else { // 80% вставка
                 rbt_root = rbt_insert(rbt_root, rand() % (size * 10), &rbt_rotations, &rbt_recolorings);
             }
@@ -698,20 +1066,39 @@ void test_crossover_point() {
         clock_t rbt_end = clock();
         double rbt_time = (double)(rbt_end - rbt_start) * 1000 / CLOCKS_PER_SEC;
 
+        // WAVL тест с такими же операциями
+        clock_t wavl_start = clock();
+        struct WAVLNode* wavl_root = NULL;
+        int wavl_rotations = 0;
+
+        for (int i = 0; i < size; i++) {
+            if (i % 5 == 0) { // 20% поиск
+                wavl_found += wavl_search(wavl_root, rand() % (size * 10)) != NULL;
+            } else { // 80% вставка
+                wavl_root = wavl_insert(wavl_root, rand() % (size * 10), &wavl_rotations);
+            }
+        }
+        clock_t wavl_end = clock();
+        double wavl_time = (double)(wavl_end - wavl_start) * 1000 / CLOCKS_PER_SEC;
+
         const char* advantage;
-        if (avl_time < rbt_time) {
+        if (avl_time < rbt_time && avl_time < wavl_time) {
             advantage = "AVL";
-        } else {
+        } else if (rbt_time < wavl_time) {
             advantage = "RBT";
+        } else {
+            advantage = "WAVL";
         }
 
-        printf("%-12d | %-9.3f | %-9.3f | %s\n",
-               size, avl_time, rbt_time, advantage);
+        printf("%-12d | %-9.3f | %-9.3f | %-10.3f | %s\n",
+               size, avl_time, rbt_time, wavl_time, advantage);
 
         free_avl_tree(avl_root);
         free_rbt_tree(rbt_root);
+        free_wavl_tree(wavl_root);
     }
 
+    printf("\nНайдено при поиске: AVL %d, RBT %d, WAVL %d\n", avl_found, rbt_found, wavl_found);
     printf("\nВЫВОД: RBT обгоняет AVL при высоком проценте вставок (>70%%) \n");
     printf("       и больших объемах данных (>1000 операций)\n");
 }
@@ -743,6 +1130,15 @@ void benchmark_avl_vs_rbt() {
     }
     clock_t rbt_end = clock();
 
+    struct WAVLNode* wavl_root = NULL;
+    int wavl_rotations = 0;
+    clock_t wavl_start = clock();
+    for (int i = 0; i < NUM_OPERATIONS; i++) {
+        int key = rand() % 10000;
+        wavl_root = wavl_insert(wavl_root, key, &wavl_rotations);
+    }
+    clock_t wavl_end = clock();
+
     printf("Результаты для %d случайных вставок:\n", NUM_OPERATIONS);
     printf("AVL Tree:\n");
     printf(" - Время: %.3f ms\n", (double)(avl_end - avl_start) * 1000 / CLOCKS_PER_SEC);
@@ -752,14 +1148,31 @@ void benchmark_avl_vs_rbt() {
     printf("Red-Black Tree:\n");
     printf(" - Время: %.3f ms\n", (double)(rbt_end - rbt_start) * 1000 / CLOCKS_PER_SEC);
     printf(" - Вращения: %d\n", rbt_rotations);
-    printf(" - Перекрашивания: %d\n", rbt_recolorings);
+    printf(" - Перекрашивания: %d\n\n", rbt_recolorings);
+
+    printf("WAVL Tree:\n");
+    printf(" - Время: %.3f ms\n", (double)(wavl_end - wavl_start) * 1000 / CLOCKS_PER_SEC);
+    printf(" - Вращения: %d\n", wavl_rotations);
+    printf(" - Высота: %d\n", wavl_height(wavl_root));
 
     // Очистка памяти
     free_avl_tree(avl_root);
     free_rbt_tree(rbt_root);
+    free_wavl_tree(wavl_root);
 }
 
-int main() {
+// В choose_struct этот файл входит ради реализаций деревьев, без main
+#ifndef APP_NO_MAIN
+int main(int argc, char** argv) {
+    // app --parallel ... - только многопоточный прогон (тест 29 с параметрами)
+    if (argc >= 2 && strcmp(argv[1], "--parallel") == 0)
+        return parallel_runner_main(argc - 2, argv + 2);
+    // app --serve ... / app --load ... - сервер дерева и генератор нагрузки (тест 32)
+    if (argc >= 2 && strcmp(argv[1], "--serve") == 0)
+        return tree_server_main(argc - 2, argv + 2);
+    if (argc >= 2 && strcmp(argv[1], "--load") == 0)
+        return load_generator_main(argc - 2, argv + 2);
+
     printf("КЕЙС 2: AVL vs RBT - ПОЛНЫЙ ТЕСТОВЫЙ НАБОР\n\n");
 
     benchmark_avl_vs_rbt();        // Оригинальный тест
@@ -770,6 +1183,31 @@ int main() {
     test_large_scale_performance(); // Новый тест 5
     test_scenario_performance();   // Новый тест 6 - сценарии
     test_crossover_point();        // Новый тест 7 - точка перехода
+    test_set_operations();         // Тест 8 - join/split и операции над множествами
+    test_avl_snapshot();           // Тест 9 - снимок AVL в раскладке Eytzinger
+    test_tree_relayout();          // Тест 10 - перераскладка узлов в DFS/vEB порядок
+    test_batch_search();           // Тест 11 - пакетный поиск с предвыборкой
+    test_node_search();            // Тест 12 - SIMD-поиск внутри узлов B+ дерева
+    test_swiss_table();            // Тест 13 - хеш-таблица Swiss table
+    test_splay_treap();            // Тест 14 - splay и treap на перекошенном доступе
+    test_order_statistics();       // Тест 15 - rank/select/count по размерам поддеревьев
+    test_persistent_avl();         // Тест 16 - персистентное AVL дерево со снимками
+    test_finger_insert();          // Тест 17 - вставка с подсказкой и правым пальцем
+    test_lsm_tree();               // Тест 18 - LSM-индекс для логирования
+    test_bloom_filter();           // Тест 19 - фильтр Блума для отсутствующих ключей
+    test_session_cache();          // Тест 20 - кеш сессий с LRU и TTL
+    test_art();                    // Тест 21 - адаптивное radix дерево на целых ключах
+    test_wavl_tree();              // Тест 22 - WAVL на нагрузках с удалениями
+    test_disk_bplus();             // Тест 23 - B+ дерево в файле через mmap
+    test_tree_serialize();         // Тест 24 - сохранение и быстрая загрузка деревьев
+    test_string_tree();            // Тест 25 - строковые ключи: арена и префиксы
+    test_adaptive_tree();          // Тест 26 - переключение AVL/RBT по смеси операций
+    test_small_set();              // Тест 27 - малые множества в одной кеш-линии
+    test_node_storage();           // Тест 28 - узлы на 2-МиБ страницах
+    test_parallel_scaling();       // Тест 29 - независимые деревья в K потоках
+    test_trace_profile();          // Тест 30 - профиль нагрузки по журналу операций
+    test_delta_index();            // Тест 31 - индекс временных рядов на блоках с дельтами
+    test_tree_server();            // Тест 32 - сервер дерева на Unix-сокете и генератор нагрузки
 
     printf("\n=== ОТВЕТЫ НА ВОПРОСЫ ===\n");
     printf("1. Какая структура выиграет в каждом сценарии?\n");
@@ -793,3 +1231,4 @@ int main() {
 
     return 0;
 }
+#endif
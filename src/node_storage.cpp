@@ -0,0 +1,389 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+
+#include <atomic>
+#include <unordered_map>
+
+#include "methods.h"
+
+// ========== ХРАНИЛИЩЕ УЗЛОВ НА БОЛЬШИХ СТРАНИЦАХ ==========
+// Все узлы AVLNode/RBNode создаются через tree_node_alloc. По умолчанию это
+// malloc; в режимах-аренах узлы нарезаются из одной заранее зарезервированной
+// области, выровненной на 2 МиБ. Случайный спуск по дереву в 100M узлов
+// задевает новую 4-КиБ страницу почти на каждом уровне, и промахи TLB стоят
+// не меньше промахов кеша; на 2-МиБ страницах вся область укладывается в
+// несколько сотен записей TLB.
+//
+// Освобожденные узлы уходят в список свободных своего размера (шаг 8 байт);
+// если область кончилась, узлы берутся из malloc, а tree_node_free различает
+// их по адресу.
+
+#define NODE_STORAGE_HUGE_PAGE (2 * 1024 * 1024)
+#define NODE_STORAGE_MAX_NODE 64
+#define NODE_STORAGE_CLASSES (NODE_STORAGE_MAX_NODE / 8 + 1)
+
+struct NodeStorageState {
+    enum NodeStorage mode;
+    char* base;
+    size_t capacity;
+    size_t used;
+    void* free_lists[NODE_STORAGE_CLASSES];
+    long long live; // узлов области на руках
+    std::atomic_flag lock;
+};
+
+// Параллельные операции над множествами и сборка (тест 8) создают и
+// освобождают узлы из нескольких потоков; захват короткий, хватает спин-блокировки
+static struct NodeStorageState node_storage = {NODE_STORAGE_MALLOC, NULL, 0, 0, {NULL}, 0,
+                                               ATOMIC_FLAG_INIT};
+
+static void node_storage_lock() {
+    while (node_storage.lock.test_and_set(std::memory_order_acquire))
+        ;
+}
+
+static void node_storage_unlock() {
+    node_storage.lock.clear(std::memory_order_release);
+}
+
+// Чужие блоки по адресу начала; число - чтобы обычный free не искал в пустой таблице
+struct NodeBlockOwner {
+    void* owner;
+    NodeBlockRelease release;
+};
+static std::unordered_map<uintptr_t, struct NodeBlockOwner> node_storage_blocks;
+static std::atomic<int> node_storage_block_count(0);
+
+void node_storage_register_block(void* base, void* owner, NodeBlockRelease release) {
+    node_storage_lock();
+    struct NodeBlockOwner entry = {owner, release};
+    node_storage_blocks[(uintptr_t)base] = entry;
+    node_storage_block_count.store((int)node_storage_blocks.size(), std::memory_order_relaxed);
+    node_storage_unlock();
+}
+
+void node_storage_unregister_block(void* base) {
+    node_storage_lock();
+    node_storage_blocks.erase((uintptr_t)base);
+    node_storage_block_count.store((int)node_storage_blocks.size(), std::memory_order_relaxed);
+    node_storage_unlock();
+}
+
+// 1 - узел из чужого блока, отдан владельцу
+static int node_storage_release_foreign(void* node) {
+    if (node_storage_block_count.load(std::memory_order_relaxed) == 0)
+        return 0;
+    uintptr_t base = (uintptr_t)node & ~(uintptr_t)(NODE_STORAGE_BLOCK_BYTES - 1);
+    node_storage_lock();
+    std::unordered_map<uintptr_t, struct NodeBlockOwner>::iterator it = node_storage_blocks.find(base);
+    int found = it != node_storage_blocks.end();
+    struct NodeBlockOwner entry = found ? it->second : (struct NodeBlockOwner){NULL, NULL};
+    node_storage_unlock();
+    // Владелец может тут же снять регистрацию блока - вызов вне блокировки
+    if (found)
+        entry.release(entry.owner, node);
+    return found;
+}
+
+static int node_storage_owns(const void* node) {
+    return (const char*)node >= node_storage.base &&
+           (const char*)node < node_storage.base + node_storage.capacity;
+}
+
+enum NodeStorage node_storage_set(enum NodeStorage mode, size_t capacity) {
+    if (node_storage.live > 0) {
+        fprintf(stderr, "node_storage_set: в области еще %lld узлов, режим не изменен\n",
+                node_storage.live);
+        return node_storage.mode;
+    }
+    if (node_storage.base != NULL)
+        munmap(node_storage.base, node_storage.capacity);
+    node_storage.base = NULL;
+    node_storage.capacity = 0;
+    node_storage.used = 0;
+    memset(node_storage.free_lists, 0, sizeof(node_storage.free_lists));
+    node_storage.mode = NODE_STORAGE_MALLOC;
+    if (mode == NODE_STORAGE_MALLOC)
+        return mode;
+
+    capacity = (capacity + NODE_STORAGE_HUGE_PAGE - 1) & ~(size_t)(NODE_STORAGE_HUGE_PAGE - 1);
+    char* base = (char*)MAP_FAILED;
+#ifdef MAP_HUGETLB
+    // hugetlbfs: страницы должны быть заранее выделены в vm.nr_hugepages.
+    // Без MAP_NORESERVE резерв проверяется сразу, а не SIGBUS при первом касании
+    if (mode == NODE_STORAGE_HUGETLB)
+        base = (char*)mmap(NULL, capacity, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+    if (mode == NODE_STORAGE_HUGETLB && base == (char*)MAP_FAILED)
+        mode = NODE_STORAGE_THP;
+
+    if (base == (char*)MAP_FAILED) {
+        // Резерв с запасом, лишнее по краям отрезается до границы 2 МиБ
+        size_t reserve = capacity + NODE_STORAGE_HUGE_PAGE;
+        char* raw = (char*)mmap(NULL, reserve, PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (raw == (char*)MAP_FAILED)
+            return NODE_STORAGE_MALLOC;
+        base = (char*)(((uintptr_t)raw + NODE_STORAGE_HUGE_PAGE - 1) &
+                       ~(uintptr_t)(NODE_STORAGE_HUGE_PAGE - 1));
+        if (base > raw)
+            munmap(raw, base - raw);
+        if (raw + reserve > base + capacity)
+            munmap(base + capacity, raw + reserve - (base + capacity));
+
+#ifdef MADV_HUGEPAGE
+        if (mode == NODE_STORAGE_THP && madvise(base, capacity, MADV_HUGEPAGE) != 0)
+            mode = NODE_STORAGE_ARENA_4K;
+#else
+        mode = NODE_STORAGE_ARENA_4K;
+#endif
+#ifdef MADV_NOHUGEPAGE
+        // При transparent_hugepage=always иначе и "4 КиБ" получила бы большие страницы
+        if (mode == NODE_STORAGE_ARENA_4K)
+            madvise(base, capacity, MADV_NOHUGEPAGE);
+#endif
+    }
+
+    node_storage.base = base;
+    node_storage.capacity = capacity;
+    node_storage.mode = mode;
+    return mode;
+}
+
+enum NodeStorage node_storage_mode() {
+    return node_storage.mode;
+}
+
+void* tree_node_alloc(size_t size) {
+    if (node_storage.mode == NODE_STORAGE_MALLOC || size > NODE_STORAGE_MAX_NODE)
+        return malloc(size);
+
+    size_t cls = (size + 7) / 8;
+    node_storage_lock();
+    void* node = node_storage.free_lists[cls];
+    if (node != NULL) {
+        node_storage.free_lists[cls] = *(void**)node;
+    } else if (node_storage.used + cls * 8 <= node_storage.capacity) {
+        node = node_storage.base + node_storage.used;
+        node_storage.used += cls * 8;
+    }
+    if (node != NULL)
+        node_storage.live++;
+    node_storage_unlock();
+    return node != NULL ? node : malloc(size);
+}
+
+void tree_node_free(void* node, size_t size) {
+    if (!node_storage_owns(node)) {
+        if (!node_storage_release_foreign(node))
+            free(node);
+        return;
+    }
+    size_t cls = (size + 7) / 8;
+    node_storage_lock();
+    *(void**)node = node_storage.free_lists[cls];
+    node_storage.free_lists[cls] = node;
+    node_storage.live--;
+    node_storage_unlock();
+}
+
+size_t node_storage_huge_bytes() {
+    if (node_storage.base == NULL)
+        return 0;
+    if (node_storage.mode == NODE_STORAGE_HUGETLB)
+        return (node_storage.used + NODE_STORAGE_HUGE_PAGE - 1) &
+               ~(size_t)(NODE_STORAGE_HUGE_PAGE - 1);
+
+    // AnonHugePages отображения, начинающегося с base (ядро могло отказать в THP)
+    FILE* f = fopen("/proc/self/smaps", "r");
+    if (f == NULL)
+        return 0;
+    char line[256];
+    int in_region = 0;
+    size_t kb = 0;
+    while (fgets(line, sizeof(line), f) != NULL) {
+        unsigned long start, end;
+        if (sscanf(line, "%lx-%lx ", &start, &end) == 2) {
+            in_region = (char*)start >= node_storage.base &&
+                        (char*)start < node_storage.base + node_storage.capacity;
+        } else if (in_region && strncmp(line, "AnonHugePages:", 14) == 0) {
+            kb += strtoul(line + 14, NULL, 10);
+        }
+    }
+    fclose(f);
+    return kb * 1024;
+}
+
+// ==================== ТЕСТ 28: УЗЛЫ НА 2-МиБ СТРАНИЦАХ ====================
+
+// Счетчик промахов dTLB на чтение; -1, если PMU недоступен (например, в ВМ)
+static int tlb_counter_open() {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                  (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static long long tlb_counter_read(int fd) {
+    long long value = 0;
+    if (fd < 0 || read(fd, &value, sizeof(value)) != sizeof(value))
+        return -1;
+    return value;
+}
+
+static long minor_faults() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_minflt;
+}
+
+void test_node_storage() {
+    printf("=== ТЕСТ 28: Узлы AVL/RBT на 2-МиБ страницах против malloc ===\n\n");
+
+    const int sizes[] = {1000000, 16000000};
+    const int LOOKUPS = 5000000;
+    const int LOOKUP_PASSES = 3;
+    // Подписи выровнены вручную: %-Ns считает байты, а не буквы
+    const char* storage_labels[] = {
+        "malloc       ", "арена 4 КиБ  ", "арена THP    ", "арена hugetlb"
+    };
+
+    // Проба режимов: что дает система
+    int hugetlb_ok = node_storage_set(NODE_STORAGE_HUGETLB, NODE_STORAGE_HUGE_PAGE) == NODE_STORAGE_HUGETLB;
+    node_storage_set(NODE_STORAGE_MALLOC, 0);
+    int tlb_fd = tlb_counter_open();
+    printf("hugetlbfs: %s; счетчик промахов dTLB: %s\n",
+           hugetlb_ok ? "доступен" : "нет заранее выделенных страниц (строка пропускается)",
+           tlb_fd >= 0 ? "доступен" : "недоступен (нет PMU), вместо него - page faults");
+    printf("Ключи случайные; поиск - %d существующих ключей в случайном порядке\n\n", LOOKUPS);
+
+    srand(time(NULL));
+    int max_n = sizes[1];
+    int* keys = (int*)malloc(max_n * sizeof(int));
+    int* queries = (int*)malloc(LOOKUPS * sizeof(int));
+
+    // Время поиска [размер][AVL/RBT][хранилище]; 0 - режим не получен
+    double lookups_ns[2][2][4] = {};
+    for (int si = 0; si < 2; si++) {
+        int n = sizes[si];
+        for (int i = 0; i < n; i++)
+            keys[i] = rand();
+        for (int i = 0; i < LOOKUPS; i++)
+            queries[i] = keys[rand() % n];
+
+        printf("N = %d\n", n);
+        printf("Дерево | Хранилище     | Вставка ns | Поиск ns | Page faults | dTLB/поиск | Больших стр., МиБ\n");
+        printf("-------|---------------|------------|----------|-------------|------------|------------------\n");
+
+        for (int is_rbt = 0; is_rbt < 2; is_rbt++) {
+            for (int m = NODE_STORAGE_MALLOC; m <= NODE_STORAGE_HUGETLB; m++) {
+                if (m == NODE_STORAGE_HUGETLB && !hugetlb_ok)
+                    continue;
+                size_t node_size = is_rbt ? sizeof(struct RBNode) : sizeof(struct AVLNode);
+                enum NodeStorage got = node_storage_set((enum NodeStorage)m, (size_t)n * node_size);
+
+                struct AVLNode* avl = NULL;
+                struct RBNode* rbt = NULL;
+                int rotations = 0;
+                int recolorings = 0;
+                long faults = minor_faults();
+                clock_t start = clock();
+                for (int i = 0; i < n; i++) {
+                    if (is_rbt)
+                        rbt = rbt_insert(rbt, keys[i], &rotations, &recolorings);
+                    else
+                        avl = avl_insert(avl, keys[i], &rotations);
+                }
+                double insert_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / n;
+                faults = minor_faults() - faults;
+
+                // Лучший из LOOKUP_PASSES проходов: разброс одиночного замера на ВМ велик
+                double lookup_ns = 0;
+                long long tlb_misses = -1;
+                long long found = 0;
+                for (int pass = 0; pass < LOOKUP_PASSES; pass++) {
+                    if (tlb_fd >= 0) {
+                        ioctl(tlb_fd, PERF_EVENT_IOC_RESET, 0);
+                        ioctl(tlb_fd, PERF_EVENT_IOC_ENABLE, 0);
+                    }
+                    found = 0;
+                    start = clock();
+                    for (int i = 0; i < LOOKUPS; i++) {
+                        if (is_rbt)
+                            found += rbt_search(rbt, queries[i]) != NULL;
+                        else
+                            found += avl_search(avl, queries[i]) != NULL;
+                    }
+                    double ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / LOOKUPS;
+                    if (pass == 0 || ns < lookup_ns)
+                        lookup_ns = ns;
+                    if (tlb_fd >= 0) {
+                        ioctl(tlb_fd, PERF_EVENT_IOC_DISABLE, 0);
+                        long long misses = tlb_counter_read(tlb_fd);
+                        if (tlb_misses < 0 || misses < tlb_misses)
+                            tlb_misses = misses;
+                    }
+                }
+                size_t huge = node_storage_huge_bytes();
+
+                lookups_ns[si][is_rbt][got] = lookup_ns;
+
+                char tlb_text[32];
+                if (tlb_misses >= 0)
+                    snprintf(tlb_text, sizeof(tlb_text), "%.2f", (double)tlb_misses / LOOKUPS);
+                else
+                    snprintf(tlb_text, sizeof(tlb_text), "       н/д");
+                printf("%s    | %s | %10.1f | %8.1f | %11ld | %10s | %17.0f%s\n",
+                       is_rbt ? "RBT" : "AVL", storage_labels[got], insert_ns, lookup_ns, faults,
+                       tlb_text, huge / (1024.0 * 1024.0), found == LOOKUPS ? "" : "  ОШИБКА");
+
+                if (is_rbt)
+                    free_rbt_tree(rbt);
+                else
+                    free_avl_tree(avl);
+                node_storage_set(NODE_STORAGE_MALLOC, 0);
+            }
+        }
+        printf("\n");
+    }
+
+    if (tlb_fd >= 0)
+        close(tlb_fd);
+    free(keys);
+    free(queries);
+
+    printf("ВЫВОД:\n");
+    for (int si = 0; si < 2; si++) {
+        double (*t)[4] = lookups_ns[si];
+        if (t[0][NODE_STORAGE_THP] == 0 || t[1][NODE_STORAGE_THP] == 0) {
+            printf("• N = %d: THP недоступны, сравнивать не с чем\n", sizes[si]);
+            continue;
+        }
+        printf("• Ускорение поиска на THP, N = %d: против malloc %.2fx (AVL) / %.2fx (RBT),\n", sizes[si],
+               t[0][NODE_STORAGE_MALLOC] / t[0][NODE_STORAGE_THP],
+               t[1][NODE_STORAGE_MALLOC] / t[1][NODE_STORAGE_THP]);
+        printf("  против арены на 4 КиБ %.2fx / %.2fx\n",
+               t[0][NODE_STORAGE_ARENA_4K] / t[0][NODE_STORAGE_THP],
+               t[1][NODE_STORAGE_ARENA_4K] / t[1][NODE_STORAGE_THP]);
+    }
+    printf("• Арена на 4 КиБ отделяет вклад плотной нарезки узлов (нет заголовков malloc)\n");
+    printf("  от вклада самих больших страниц\n");
+    printf("• Page faults при вставке падают в сотни раз: одна ошибка на 2 МиБ вместо 4 КиБ\n");
+    printf("• Без THP и hugetlbfs режим откатывается к арене на 4 КиБ, код деревьев не меняется\n\n");
+}
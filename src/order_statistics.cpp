@@ -0,0 +1,275 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "methods.h"
+
+// ========== ПОРЯДКОВЫЕ СТАТИСТИКИ ==========
+// Размер поддерева в каждом узле поддерживают вставка и повороты
+// (src/main.cpp), а также join/split (src/tree_join.cpp). Здесь только
+// запросы: каждый - один спуск от корня.
+
+#ifdef TREE_ORDER_STATISTICS
+
+// Число ключей < key (inclusive == 0) или <= key (inclusive == 1)
+static int avl_count_below(struct AVLNode* node, int key, int inclusive) {
+    int count = 0;
+    while (node != NULL) {
+        if (key < node->key || (key == node->key && !inclusive)) {
+            node = node->left;
+        } else {
+            count += avl_size(node->left) + 1;
+            node = node->right;
+        }
+    }
+    return count;
+}
+
+static int rbt_count_below(struct RBNode* node, int key, int inclusive) {
+    int count = 0;
+    while (node != NULL) {
+        if (key < node->key || (key == node->key && !inclusive)) {
+            node = node->left;
+        } else {
+            count += rbt_size(node->left) + 1;
+            node = node->right;
+        }
+    }
+    return count;
+}
+
+int avl_rank(struct AVLNode* root, int key) {
+    return avl_count_below(root, key, 0);
+}
+
+int rbt_rank(struct RBNode* root, int key) {
+    return rbt_count_below(root, key, 0);
+}
+
+struct AVLNode* avl_select(struct AVLNode* root, int k) {
+    struct AVLNode* node = root;
+    while (node != NULL) {
+        int left = avl_size(node->left);
+        if (k < left) {
+            node = node->left;
+        } else if (k == left) {
+            return node;
+        } else {
+            k -= left + 1;
+            node = node->right;
+        }
+    }
+    return NULL;
+}
+
+struct RBNode* rbt_select(struct RBNode* root, int k) {
+    struct RBNode* node = root;
+    while (node != NULL) {
+        int left = rbt_size(node->left);
+        if (k < left) {
+            node = node->left;
+        } else if (k == left) {
+            return node;
+        } else {
+            k -= left + 1;
+            node = node->right;
+        }
+    }
+    return NULL;
+}
+
+int avl_range_count(struct AVLNode* root, int lo, int hi) {
+    if (lo > hi)
+        return 0;
+    return avl_count_below(root, hi, 1) - avl_count_below(root, lo, 0);
+}
+
+int rbt_range_count(struct RBNode* root, int lo, int hi) {
+    if (lo > hi)
+        return 0;
+    return rbt_count_below(root, hi, 1) - rbt_count_below(root, lo, 0);
+}
+
+#endif
+
+// ==================== ТЕСТ 15: ПОРЯДКОВЫЕ СТАТИСТИКИ ====================
+
+#ifdef TREE_ORDER_STATISTICS
+
+static int compare_ints(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+// Первая позиция в sorted с элементом >= key
+static int lower_bound(const int* sorted, int n, int key) {
+    int lo = 0;
+    int hi = n;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (sorted[mid] < key)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+// Подсчет перебором всего дерева - так пришлось бы считать без размеров
+static int avl_range_count_scan(struct AVLNode* node, int lo, int hi) {
+    if (node == NULL)
+        return 0;
+    return (node->key >= lo && node->key <= hi) +
+           avl_range_count_scan(node->left, lo, hi) +
+           avl_range_count_scan(node->right, lo, hi);
+}
+
+#endif
+
+void test_order_statistics() {
+    printf("=== ТЕСТ 15: Порядковые статистики (rank, select, count в диапазоне) ===\n\n");
+
+    const int N = 1000000;
+
+    srand(time(NULL));
+
+    int* keys = (int*)malloc(N * sizeof(int));
+    for (int i = 0; i < N; i++)
+        keys[i] = rand() % (N * 8);
+
+    struct AVLNode* avl_root = NULL;
+    struct RBNode* rbt_root = NULL;
+    int rotations = 0;
+    int recolorings = 0;
+
+    clock_t start = clock();
+    for (int i = 0; i < N; i++)
+        avl_root = avl_insert(avl_root, keys[i], &rotations);
+    double avl_insert_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / N;
+
+    start = clock();
+    for (int i = 0; i < N; i++)
+        rbt_root = rbt_insert(rbt_root, keys[i], &rotations, &recolorings);
+    double rbt_insert_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / N;
+
+#ifdef TREE_ORDER_STATISTICS
+    printf("Размеры поддеревьев: включены (TREE_ORDER_STATISTICS)\n");
+#else
+    printf("Размеры поддеревьев: выключены (сборка с -DTREE_ORDER_STATISTICS=OFF)\n");
+#endif
+    printf("Вставка %d ключей: AVL %.1f ns/операция (узел %d байт), RBT %.1f ns/операция (узел %d байт)\n",
+           N, avl_insert_ns, (int)sizeof(struct AVLNode),
+           rbt_insert_ns, (int)sizeof(struct RBNode));
+    printf("Накладные расходы - разница с соседней сборкой с выключенной опцией\n\n");
+
+#ifdef TREE_ORDER_STATISTICS
+    const int NUM_QUERIES = 500000;
+    const int NUM_SCANS = 10;
+
+    // Эталон: отсортированные уникальные ключи
+    int* sorted = (int*)malloc(N * sizeof(int));
+    for (int i = 0; i < N; i++)
+        sorted[i] = keys[i];
+    qsort(sorted, N, sizeof(int), compare_ints);
+    int n = 0;
+    for (int i = 0; i < N; i++)
+        if (n == 0 || sorted[i] != sorted[n - 1])
+            sorted[n++] = sorted[i];
+
+    // Размер дерева: O(n) обход против O(1) чтения корня
+    start = clock();
+    int counted = count_avl_nodes(avl_root);
+    double count_us = (double)(clock() - start) * 1e6 / CLOCKS_PER_SEC;
+    printf("Размер AVL: count_avl_nodes %d за %.1f us, avl_size %d за O(1)%s\n",
+           counted, count_us, avl_size(avl_root),
+           counted == n && avl_size(avl_root) == n && rbt_size(rbt_root) == n ? "" : " ОШИБКА");
+
+    int* queries = (int*)malloc(NUM_QUERIES * sizeof(int));
+    int* ranks = (int*)malloc(NUM_QUERIES * sizeof(int));
+    for (int i = 0; i < NUM_QUERIES; i++) {
+        queries[i] = rand() % (N * 8);
+        ranks[i] = rand() % n;
+    }
+
+    printf("\n%-14s | %-12s | %-12s | %s\n", "Запрос", "AVL (ns)", "RBT (ns)", "Проверка");
+    printf("---------------|--------------|--------------|---------\n");
+
+    // rank
+    start = clock();
+    long long avl_sum = 0;
+    for (int i = 0; i < NUM_QUERIES; i++)
+        avl_sum += avl_rank(avl_root, queries[i]);
+    double avl_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / NUM_QUERIES;
+    start = clock();
+    long long rbt_sum = 0;
+    for (int i = 0; i < NUM_QUERIES; i++)
+        rbt_sum += rbt_rank(rbt_root, queries[i]);
+    double rbt_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / NUM_QUERIES;
+    long long expected = 0;
+    for (int i = 0; i < NUM_QUERIES; i++)
+        expected += lower_bound(sorted, n, queries[i]);
+    printf("%-14s | %-12.1f | %-12.1f | %s\n", "rank", avl_ns, rbt_ns,
+           avl_sum == expected && rbt_sum == expected ? "OK" : "ОШИБКА");
+
+    // select
+    int errors = 0;
+    start = clock();
+    for (int i = 0; i < NUM_QUERIES; i++)
+        errors += avl_select(avl_root, ranks[i])->key != sorted[ranks[i]];
+    avl_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / NUM_QUERIES;
+    start = clock();
+    for (int i = 0; i < NUM_QUERIES; i++)
+        errors += rbt_select(rbt_root, ranks[i])->key != sorted[ranks[i]];
+    rbt_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / NUM_QUERIES;
+    errors += avl_select(avl_root, n) != NULL || rbt_select(rbt_root, -1) != NULL;
+    printf("%-14s | %-12.1f | %-12.1f | %s\n", "select", avl_ns, rbt_ns,
+           errors == 0 ? "OK" : "ОШИБКА");
+
+    // count в диапазоне: окно [q, q + N/100]
+    const int WINDOW = N / 100;
+    start = clock();
+    avl_sum = 0;
+    for (int i = 0; i < NUM_QUERIES; i++)
+        avl_sum += avl_range_count(avl_root, queries[i], queries[i] + WINDOW);
+    avl_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / NUM_QUERIES;
+    start = clock();
+    rbt_sum = 0;
+    for (int i = 0; i < NUM_QUERIES; i++)
+        rbt_sum += rbt_range_count(rbt_root, queries[i], queries[i] + WINDOW);
+    rbt_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / NUM_QUERIES;
+    expected = 0;
+    for (int i = 0; i < NUM_QUERIES; i++)
+        expected += lower_bound(sorted, n, queries[i] + WINDOW + 1) - lower_bound(sorted, n, queries[i]);
+    printf("%-14s | %-12.1f | %-12.1f | %s\n", "range_count", avl_ns, rbt_ns,
+           avl_sum == expected && rbt_sum == expected ? "OK" : "ОШИБКА");
+
+    // Тот же подсчет полным обходом
+    start = clock();
+    long long scan_sum = 0;
+    long long fast_sum = 0;
+    for (int i = 0; i < NUM_SCANS; i++) {
+        scan_sum += avl_range_count_scan(avl_root, queries[i], queries[i] + WINDOW);
+        fast_sum += avl_range_count(avl_root, queries[i], queries[i] + WINDOW);
+    }
+    double scan_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / NUM_SCANS;
+    printf("%-14s | %-12.1f | %-12s | %s\n", "обход (O(n))", scan_ns, "-",
+           scan_sum == fast_sum ? "OK" : "ОШИБКА");
+
+    // Перцентили - ключи по рангу
+    printf("\nПерцентили ключей (AVL): p50=%d, p90=%d, p99=%d, max=%d\n",
+           avl_select(avl_root, n / 2)->key, avl_select(avl_root, (int)(n * 0.9))->key,
+           avl_select(avl_root, (int)(n * 0.99))->key, avl_select(avl_root, n - 1)->key);
+
+    free(sorted);
+    free(queries);
+    free(ranks);
+#endif
+
+    free(keys);
+    free_avl_tree(avl_root);
+    free_rbt_tree(rbt_root);
+
+    printf("\nВЫВОД: размер поддерева стоит одного поля и пары сложений на поворот,\n");
+    printf("       зато rank/select/count становятся одним спуском вместо обхода всего дерева\n\n");
+}
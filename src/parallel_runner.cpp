@@ -0,0 +1,276 @@
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "methods.h"
+
+// ========== МНОГОПОТОЧНЫЙ ПРОГОН НЕЗАВИСИМЫХ ДЕРЕВЬЕВ ==========
+// На одной машине обычно живет много независимых индексов. Каждый поток
+// получает свое дерево, свой генератор ключей и свое ядро; общими остаются
+// только malloc и полоса памяти - их предел и показывает рост K.
+//
+// Существующие тесты печатают таблицы и пользуются общим rand(), поэтому
+// в потоках гоняются отдельные нагрузки: вставка, поиск и смесь.
+
+static const char* parallel_workload_names[] = {"insert", "search", "mixed"};
+
+struct ParallelThread {
+    int cpu;    // ядро, к которому привязан поток
+    int pinned; // привязка удалась
+    int is_rbt;
+    enum ParallelWorkload workload;
+    int keys;
+    unsigned seed;
+    long long ops;
+    long long checksum; // чтобы поиск не выбросил компилятор
+    double end_ms;
+    double ms;
+};
+
+struct ParallelStart {
+    std::atomic<int> ready;
+    std::atomic<bool> go;
+    double start_ms;
+};
+
+// xorshift32: у rand() в glibc общая блокировка, она исказила бы масштабирование
+static unsigned parallel_next(unsigned* state) {
+    unsigned x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static void parallel_thread_main(struct ParallelThread* t, struct ParallelStart* start) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(t->cpu, &set);
+    t->pinned = sched_setaffinity(0, sizeof(set), &set) == 0;
+
+    unsigned rng = t->seed;
+    int n = t->keys;
+    int range = t->workload == PARALLEL_MIXED ? 2 * n : 0x7fffffff;
+    int* keys = (int*)malloc(n * sizeof(int));
+    for (int i = 0; i < n; i++)
+        keys[i] = (int)(parallel_next(&rng) % (unsigned)range);
+
+    // Заполнение до старта: поиск и смесь меряются на готовом дереве
+    struct AVLNode* avl = NULL;
+    struct RBNode* rbt = NULL;
+    int rotations = 0;
+    int recolorings = 0;
+    if (t->workload != PARALLEL_INSERT) {
+        int prefill = t->workload == PARALLEL_MIXED ? n / 2 : n;
+        for (int i = 0; i < prefill; i++) {
+            if (t->is_rbt)
+                rbt = rbt_insert(rbt, keys[i], &rotations, &recolorings);
+            else
+                avl = avl_insert(avl, keys[i], &rotations);
+        }
+    }
+
+    start->ready.fetch_add(1);
+    while (!start->go.load(std::memory_order_acquire))
+        std::this_thread::yield();
+
+    long long checksum = 0;
+    for (int i = 0; i < n; i++) {
+        if (t->workload == PARALLEL_INSERT) {
+            if (t->is_rbt)
+                rbt = rbt_insert(rbt, keys[i], &rotations, &recolorings);
+            else
+                avl = avl_insert(avl, keys[i], &rotations);
+            continue;
+        }
+        unsigned r = parallel_next(&rng);
+        int key = t->workload == PARALLEL_SEARCH ? keys[r % n] : (int)(r % (unsigned)range);
+        // Смесь: 50% поиск, 25% вставка, 25% удаление - размер держится около n/2
+        int op = t->workload == PARALLEL_SEARCH ? 0 : (int)(r >> 30);
+        if (op <= 1) {
+            checksum += t->is_rbt ? rbt_search(rbt, key) != NULL : avl_search(avl, key) != NULL;
+        } else if (op == 2) {
+            if (t->is_rbt)
+                rbt = rbt_insert(rbt, key, &rotations, &recolorings);
+            else
+                avl = avl_insert(avl, key, &rotations);
+        } else {
+            if (t->is_rbt)
+                rbt = rbt_delete(rbt, key, &rotations, &recolorings);
+            else
+                avl = avl_delete(avl, key, &rotations);
+        }
+    }
+    t->end_ms = wall_time_ms();
+    t->ms = t->end_ms - start->start_ms;
+    t->ops = n;
+    t->checksum = checksum;
+
+    free_rbt_tree(rbt);
+    free_avl_tree(avl);
+    free(keys);
+}
+
+// Ядра, на которых процессу разрешено работать
+static std::vector<int> parallel_allowed_cpus() {
+    std::vector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+            if (CPU_ISSET(cpu, &set))
+                cpus.push_back(cpu);
+    }
+    if (cpus.empty())
+        cpus.push_back(0);
+    return cpus;
+}
+
+int parallel_core_count() {
+    return (int)parallel_allowed_cpus().size();
+}
+
+double parallel_run(enum ParallelWorkload workload, int is_rbt, int threads, int keys,
+                    double* per_thread_mops, int* pinned) {
+    std::vector<int> cpus = parallel_allowed_cpus();
+    std::vector<struct ParallelThread> state(threads);
+    std::vector<std::thread> workers;
+    struct ParallelStart start;
+    start.ready = 0;
+    start.go = false;
+    start.start_ms = 0;
+
+    for (int i = 0; i < threads; i++) {
+        struct ParallelThread* t = &state[i];
+        memset(t, 0, sizeof(*t));
+        // Больше потоков, чем ядер, - по кругу (переподписка)
+        t->cpu = cpus[i % cpus.size()];
+        t->is_rbt = is_rbt;
+        t->workload = workload;
+        t->keys = keys;
+        t->seed = 2463534242u + 7919u * (unsigned)i;
+        workers.push_back(std::thread(parallel_thread_main, t, &start));
+    }
+    while (start.ready.load() < threads)
+        std::this_thread::yield();
+    start.start_ms = wall_time_ms();
+    start.go.store(true, std::memory_order_release);
+    for (int i = 0; i < threads; i++)
+        workers[i].join();
+
+    double end_ms = start.start_ms;
+    long long ops = 0;
+    int all_pinned = 1;
+    for (int i = 0; i < threads; i++) {
+        if (state[i].end_ms > end_ms)
+            end_ms = state[i].end_ms;
+        ops += state[i].ops;
+        all_pinned &= state[i].pinned;
+        if (per_thread_mops != NULL)
+            per_thread_mops[i] = state[i].ops / (state[i].ms * 1000.0);
+    }
+    if (pinned != NULL)
+        *pinned = all_pinned;
+    return ops / ((end_ms - start.start_ms) * 1000.0);
+}
+
+// K = 1, 2, 4, ... и последним - max_threads
+static std::vector<int> parallel_thread_counts(int max_threads) {
+    std::vector<int> counts;
+    for (int k = 1; k < max_threads; k *= 2)
+        counts.push_back(k);
+    counts.push_back(max_threads);
+    return counts;
+}
+
+// Одна таблица масштабирования: AVL и RBT для всех K
+static void parallel_print_scaling(enum ParallelWorkload workload, int max_threads, int keys,
+                                   int verbose) {
+    std::vector<int> counts = parallel_thread_counts(max_threads);
+    std::vector<double> per_thread(max_threads);
+
+    printf("Нагрузка %s, %d операций на поток\n", parallel_workload_names[workload], keys);
+    printf("Дерево |   K | Всего Mops/s | Поток мин | Поток макс | Эффективность\n");
+    printf("-------|-----|--------------|-----------|------------|--------------\n");
+    for (int is_rbt = 0; is_rbt < 2; is_rbt++) {
+        double single = 0;
+        for (size_t c = 0; c < counts.size(); c++) {
+            int k = counts[c];
+            int pinned = 0;
+            double total = parallel_run(workload, is_rbt, k, keys, per_thread.data(), &pinned);
+            if (k == 1)
+                single = total;
+            double lo = per_thread[0];
+            double hi = per_thread[0];
+            for (int i = 1; i < k; i++) {
+                if (per_thread[i] < lo)
+                    lo = per_thread[i];
+                if (per_thread[i] > hi)
+                    hi = per_thread[i];
+            }
+            // Эффективность: доля от идеального K-кратного роста
+            printf("%s    | %3d | %12.2f | %9.2f | %10.2f | %12.0f%%%s\n", is_rbt ? "RBT" : "AVL", k,
+                   total, lo, hi, 100.0 * total / (k * single), pinned ? "" : "  (без привязки)");
+            if (verbose) {
+                printf("       |     | потоки:");
+                for (int i = 0; i < k; i++)
+                    printf(" %.2f", per_thread[i]);
+                printf("\n");
+            }
+        }
+    }
+    printf("\n");
+}
+
+int parallel_runner_main(int argc, char** argv) {
+    int workload = -1;
+    if (argc >= 1) {
+        for (int w = 0; w < 3; w++)
+            if (strcmp(argv[0], parallel_workload_names[w]) == 0)
+                workload = w;
+    }
+    int cores = parallel_core_count();
+    int max_threads = argc >= 2 ? atoi(argv[1]) : cores;
+    int keys = argc >= 3 ? atoi(argv[2]) : 1000000;
+    if (workload < 0 || max_threads < 1 || keys < 1) {
+        fprintf(stderr, "использование: app --parallel <insert|search|mixed> [макс. потоков] [операций на поток]\n");
+        fprintf(stderr, "  по умолчанию потоков - по числу доступных ядер (%d), операций - 1000000\n", cores);
+        return 1;
+    }
+
+    printf("=== МНОГОПОТОЧНЫЙ ПРОГОН: %s, K = 1..%d, ядер доступно: %d ===\n\n",
+           parallel_workload_names[workload], max_threads, cores);
+    parallel_print_scaling((enum ParallelWorkload)workload, max_threads, keys, 1);
+    return 0;
+}
+
+// ==================== ТЕСТ 29: МАСШТАБИРОВАНИЕ ПО ПОТОКАМ ====================
+
+void test_parallel_scaling() {
+    printf("=== ТЕСТ 29: Независимые деревья в K потоках, привязанных к ядрам ===\n\n");
+
+    const int KEYS = 1000000;
+    int cores = parallel_core_count();
+    printf("Ядер доступно: %d. Каждый поток - свое дерево и свое ядро;\n", cores);
+    printf("\"Эффективность\" - доля от K-кратного роста относительно K = 1\n");
+    if (cores == 1)
+        printf("На одном ядре масштабировать нечего; для переподписки: app --parallel <нагрузка> <K>\n");
+    printf("\n");
+
+    for (int w = PARALLEL_INSERT; w <= PARALLEL_MIXED; w++)
+        parallel_print_scaling((enum ParallelWorkload)w, cores, KEYS, 0);
+
+    printf("ВЫВОД:\n");
+    printf("• search не выделяет память: если его эффективность падает с ростом K,\n");
+    printf("  предел - полоса и задержка памяти, общие на сокет\n");
+    printf("• Если insert теряет эффективность раньше search, предел - malloc\n");
+    printf("  (конкуренция аллокатора), а не сами деревья\n");
+    printf("• mixed сочетает оба предела: вставки и удаления держат malloc занятым\n");
+    printf("• Полный отчет по потокам и переподписка: app --parallel <insert|search|mixed> [K] [операций]\n\n");
+}
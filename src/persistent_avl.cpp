@@ -0,0 +1,308 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "methods.h"
+
+// ========== ПЕРСИСТЕНТНОЕ AVL ДЕРЕВО (КОПИРОВАНИЕ ПУТИ) ==========
+// Версия - это корень. Вставка и удаление копируют только узлы на пути
+// от корня (и соседей, участвующих в поворотах), остальное разделяется
+// со старыми версиями. Узлы освобождаются подсчетом ссылок.
+//
+// Операции забирают ссылку вызывающего на старый корень. Узел со
+// счетчиком 1, достигнутый по изменяемому пути, больше никому не виден
+// и меняется на месте; копируется только то, что разделено со снимками
+// (pavl_snapshot). Без снимков вставка идет на месте, как avl_insert.
+
+static long pavl_live = 0;
+
+static struct PAVLNode* pavl_new_node(int key) {
+    struct PAVLNode* node = (struct PAVLNode*)malloc(sizeof(struct PAVLNode));
+    node->key = key;
+    node->height = 1;
+    node->refcount = 1;
+    node->left = node->right = NULL;
+    pavl_live++;
+    return node;
+}
+
+static void pavl_retain(struct PAVLNode* node) {
+    if (node != NULL)
+        node->refcount++;
+}
+
+struct PAVLNode* pavl_snapshot(struct PAVLNode* root) {
+    pavl_retain(root);
+    return root;
+}
+
+static int pavl_height(struct PAVLNode* node) {
+    return node ? node->height : 0;
+}
+
+static void pavl_update_height(struct PAVLNode* node) {
+    int hl = pavl_height(node->left);
+    int hr = pavl_height(node->right);
+    node->height = 1 + (hl > hr ? hl : hr);
+}
+
+static int pavl_balance(struct PAVLNode* node) {
+    return node ? pavl_height(node->left) - pavl_height(node->right) : 0;
+}
+
+// Новый узел с теми же полями; дети получают по ссылке
+static struct PAVLNode* pavl_copy(struct PAVLNode* node) {
+    struct PAVLNode* copy = pavl_new_node(node->key);
+    copy->height = node->height;
+    copy->left = node->left;
+    copy->right = node->right;
+    pavl_retain(copy->left);
+    pavl_retain(copy->right);
+    return copy;
+}
+
+// Ссылка из изменяемого родителя (или корня) на node: вернуть изменяемый
+// узел. Если node разделен со снимками - копия, а ссылка переходит
+// с оригинала на копию.
+static struct PAVLNode* pavl_own(struct PAVLNode* node) {
+    if (node->refcount == 1)
+        return node;
+    struct PAVLNode* copy = pavl_copy(node);
+    node->refcount--;
+    return copy;
+}
+
+// Повороты над изменяемым x; поднимаемый сын делается изменяемым
+static struct PAVLNode* pavl_rotate_right(struct PAVLNode* y) {
+    struct PAVLNode* x = pavl_own(y->left);
+    y->left = x->right;
+    x->right = y;
+    pavl_update_height(y);
+    pavl_update_height(x);
+    return x;
+}
+
+static struct PAVLNode* pavl_rotate_left(struct PAVLNode* x) {
+    struct PAVLNode* y = pavl_own(x->right);
+    x->right = y->left;
+    y->left = x;
+    pavl_update_height(x);
+    pavl_update_height(y);
+    return y;
+}
+
+static struct PAVLNode* pavl_rebalance(struct PAVLNode* node) {
+    pavl_update_height(node);
+    int balance = pavl_balance(node);
+
+    if (balance > 1) {
+        if (pavl_balance(node->left) < 0)
+            node->left = pavl_rotate_left(pavl_own(node->left));
+        return pavl_rotate_right(node);
+    }
+    if (balance < -1) {
+        if (pavl_balance(node->right) > 0)
+            node->right = pavl_rotate_right(pavl_own(node->right));
+        return pavl_rotate_left(node);
+    }
+    return node;
+}
+
+static struct PAVLNode* pavl_insert_mut(struct PAVLNode* node, int key) {
+    if (key < node->key)
+        node->left = node->left ? pavl_insert_mut(pavl_own(node->left), key) : pavl_new_node(key);
+    else
+        node->right = node->right ? pavl_insert_mut(pavl_own(node->right), key) : pavl_new_node(key);
+    return pavl_rebalance(node);
+}
+
+// Снимает минимальный узел поддерева, его ключ - в *key
+static struct PAVLNode* pavl_delete_min_mut(struct PAVLNode* node, int* key) {
+    if (node->left == NULL) {
+        struct PAVLNode* right = node->right;
+        *key = node->key;
+        free(node);
+        pavl_live--;
+        return right;
+    }
+    node->left = pavl_delete_min_mut(pavl_own(node->left), key);
+    return pavl_rebalance(node);
+}
+
+static struct PAVLNode* pavl_delete_mut(struct PAVLNode* node, int key) {
+    if (key < node->key) {
+        node->left = pavl_delete_mut(pavl_own(node->left), key);
+    } else if (key > node->key) {
+        node->right = pavl_delete_mut(pavl_own(node->right), key);
+    } else if (node->left == NULL || node->right == NULL) {
+        // Ссылка на единственного сына переходит к родителю
+        struct PAVLNode* child = node->left ? node->left : node->right;
+        free(node);
+        pavl_live--;
+        return child;
+    } else {
+        node->right = pavl_delete_min_mut(pavl_own(node->right), &node->key);
+    }
+    return pavl_rebalance(node);
+}
+
+struct PAVLNode* pavl_insert(struct PAVLNode* root, int key) {
+    // Ключ уже есть - версия не меняется, ссылка просто возвращается
+    if (pavl_search(root, key) != NULL)
+        return root;
+    if (root == NULL)
+        return pavl_new_node(key);
+    return pavl_insert_mut(pavl_own(root), key);
+}
+
+struct PAVLNode* pavl_delete(struct PAVLNode* root, int key) {
+    if (pavl_search(root, key) == NULL)
+        return root;
+    return pavl_delete_mut(pavl_own(root), key);
+}
+
+struct PAVLNode* pavl_search(struct PAVLNode* node, int key) {
+    while (node != NULL && node->key != key)
+        node = key < node->key ? node->left : node->right;
+    return node;
+}
+
+void pavl_release(struct PAVLNode* root) {
+    if (root == NULL || --root->refcount > 0)
+        return;
+    pavl_release(root->left);
+    pavl_release(root->right);
+    free(root);
+    pavl_live--;
+}
+
+long pavl_live_nodes() {
+    return pavl_live;
+}
+
+// ==================== ТЕСТ 16: ПЕРСИСТЕНТНОЕ AVL ДЕРЕВО ====================
+
+static int pavl_count(struct PAVLNode* node) {
+    if (node == NULL) return 0;
+    return 1 + pavl_count(node->left) + pavl_count(node->right);
+}
+
+void test_persistent_avl() {
+    printf("=== ТЕСТ 16: Персистентное AVL дерево (копирование пути) ===\n\n");
+
+    const int N = 1 << 18;
+    const int SNAPSHOT_EVERY = 1000;
+
+    srand(time(NULL));
+
+    // Уникальные ключи: снимок i точно не содержит ключей, вставленных позже
+    int* keys = (int*)malloc(N * sizeof(int));
+    for (int i = 0; i < N; i++)
+        keys[i] = i * 4;
+    for (int i = N - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        int tmp = keys[i];
+        keys[i] = keys[j];
+        keys[j] = tmp;
+    }
+
+    printf("%-30s | %-12s | %-12s | %-10s | %s\n",
+           "Режим", "ns/вставка", "Живых узлов", "Версий", "Байт на версию");
+    printf("-------------------------------|--------------|--------------|------------|---------------\n");
+
+    // Базовая линия: вставка на месте
+    struct AVLNode* avl_root = NULL;
+    int rotations = 0;
+    clock_t start = clock();
+    for (int i = 0; i < N; i++)
+        avl_root = avl_insert(avl_root, keys[i], &rotations);
+    double ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / N;
+    int unique = count_avl_nodes(avl_root);
+    printf("%-30s | %-12.1f | %-12d | %-10d | %s\n", "avl_insert (на месте)", ns, unique, 1, "-");
+
+    // Без снимков: все узлы со счетчиком 1, вставка идет на месте
+    long base_live = pavl_live_nodes();
+    struct PAVLNode* root = NULL;
+    start = clock();
+    for (int i = 0; i < N; i++)
+        root = pavl_insert(root, keys[i]);
+    ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / N;
+    long live = pavl_live_nodes() - base_live;
+    printf("%-30s | %-12.1f | %-12ld | %-10d | %s\n", "без снимков", ns, live, 1, "-");
+    int latest_ok = live == unique && pavl_count(root) == unique;
+    pavl_release(root);
+
+    // Снимок каждые SNAPSHOT_EVERY вставок (экспорт без остановки записи)
+    int num_snapshots = N / SNAPSHOT_EVERY;
+    struct PAVLNode** snapshots = (struct PAVLNode**)malloc(num_snapshots * sizeof(struct PAVLNode*));
+    int* snapshot_sizes = (int*)malloc(num_snapshots * sizeof(int));
+    int taken = 0;
+    root = NULL;
+    start = clock();
+    for (int i = 0; i < N; i++) {
+        if (i % SNAPSHOT_EVERY == 0 && i > 0 && taken < num_snapshots) {
+            snapshots[taken] = pavl_snapshot(root);
+            snapshot_sizes[taken++] = i; // ключи keys[0..i-1]
+        }
+        root = pavl_insert(root, keys[i]);
+    }
+    ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / N;
+    live = pavl_live_nodes() - base_live;
+    printf("%-30s | %-12.1f | %-12ld | %-10d | %.1f\n", "снимок каждые 1000 вставок", ns, live,
+           taken + 1, (double)(live - unique) * sizeof(struct PAVLNode) / taken);
+
+    // Старые снимки не видят поздних ключей
+    int snapshots_ok = 1;
+    for (int s = 0; s < taken; s += taken / 8 + 1) {
+        int last = snapshot_sizes[s];
+        if (pavl_search(snapshots[s], keys[last]) != NULL || pavl_count(snapshots[s]) != last)
+            snapshots_ok = 0;
+        for (int j = 0; j < last; j += 97)
+            if (pavl_search(snapshots[s], keys[j]) == NULL)
+                snapshots_ok = 0;
+    }
+    for (int s = 0; s < taken; s++)
+        pavl_release(snapshots[s]);
+    pavl_release(root);
+
+    // Все версии сохранены
+    struct PAVLNode** versions = (struct PAVLNode**)malloc((N + 1) * sizeof(struct PAVLNode*));
+    versions[0] = NULL;
+    start = clock();
+    for (int i = 0; i < N; i++)
+        versions[i + 1] = pavl_insert(pavl_snapshot(versions[i]), keys[i]);
+    ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / N;
+    live = pavl_live_nodes() - base_live;
+    printf("%-30s | %-12.1f | %-12ld | %-10d | %.1f\n", "все версии", ns, live,
+           N, (double)(live - unique) * sizeof(struct PAVLNode) / N);
+
+    // Удаление в новой версии не меняет старую
+    struct PAVLNode* latest = pavl_snapshot(versions[N]);
+    start = clock();
+    for (int i = 0; i < N / 2; i++)
+        latest = pavl_delete(latest, keys[i]);
+    double delete_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / (N / 2);
+    int versions_ok = pavl_count(versions[N]) == unique;
+    for (int i = 0; i < N / 2; i++)
+        if (pavl_search(latest, keys[i]) != NULL)
+            versions_ok = 0;
+
+    for (int i = 0; i <= N; i++)
+        pavl_release(versions[i]);
+    pavl_release(latest);
+    int leaks = pavl_live_nodes() != base_live;
+
+    printf("\nУдаление %d ключей из новой версии (старые сохранены): %.1f ns/операция\n", N / 2, delete_ns);
+    printf("Узел: AVL %d байт, персистентный %d байт (плюс счетчик ссылок)\n",
+           (int)sizeof(struct AVLNode), (int)sizeof(struct PAVLNode));
+    printf("Проверка: %s\n", latest_ok && snapshots_ok && versions_ok && !leaks ? "OK" : "ОШИБКА");
+
+    free(snapshots);
+    free(snapshot_sizes);
+    free(versions);
+    free(keys);
+    free_avl_tree(avl_root);
+
+    printf("\nВЫВОД: версия стоит O(log n) узлов; без снимков вставка идет на месте,\n");
+    printf("       а после снимка каждый разделенный узел копируется не больше одного раза\n\n");
+}
@@ -0,0 +1,474 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "methods.h"
+
+// ========== КЕШ СЕССИЙ С ОГРАНИЧЕНИЕМ ПАМЯТИ ==========
+// Каждая сессия - одна запись из заранее выделенного пула (жесткий
+// бюджет), которая одновременно лежит в трех структурах:
+//   - AVL индекс по id сессии (поиск);
+//   - двусвязный LRU список (вытеснение самой давней при переполнении);
+//   - AVL индекс по (expires, id) (истечение TTL).
+// Узлы базовых AVL/RBT хранят только ключ, поэтому здесь оба индекса
+// интрузивные: ссылки деревьев лежат прямо в записи, и удаление записи
+// из всех структур не требует дополнительных поисков и выделений памяти.
+// Очистка по TTL - удаление префикса индекса истечения (все записи
+// с expires <= now), по одной минимальной записи за шаг.
+//
+// Продление сессии при попадании меняет только deadline; ключ expires
+// в индексе догоняет его лениво - когда очистка доходит до записи,
+// которая еще жива, она переставляется на новый срок. Так запись
+// двигается в индексе не чаще раза за TTL, а не на каждом обращении.
+
+enum { SESSION_BY_ID = 0, SESSION_BY_EXPIRY = 1 };
+
+struct SessionEntry {
+    int id;
+    int expires;                     // ключ в индексе истечения, <= deadline
+    int deadline;                    // настоящий срок жизни
+    struct SessionEntry* link[2][2]; // [индекс][0 - левый, 1 - правый]
+    int height[2];
+    struct SessionEntry* lru_prev;   // к более свежим
+    struct SessionEntry* lru_next;   // к более давним
+};
+
+struct SessionCache {
+    struct SessionEntry* pool;
+    struct SessionEntry* free_list;  // по lru_next
+    int capacity;
+    int ttl;
+    int size;
+
+    struct SessionEntry* root[2];
+    struct SessionEntry* lru_head;   // самая свежая
+    struct SessionEntry* lru_tail;   // кандидат на вытеснение
+
+    struct SessionCacheStats stats;
+};
+
+// ---------- Интрузивное AVL дерево (t - номер индекса) ----------
+
+static int se_height(int t, struct SessionEntry* e) {
+    return e ? e->height[t] : 0;
+}
+
+static void se_update(int t, struct SessionEntry* e) {
+    int hl = se_height(t, e->link[t][0]);
+    int hr = se_height(t, e->link[t][1]);
+    e->height[t] = 1 + (hl > hr ? hl : hr);
+}
+
+static int se_balance(int t, struct SessionEntry* e) {
+    return se_height(t, e->link[t][0]) - se_height(t, e->link[t][1]);
+}
+
+static int se_less(int t, struct SessionEntry* a, struct SessionEntry* b) {
+    if (t == SESSION_BY_EXPIRY && a->expires != b->expires)
+        return a->expires < b->expires;
+    return a->id < b->id;
+}
+
+// Поворот: поднимается сын с стороны dir
+static struct SessionEntry* se_rotate(int t, struct SessionEntry* e, int dir) {
+    struct SessionEntry* child = e->link[t][dir];
+    e->link[t][dir] = child->link[t][!dir];
+    child->link[t][!dir] = e;
+    se_update(t, e);
+    se_update(t, child);
+    return child;
+}
+
+static struct SessionEntry* se_rebalance(int t, struct SessionEntry* e, long long* rotations) {
+    se_update(t, e);
+    int balance = se_balance(t, e);
+
+    if (balance > 1) {
+        if (se_balance(t, e->link[t][0]) < 0) {
+            (*rotations)++;
+            e->link[t][0] = se_rotate(t, e->link[t][0], 1);
+        }
+        (*rotations)++;
+        return se_rotate(t, e, 0);
+    }
+    if (balance < -1) {
+        if (se_balance(t, e->link[t][1]) > 0) {
+            (*rotations)++;
+            e->link[t][1] = se_rotate(t, e->link[t][1], 0);
+        }
+        (*rotations)++;
+        return se_rotate(t, e, 1);
+    }
+    return e;
+}
+
+static struct SessionEntry* se_insert(int t, struct SessionEntry* node, struct SessionEntry* e,
+                                      long long* rotations) {
+    if (node == NULL) {
+        e->link[t][0] = e->link[t][1] = NULL;
+        e->height[t] = 1;
+        return e;
+    }
+    int dir = !se_less(t, e, node);
+    node->link[t][dir] = se_insert(t, node->link[t][dir], e, rotations);
+    return se_rebalance(t, node, rotations);
+}
+
+// Снимает минимальную запись поддерева в *min
+static struct SessionEntry* se_remove_min(int t, struct SessionEntry* node, struct SessionEntry** min,
+                                          long long* rotations) {
+    if (node->link[t][0] == NULL) {
+        *min = node;
+        return node->link[t][1];
+    }
+    node->link[t][0] = se_remove_min(t, node->link[t][0], min, rotations);
+    return se_rebalance(t, node, rotations);
+}
+
+// Удаляет именно запись e (ключи в индексе уникальны)
+static struct SessionEntry* se_remove(int t, struct SessionEntry* node, struct SessionEntry* e,
+                                      long long* rotations) {
+    if (node == NULL)
+        return NULL;
+    if (node != e) {
+        int dir = !se_less(t, e, node);
+        node->link[t][dir] = se_remove(t, node->link[t][dir], e, rotations);
+        return se_rebalance(t, node, rotations);
+    }
+    if (e->link[t][0] == NULL)
+        return e->link[t][1];
+    if (e->link[t][1] == NULL)
+        return e->link[t][0];
+
+    // Два сына: на место e встает преемник
+    struct SessionEntry* successor;
+    struct SessionEntry* right = se_remove_min(t, e->link[t][1], &successor, rotations);
+    successor->link[t][0] = e->link[t][0];
+    successor->link[t][1] = right;
+    return se_rebalance(t, successor, rotations);
+}
+
+static struct SessionEntry* se_find(struct SessionEntry* node, int id) {
+    while (node != NULL && node->id != id)
+        node = node->link[SESSION_BY_ID][id > node->id];
+    return node;
+}
+
+// ---------- LRU список ----------
+
+static void lru_unlink(struct SessionCache* cache, struct SessionEntry* e) {
+    if (e->lru_prev) e->lru_prev->lru_next = e->lru_next;
+    else cache->lru_head = e->lru_next;
+    if (e->lru_next) e->lru_next->lru_prev = e->lru_prev;
+    else cache->lru_tail = e->lru_prev;
+}
+
+static void lru_push_front(struct SessionCache* cache, struct SessionEntry* e) {
+    e->lru_prev = NULL;
+    e->lru_next = cache->lru_head;
+    if (cache->lru_head) cache->lru_head->lru_prev = e;
+    else cache->lru_tail = e;
+    cache->lru_head = e;
+}
+
+// ---------- Кеш ----------
+
+struct SessionCache* session_cache_create(int max_entries, int ttl) {
+    struct SessionCache* cache = (struct SessionCache*)malloc(sizeof(struct SessionCache));
+    if (max_entries < 1)
+        max_entries = 1;
+    cache->pool = (struct SessionEntry*)malloc(max_entries * sizeof(struct SessionEntry));
+    cache->capacity = max_entries;
+    cache->ttl = ttl;
+    cache->size = 0;
+    cache->root[SESSION_BY_ID] = cache->root[SESSION_BY_EXPIRY] = NULL;
+    cache->lru_head = cache->lru_tail = NULL;
+    cache->stats = (struct SessionCacheStats){0, 0, 0, 0, 0, 0, 0};
+
+    cache->free_list = NULL;
+    for (int i = max_entries - 1; i >= 0; i--) {
+        cache->pool[i].lru_next = cache->free_list;
+        cache->free_list = &cache->pool[i];
+    }
+    return cache;
+}
+
+void session_cache_free(struct SessionCache* cache) {
+    if (cache == NULL)
+        return;
+    free(cache->pool);
+    free(cache);
+}
+
+static void session_unlink(struct SessionCache* cache, struct SessionEntry* e) {
+    long long* rotations = &cache->stats.rotations;
+    cache->root[SESSION_BY_ID] = se_remove(SESSION_BY_ID, cache->root[SESSION_BY_ID], e, rotations);
+    if (cache->ttl > 0)
+        cache->root[SESSION_BY_EXPIRY] = se_remove(SESSION_BY_EXPIRY, cache->root[SESSION_BY_EXPIRY], e, rotations);
+    lru_unlink(cache, e);
+    e->lru_next = cache->free_list;
+    cache->free_list = e;
+    cache->size--;
+}
+
+// Продление: в начало LRU и новый срок (индекс истечения не трогается)
+static void session_touch(struct SessionCache* cache, struct SessionEntry* e, int now) {
+    if (cache->lru_head != e) {
+        lru_unlink(cache, e);
+        lru_push_front(cache, e);
+    }
+    e->deadline = now + cache->ttl;
+}
+
+int session_cache_get(struct SessionCache* cache, int session_id, int now) {
+    struct SessionEntry* e = se_find(cache->root[SESSION_BY_ID], session_id);
+    // Истекшая, но еще не вычищенная запись - тоже промах
+    if (e != NULL && cache->ttl > 0 && e->deadline <= now) {
+        session_unlink(cache, e);
+        cache->stats.expired++;
+        e = NULL;
+    }
+    if (e == NULL) {
+        cache->stats.misses++;
+        return 0;
+    }
+    cache->stats.hits++;
+    session_touch(cache, e, now);
+    return 1;
+}
+
+void session_cache_put(struct SessionCache* cache, int session_id, int now) {
+    struct SessionEntry* e = se_find(cache->root[SESSION_BY_ID], session_id);
+    if (e != NULL) {
+        session_touch(cache, e, now);
+        return;
+    }
+
+    if (cache->free_list == NULL) {
+        session_unlink(cache, cache->lru_tail);
+        cache->stats.evictions++;
+    }
+    e = cache->free_list;
+    cache->free_list = e->lru_next;
+
+    long long* rotations = &cache->stats.rotations;
+    e->id = session_id;
+    e->expires = e->deadline = now + cache->ttl;
+    cache->root[SESSION_BY_ID] = se_insert(SESSION_BY_ID, cache->root[SESSION_BY_ID], e, rotations);
+    if (cache->ttl > 0)
+        cache->root[SESSION_BY_EXPIRY] = se_insert(SESSION_BY_EXPIRY, cache->root[SESSION_BY_EXPIRY], e, rotations);
+    lru_push_front(cache, e);
+    cache->size++;
+    cache->stats.inserts++;
+}
+
+int session_cache_remove(struct SessionCache* cache, int session_id) {
+    struct SessionEntry* e = se_find(cache->root[SESSION_BY_ID], session_id);
+    if (e == NULL)
+        return 0;
+    session_unlink(cache, e);
+    cache->stats.removes++;
+    return 1;
+}
+
+int session_cache_expire(struct SessionCache* cache, int now) {
+    if (cache->ttl <= 0)
+        return 0;
+    int purged = 0;
+    long long* rotations = &cache->stats.rotations;
+    while (cache->root[SESSION_BY_EXPIRY] != NULL) {
+        struct SessionEntry* oldest = cache->root[SESSION_BY_EXPIRY];
+        while (oldest->link[SESSION_BY_EXPIRY][0] != NULL)
+            oldest = oldest->link[SESSION_BY_EXPIRY][0];
+        if (oldest->expires > now)
+            break;
+        if (oldest->deadline > now) {
+            // Сессию продлили после постановки в индекс - переставить
+            cache->root[SESSION_BY_EXPIRY] = se_remove(SESSION_BY_EXPIRY, cache->root[SESSION_BY_EXPIRY], oldest, rotations);
+            oldest->expires = oldest->deadline;
+            cache->root[SESSION_BY_EXPIRY] = se_insert(SESSION_BY_EXPIRY, cache->root[SESSION_BY_EXPIRY], oldest, rotations);
+            continue;
+        }
+        session_unlink(cache, oldest);
+        purged++;
+    }
+    cache->stats.expired += purged;
+    return purged;
+}
+
+int session_cache_size(struct SessionCache* cache) {
+    return cache->size;
+}
+
+size_t session_cache_memory_bytes(struct SessionCache* cache) {
+    return sizeof(struct SessionCache) + (size_t)cache->capacity * sizeof(struct SessionEntry);
+}
+
+void session_cache_get_stats(struct SessionCache* cache, struct SessionCacheStats* stats) {
+    *stats = cache->stats;
+}
+
+// ==================== ТЕСТ 20: КЕШ СЕССИЙ ====================
+
+// Обход индекса: число записей, порядок ключей и высоты
+static int se_check(int t, struct SessionEntry* node, struct SessionEntry* lo, struct SessionEntry* hi, int* ok) {
+    if (node == NULL)
+        return 0;
+    if ((lo && !se_less(t, lo, node)) || (hi && !se_less(t, node, hi)))
+        *ok = 0;
+    int left = se_check(t, node->link[t][0], lo, node, ok);
+    int right = se_check(t, node->link[t][1], node, hi, ok);
+    int balance = se_balance(t, node);
+    if (balance > 1 || balance < -1 || node->height[t] != 1 + (se_height(t, node->link[t][0]) >
+        se_height(t, node->link[t][1]) ? se_height(t, node->link[t][0]) : se_height(t, node->link[t][1])))
+        *ok = 0;
+    return 1 + left + right;
+}
+
+static int session_cache_check(struct SessionCache* cache, int now_purged) {
+    int ok = 1;
+    int lru = 0;
+    for (struct SessionEntry* e = cache->lru_head; e != NULL; e = e->lru_next) {
+        lru++;
+        if (se_find(cache->root[SESSION_BY_ID], e->id) != e)
+            ok = 0;
+        if (cache->ttl > 0 && (e->deadline <= now_purged || e->expires > e->deadline))
+            ok = 0;
+    }
+    int by_id = se_check(SESSION_BY_ID, cache->root[SESSION_BY_ID], NULL, NULL, &ok);
+    int by_expiry = cache->ttl > 0 ?
+        se_check(SESSION_BY_EXPIRY, cache->root[SESSION_BY_EXPIRY], NULL, NULL, &ok) : cache->size;
+    return ok && lru == cache->size && by_id == cache->size && by_expiry == cache->size &&
+           cache->size <= cache->capacity;
+}
+
+// Нагрузка: 5% входов новых пользователей, 3% выходов, остальное - обращения
+// к недавним сессиям (возраст id ~ u^4, свежие сессии активнее). Промах -
+// повторный вход. Время логическое: одна операция - один тик.
+static double run_session_workload(struct SessionCache* cache, int ops, int purge_every,
+                                   int* next_id, double* purge_ns) {
+    const int WINDOW = 262144;
+    int now = 0;
+    clock_t purge_ticks = 0;
+
+    clock_t start = clock();
+    for (int i = 0; i < ops; i++) {
+        now++;
+        int r = rand() % 100;
+        if (r < 5) {
+            session_cache_put(cache, (*next_id)++, now);
+        } else {
+            double u = (double)rand() / ((double)RAND_MAX + 1.0);
+            int offset = (int)(WINDOW * u * u * u * u);
+            int id = *next_id - 1 - offset;
+            if (id < 0)
+                id = 0;
+            if (r < 8) {
+                session_cache_remove(cache, id);
+            } else if (!session_cache_get(cache, id, now)) {
+                session_cache_put(cache, id, now);
+            }
+        }
+
+        // Каждые purge_every тиков (и на тиках входа) удаляем сессии с истекшим TTL
+        if (purge_every > 0 && now % purge_every == 0) {
+            clock_t purge_start = clock();
+            session_cache_expire(cache, now);
+            purge_ticks += clock() - purge_start;
+        }
+    }
+    double total_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC;
+    *purge_ns = (double)purge_ticks * 1e9 / CLOCKS_PER_SEC;
+    return total_ns;
+}
+
+void test_session_cache() {
+    printf("=== ТЕСТ 20: Кеш сессий с бюджетом памяти, LRU и TTL ===\n\n");
+
+    const int OPS = 4000000;
+    const int PREFILL = 100000;
+    const int PURGE_EVERY = 4096;
+    const int TTL = 100000;
+    const int CAPACITIES[] = {16384, 65536, 262144};
+    const int NUM_CAPACITIES = sizeof(CAPACITIES) / sizeof(CAPACITIES[0]);
+
+    srand(time(NULL));
+
+    printf("%d операций: 5%% вход, 3%% выход, 92%% обращение (промах = повторный вход)\n", OPS);
+    printf("TTL %d тиков, очистка истекших каждые %d операций\n\n", TTL, PURGE_EVERY);
+
+    printf("Емкость  | TTL    | Попаданий %% | ns/оп    | Вытеснено  | Истекло    | ns/истекшую | Память МБ | Проверка\n");
+    printf("---------|--------|-------------|----------|------------|------------|-------------|-----------|---------\n");
+
+    int all_ok = 1;
+    int total_sessions = 0;
+    for (int c = 0; c < NUM_CAPACITIES; c++) {
+        for (int with_ttl = 0; with_ttl <= 1; with_ttl++) {
+            struct SessionCache* cache = session_cache_create(CAPACITIES[c], with_ttl ? TTL : 0);
+            int next_id = 0;
+            for (int i = 0; i < PREFILL; i++)
+                session_cache_put(cache, next_id++, 0);
+
+            // Счетчики - только за основной прогон
+            cache->stats = (struct SessionCacheStats){0, 0, 0, 0, 0, 0, 0};
+            double purge_ns = 0;
+            double total_ns = run_session_workload(cache, OPS, with_ttl ? PURGE_EVERY : 0,
+                                                   &next_id, &purge_ns);
+            total_sessions = next_id;
+
+            struct SessionCacheStats stats;
+            session_cache_get_stats(cache, &stats);
+            int ok = session_cache_check(cache, with_ttl ? OPS - OPS % PURGE_EVERY : 0);
+            all_ok &= ok;
+
+            char ttl_label[16];
+            if (with_ttl)
+                snprintf(ttl_label, sizeof(ttl_label), "%d", TTL);
+            else
+                snprintf(ttl_label, sizeof(ttl_label), "-");
+            printf("%-8d | %-6s | %-11.2f | %-8.1f | %-10lld | %-10lld | %-11.1f | %-9.2f | %s\n",
+                   CAPACITIES[c], ttl_label,
+                   100.0 * stats.hits / (stats.hits + stats.misses), total_ns / OPS,
+                   stats.evictions, stats.expired,
+                   stats.expired > 0 ? purge_ns / stats.expired : 0.0,
+                   session_cache_memory_bytes(cache) / (1024.0 * 1024.0), ok ? "OK" : "ОШИБКА");
+            session_cache_free(cache);
+        }
+    }
+
+    // Стоимость вытеснения: вставки новых id в полный кеш против вставок
+    // того же числа id в кеш, где место еще есть
+    const int CAPACITY = 65536;
+    struct SessionCache* full = session_cache_create(CAPACITY, TTL);
+    struct SessionCache* roomy = session_cache_create(2 * CAPACITY, TTL);
+    for (int i = 0; i < CAPACITY; i++) {
+        session_cache_put(full, i, i);
+        session_cache_put(roomy, i, i);
+    }
+    clock_t start = clock();
+    for (int i = CAPACITY; i < 2 * CAPACITY; i++)
+        session_cache_put(roomy, i, i);
+    double plain_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / CAPACITY;
+    start = clock();
+    for (int i = CAPACITY; i < 2 * CAPACITY; i++)
+        session_cache_put(full, i, i);
+    double evict_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / CAPACITY;
+    all_ok &= session_cache_check(full, 0) && session_cache_size(full) == CAPACITY &&
+              se_find(full->root[SESSION_BY_ID], CAPACITY - 1) == NULL;
+
+    printf("\nВставка в кеш на %d записей: %.1f ns без вытеснения, %.1f ns с вытеснением\n",
+           CAPACITY, plain_ns, evict_ns);
+    printf("Стоимость одного вытеснения: %.1f ns (удаление из двух индексов и LRU)\n",
+           evict_ns - plain_ns);
+    printf("Запись кеша %d байт; без ограничения дерево сценария 2 выросло бы\n",
+           (int)sizeof(struct SessionEntry));
+    printf("до %d сессий (%.1f МБ только на узлы AVL)\n", total_sessions,
+           (double)total_sessions * sizeof(struct AVLNode) / (1024.0 * 1024.0));
+    printf("Проверка индексов и LRU: %s\n", all_ok ? "OK" : "ОШИБКА");
+
+    session_cache_free(full);
+    session_cache_free(roomy);
+
+    printf("\nВЫВОД: бюджет записей держит память постоянной, вытеснение стоит двух удалений\n");
+    printf("       из AVL; когда емкость больше рабочего набора, долю попаданий задает TTL\n\n");
+}
@@ -0,0 +1,406 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "methods.h"
+
+// ========== МАЛОЕ МНОЖЕСТВО: МАССИВ В КЕШ-ЛИНИИ ИЛИ ДЕРЕВО ==========
+// До SMALL_SET_CAPACITY ключей множество - отсортированный массив внутри
+// самой структуры (64 байта, одна кеш-линия): ни одного malloc, поиск -
+// четыре SSE2-сравнения и подсчет бит. На (CAPACITY + 1)-м ключе массив
+// превращается в AVL или RBT линейной сборкой, а когда в дереве остается
+// SMALL_SET_DEMOTE ключей, они возвращаются в массив. Разрыв между
+// порогами не дает множеству на границе перестраиваться на каждой операции.
+//
+// В режиме дерева keys[0..1] хранят указатель на корень, keys[2] - размер.
+
+#define SMALL_SET_TREE -1
+
+static void* small_root(const struct SmallSet* set) {
+    void* root;
+    memcpy(&root, set->keys, sizeof(root));
+    return root;
+}
+
+static void small_set_tree_mode(struct SmallSet* set, void* root, int size) {
+    memcpy(set->keys, &root, sizeof(root));
+    set->keys[2] = size;
+    set->count = SMALL_SET_TREE;
+}
+
+// Число ключей массива, меньших key
+static int small_rank(const struct SmallSet* set, int key) {
+#if defined(__SSE2__)
+    // Читаются все 16 слов кеш-линии; лишние (включая count/kind) отсекает маска
+    __m128i k = _mm_set1_epi32(key);
+    const __m128i* v = (const __m128i*)set->keys;
+    unsigned bits = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(k, _mm_load_si128(v))));
+    bits |= _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(k, _mm_load_si128(v + 1)))) << 4;
+    bits |= _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(k, _mm_load_si128(v + 2)))) << 8;
+    bits |= _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(k, _mm_load_si128(v + 3)))) << 12;
+    return __builtin_popcount(bits & ((1u << set->count) - 1));
+#else
+    // Без ветвлений: сумма результатов сравнения
+    int rank = 0;
+    for (int i = 0; i < set->count; i++)
+        rank += set->keys[i] < key;
+    return rank;
+#endif
+}
+
+static int small_collect_avl(struct AVLNode* node, int* out, int pos) {
+    if (node == NULL)
+        return pos;
+    pos = small_collect_avl(node->left, out, pos);
+    out[pos++] = node->key;
+    return small_collect_avl(node->right, out, pos);
+}
+
+static int small_collect_rbt(struct RBNode* node, int* out, int pos) {
+    if (node == NULL)
+        return pos;
+    pos = small_collect_rbt(node->left, out, pos);
+    out[pos++] = node->key;
+    return small_collect_rbt(node->right, out, pos);
+}
+
+void small_set_init(struct SmallSet* set, enum SmallSetKind kind) {
+    memset(set->keys, 0, sizeof(set->keys));
+    set->count = 0;
+    set->kind = (short)kind;
+}
+
+void small_set_clear(struct SmallSet* set) {
+    if (set->count == SMALL_SET_TREE) {
+        if (set->kind == SMALL_SET_AVL)
+            free_avl_tree((struct AVLNode*)small_root(set));
+        else
+            free_rbt_tree((struct RBNode*)small_root(set));
+    }
+    small_set_init(set, (enum SmallSetKind)set->kind);
+}
+
+int small_set_contains(const struct SmallSet* set, int key) {
+    if (set->count != SMALL_SET_TREE) {
+        int r = small_rank(set, key);
+        return r < set->count && set->keys[r] == key;
+    }
+    if (set->kind == SMALL_SET_AVL)
+        return avl_search((struct AVLNode*)small_root(set), key) != NULL;
+    return rbt_search((struct RBNode*)small_root(set), key) != NULL;
+}
+
+int small_set_insert(struct SmallSet* set, int key) {
+    if (set->count != SMALL_SET_TREE) {
+        int r = small_rank(set, key);
+        if (r < set->count && set->keys[r] == key)
+            return 0;
+        if (set->count < SMALL_SET_CAPACITY) {
+            memmove(set->keys + r + 1, set->keys + r, (set->count - r) * sizeof(int));
+            set->keys[r] = key;
+            set->count++;
+            return 1;
+        }
+
+        // Массив полон: все ключи и новый - в дерево
+        int sorted[SMALL_SET_CAPACITY + 1];
+        memcpy(sorted, set->keys, r * sizeof(int));
+        sorted[r] = key;
+        memcpy(sorted + r + 1, set->keys + r, (SMALL_SET_CAPACITY - r) * sizeof(int));
+        void* root = set->kind == SMALL_SET_AVL
+                         ? (void*)avl_build_sorted(sorted, SMALL_SET_CAPACITY + 1)
+                         : (void*)rbt_build_sorted(sorted, SMALL_SET_CAPACITY + 1);
+        small_set_tree_mode(set, root, SMALL_SET_CAPACITY + 1);
+        return 1;
+    }
+
+    // Вставка в деревья не сообщает, был ли ключ, а размер нужен для возврата в массив
+    if (small_set_contains(set, key))
+        return 0;
+    int rotations = 0;
+    int recolorings = 0;
+    void* root;
+    if (set->kind == SMALL_SET_AVL)
+        root = avl_insert((struct AVLNode*)small_root(set), key, &rotations);
+    else
+        root = rbt_insert((struct RBNode*)small_root(set), key, &rotations, &recolorings);
+    small_set_tree_mode(set, root, set->keys[2] + 1);
+    return 1;
+}
+
+int small_set_delete(struct SmallSet* set, int key) {
+    if (set->count != SMALL_SET_TREE) {
+        int r = small_rank(set, key);
+        if (r >= set->count || set->keys[r] != key)
+            return 0;
+        memmove(set->keys + r, set->keys + r + 1, (set->count - r - 1) * sizeof(int));
+        set->count--;
+        return 1;
+    }
+
+    if (!small_set_contains(set, key))
+        return 0;
+    int rotations = 0;
+    int recolorings = 0;
+    int size = set->keys[2] - 1;
+    void* root;
+    if (set->kind == SMALL_SET_AVL)
+        root = avl_delete((struct AVLNode*)small_root(set), key, &rotations);
+    else
+        root = rbt_delete((struct RBNode*)small_root(set), key, &rotations, &recolorings);
+
+    if (size > SMALL_SET_DEMOTE) {
+        small_set_tree_mode(set, root, size);
+        return 1;
+    }
+
+    // Дерево стало маленьким: обратно в массив
+    int keys[SMALL_SET_DEMOTE];
+    if (set->kind == SMALL_SET_AVL) {
+        small_collect_avl((struct AVLNode*)root, keys, 0);
+        free_avl_tree((struct AVLNode*)root);
+    } else {
+        small_collect_rbt((struct RBNode*)root, keys, 0);
+        free_rbt_tree((struct RBNode*)root);
+    }
+    small_set_init(set, (enum SmallSetKind)set->kind);
+    memcpy(set->keys, keys, size * sizeof(int));
+    set->count = (short)size;
+    return 1;
+}
+
+int small_set_size(const struct SmallSet* set) {
+    return set->count == SMALL_SET_TREE ? set->keys[2] : set->count;
+}
+
+int small_set_is_tree(const struct SmallSet* set) {
+    return set->count == SMALL_SET_TREE;
+}
+
+size_t small_set_heap_bytes(const struct SmallSet* set) {
+    if (set->count != SMALL_SET_TREE)
+        return 0;
+    size_t node = set->kind == SMALL_SET_AVL ? sizeof(struct AVLNode) : sizeof(struct RBNode);
+    return (size_t)set->keys[2] * node;
+}
+
+// ==================== ТЕСТ 27: МИЛЛИОНЫ МАЛЫХ МНОЖЕСТВ ====================
+
+// Заголовок блока malloc в glibc
+#define SMALL_MALLOC_HEADER 16
+
+void test_small_set() {
+    printf("=== ТЕСТ 27: Малые множества - массив в кеш-линии против AVL/RBT на каждый набор ===\n\n");
+
+    const int SETS = 1000000;
+    const int KEY_RANGE = 1000;
+    const int LOOKUPS = 10000000;
+    const int SHRINK_TO = 4;  // большие наборы потом сокращаются до стольких ключей
+
+    srand(time(NULL));
+
+    // 90% наборов - 1..12 ключей (как в тестах 1-3), 10% - 13..64
+    int* sizes = (int*)malloc(SETS * sizeof(int));
+    int* offsets = (int*)malloc((SETS + 1) * sizeof(int));
+    int max_size = 0;
+    offsets[0] = 0;
+    for (int s = 0; s < SETS; s++) {
+        sizes[s] = rand() % 10 == 0 ? 13 + rand() % 52 : 1 + rand() % 12;
+        offsets[s + 1] = offsets[s] + sizes[s];
+        if (sizes[s] > max_size)
+            max_size = sizes[s];
+    }
+    int total = offsets[SETS];
+    int* keys = (int*)malloc(total * sizeof(int));
+    // Ключи внутри набора без повторов: иначе сокращение удалило бы и оставляемые
+    for (int s = 0; s < SETS; s++) {
+        int* set_keys = keys + offsets[s];
+        for (int k = 0; k < sizes[s]; k++) {
+            int dup;
+            do {
+                set_keys[k] = rand() % KEY_RANGE;
+                dup = 0;
+                for (int j = 0; j < k; j++)
+                    dup |= set_keys[j] == set_keys[k];
+            } while (dup);
+        }
+    }
+    int* lookup_sets = (int*)malloc(LOOKUPS * sizeof(int));
+    int* lookup_keys = (int*)malloc(LOOKUPS * sizeof(int));
+    for (int i = 0; i < LOOKUPS; i++) {
+        int s = rand() % SETS;
+        lookup_sets[i] = s;
+        // Половина запросов - ключи набора
+        lookup_keys[i] = i % 2 == 0 ? keys[offsets[s] + rand() % sizes[s]] : rand() % KEY_RANGE;
+    }
+    int deletes = 0;
+    for (int s = 0; s < SETS; s++)
+        if (sizes[s] > SMALL_SET_CAPACITY)
+            deletes += sizes[s] - SHRINK_TO;
+
+    printf("Наборов: %d, ключей: %d (в среднем %.1f на набор), поисков: %d\n",
+           SETS, total, (double)total / SETS, LOOKUPS);
+    printf("Порог: до %d ключей - массив (sizeof(SmallSet) = %d), обратно при %d\n",
+           SMALL_SET_CAPACITY, (int)sizeof(struct SmallSet), SMALL_SET_DEMOTE);
+    printf("Память: структуры наборов + узлы с заголовком malloc (%d байт)\n\n", SMALL_MALLOC_HEADER);
+
+    printf("Структура           | Вставка ns | Поиск ns | Удаление ns | Байт/ключ | Деревьев | Проверка\n");
+    printf("--------------------|------------|----------|-------------|-----------|----------|---------\n");
+
+    const char* labels[] = {
+        "SmallSet -> AVL    ", "SmallSet -> RBT    ", "AVL на набор       ", "RBT на набор       "
+    };
+    double lookup_ns[4];
+    double bytes_per_key[4];
+    long long expected_found = -1;
+    int all_ok = 1;
+    for (int v = 0; v < 4; v++) {
+        struct SmallSet* small = NULL;
+        struct AVLNode** avl_roots = NULL;
+        struct RBNode** rbt_roots = NULL;
+        if (v < 2) {
+            small = (struct SmallSet*)aligned_alloc(64, (size_t)SETS * sizeof(struct SmallSet));
+            for (int s = 0; s < SETS; s++)
+                small_set_init(&small[s], v == 0 ? SMALL_SET_AVL : SMALL_SET_RBT);
+        } else if (v == 2) {
+            avl_roots = (struct AVLNode**)calloc(SETS, sizeof(struct AVLNode*));
+        } else {
+            rbt_roots = (struct RBNode**)calloc(SETS, sizeof(struct RBNode*));
+        }
+
+        // Вставка по кругу: k-й ключ во все наборы, затем (k+1)-й
+        int rotations = 0;
+        int recolorings = 0;
+        clock_t start = clock();
+        for (int k = 0; k < max_size; k++) {
+            for (int s = 0; s < SETS; s++) {
+                if (k >= sizes[s])
+                    continue;
+                int key = keys[offsets[s] + k];
+                if (v < 2)
+                    small_set_insert(&small[s], key);
+                else if (v == 2)
+                    avl_roots[s] = avl_insert(avl_roots[s], key, &rotations);
+                else
+                    rbt_roots[s] = rbt_insert(rbt_roots[s], key, &rotations, &recolorings);
+            }
+        }
+        double insert_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / total;
+
+        long long found = 0;
+        start = clock();
+        for (int i = 0; i < LOOKUPS; i++) {
+            int s = lookup_sets[i];
+            if (v < 2)
+                found += small_set_contains(&small[s], lookup_keys[i]);
+            else if (v == 2)
+                found += avl_search(avl_roots[s], lookup_keys[i]) != NULL;
+            else
+                found += rbt_search(rbt_roots[s], lookup_keys[i]) != NULL;
+        }
+        lookup_ns[v] = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / LOOKUPS;
+        if (expected_found < 0)
+            expected_found = found;
+        int ok = found == expected_found;
+
+        // Память и размеры после вставки
+        long long unique = 0;
+        size_t bytes = 0;
+        int trees = 0;
+        for (int s = 0; s < SETS; s++) {
+            if (v < 2) {
+                unique += small_set_size(&small[s]);
+                trees += small_set_is_tree(&small[s]);
+                bytes += sizeof(struct SmallSet) + small_set_heap_bytes(&small[s]) +
+                         (size_t)small_set_is_tree(&small[s]) * small_set_size(&small[s]) *
+                             SMALL_MALLOC_HEADER;
+            } else if (v == 2) {
+                int n = count_avl_nodes(avl_roots[s]);
+                unique += n;
+                trees += n > 0;
+                bytes += sizeof(struct AVLNode*) + (size_t)n * (sizeof(struct AVLNode) + SMALL_MALLOC_HEADER);
+            } else {
+                int n = count_rbt_nodes(rbt_roots[s]);
+                unique += n;
+                trees += n > 0;
+                bytes += sizeof(struct RBNode*) + (size_t)n * (sizeof(struct RBNode) + SMALL_MALLOC_HEADER);
+            }
+        }
+        bytes_per_key[v] = (double)bytes / unique;
+
+        // Большие наборы сокращаются до SHRINK_TO ключей
+        start = clock();
+        for (int s = 0; s < SETS; s++) {
+            if (sizes[s] <= SMALL_SET_CAPACITY)
+                continue;
+            for (int k = SHRINK_TO; k < sizes[s]; k++) {
+                int key = keys[offsets[s] + k];
+                if (v < 2)
+                    small_set_delete(&small[s], key);
+                else if (v == 2)
+                    avl_roots[s] = avl_delete(avl_roots[s], key, &rotations);
+                else
+                    rbt_roots[s] = rbt_delete(rbt_roots[s], key, &rotations, &recolorings);
+            }
+        }
+        double delete_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / deletes;
+
+        // После сокращения все наборы снова массивы, ключи на месте
+        for (int s = 0; s < SETS && ok; s++) {
+            int first = offsets[s];
+            int count = sizes[s] > SMALL_SET_CAPACITY ? SHRINK_TO : sizes[s];
+            for (int k = 0; k < count && ok; k++) {
+                if (v < 2)
+                    ok = small_set_contains(&small[s], keys[first + k]) && !small_set_is_tree(&small[s]);
+                else if (v == 2)
+                    ok = avl_search(avl_roots[s], keys[first + k]) != NULL;
+                else
+                    ok = rbt_search(rbt_roots[s], keys[first + k]) != NULL;
+            }
+        }
+        all_ok &= ok;
+
+        printf("%s | %10.1f | %8.1f | %11.1f | %9.1f | %7.1f%% | %s\n",
+               labels[v], insert_ns, lookup_ns[v], delete_ns, bytes_per_key[v],
+               100.0 * trees / SETS, ok ? "ok" : "ОШИБКА");
+
+        for (int s = 0; s < SETS; s++) {
+            if (v < 2)
+                small_set_clear(&small[s]);
+            else if (v == 2)
+                free_avl_tree(avl_roots[s]);
+            else
+                free_rbt_tree(rbt_roots[s]);
+        }
+        free(small);
+        free(avl_roots);
+        free(rbt_roots);
+    }
+
+    printf("\n\"Деревьев\" - доля наборов, хранимых деревом (для AVL/RBT на набор - непустые)\n");
+    printf("Проверка (одинаковые результаты поиска, ключи после сокращения): %s\n\n",
+           all_ok ? "ok" : "ОШИБКА");
+
+    printf("ВЫВОД:\n");
+    printf("• Поиск в малом наборе: %.0f ns против %.0f (AVL) и %.0f (RBT) - одна кеш-линия\n",
+           lookup_ns[0], lookup_ns[2], lookup_ns[3]);
+    printf("  и 4 SSE2-сравнения вместо цепочки промахов по узлам\n");
+    printf("• Память: %.1f байт на ключ против %.1f (AVL) и %.1f (RBT): нет заголовков\n",
+           bytes_per_key[0], bytes_per_key[2], bytes_per_key[3]);
+    printf("  malloc и указателей; большие наборы по-прежнему живут в дереве\n");
+    printf("• Удаление из дерева набора не быстрее чистого дерева: лишний поиск ради\n");
+    printf("  точного размера и сборка массива при возврате\n");
+    printf("• Для наборов в несколько ключей дерево - лишняя роскошь: переход в дерево\n");
+    printf("  нужен только, когда набор вырастает за кеш-линию\n\n");
+
+    free(sizes);
+    free(offsets);
+    free(keys);
+    free(lookup_sets);
+    free(lookup_keys);
+}
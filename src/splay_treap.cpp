@@ -0,0 +1,414 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "methods.h"
+
+// ========== SPLAY ДЕРЕВО (НИСХОДЯЩЕЕ РАСШИРЕНИЕ) ==========
+// Каждый доступ поднимает ключ в корень, поэтому часто запрашиваемые
+// ключи оказываются у корня. Нисходящий вариант (Sleator-Tarjan) делает
+// расширение за один проход сверху вниз без стека и родителей.
+
+static struct SplayNode* splay_create_node(int key) {
+    struct SplayNode* node = (struct SplayNode*)malloc(sizeof(struct SplayNode));
+    node->key = key;
+    node->left = node->right = NULL;
+    return node;
+}
+
+static struct SplayNode* splay(struct SplayNode* t, int key, int* rotations) {
+    if (t == NULL)
+        return NULL;
+
+    // header.right - собранное левое дерево, header.left - правое
+    struct SplayNode header;
+    header.left = header.right = NULL;
+    struct SplayNode* l = &header;
+    struct SplayNode* r = &header;
+
+    for (;;) {
+        if (key < t->key) {
+            if (t->left == NULL)
+                break;
+            if (key < t->left->key) {
+                // Zig-zig: поворот направо
+                struct SplayNode* y = t->left;
+                t->left = y->right;
+                y->right = t;
+                t = y;
+                (*rotations)++;
+                if (t->left == NULL)
+                    break;
+            }
+            r->left = t;
+            r = t;
+            t = t->left;
+        } else if (key > t->key) {
+            if (t->right == NULL)
+                break;
+            if (key > t->right->key) {
+                struct SplayNode* y = t->right;
+                t->right = y->left;
+                y->left = t;
+                t = y;
+                (*rotations)++;
+                if (t->right == NULL)
+                    break;
+            }
+            l->right = t;
+            l = t;
+            t = t->right;
+        } else {
+            break;
+        }
+    }
+
+    l->right = t->left;
+    r->left = t->right;
+    t->left = header.right;
+    t->right = header.left;
+    return t;
+}
+
+struct SplayNode* splay_search(struct SplayNode* root, int key, int* rotations) {
+    return splay(root, key, rotations);
+}
+
+struct SplayNode* splay_insert(struct SplayNode* root, int key, int* rotations) {
+    if (root == NULL)
+        return splay_create_node(key);
+
+    root = splay(root, key, rotations);
+    if (key == root->key)
+        return root;
+
+    struct SplayNode* node = splay_create_node(key);
+    if (key < root->key) {
+        node->left = root->left;
+        node->right = root;
+        root->left = NULL;
+    } else {
+        node->right = root->right;
+        node->left = root;
+        root->right = NULL;
+    }
+    return node;
+}
+
+struct SplayNode* splay_delete(struct SplayNode* root, int key, int* rotations) {
+    if (root == NULL)
+        return NULL;
+
+    root = splay(root, key, rotations);
+    if (key != root->key)
+        return root;
+
+    struct SplayNode* rest;
+    if (root->left == NULL) {
+        rest = root->right;
+    } else {
+        // Максимум левого поддерева поднимается в корень, у него нет правого сына
+        rest = splay(root->left, key, rotations);
+        rest->right = root->right;
+    }
+    free(root);
+    return rest;
+}
+
+void free_splay_tree(struct SplayNode* root) {
+    // Без рекурсии: splay-дерево может выродиться в длинную цепочку
+    while (root != NULL) {
+        if (root->left != NULL) {
+            struct SplayNode* l = root->left;
+            root->left = l->right;
+            l->right = root;
+            root = l;
+        } else {
+            struct SplayNode* next = root->right;
+            free(root);
+            root = next;
+        }
+    }
+}
+
+// ========== ДЕКАРТОВО ДЕРЕВО (TREAP) ==========
+// BST по ключам и куча по случайным приоритетам: ожидаемая глубина
+// O(log n) без хранения высот и цветов.
+
+static unsigned int treap_random_state = 2463534242u;
+
+static unsigned int treap_random() {
+    // xorshift32: отдельный генератор, чтобы не сбивать rand() в тестах
+    unsigned int x = treap_random_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    treap_random_state = x;
+    return x;
+}
+
+static struct TreapNode* treap_rotate_right(struct TreapNode* y) {
+    struct TreapNode* x = y->left;
+    y->left = x->right;
+    x->right = y;
+    return x;
+}
+
+static struct TreapNode* treap_rotate_left(struct TreapNode* x) {
+    struct TreapNode* y = x->right;
+    x->right = y->left;
+    y->left = x;
+    return y;
+}
+
+struct TreapNode* treap_insert(struct TreapNode* node, int key, int* rotations) {
+    if (node == NULL) {
+        struct TreapNode* new_node = (struct TreapNode*)malloc(sizeof(struct TreapNode));
+        new_node->key = key;
+        new_node->priority = treap_random();
+        new_node->left = new_node->right = NULL;
+        return new_node;
+    }
+
+    if (key < node->key) {
+        node->left = treap_insert(node->left, key, rotations);
+        if (node->left->priority > node->priority) {
+            (*rotations)++;
+            node = treap_rotate_right(node);
+        }
+    } else if (key > node->key) {
+        node->right = treap_insert(node->right, key, rotations);
+        if (node->right->priority > node->priority) {
+            (*rotations)++;
+            node = treap_rotate_left(node);
+        }
+    }
+    return node;
+}
+
+struct TreapNode* treap_delete(struct TreapNode* node, int key, int* rotations) {
+    if (node == NULL)
+        return NULL;
+
+    if (key < node->key) {
+        node->left = treap_delete(node->left, key, rotations);
+    } else if (key > node->key) {
+        node->right = treap_delete(node->right, key, rotations);
+    } else if (node->left == NULL || node->right == NULL) {
+        struct TreapNode* child = node->left != NULL ? node->left : node->right;
+        free(node);
+        return child;
+    } else {
+        // Опускаем узел поворотом в сторону сына с меньшим приоритетом
+        (*rotations)++;
+        if (node->left->priority > node->right->priority) {
+            node = treap_rotate_right(node);
+            node->right = treap_delete(node->right, key, rotations);
+        } else {
+            node = treap_rotate_left(node);
+            node->left = treap_delete(node->left, key, rotations);
+        }
+    }
+    return node;
+}
+
+struct TreapNode* treap_search(struct TreapNode* node, int key) {
+    while (node != NULL && node->key != key)
+        node = key < node->key ? node->left : node->right;
+    return node;
+}
+
+void free_treap(struct TreapNode* root) {
+    if (root == NULL) return;
+    free_treap(root->left);
+    free_treap(root->right);
+    free(root);
+}
+
+// ==================== ТЕСТ 14: SPLAY И TREAP НА НЕРАВНОМЕРНОМ ДОСТУПЕ ====================
+
+// Поток запросов по закону Ципфа: ранг r выбирается с вероятностью ~ 1/r^s.
+// Ранги отображаются на перемешанные ключи, чтобы горячие ключи были
+// разбросаны по всему дереву, а не собраны у минимума.
+static void zipf_stream(const int* keys, int n, double s, int* out, int count) {
+    double* cdf = (double*)malloc(n * sizeof(double));
+    double sum = 0;
+    for (int i = 0; i < n; i++) {
+        sum += 1.0 / pow((double)(i + 1), s);
+        cdf[i] = sum;
+    }
+    for (int i = 0; i < count; i++) {
+        double u = ((double)rand() / ((double)RAND_MAX + 1.0)) * sum;
+        int lo = 0;
+        int hi = n - 1;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (cdf[mid] < u)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        out[i] = keys[lo];
+    }
+    free(cdf);
+}
+
+void test_splay_treap() {
+    printf("=== ТЕСТ 14: Splay-дерево и декартово дерево на неравномерном доступе ===\n\n");
+
+    const int N = 1 << 18;
+    const int NUM_LOOKUPS = 1000000;
+    const double SKEWS[] = {0.0, 0.5, 0.8, 0.99, 1.2, 1.5};
+    const int NUM_SKEWS = sizeof(SKEWS) / sizeof(SKEWS[0]);
+
+    srand(time(NULL));
+
+    // Уникальные ключи в случайном порядке
+    int* keys = (int*)malloc(N * sizeof(int));
+    for (int i = 0; i < N; i++)
+        keys[i] = i * 4;
+    for (int i = N - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        int tmp = keys[i];
+        keys[i] = keys[j];
+        keys[j] = tmp;
+    }
+
+    struct AVLNode* avl_root = NULL;
+    struct RBNode* rbt_root = NULL;
+    struct SplayNode* splay_root = NULL;
+    struct TreapNode* treap_root = NULL;
+    int avl_rotations = 0;
+    int rbt_rotations = 0;
+    int rbt_recolorings = 0;
+    int splay_rotations = 0;
+    int treap_rotations = 0;
+
+    clock_t start = clock();
+    for (int i = 0; i < N; i++)
+        splay_root = splay_insert(splay_root, keys[i], &splay_rotations);
+    double splay_insert_ms = (double)(clock() - start) * 1000 / CLOCKS_PER_SEC;
+
+    start = clock();
+    for (int i = 0; i < N; i++)
+        treap_root = treap_insert(treap_root, keys[i], &treap_rotations);
+    double treap_insert_ms = (double)(clock() - start) * 1000 / CLOCKS_PER_SEC;
+
+    start = clock();
+    for (int i = 0; i < N; i++)
+        avl_root = avl_insert(avl_root, keys[i], &avl_rotations);
+    double avl_insert_ms = (double)(clock() - start) * 1000 / CLOCKS_PER_SEC;
+
+    start = clock();
+    for (int i = 0; i < N; i++)
+        rbt_root = rbt_insert(rbt_root, keys[i], &rbt_rotations, &rbt_recolorings);
+    double rbt_insert_ms = (double)(clock() - start) * 1000 / CLOCKS_PER_SEC;
+
+    printf("Вставка %d ключей: AVL %.3f ms, RBT %.3f ms, Splay %.3f ms, Treap %.3f ms\n\n",
+           N, avl_insert_ms, rbt_insert_ms, splay_insert_ms, treap_insert_ms);
+
+    printf("Поиск, ns/операция (%d запросов, Zipf с параметром s):\n", NUM_LOOKUPS);
+    printf("%-5s | %-9s | %-9s | %-9s | %-9s | %-13s | %s\n",
+           "s", "AVL", "RBT", "Splay", "Treap", "Лучший", "Splay vs лучшее из AVL/RBT");
+    printf("------|-----------|-----------|-----------|-----------|---------------|---------------------------\n");
+
+    int* stream = (int*)malloc(NUM_LOOKUPS * sizeof(int));
+    for (int k = 0; k < NUM_SKEWS; k++) {
+        zipf_stream(keys, N, SKEWS[k], stream, NUM_LOOKUPS);
+
+        start = clock();
+        int avl_found = 0;
+        for (int i = 0; i < NUM_LOOKUPS; i++)
+            avl_found += avl_search(avl_root, stream[i]) != NULL;
+        double avl_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / NUM_LOOKUPS;
+
+        start = clock();
+        int rbt_found = 0;
+        for (int i = 0; i < NUM_LOOKUPS; i++)
+            rbt_found += rbt_search(rbt_root, stream[i]) != NULL;
+        double rbt_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / NUM_LOOKUPS;
+
+        start = clock();
+        int splay_found = 0;
+        for (int i = 0; i < NUM_LOOKUPS; i++) {
+            splay_root = splay_search(splay_root, stream[i], &splay_rotations);
+            splay_found += splay_root->key == stream[i];
+        }
+        double splay_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / NUM_LOOKUPS;
+
+        start = clock();
+        int treap_found = 0;
+        for (int i = 0; i < NUM_LOOKUPS; i++)
+            treap_found += treap_search(treap_root, stream[i]) != NULL;
+        double treap_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / NUM_LOOKUPS;
+
+        const char* best = "AVL";
+        double best_ns = avl_ns;
+        if (rbt_ns < best_ns) { best = "RBT"; best_ns = rbt_ns; }
+        if (splay_ns < best_ns) { best = "Splay"; best_ns = splay_ns; }
+        if (treap_ns < best_ns) { best = "Treap"; best_ns = treap_ns; }
+        double balanced_ns = avl_ns < rbt_ns ? avl_ns : rbt_ns;
+
+        printf("%-5.2f | %-9.1f | %-9.1f | %-9.1f | %-9.1f | %-13s | %+.1f%%%s\n",
+               SKEWS[k], avl_ns, rbt_ns, splay_ns, treap_ns, best,
+               (balanced_ns - splay_ns) / balanced_ns * 100,
+               avl_found == NUM_LOOKUPS && rbt_found == NUM_LOOKUPS &&
+               splay_found == NUM_LOOKUPS && treap_found == NUM_LOOKUPS ? "" : " ОШИБКА");
+    }
+
+    // Удаление половины ключей во всех четырех структурах
+    start = clock();
+    for (int i = 0; i < N / 2; i++)
+        avl_root = avl_delete(avl_root, keys[i], &avl_rotations);
+    double avl_delete_ms = (double)(clock() - start) * 1000 / CLOCKS_PER_SEC;
+
+    start = clock();
+    for (int i = 0; i < N / 2; i++)
+        rbt_root = rbt_delete(rbt_root, keys[i], &rbt_rotations, &rbt_recolorings);
+    double rbt_delete_ms = (double)(clock() - start) * 1000 / CLOCKS_PER_SEC;
+
+    start = clock();
+    for (int i = 0; i < N / 2; i++)
+        splay_root = splay_delete(splay_root, keys[i], &splay_rotations);
+    double splay_delete_ms = (double)(clock() - start) * 1000 / CLOCKS_PER_SEC;
+
+    start = clock();
+    for (int i = 0; i < N / 2; i++)
+        treap_root = treap_delete(treap_root, keys[i], &treap_rotations);
+    double treap_delete_ms = (double)(clock() - start) * 1000 / CLOCKS_PER_SEC;
+
+    int avl_left = 0;
+    int rbt_left = 0;
+    int splay_left = 0;
+    int treap_left = 0;
+    for (int i = 0; i < N; i++) {
+        avl_left += avl_search(avl_root, keys[i]) != NULL;
+        rbt_left += rbt_search(rbt_root, keys[i]) != NULL;
+        splay_root = splay_search(splay_root, keys[i], &splay_rotations);
+        splay_left += splay_root != NULL && splay_root->key == keys[i];
+        treap_left += treap_search(treap_root, keys[i]) != NULL;
+    }
+
+    printf("\nУдаление %d ключей (осталось, ожидалось %d):\n", N / 2, N - N / 2);
+    printf("AVL %.3f ms (%d), RBT %.3f ms (%d), Splay %.3f ms (%d), Treap %.3f ms (%d)%s\n",
+           avl_delete_ms, avl_left, rbt_delete_ms, rbt_left, splay_delete_ms, splay_left,
+           treap_delete_ms, treap_left,
+           avl_left == N - N / 2 && rbt_left == N - N / 2 && splay_left == N - N / 2 &&
+           treap_left == N - N / 2 && avl_is_valid(avl_root) && rbt_is_valid(rbt_root)
+               ? "" : " ОШИБКА");
+    printf("Вращений всего: AVL %d, Splay %d, Treap %d\n",
+           avl_rotations, splay_rotations, treap_rotations);
+
+    free(stream);
+    free(keys);
+    free_avl_tree(avl_root);
+    free_rbt_tree(rbt_root);
+    free_splay_tree(splay_root);
+    free_treap(treap_root);
+
+    printf("\nВЫВОД: при равномерном доступе строгий баланс (AVL/RBT) заметно быстрее: splay\n");
+    printf("       пишет в память на каждом поиске, а верхние уровни treap разбросаны по куче.\n");
+    printf("       С ростом перекоса отставание splay быстро сокращается - горячие ключи\n");
+    printf("       оказываются у корня; смотрите на знак последней колонки\n\n");
+}
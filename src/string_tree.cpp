@@ -0,0 +1,855 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <map>
+#include <string>
+
+#include "methods.h"
+
+// ========== AVL/RBT СО СТРОКОВЫМИ КЛЮЧАМИ ==========
+// Байты ключей лежат подряд в одной арене (ссылка - смещение, а не
+// указатель: арена растет через realloc), узел хранит длину и первые
+// 16 байт ключа как два big-endian числа. Сравнение таких пар
+// совпадает с лексикографическим сравнением первых 16 байт, поэтому
+// до арены сравнение доходит, только если совпали префиксы. Ключ не
+// длиннее 16 байт целиком лежит в узле и в арену не попадает.
+// Префикс в 16 байт покрывает общие начала доменных имен ("www.",
+// "api.") у соседей по дереву, и сравнение обычно решается в узле.
+//
+// Фронтальное кодирование (front_coding = 1): новый ключ записывается
+// как ссылка на полностью сохраненный ключ-базу, число общих байт
+// (lcp) и свой хвост. Базу берем у соседей по порядку (предшественник
+// и преемник в момент вставки) - у отсортированных доменных имен они
+// делят самый длинный префикс. Цепочек нет: база всегда хранится целиком.
+// Арена только растет; удаления ключей нет.
+
+#define STR_PREFIX_BYTES 16
+#define STR_FC_HEADER 4       // ссылка на базу перед хвостом
+#define STR_ARENA_INITIAL 4096
+
+struct StrKeys {
+    char* arena;
+    size_t used;
+    size_t capacity;
+    int front_coding;
+    int count;
+    long long compares;       // сравнений ключей
+    long long full_compares;  // из них дошли до арены
+};
+
+struct StrAVLNode {
+    uint64_t prefix[2];
+    uint32_t ref;    // смещение ключа в арене (при lcp > 0 - заголовка с базой)
+    uint8_t len;
+    uint8_t lcp;     // 0 - ключ хранится целиком
+    int8_t height;
+    struct StrAVLNode* left;
+    struct StrAVLNode* right;
+};
+
+struct StrRBNode {
+    uint64_t prefix[2];
+    uint32_t ref;
+    uint8_t len;
+    uint8_t lcp;
+    uint8_t color;   // RED / BLACK
+    struct StrRBNode* left;
+    struct StrRBNode* right;
+    struct StrRBNode* parent;
+};
+
+struct StrAVLTree {
+    struct StrKeys keys;
+    struct StrAVLNode* root;
+};
+
+struct StrRBTree {
+    struct StrKeys keys;
+    struct StrRBNode* root;
+};
+
+// Соседний по порядку ключ, от которого можно взять базу
+struct StrNeighbor {
+    const uint64_t* prefix;
+    uint32_t ref;
+    int len;
+    int lcp;
+};
+
+static void str_keys_init(struct StrKeys* keys, int front_coding) {
+    keys->arena = (char*)malloc(STR_ARENA_INITIAL);
+    keys->used = 0;
+    keys->capacity = STR_ARENA_INITIAL;
+    keys->front_coding = front_coding;
+    keys->count = 0;
+    keys->compares = 0;
+    keys->full_compares = 0;
+}
+
+static uint64_t str_prefix_word(const char* key, int len) {
+    if (len >= 8) {
+        uint64_t value;
+        memcpy(&value, key, sizeof(value));
+        return __builtin_bswap64(value);
+    }
+    uint64_t value = 0;
+    for (int i = 0; i < len; i++)
+        value |= (uint64_t)(uint8_t)key[i] << (56 - 8 * i);
+    return value;
+}
+
+static void str_prefix(const char* key, int len, uint64_t* prefix) {
+    prefix[0] = str_prefix_word(key, len);
+    prefix[1] = len > 8 ? str_prefix_word(key + 8, len - 8) : 0;
+}
+
+static uint32_t str_load_ref(const char* p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static uint32_t str_arena_append(struct StrKeys* keys, const void* data, size_t bytes) {
+    if (keys->used + bytes > keys->capacity) {
+        while (keys->used + bytes > keys->capacity)
+            keys->capacity *= 2;
+        keys->arena = (char*)realloc(keys->arena, keys->capacity);
+    }
+    uint32_t ref = (uint32_t)keys->used;
+    memcpy(keys->arena + keys->used, data, bytes);
+    keys->used += bytes;
+    return ref;
+}
+
+// Полный ключ узла в буфер (до 255 байт)
+static void str_decode(const struct StrKeys* keys, const uint64_t* prefix, uint32_t ref,
+                       int len, int lcp, char* out) {
+    if (len <= STR_PREFIX_BYTES) {
+        for (int i = 0; i < len; i++)
+            out[i] = (char)(prefix[i / 8] >> (56 - 8 * (i % 8)));
+        return;
+    }
+    const char* p = keys->arena + ref;
+    if (lcp == 0) {
+        memcpy(out, p, len);
+        return;
+    }
+    memcpy(out, keys->arena + str_load_ref(p), lcp);
+    memcpy(out + lcp, p + STR_FC_HEADER, len - lcp);
+}
+
+static int str_tail_compare(const char* a, int alen, const char* b, int blen) {
+    int n = alen < blen ? alen : blen;
+    if (n > 0) {
+        int c = memcmp(a, b, n);
+        if (c != 0)
+            return c;
+    }
+    return alen - blen;
+}
+
+// Сравнение запроса q с ключом узла: <0, 0, >0
+static int str_compare(struct StrKeys* keys, const char* q, int qlen, const uint64_t* qprefix,
+                       const uint64_t* prefix, uint32_t ref, int len, int lcp) {
+    keys->compares++;
+    if (qprefix[0] != prefix[0])
+        return qprefix[0] < prefix[0] ? -1 : 1;
+    if (qprefix[1] != prefix[1])
+        return qprefix[1] < prefix[1] ? -1 : 1;
+    // Префиксы равны: если хоть один ключ не длиннее 16 байт, решает длина
+    if (qlen <= STR_PREFIX_BYTES || len <= STR_PREFIX_BYTES)
+        return qlen - len;
+
+    keys->full_compares++;
+    const char* p = keys->arena + ref;
+    int pos = STR_PREFIX_BYTES;
+    if (lcp == 0)
+        return str_tail_compare(q + pos, qlen - pos, p + pos, len - pos);
+
+    const char* base = keys->arena + str_load_ref(p);
+    if (pos < lcp) {
+        // Узел длиннее lcp, поэтому запрос короче lcp меньше узла
+        int n = (qlen < lcp ? qlen : lcp) - pos;
+        int c = memcmp(q + pos, base + pos, n);
+        if (c != 0)
+            return c;
+        if (qlen < lcp)
+            return -1;
+        pos = lcp;
+    }
+    return str_tail_compare(q + pos, qlen - pos, p + STR_FC_HEADER + (pos - lcp), len - pos);
+}
+
+static int str_common_prefix(const char* a, int alen, const char* b, int blen) {
+    int n = alen < blen ? alen : blen;
+    int i = 0;
+    while (i < n && a[i] == b[i])
+        i++;
+    return i;
+}
+
+// Кандидат в базы: полный ключ соседа или его собственная база
+static void str_base_candidate(const struct StrKeys* keys, const char* q, int qlen,
+                               const struct StrNeighbor* nb, uint32_t* base, int* shared) {
+    char buffer[256];
+    str_decode(keys, nb->prefix, nb->ref, nb->len, nb->lcp, buffer);
+    int common = str_common_prefix(q, qlen, buffer, nb->len);
+    if (nb->lcp == 0) {
+        *base = nb->ref;
+        *shared = common;
+    } else {
+        // С базой соседа гарантированно совпадают первые min(common, lcp) байт
+        *base = str_load_ref(keys->arena + nb->ref);
+        *shared = common < nb->lcp ? common : nb->lcp;
+    }
+}
+
+// Записывает ключ в арену; *lcp = 0 - целиком
+static uint32_t str_store(struct StrKeys* keys, const char* q, int qlen,
+                          const struct StrNeighbor* pred, const struct StrNeighbor* succ,
+                          uint8_t* lcp) {
+    *lcp = 0;
+    if (qlen <= STR_PREFIX_BYTES)
+        return 0;
+    if (keys->front_coding) {
+        uint32_t best_base = 0;
+        int best_shared = 0;
+        const struct StrNeighbor* neighbors[2] = {pred, succ};
+        for (int i = 0; i < 2; i++) {
+            // Короткий сосед весь в узле - базой служить не может
+            if (neighbors[i] == NULL || neighbors[i]->len <= STR_PREFIX_BYTES)
+                continue;
+            uint32_t base;
+            int shared;
+            str_base_candidate(keys, q, qlen, neighbors[i], &base, &shared);
+            if (shared > best_shared) {
+                best_base = base;
+                best_shared = shared;
+            }
+        }
+        // Ссылка на базу стоит 4 байта - короче общий префикс не выгоден
+        if (best_shared > STR_FC_HEADER) {
+            uint32_t ref = str_arena_append(keys, &best_base, STR_FC_HEADER);
+            str_arena_append(keys, q + best_shared, qlen - best_shared);
+            *lcp = (uint8_t)best_shared;
+            return ref;
+        }
+    }
+    return str_arena_append(keys, q, qlen);
+}
+
+static void str_fill_stats(const struct StrKeys* keys, size_t node_size, struct StrTreeStats* stats) {
+    stats->count = keys->count;
+    stats->compares = keys->compares;
+    stats->full_compares = keys->full_compares;
+    stats->node_bytes = (size_t)keys->count * node_size;
+    stats->arena_bytes = keys->used;
+}
+
+// ---------- AVL ----------
+
+static int str_avl_h(struct StrAVLNode* node) {
+    return node ? node->height : 0;
+}
+
+static void str_avl_fix_height(struct StrAVLNode* node) {
+    int hl = str_avl_h(node->left);
+    int hr = str_avl_h(node->right);
+    node->height = 1 + (hl > hr ? hl : hr);
+}
+
+static struct StrAVLNode* str_avl_rotate_right(struct StrAVLNode* y) {
+    struct StrAVLNode* x = y->left;
+    y->left = x->right;
+    x->right = y;
+    str_avl_fix_height(y);
+    str_avl_fix_height(x);
+    return x;
+}
+
+static struct StrAVLNode* str_avl_rotate_left(struct StrAVLNode* x) {
+    struct StrAVLNode* y = x->right;
+    x->right = y->left;
+    y->left = x;
+    str_avl_fix_height(x);
+    str_avl_fix_height(y);
+    return y;
+}
+
+static struct StrNeighbor str_avl_neighbor(struct StrAVLNode* node) {
+    struct StrNeighbor nb = {node->prefix, node->ref, node->len, node->lcp};
+    return nb;
+}
+
+// pred/succ - ближайшие предки, от которых спуск шел вправо/влево
+static struct StrAVLNode* str_avl_insert_rec(struct StrAVLTree* tree, struct StrAVLNode* node,
+                                             const char* q, int qlen, const uint64_t* qprefix,
+                                             struct StrAVLNode* pred, struct StrAVLNode* succ,
+                                             int* inserted) {
+    if (node == NULL) {
+        struct StrNeighbor pn;
+        struct StrNeighbor sn;
+        if (pred != NULL)
+            pn = str_avl_neighbor(pred);
+        if (succ != NULL)
+            sn = str_avl_neighbor(succ);
+
+        struct StrAVLNode* new_node = (struct StrAVLNode*)malloc(sizeof(struct StrAVLNode));
+        new_node->prefix[0] = qprefix[0];
+        new_node->prefix[1] = qprefix[1];
+        new_node->len = (uint8_t)qlen;
+        new_node->ref = str_store(&tree->keys, q, qlen, pred ? &pn : NULL, succ ? &sn : NULL,
+                                  &new_node->lcp);
+        new_node->height = 1;
+        new_node->left = new_node->right = NULL;
+        *inserted = 1;
+        return new_node;
+    }
+
+    int c = str_compare(&tree->keys, q, qlen, qprefix, node->prefix, node->ref, node->len, node->lcp);
+    if (c < 0)
+        node->left = str_avl_insert_rec(tree, node->left, q, qlen, qprefix, pred, node, inserted);
+    else if (c > 0)
+        node->right = str_avl_insert_rec(tree, node->right, q, qlen, qprefix, node, succ, inserted);
+    else
+        return node;
+    if (!*inserted)
+        return node;
+
+    str_avl_fix_height(node);
+    int balance = str_avl_h(node->left) - str_avl_h(node->right);
+    // Сторону внука определяем по балансу сына, чтобы не сравнивать строки еще раз
+    if (balance > 1) {
+        if (str_avl_h(node->left->left) < str_avl_h(node->left->right))
+            node->left = str_avl_rotate_left(node->left);
+        return str_avl_rotate_right(node);
+    }
+    if (balance < -1) {
+        if (str_avl_h(node->right->right) < str_avl_h(node->right->left))
+            node->right = str_avl_rotate_right(node->right);
+        return str_avl_rotate_left(node);
+    }
+    return node;
+}
+
+struct StrAVLTree* str_avl_create(int front_coding) {
+    struct StrAVLTree* tree = (struct StrAVLTree*)malloc(sizeof(struct StrAVLTree));
+    str_keys_init(&tree->keys, front_coding);
+    tree->root = NULL;
+    return tree;
+}
+
+static void str_avl_free_nodes(struct StrAVLNode* node) {
+    if (node == NULL)
+        return;
+    str_avl_free_nodes(node->left);
+    str_avl_free_nodes(node->right);
+    free(node);
+}
+
+void str_avl_free(struct StrAVLTree* tree) {
+    if (tree == NULL)
+        return;
+    str_avl_free_nodes(tree->root);
+    free(tree->keys.arena);
+    free(tree);
+}
+
+int str_avl_insert(struct StrAVLTree* tree, const char* key, int len) {
+    if (len < 0 || len > STR_KEY_MAX)
+        return -1;
+    uint64_t qprefix[2];
+    str_prefix(key, len, qprefix);
+    int inserted = 0;
+    tree->root = str_avl_insert_rec(tree, tree->root, key, len, qprefix, NULL, NULL, &inserted);
+    tree->keys.count += inserted;
+    return inserted;
+}
+
+int str_avl_contains(struct StrAVLTree* tree, const char* key, int len) {
+    if (len < 0 || len > STR_KEY_MAX)
+        return 0;
+    uint64_t qprefix[2];
+    str_prefix(key, len, qprefix);
+    struct StrAVLNode* node = tree->root;
+    while (node != NULL) {
+        int c = str_compare(&tree->keys, key, len, qprefix, node->prefix, node->ref, node->len,
+                            node->lcp);
+        if (c == 0)
+            return 1;
+        node = c < 0 ? node->left : node->right;
+    }
+    return 0;
+}
+
+int str_avl_height(struct StrAVLTree* tree) {
+    return str_avl_h(tree->root);
+}
+
+void str_avl_get_stats(struct StrAVLTree* tree, struct StrTreeStats* stats) {
+    str_fill_stats(&tree->keys, sizeof(struct StrAVLNode), stats);
+}
+
+// Обход по порядку: строго возрастающие ключи и верные высоты
+static int str_avl_check(struct StrAVLTree* tree, struct StrAVLNode* node, char* prev, int* prev_len,
+                         int* has_prev, int* count) {
+    if (node == NULL)
+        return 1;
+    if (!str_avl_check(tree, node->left, prev, prev_len, has_prev, count))
+        return 0;
+    char key[256];
+    str_decode(&tree->keys, node->prefix, node->ref, node->len, node->lcp, key);
+    uint64_t prefix[2];
+    str_prefix(key, node->len, prefix);
+    if (prefix[0] != node->prefix[0] || prefix[1] != node->prefix[1])
+        return 0;
+    if (*has_prev && str_tail_compare(prev, *prev_len, key, node->len) >= 0)
+        return 0;
+    memcpy(prev, key, node->len);
+    *prev_len = node->len;
+    *has_prev = 1;
+    (*count)++;
+    if (!str_avl_check(tree, node->right, prev, prev_len, has_prev, count))
+        return 0;
+    int hl = str_avl_h(node->left);
+    int hr = str_avl_h(node->right);
+    return node->height == 1 + (hl > hr ? hl : hr) && hl - hr <= 1 && hr - hl <= 1;
+}
+
+int str_avl_is_valid(struct StrAVLTree* tree) {
+    char prev[256];
+    int prev_len = 0;
+    int has_prev = 0;
+    int count = 0;
+    return str_avl_check(tree, tree->root, prev, &prev_len, &has_prev, &count) &&
+           count == tree->keys.count;
+}
+
+// ---------- RBT ----------
+
+static void str_rbt_rotate_left(struct StrRBNode** root, struct StrRBNode* x) {
+    struct StrRBNode* y = x->right;
+    x->right = y->left;
+    if (y->left != NULL)
+        y->left->parent = x;
+    y->parent = x->parent;
+    if (x->parent == NULL)
+        *root = y;
+    else if (x == x->parent->left)
+        x->parent->left = y;
+    else
+        x->parent->right = y;
+    y->left = x;
+    x->parent = y;
+}
+
+static void str_rbt_rotate_right(struct StrRBNode** root, struct StrRBNode* y) {
+    struct StrRBNode* x = y->left;
+    y->left = x->right;
+    if (x->right != NULL)
+        x->right->parent = y;
+    x->parent = y->parent;
+    if (y->parent == NULL)
+        *root = x;
+    else if (y == y->parent->left)
+        y->parent->left = x;
+    else
+        y->parent->right = x;
+    x->right = y;
+    y->parent = x;
+}
+
+static void str_rbt_fix(struct StrRBNode** root, struct StrRBNode* z) {
+    while (z != *root && z->parent->color == RED) {
+        struct StrRBNode* grand_parent = z->parent->parent;
+        if (z->parent == grand_parent->left) {
+            struct StrRBNode* uncle = grand_parent->right;
+            if (uncle != NULL && uncle->color == RED) {
+                grand_parent->color = RED;
+                z->parent->color = BLACK;
+                uncle->color = BLACK;
+                z = grand_parent;
+            } else {
+                if (z == z->parent->right) {
+                    z = z->parent;
+                    str_rbt_rotate_left(root, z);
+                }
+                z->parent->color = BLACK;
+                grand_parent->color = RED;
+                str_rbt_rotate_right(root, grand_parent);
+            }
+        } else {
+            struct StrRBNode* uncle = grand_parent->left;
+            if (uncle != NULL && uncle->color == RED) {
+                grand_parent->color = RED;
+                z->parent->color = BLACK;
+                uncle->color = BLACK;
+                z = grand_parent;
+            } else {
+                if (z == z->parent->left) {
+                    z = z->parent;
+                    str_rbt_rotate_right(root, z);
+                }
+                z->parent->color = BLACK;
+                grand_parent->color = RED;
+                str_rbt_rotate_left(root, grand_parent);
+            }
+        }
+    }
+    (*root)->color = BLACK;
+}
+
+struct StrRBTree* str_rbt_create(int front_coding) {
+    struct StrRBTree* tree = (struct StrRBTree*)malloc(sizeof(struct StrRBTree));
+    str_keys_init(&tree->keys, front_coding);
+    tree->root = NULL;
+    return tree;
+}
+
+static void str_rbt_free_nodes(struct StrRBNode* node) {
+    if (node == NULL)
+        return;
+    str_rbt_free_nodes(node->left);
+    str_rbt_free_nodes(node->right);
+    free(node);
+}
+
+void str_rbt_free(struct StrRBTree* tree) {
+    if (tree == NULL)
+        return;
+    str_rbt_free_nodes(tree->root);
+    free(tree->keys.arena);
+    free(tree);
+}
+
+int str_rbt_insert(struct StrRBTree* tree, const char* key, int len) {
+    if (len < 0 || len > STR_KEY_MAX)
+        return -1;
+    uint64_t qprefix[2];
+    str_prefix(key, len, qprefix);
+    struct StrRBNode* y = NULL;
+    struct StrRBNode* x = tree->root;
+    struct StrRBNode* pred = NULL;
+    struct StrRBNode* succ = NULL;
+    int c = 0;
+    while (x != NULL) {
+        y = x;
+        c = str_compare(&tree->keys, key, len, qprefix, x->prefix, x->ref, x->len, x->lcp);
+        if (c < 0) {
+            succ = x;
+            x = x->left;
+        } else if (c > 0) {
+            pred = x;
+            x = x->right;
+        } else {
+            return 0;
+        }
+    }
+
+    struct StrNeighbor pn;
+    struct StrNeighbor sn;
+    if (pred != NULL) {
+        pn.prefix = pred->prefix;
+        pn.ref = pred->ref;
+        pn.len = pred->len;
+        pn.lcp = pred->lcp;
+    }
+    if (succ != NULL) {
+        sn.prefix = succ->prefix;
+        sn.ref = succ->ref;
+        sn.len = succ->len;
+        sn.lcp = succ->lcp;
+    }
+
+    struct StrRBNode* z = (struct StrRBNode*)malloc(sizeof(struct StrRBNode));
+    z->prefix[0] = qprefix[0];
+    z->prefix[1] = qprefix[1];
+    z->len = (uint8_t)len;
+    z->ref = str_store(&tree->keys, key, len, pred ? &pn : NULL, succ ? &sn : NULL, &z->lcp);
+    z->color = RED;
+    z->left = z->right = NULL;
+    z->parent = y;
+    if (y == NULL)
+        tree->root = z;
+    else if (c < 0)
+        y->left = z;
+    else
+        y->right = z;
+
+    str_rbt_fix(&tree->root, z);
+    tree->keys.count++;
+    return 1;
+}
+
+int str_rbt_contains(struct StrRBTree* tree, const char* key, int len) {
+    if (len < 0 || len > STR_KEY_MAX)
+        return 0;
+    uint64_t qprefix[2];
+    str_prefix(key, len, qprefix);
+    struct StrRBNode* node = tree->root;
+    while (node != NULL) {
+        int c = str_compare(&tree->keys, key, len, qprefix, node->prefix, node->ref, node->len,
+                            node->lcp);
+        if (c == 0)
+            return 1;
+        node = c < 0 ? node->left : node->right;
+    }
+    return 0;
+}
+
+static int str_rbt_h(struct StrRBNode* node) {
+    if (node == NULL)
+        return 0;
+    int hl = str_rbt_h(node->left);
+    int hr = str_rbt_h(node->right);
+    return 1 + (hl > hr ? hl : hr);
+}
+
+int str_rbt_height(struct StrRBTree* tree) {
+    return str_rbt_h(tree->root);
+}
+
+void str_rbt_get_stats(struct StrRBTree* tree, struct StrTreeStats* stats) {
+    str_fill_stats(&tree->keys, sizeof(struct StrRBNode), stats);
+}
+
+// Возвращает черную высоту или -1 при нарушении
+static int str_rbt_check(struct StrRBTree* tree, struct StrRBNode* node, char* prev, int* prev_len,
+                         int* has_prev, int* count) {
+    if (node == NULL)
+        return 1;
+    if (node->color == RED && ((node->left && node->left->color == RED) ||
+                               (node->right && node->right->color == RED)))
+        return -1;
+    if ((node->left && node->left->parent != node) || (node->right && node->right->parent != node))
+        return -1;
+    int bl = str_rbt_check(tree, node->left, prev, prev_len, has_prev, count);
+    if (bl < 0)
+        return -1;
+    char key[256];
+    str_decode(&tree->keys, node->prefix, node->ref, node->len, node->lcp, key);
+    uint64_t prefix[2];
+    str_prefix(key, node->len, prefix);
+    if (prefix[0] != node->prefix[0] || prefix[1] != node->prefix[1])
+        return -1;
+    if (*has_prev && str_tail_compare(prev, *prev_len, key, node->len) >= 0)
+        return -1;
+    memcpy(prev, key, node->len);
+    *prev_len = node->len;
+    *has_prev = 1;
+    (*count)++;
+    int br = str_rbt_check(tree, node->right, prev, prev_len, has_prev, count);
+    if (br < 0 || bl != br)
+        return -1;
+    return bl + (node->color == BLACK);
+}
+
+int str_rbt_is_valid(struct StrRBTree* tree) {
+    char prev[256];
+    int prev_len = 0;
+    int has_prev = 0;
+    int count = 0;
+    if (tree->root != NULL && tree->root->color != BLACK)
+        return 0;
+    return str_rbt_check(tree, tree->root, prev, &prev_len, &has_prev, &count) > 0 &&
+           count == tree->keys.count;
+}
+
+// ==================== ТЕСТ 25: ДОМЕННЫЕ ИМЕНА ====================
+
+static const char* STR_SUBDOMAINS[] = {
+    "www.", "www.", "www.", "mail.", "api.", "cdn.", "m.", "static.", "img.", "eu.api.", "", "", ""
+};
+static const char* STR_SYLLABLES[] = {
+    "ka", "ro", "mi", "net", "sof", "da", "ta", "clo", "ud", "shop", "ban", "k", "tech", "lo",
+    "gi", "pro", "me", "dia", "ser", "vi", "ce", "ho", "st", "tra", "vel", "bo", "ok", "fin",
+    "an", "ce", "mar", "ket", "no", "va", "zen", "li", "fe", "go", "play", "hub", "lab", "box"
+};
+static const char* STR_TLDS[] = {
+    ".com", ".com", ".com", ".com", ".net", ".org", ".ru", ".ru", ".de", ".io", ".co.uk", ".info"
+};
+
+static int str_random_domain(char* out) {
+    int len = 0;
+    const char* sub = STR_SUBDOMAINS[rand() % (sizeof(STR_SUBDOMAINS) / sizeof(STR_SUBDOMAINS[0]))];
+    len += sprintf(out + len, "%s", sub);
+    int syllables = 2 + rand() % 3;
+    for (int i = 0; i < syllables; i++)
+        len += sprintf(out + len, "%s",
+                       STR_SYLLABLES[rand() % (sizeof(STR_SYLLABLES) / sizeof(STR_SYLLABLES[0]))]);
+    if (rand() % 3 == 0)
+        len += sprintf(out + len, "%d", rand() % 1000);
+    len += sprintf(out + len, "%s", STR_TLDS[rand() % (sizeof(STR_TLDS) / sizeof(STR_TLDS[0]))]);
+    return len;
+}
+
+// Память std::map<std::string>: узел (4 служебных поля + строка), а
+// строки длиннее встроенного буфера - отдельным блоком в куче
+static size_t str_map_memory(const std::map<std::string, char>& map) {
+    const size_t node_bytes = 4 * sizeof(void*) + sizeof(std::string) + sizeof(char);
+    const size_t sso_capacity = 15;
+    size_t bytes = 0;
+    for (std::map<std::string, char>::const_iterator it = map.begin(); it != map.end(); ++it) {
+        bytes += (node_bytes + 7) / 8 * 8;
+        if (it->first.size() > sso_capacity)
+            bytes += it->first.size() + 1;
+    }
+    return bytes;
+}
+
+void test_string_tree() {
+    printf("=== ТЕСТ 25: AVL/RBT на строковых ключах (арена + префикс в узле) против std::map ===\n\n");
+
+    const int N = 1000000;
+    const int QUERIES = 1000000;
+
+    srand(time(NULL));
+
+    // Имена в одном буфере, как их прочитал бы сервер из сети
+    char* names = (char*)malloc((size_t)N * 64);
+    int* offsets = (int*)malloc(N * sizeof(int));
+    int* lengths = (int*)malloc(N * sizeof(int));
+    long long total_len = 0;
+    for (int i = 0; i < N; i++) {
+        offsets[i] = i * 64;
+        lengths[i] = str_random_domain(names + offsets[i]);
+        total_len += lengths[i];
+    }
+    // Половина запросов - имена из набора, половина - новые (почти все промахи)
+    char* query_names = (char*)malloc((size_t)QUERIES * 64);
+    int* query_lengths = (int*)malloc(QUERIES * sizeof(int));
+    for (int i = 0; i < QUERIES; i++) {
+        char* q = query_names + (size_t)i * 64;
+        if (i % 2 == 0) {
+            int j = rand() % N;
+            memcpy(q, names + offsets[j], lengths[j]);
+            query_lengths[i] = lengths[j];
+        } else {
+            query_lengths[i] = str_random_domain(q);
+        }
+    }
+
+    printf("Имен: %d (средняя длина %.1f байт), поисков: %d (половина - промахи)\n",
+           N, (double)total_len / N, QUERIES);
+    printf("Примеры: %.*s, %.*s, %.*s\n\n", lengths[0], names + offsets[0],
+           lengths[1], names + offsets[1], lengths[2], names + offsets[2]);
+
+    // ---------- std::map<std::string> ----------
+    std::map<std::string, char> map;
+    clock_t start = clock();
+    for (int i = 0; i < N; i++)
+        map.insert(std::make_pair(std::string(names + offsets[i], lengths[i]), (char)0));
+    double map_insert_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / N;
+
+    long long expected = 0;
+    start = clock();
+    for (int i = 0; i < QUERIES; i++)
+        expected += map.count(std::string(query_names + (size_t)i * 64, query_lengths[i]));
+    double map_search_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / QUERIES;
+    size_t map_bytes = str_map_memory(map);
+    int unique = (int)map.size();
+
+    printf("Структура          | Вставка ns | Поиск ns | Память МБ | Байт/ключ | До арены | Высота | Проверка\n");
+    printf("-------------------|------------|----------|-----------|-----------|----------|--------|---------\n");
+    printf("std::map<string>   | %10.1f | %8.1f | %9.1f | %9.1f | %8s | %6s | %s\n",
+           map_insert_ns, map_search_ns, map_bytes / (1024.0 * 1024.0), (double)map_bytes / unique,
+           "-", "-", "ok");
+    map.clear();
+
+    // ---------- строковые AVL и RBT ----------
+    // Подписи выровнены вручную: %-Ns считает байты, а не буквы
+    const char* labels[] = {
+        "AVL арена         ", "AVL арена + FC    ", "RBT арена         ", "RBT арена + FC    "
+    };
+    double search_ns[4];
+    size_t bytes[4];
+    double full_share[4];
+    size_t arena_bytes[2] = {0, 0};
+    int all_ok = 1;
+    for (int v = 0; v < 4; v++) {
+        int is_rbt = v >= 2;
+        int front_coding = v % 2;
+        struct StrAVLTree* avl = is_rbt ? NULL : str_avl_create(front_coding);
+        struct StrRBTree* rbt = is_rbt ? str_rbt_create(front_coding) : NULL;
+
+        start = clock();
+        for (int i = 0; i < N; i++) {
+            if (is_rbt)
+                str_rbt_insert(rbt, names + offsets[i], lengths[i]);
+            else
+                str_avl_insert(avl, names + offsets[i], lengths[i]);
+        }
+        double insert_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / N;
+
+        struct StrTreeStats before;
+        if (is_rbt)
+            str_rbt_get_stats(rbt, &before);
+        else
+            str_avl_get_stats(avl, &before);
+
+        long long found = 0;
+        start = clock();
+        for (int i = 0; i < QUERIES; i++) {
+            const char* q = query_names + (size_t)i * 64;
+            found += is_rbt ? str_rbt_contains(rbt, q, query_lengths[i])
+                            : str_avl_contains(avl, q, query_lengths[i]);
+        }
+        search_ns[v] = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / QUERIES;
+
+        struct StrTreeStats stats;
+        if (is_rbt)
+            str_rbt_get_stats(rbt, &stats);
+        else
+            str_avl_get_stats(avl, &stats);
+        int height = is_rbt ? str_rbt_height(rbt) : str_avl_height(avl);
+        int ok = found == expected && stats.count == unique &&
+                 (is_rbt ? str_rbt_is_valid(rbt) : str_avl_is_valid(avl));
+        all_ok &= ok;
+
+        bytes[v] = stats.node_bytes + stats.arena_bytes;
+        arena_bytes[front_coding] = stats.arena_bytes;
+        full_share[v] = 100.0 * (stats.full_compares - before.full_compares) /
+                        (stats.compares - before.compares);
+        printf("%s | %10.1f | %8.1f | %9.1f | %9.1f | %7.1f%% | %6d | %s\n",
+               labels[v], insert_ns, search_ns[v], bytes[v] / (1024.0 * 1024.0),
+               (double)bytes[v] / unique, full_share[v], height, ok ? "ok" : "ОШИБКА");
+
+        str_avl_free(avl);
+        str_rbt_free(rbt);
+    }
+
+    printf("\n\"До арены\" - доля сравнений при поиске, которым не хватило 16 байт префикса в узле\n");
+    printf("Арена: %.1f МБ без кодирования, %.1f МБ с фронтальным кодированием (%.0f%%)\n",
+           arena_bytes[0] / (1024.0 * 1024.0), arena_bytes[1] / (1024.0 * 1024.0),
+           100.0 * arena_bytes[1] / arena_bytes[0]);
+    printf("Проверка (порядок, инварианты, результаты поиска как у std::map): %s\n\n",
+           all_ok ? "ok" : "ОШИБКА");
+
+    printf("ВЫВОД:\n");
+    printf("• Поиск: AVL %.0f ns и RBT %.0f ns против %.0f ns у std::map - префикс в узле\n",
+           search_ns[0], search_ns[2], map_search_ns);
+    printf("  решает %.0f%% сравнений без обращения к строке, а строки не разбросаны по куче\n",
+           100.0 - full_share[0]);
+    printf("• Память: %.0f байт на имя против %.0f у std::map (узел + std::string + блок\n",
+           (double)bytes[0] / unique, (double)map_bytes / unique);
+    printf("  в куче для длинных имен); фронтальное кодирование сокращает арену до %.0f%%\n",
+           100.0 * arena_bytes[1] / arena_bytes[0]);
+    double fc_change = 100.0 * search_ns[1] / search_ns[0] - 100.0;
+    printf("• Фронтальное кодирование экономит %.0f%% всей памяти, а поиск с ним на %.0f%%\n",
+           100.0 - 100.0 * bytes[1] / bytes[0], fc_change >= 0 ? fc_change : -fc_change);
+    if (fc_change >= 0)
+        printf("  медленнее (чтение базы); оно окупается, когда имена длинные и арена\n"
+               "  больше узлов - короткие имена и так целиком лежат в узле\n\n");
+    else
+        printf("  быстрее: меньшая арена лучше держится в кеше, и это перекрывает чтение\n"
+               "  базы; короткие имена целиком лежат в узле, и им кодирование не нужно\n\n");
+
+    free(names);
+    free(offsets);
+    free(lengths);
+    free(query_names);
+    free(query_lengths);
+}
@@ -0,0 +1,357 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "methods.h"
+
+// ========== ХЕШ-ТАБЛИЦА С ОТКРЫТОЙ АДРЕСАЦИЕЙ (SWISS TABLE) ==========
+// Для каждого слота хранится управляющий байт: старший бит = 1 у пустых
+// и удаленных слотов, у занятых - 7 младших бит хеша (H2). Поиск
+// сравнивает сразу группу из 16 управляющих байт одной SSE2-инструкцией
+// и проверяет ключи только у совпавших по H2 слотов.
+// Первые 16 байт ctrl продублированы в конце массива, поэтому группу
+// можно читать с любой позиции без перехода через границу.
+
+#define SWISS_GROUP 16
+#define SWISS_EMPTY ((int8_t)-128)   // 0b10000000
+#define SWISS_DELETED ((int8_t)-2)   // 0b11111110
+
+static uint64_t swiss_hash(int key) {
+    uint64_t h = (uint64_t)(uint32_t)key * 0x9E3779B97F4A7C15ULL;
+    return h ^ (h >> 29);
+}
+
+// Битовые маски слотов группы
+#if defined(__SSE2__)
+
+static uint32_t swiss_match(const int8_t* group, int8_t h2) {
+    __m128i ctrl = _mm_loadu_si128((const __m128i*)group);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(h2)));
+}
+
+static uint32_t swiss_match_empty(const int8_t* group) {
+    return swiss_match(group, SWISS_EMPTY);
+}
+
+static uint32_t swiss_match_free(const int8_t* group) {
+    // Пустые и удаленные - это байты со старшим битом
+    __m128i ctrl = _mm_loadu_si128((const __m128i*)group);
+    return (uint32_t)_mm_movemask_epi8(ctrl);
+}
+
+#else
+
+static uint32_t swiss_match(const int8_t* group, int8_t h2) {
+    uint32_t mask = 0;
+    for (int i = 0; i < SWISS_GROUP; i++)
+        if (group[i] == h2)
+            mask |= 1u << i;
+    return mask;
+}
+
+static uint32_t swiss_match_empty(const int8_t* group) {
+    return swiss_match(group, SWISS_EMPTY);
+}
+
+static uint32_t swiss_match_free(const int8_t* group) {
+    uint32_t mask = 0;
+    for (int i = 0; i < SWISS_GROUP; i++)
+        if (group[i] < 0)
+            mask |= 1u << i;
+    return mask;
+}
+
+#endif
+
+static void swiss_set_ctrl(struct SwissTable* table, size_t i, int8_t value) {
+    table->ctrl[i] = value;
+    if (i < SWISS_GROUP)
+        table->ctrl[table->capacity + i] = value;
+}
+
+static void swiss_allocate(struct SwissTable* table, size_t capacity) {
+    table->capacity = capacity;
+    table->ctrl = (int8_t*)malloc(capacity + SWISS_GROUP);
+    table->keys = (int*)malloc(capacity * sizeof(int));
+    memset(table->ctrl, SWISS_EMPTY, capacity + SWISS_GROUP);
+    table->size = 0;
+    table->tombstones = 0;
+    table->growth_left = capacity - capacity / 8; // максимальная загрузка 7/8
+}
+
+struct SwissTable* swiss_create(size_t capacity_hint) {
+    size_t capacity = SWISS_GROUP;
+    while (capacity - capacity / 8 < capacity_hint)
+        capacity *= 2;
+    struct SwissTable* table = (struct SwissTable*)malloc(sizeof(struct SwissTable));
+    swiss_allocate(table, capacity);
+    table->rehashes = 0;
+    return table;
+}
+
+void swiss_free(struct SwissTable* table) {
+    if (table == NULL)
+        return;
+    free(table->ctrl);
+    free(table->keys);
+    free(table);
+}
+
+// Индекс слота с ключом или -1
+static long swiss_find(struct SwissTable* table, int key, uint64_t hash) {
+    size_t mask = table->capacity - 1;
+    size_t pos = (size_t)(hash >> 7) & mask;
+    int8_t h2 = (int8_t)(hash & 0x7F);
+
+    // Квадратичное пробирование по группам
+    for (size_t step = SWISS_GROUP;; step += SWISS_GROUP) {
+        const int8_t* group = table->ctrl + pos;
+        uint32_t match = swiss_match(group, h2);
+        while (match != 0) {
+            size_t i = (pos + __builtin_ctz(match)) & mask;
+            if (table->keys[i] == key)
+                return (long)i;
+            match &= match - 1;
+        }
+        if (swiss_match_empty(group) != 0)
+            return -1;
+        pos = (pos + step) & mask;
+    }
+}
+
+// Первый свободный (пустой или удаленный) слот на пути пробирования
+static size_t swiss_find_free(struct SwissTable* table, uint64_t hash) {
+    size_t mask = table->capacity - 1;
+    size_t pos = (size_t)(hash >> 7) & mask;
+    for (size_t step = SWISS_GROUP;; step += SWISS_GROUP) {
+        uint32_t free_slots = swiss_match_free(table->ctrl + pos);
+        if (free_slots != 0)
+            return (pos + __builtin_ctz(free_slots)) & mask;
+        pos = (pos + step) & mask;
+    }
+}
+
+static void swiss_rehash(struct SwissTable* table, size_t capacity) {
+    int8_t* old_ctrl = table->ctrl;
+    int* old_keys = table->keys;
+    size_t old_capacity = table->capacity;
+
+    swiss_allocate(table, capacity);
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (old_ctrl[i] < 0)
+            continue;
+        uint64_t hash = swiss_hash(old_keys[i]);
+        size_t slot = swiss_find_free(table, hash);
+        swiss_set_ctrl(table, slot, (int8_t)(hash & 0x7F));
+        table->keys[slot] = old_keys[i];
+        table->size++;
+        table->growth_left--;
+    }
+    table->rehashes++;
+
+    free(old_ctrl);
+    free(old_keys);
+}
+
+int swiss_insert(struct SwissTable* table, int key) {
+    uint64_t hash = swiss_hash(key);
+    if (swiss_find(table, key, hash) >= 0)
+        return 0;
+
+    size_t slot = swiss_find_free(table, hash);
+    if (table->ctrl[slot] == SWISS_EMPTY && table->growth_left == 0) {
+        // Если место съели надгробия - чистим без роста, иначе удваиваем
+        if (table->tombstones > table->size / 2)
+            swiss_rehash(table, table->capacity);
+        else
+            swiss_rehash(table, table->capacity * 2);
+        slot = swiss_find_free(table, hash);
+    }
+
+    if (table->ctrl[slot] == SWISS_DELETED)
+        table->tombstones--;
+    else
+        table->growth_left--;
+    swiss_set_ctrl(table, slot, (int8_t)(hash & 0x7F));
+    table->keys[slot] = key;
+    table->size++;
+    return 1;
+}
+
+int swiss_contains(struct SwissTable* table, int key) {
+    return swiss_find(table, key, swiss_hash(key)) >= 0;
+}
+
+int swiss_erase(struct SwissTable* table, int key) {
+    long found = swiss_find(table, key, swiss_hash(key));
+    if (found < 0)
+        return 0;
+
+    size_t i = (size_t)found;
+    size_t mask = table->capacity - 1;
+    size_t before = (i - SWISS_GROUP) & mask;
+    uint32_t empty_after = swiss_match_empty(table->ctrl + i);
+    uint32_t empty_before = swiss_match_empty(table->ctrl + before);
+
+    // Слот можно сделать пустым, если любое окно из 16 байт вокруг него
+    // содержит пустой слот: тогда ни один поиск не проходил через него дальше
+    int was_never_full = empty_before != 0 && empty_after != 0 &&
+                         __builtin_ctz(empty_after) + __builtin_clz(empty_before << 16) < SWISS_GROUP;
+
+    if (was_never_full) {
+        swiss_set_ctrl(table, i, SWISS_EMPTY);
+        table->growth_left++;
+    } else {
+        swiss_set_ctrl(table, i, SWISS_DELETED);
+        table->tombstones++;
+    }
+    table->size--;
+    return 1;
+}
+
+size_t swiss_memory_bytes(struct SwissTable* table) {
+    return table->capacity + SWISS_GROUP + table->capacity * sizeof(int) + sizeof(struct SwissTable);
+}
+
+// ==================== ТЕСТ 13: SWISS TABLE vs AVL vs RBT ====================
+
+void test_swiss_table() {
+    printf("=== ТЕСТ 13: Хеш-таблица Swiss table против AVL и RBT (точечные запросы) ===\n\n");
+
+    const int N = 1000000;
+    const int NUM_LOOKUPS = 4000000;
+
+    srand(time(NULL));
+    int* keys = (int*)malloc(N * sizeof(int));
+    for (int i = 0; i < N; i++)
+        keys[i] = rand() % (N * 4);
+    int* queries = (int*)malloc(NUM_LOOKUPS * sizeof(int));
+    for (int i = 0; i < NUM_LOOKUPS; i++)
+        queries[i] = (i % 2 == 0) ? keys[rand() % N] : rand() % (N * 4); // >=50% попаданий
+
+    // Вставка
+    clock_t start = clock();
+    struct AVLNode* avl_root = NULL;
+    int avl_rotations = 0;
+    for (int i = 0; i < N; i++)
+        avl_root = avl_insert(avl_root, keys[i], &avl_rotations);
+    double avl_insert_ms = (double)(clock() - start) * 1000 / CLOCKS_PER_SEC;
+
+    start = clock();
+    struct RBNode* rbt_root = NULL;
+    int rbt_rotations = 0;
+    int rbt_recolorings = 0;
+    for (int i = 0; i < N; i++)
+        rbt_root = rbt_insert(rbt_root, keys[i], &rbt_rotations, &rbt_recolorings);
+    double rbt_insert_ms = (double)(clock() - start) * 1000 / CLOCKS_PER_SEC;
+
+    start = clock();
+    struct SwissTable* table = swiss_create(0);
+    for (int i = 0; i < N; i++)
+        swiss_insert(table, keys[i]);
+    double swiss_insert_ms = (double)(clock() - start) * 1000 / CLOCKS_PER_SEC;
+
+    // Поиск
+    start = clock();
+    int avl_found = 0;
+    for (int i = 0; i < NUM_LOOKUPS; i++)
+        avl_found += avl_search(avl_root, queries[i]) != NULL;
+    double avl_search_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / NUM_LOOKUPS;
+
+    start = clock();
+    int rbt_found = 0;
+    for (int i = 0; i < NUM_LOOKUPS; i++)
+        rbt_found += rbt_search(rbt_root, queries[i]) != NULL;
+    double rbt_search_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / NUM_LOOKUPS;
+
+    start = clock();
+    int swiss_found = 0;
+    for (int i = 0; i < NUM_LOOKUPS; i++)
+        swiss_found += swiss_contains(table, queries[i]);
+    double swiss_search_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / NUM_LOOKUPS;
+
+    int n = count_avl_nodes(avl_root);
+    printf("%d вставок (%d уникальных ключей), %d поисков\n\n", N, n, NUM_LOOKUPS);
+    printf("%-12s | %-14s | %-12s | %-12s\n", "Структура", "Вставка (ms)", "Поиск (ns)", "Байт/ключ");
+    printf("-------------|----------------|--------------|-------------\n");
+    printf("%-12s | %-14.3f | %-12.1f | %-12.1f\n", "AVL", avl_insert_ms, avl_search_ns,
+           (double)sizeof(struct AVLNode));
+    printf("%-12s | %-14.3f | %-12.1f | %-12.1f\n", "RBT", rbt_insert_ms, rbt_search_ns,
+           (double)sizeof(struct RBNode));
+    printf("%-12s | %-14.3f | %-12.1f | %-12.1f\n", "Swiss table", swiss_insert_ms, swiss_search_ns,
+           (double)swiss_memory_bytes(table) / table->size);
+    printf("Проверка: %s (размер %zu, рехешей %d)\n\n",
+           avl_found == swiss_found && rbt_found == swiss_found && (size_t)n == table->size
+               ? "OK" : "ОШИБКА",
+           table->size, table->rehashes);
+
+    // Профиль DNS-кеша: 90% поиск, 10% обновление (истек TTL: удалить + вставить).
+    // Ключи обновлений общие для всех трех структур
+    const int OPS = 2000000;
+    const int NUM_UPDATES = OPS / 10;
+    int* evicted = (int*)malloc(NUM_UPDATES * sizeof(int));
+    int* refreshed = (int*)malloc(NUM_UPDATES * sizeof(int));
+    for (int u = 0; u < NUM_UPDATES; u++) {
+        evicted[u] = keys[rand() % N];
+        refreshed[u] = rand() % (N * 4);
+    }
+
+    start = clock();
+    int found = 0;
+    for (int i = 0; i < OPS; i++) {
+        if (i % 10 == 0) {
+            swiss_erase(table, evicted[i / 10]);
+            swiss_insert(table, refreshed[i / 10]);
+        } else {
+            found += swiss_contains(table, queries[i % NUM_LOOKUPS]);
+        }
+    }
+    double swiss_dns_ms = (double)(clock() - start) * 1000 / CLOCKS_PER_SEC;
+
+    start = clock();
+    for (int i = 0; i < OPS; i++) {
+        if (i % 10 == 0) {
+            avl_root = avl_delete(avl_root, evicted[i / 10], &avl_rotations);
+            avl_root = avl_insert(avl_root, refreshed[i / 10], &avl_rotations);
+        } else {
+            found += avl_search(avl_root, queries[i % NUM_LOOKUPS]) != NULL;
+        }
+    }
+    double avl_dns_ms = (double)(clock() - start) * 1000 / CLOCKS_PER_SEC;
+
+    start = clock();
+    for (int i = 0; i < OPS; i++) {
+        if (i % 10 == 0) {
+            rbt_root = rbt_delete(rbt_root, evicted[i / 10], &rbt_rotations, &rbt_recolorings);
+            rbt_root = rbt_insert(rbt_root, refreshed[i / 10], &rbt_rotations, &rbt_recolorings);
+        } else {
+            found += rbt_search(rbt_root, queries[i % NUM_LOOKUPS]) != NULL;
+        }
+    }
+    double rbt_dns_ms = (double)(clock() - start) * 1000 / CLOCKS_PER_SEC;
+
+    printf("Профиль DNS-кеша (%d операций, 90%% поиск / 10%% обновление):\n", OPS);
+    printf("AVL Tree:    %.3f ms\n", avl_dns_ms);
+    printf("RBT:         %.3f ms\n", rbt_dns_ms);
+    printf("Swiss table: %.3f ms (надгробий: %zu)\n", swiss_dns_ms, table->tombstones);
+    printf("Проверка: %s (после обновлений размер %zu)\n",
+           avl_is_valid(avl_root) && rbt_is_valid(rbt_root) &&
+           (size_t)count_avl_nodes(avl_root) == table->size ? "OK" : "ОШИБКА", table->size);
+
+    free_avl_tree(avl_root);
+    free_rbt_tree(rbt_root);
+    swiss_free(table);
+    free(evicted);
+    free(refreshed);
+    free(keys);
+    free(queries);
+
+    printf("\nВЫВОД: когда диапазонные запросы не нужны, хеш-таблица быстрее деревьев\n");
+    printf("       на точечных запросах и занимает в разы меньше памяти на ключ\n\n");
+}
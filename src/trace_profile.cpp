@@ -0,0 +1,628 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "methods.h"
+
+// ========== ПРОФИЛЬ НАГРУЗКИ ПО ЖУРНАЛУ ОПЕРАЦИЙ ==========
+// Журнал - текст, одна операция в строке:
+//   S <ключ>        поиск
+//   I <ключ>        вставка
+//   D <ключ>        удаление
+//   R <от> <до>     диапазон [от, до]
+// Пустые строки и строки с '#' пропускаются.
+//
+// Журнал читается один раз, память не зависит от его длины: счетчики,
+// HyperLogLog на 4096 регистров для числа различных ключей и выборка по
+// хешу ключа. Выборка берет все операции ключа или ни одной - поиск находит
+// то, что вставлено, а удаление удаляет; по ней же считаются перекос и
+// рабочий набор. Когда выборка переполняется, порог хеша делится пополам,
+// и уже набранные операции отсеиваются по новому порогу.
+
+#define TRACE_HLL_BITS 12
+#define TRACE_HLL_REGISTERS (1 << TRACE_HLL_BITS)
+
+static uint64_t trace_hash(int key) {
+    uint64_t x = (uint64_t)(uint32_t)key + 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+static void trace_hll_add(unsigned char* registers, uint64_t hash) {
+    unsigned index = (unsigned)(hash >> (64 - TRACE_HLL_BITS));
+    uint64_t rest = hash << TRACE_HLL_BITS;
+    unsigned char rank = rest == 0 ? 64 - TRACE_HLL_BITS + 1 : (unsigned char)(__builtin_clzll(rest) + 1);
+    if (rank > registers[index])
+        registers[index] = rank;
+}
+
+static double trace_hll_estimate(const unsigned char* registers) {
+    double sum = 0;
+    int zeros = 0;
+    for (int i = 0; i < TRACE_HLL_REGISTERS; i++) {
+        sum += ldexp(1.0, -registers[i]);
+        zeros += registers[i] == 0;
+    }
+    double m = TRACE_HLL_REGISTERS;
+    double estimate = 0.7213 / (1 + 1.079 / m) * m * m / sum;
+    // Малые множества точнее считает linear counting
+    if (estimate <= 2.5 * m && zeros > 0)
+        estimate = m * log(m / zeros);
+    return estimate;
+}
+
+#define TRACE_READ_BUFFER (1 << 20)
+
+// Журнал читается блоками: fgets + strtol на многогигабайтных файлах
+// упираются в разбор, а не в диск
+struct TraceReader {
+    FILE* f;
+    char* buf; // TRACE_READ_BUFFER + 1 байт под завершающий ноль
+    size_t pos;
+    size_t end;
+    int eof;
+};
+
+// Следующая строка без '\n', завершенная нулем; NULL - конец файла.
+// Строка длиннее буфера отдается кусками и будет разобрана как ошибочная
+static char* trace_next_line(struct TraceReader* r) {
+    for (;;) {
+        char* start = r->buf + r->pos;
+        char* newline = (char*)memchr(start, '\n', r->end - r->pos);
+        if (newline != NULL) {
+            *newline = '\0';
+            r->pos = newline - r->buf + 1;
+            return start;
+        }
+        size_t tail = r->end - r->pos;
+        if (r->eof || tail == TRACE_READ_BUFFER) {
+            if (tail == 0)
+                return NULL;
+            r->buf[r->end] = '\0';
+            r->pos = r->end;
+            return start;
+        }
+        memmove(r->buf, start, tail);
+        r->pos = 0;
+        size_t got = fread(r->buf + tail, 1, TRACE_READ_BUFFER - tail, r->f);
+        r->end = tail + got;
+        r->eof = got == 0;
+    }
+}
+
+static const char* trace_skip_blanks(const char* p) {
+    while (*p == ' ' || *p == '\t')
+        p++;
+    return p;
+}
+
+// Целое со знаком; NULL - не число или не помещается в int
+static const char* trace_parse_int(const char* p, int* out) {
+    p = trace_skip_blanks(p);
+    int negative = *p == '-';
+    if (*p == '-' || *p == '+')
+        p++;
+    if (*p < '0' || *p > '9')
+        return NULL;
+    long long value = 0;
+    while (*p >= '0' && *p <= '9') {
+        value = value * 10 + (*p++ - '0');
+        if (value > 2147483648ll)
+            return NULL;
+    }
+    value = negative ? -value : value;
+    if (value > 2147483647ll)
+        return NULL;
+    *out = (int)value;
+    return p;
+}
+
+// 1 - операция, 0 - ошибочная строка, -1 - пустая строка или комментарий
+static int trace_parse_line(const char* line, struct TraceOp* op) {
+    line = trace_skip_blanks(line);
+    switch (*line) {
+    case '\0': case '\r': case '#': return -1;
+    case 'S': case 's': op->type = TRACE_SEARCH; break;
+    case 'I': case 'i': op->type = TRACE_INSERT; break;
+    case 'D': case 'd': op->type = TRACE_DELETE; break;
+    case 'R': case 'r': op->type = TRACE_RANGE; break;
+    default: return 0;
+    }
+    const char* p = trace_parse_int(line + 1, &op->key);
+    if (p == NULL)
+        return 0;
+    op->hi = op->key;
+    if (op->type == TRACE_RANGE) {
+        p = trace_parse_int(p, &op->hi);
+        if (p == NULL || op->hi < op->key)
+            return 0;
+    }
+    p = trace_skip_blanks(p);
+    return *p == '\0' || *p == '\r' ? 1 : 0;
+}
+
+// Оставить в выборке только операции с хешем ключа не выше порога
+static void trace_sample_shrink(struct TraceSample* sample) {
+    sample->threshold >>= 1;
+    long long kept = 0;
+    for (long long i = 0; i < sample->count; i++) {
+        if ((uint32_t)trace_hash(sample->ops[i].key) <= sample->threshold)
+            sample->ops[kept++] = sample->ops[i];
+    }
+    sample->count = kept;
+}
+
+// Наибольшее число живых ключей при проигрывании выборки
+static long long trace_sample_peak_live(const struct TraceSample* sample) {
+    struct SwissTable* live = swiss_create(1024);
+    long long peak = 0;
+    for (long long i = 0; i < sample->count; i++) {
+        const struct TraceOp* op = &sample->ops[i];
+        if (op->type == TRACE_INSERT)
+            swiss_insert(live, op->key);
+        else if (op->type == TRACE_DELETE)
+            swiss_erase(live, op->key);
+        if ((long long)live->size > peak)
+            peak = live->size;
+    }
+    swiss_free(live);
+    return peak;
+}
+
+static int compare_ints(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+static int compare_ints_desc(const void* a, const void* b) {
+    return compare_ints(b, a);
+}
+
+// Доля обращений к TRACE_HOT_KEYS_PERCENT% самых частых ключей выборки.
+// Ключ попадает в выборку со всеми своими операциями, так что частоты точные
+static double trace_sample_hot_share(const struct TraceSample* sample) {
+    int* keys = (int*)malloc((sample->count > 0 ? sample->count : 1) * sizeof(int));
+    long long n = 0;
+    for (long long i = 0; i < sample->count; i++)
+        if (sample->ops[i].type != TRACE_RANGE)
+            keys[n++] = sample->ops[i].key;
+    if (n == 0) {
+        free(keys);
+        return 0;
+    }
+    qsort(keys, n, sizeof(int), compare_ints);
+
+    // Частоты ключей пишутся поверх начала массива
+    long long distinct = 0;
+    for (long long i = 0, run = 1; i < n; i++, run++) {
+        if (i + 1 == n || keys[i + 1] != keys[i]) {
+            keys[distinct++] = (int)run;
+            run = 0;
+        }
+    }
+    qsort(keys, distinct, sizeof(int), compare_ints_desc);
+    long long hot = (distinct * TRACE_HOT_KEYS_PERCENT + 99) / 100;
+    long long hot_ops = 0;
+    for (long long i = 0; i < hot; i++)
+        hot_ops += keys[i];
+    free(keys);
+    return (double)hot_ops / n;
+}
+
+int trace_profile_file(const char* path, long long max_sample_ops, struct TraceProfile* profile,
+                       struct TraceSample** sample_out) {
+    FILE* f = fopen(path, "rb");
+    if (f == NULL)
+        return -1;
+    struct TraceReader reader = {f, (char*)malloc(TRACE_READ_BUFFER + 1), 0, 0, 0};
+
+    memset(profile, 0, sizeof(*profile));
+    unsigned char* registers = (unsigned char*)calloc(TRACE_HLL_REGISTERS, 1);
+    struct TraceSample* sample = (struct TraceSample*)malloc(sizeof(struct TraceSample));
+    sample->capacity = max_sample_ops > 0 ? max_sample_ops : 1;
+    sample->ops = (struct TraceOp*)malloc(sample->capacity * sizeof(struct TraceOp));
+    sample->count = 0;
+    sample->threshold = 0xFFFFFFFFu;
+
+    long long key_ops = 0;
+    long long monotonic = 0;
+    long long inserts_after_first = 0;
+    int last_insert = 0;
+    double range_width = 0;
+    char* line;
+    while ((line = trace_next_line(&reader)) != NULL) {
+        struct TraceOp op;
+        int parsed = trace_parse_line(line, &op);
+        if (parsed < 0)
+            continue;
+        if (parsed == 0) {
+            profile->bad_lines++;
+            continue;
+        }
+        if (profile->ops == 0 || op.key < profile->min_key)
+            profile->min_key = op.key;
+        if (profile->ops == 0 || op.hi > profile->max_key)
+            profile->max_key = op.hi;
+        profile->ops++;
+        profile->counts[op.type]++;
+
+        uint64_t hash = trace_hash(op.key);
+        if (op.type == TRACE_RANGE) {
+            range_width += (double)op.hi - op.key + 1;
+        } else {
+            key_ops++;
+            trace_hll_add(registers, hash);
+        }
+        if (op.type == TRACE_INSERT) {
+            if (profile->counts[TRACE_INSERT] > 1) {
+                inserts_after_first++;
+                monotonic += op.key >= last_insert;
+            }
+            last_insert = op.key;
+        }
+
+        if ((uint32_t)hash <= sample->threshold) {
+            while (sample->count == sample->capacity && sample->threshold > 0) {
+                trace_sample_shrink(sample);
+                if ((uint32_t)hash > sample->threshold)
+                    break;
+            }
+            if ((uint32_t)hash <= sample->threshold && sample->count < sample->capacity)
+                sample->ops[sample->count++] = op;
+        }
+    }
+    fclose(f);
+    free(reader.buf);
+
+    profile->distinct_keys = key_ops > 0 ? trace_hll_estimate(registers) : 0;
+    profile->insert_monotonic = inserts_after_first > 0 ? (double)monotonic / inserts_after_first : 0;
+    profile->avg_range_width = profile->counts[TRACE_RANGE] > 0
+                                   ? range_width / profile->counts[TRACE_RANGE] : 0;
+    profile->sample_rate = (sample->threshold + 1.0) / 4294967296.0;
+    profile->sample_ops = sample->count;
+    profile->working_set_keys = trace_sample_peak_live(sample) / profile->sample_rate;
+    profile->hot_keys_share = trace_sample_hot_share(sample);
+    free(registers);
+
+    *sample_out = sample;
+    return 0;
+}
+
+void trace_sample_free(struct TraceSample* sample) {
+    if (sample == NULL)
+        return;
+    free(sample->ops);
+    free(sample);
+}
+
+// ---------- Проигрывание выборки ----------
+
+// Обход с отсечением: ключи из [lo, hi], O(log n + k) - как скан диапазона
+static long long trace_avl_range(struct AVLNode* node, int lo, int hi) {
+    if (node == NULL)
+        return 0;
+    if (node->key < lo)
+        return trace_avl_range(node->right, lo, hi);
+    if (node->key > hi)
+        return trace_avl_range(node->left, lo, hi);
+    return 1 + trace_avl_range(node->left, lo, hi) + trace_avl_range(node->right, lo, hi);
+}
+
+static long long trace_rbt_range(struct RBNode* node, int lo, int hi) {
+    if (node == NULL)
+        return 0;
+    if (node->key < lo)
+        return trace_rbt_range(node->right, lo, hi);
+    if (node->key > hi)
+        return trace_rbt_range(node->left, lo, hi);
+    return 1 + trace_rbt_range(node->left, lo, hi) + trace_rbt_range(node->right, lo, hi);
+}
+
+static long long trace_wavl_range(struct WAVLNode* node, int lo, int hi) {
+    if (node == NULL)
+        return 0;
+    if (node->key < lo)
+        return trace_wavl_range(node->right, lo, hi);
+    if (node->key > hi)
+        return trace_wavl_range(node->left, lo, hi);
+    return 1 + trace_wavl_range(node->left, lo, hi) + trace_wavl_range(node->right, lo, hi);
+}
+
+static long long trace_splay_range(struct SplayNode* node, int lo, int hi) {
+    if (node == NULL)
+        return 0;
+    if (node->key < lo)
+        return trace_splay_range(node->right, lo, hi);
+    if (node->key > hi)
+        return trace_splay_range(node->left, lo, hi);
+    return 1 + trace_splay_range(node->left, lo, hi) + trace_splay_range(node->right, lo, hi);
+}
+
+enum TraceStructure {
+    TRACE_AVL, TRACE_RBT, TRACE_WAVL, TRACE_SPLAY, TRACE_BPLUS,
+    TRACE_SWISS, TRACE_ART, TRACE_LSM, TRACE_ADAPTIVE, TRACE_DELTA, TRACE_STRUCTURES
+};
+
+static const char* trace_structure_names[TRACE_STRUCTURES] = {
+    "AVL Tree", "Red-Black Tree", "WAVL Tree", "Splay Tree", "B+ tree",
+    "Hash table (Swiss)", "ART", "LSM index", "Adaptive AVL/RBT", "Delta index"
+};
+
+// Чего структура не умеет: удалений у B+ и LSM нет, диапазонов - у хеша и LSM
+static const int trace_has_delete[TRACE_STRUCTURES] = {1, 1, 1, 1, 0, 1, 1, 0, 1, 1};
+static const int trace_has_range[TRACE_STRUCTURES] = {1, 1, 1, 1, 1, 0, 1, 0, 0, 1};
+
+static void trace_replay_one(const struct TraceSample* sample, enum TraceStructure s,
+                             int* range_buffer, struct TraceReplayResult* result) {
+    struct AVLNode* avl = NULL;
+    struct RBNode* rbt = NULL;
+    struct WAVLNode* wavl = NULL;
+    struct SplayNode* splay = NULL;
+    struct BPlusTree* bplus = s == TRACE_BPLUS ? bplus_create(BTREE_NODE_KEYS, NULL) : NULL;
+    struct SwissTable* swiss = s == TRACE_SWISS ? swiss_create(1024) : NULL;
+    struct ARTree* art = s == TRACE_ART ? art_create() : NULL;
+    struct LSMTree* lsm = s == TRACE_LSM ? lsm_create(32768, 4, 0) : NULL;
+    struct AdaptiveTree* adaptive = s == TRACE_ADAPTIVE ? adaptive_create(0.12) : NULL;
+    struct DeltaIndex* delta = s == TRACE_DELTA ? delta_index_create() : NULL;
+    int max_out = (int)(sample->count > 0 ? sample->count : 1);
+    int rotations = 0;
+    int recolorings = 0;
+    long long checksum = 0;
+
+    clock_t start = clock();
+    for (long long i = 0; i < sample->count; i++) {
+        const struct TraceOp* op = &sample->ops[i];
+        int key = op->key;
+        switch (op->type) {
+        case TRACE_SEARCH:
+            switch (s) {
+            case TRACE_AVL: checksum += avl_search(avl, key) != NULL; break;
+            case TRACE_RBT: checksum += rbt_search(rbt, key) != NULL; break;
+            case TRACE_WAVL: checksum += wavl_search(wavl, key) != NULL; break;
+            case TRACE_SPLAY:
+                splay = splay_search(splay, key, &rotations);
+                checksum += splay != NULL && splay->key == key;
+                break;
+            case TRACE_BPLUS: checksum += bplus_contains(bplus, key); break;
+            case TRACE_SWISS: checksum += swiss_contains(swiss, key); break;
+            case TRACE_ART: checksum += art_contains(art, key); break;
+            case TRACE_LSM: checksum += lsm_contains(lsm, key); break;
+            case TRACE_DELTA: checksum += delta_index_contains(delta, key); break;
+            default: checksum += adaptive_contains(adaptive, key); break;
+            }
+            break;
+        case TRACE_INSERT:
+            switch (s) {
+            case TRACE_AVL: avl = avl_insert(avl, key, &rotations); break;
+            case TRACE_RBT: rbt = rbt_insert(rbt, key, &rotations, &recolorings); break;
+            case TRACE_WAVL: wavl = wavl_insert(wavl, key, &rotations); break;
+            case TRACE_SPLAY: splay = splay_insert(splay, key, &rotations); break;
+            case TRACE_BPLUS: bplus_insert(bplus, key); break;
+            case TRACE_SWISS: swiss_insert(swiss, key); break;
+            case TRACE_ART: art_insert(art, key); break;
+            case TRACE_LSM: lsm_insert(lsm, key); break;
+            case TRACE_DELTA: delta_index_insert(delta, key); break;
+            default: adaptive_insert(adaptive, key); break;
+            }
+            break;
+        case TRACE_DELETE:
+            switch (s) {
+            case TRACE_AVL: avl = avl_delete(avl, key, &rotations); break;
+            case TRACE_RBT: rbt = rbt_delete(rbt, key, &rotations, &recolorings); break;
+            case TRACE_WAVL: wavl = wavl_delete(wavl, key, &rotations); break;
+            case TRACE_SPLAY: splay = splay_delete(splay, key, &rotations); break;
+            case TRACE_SWISS: swiss_erase(swiss, key); break;
+            case TRACE_ART: art_delete(art, key); break;
+            case TRACE_ADAPTIVE: adaptive_delete(adaptive, key); break;
+            case TRACE_DELTA: delta_index_delete(delta, key); break;
+            default: break;
+            }
+            break;
+        default:
+            switch (s) {
+            case TRACE_AVL: checksum += trace_avl_range(avl, key, op->hi); break;
+            case TRACE_RBT: checksum += trace_rbt_range(rbt, key, op->hi); break;
+            case TRACE_WAVL: checksum += trace_wavl_range(wavl, key, op->hi); break;
+            case TRACE_SPLAY: checksum += trace_splay_range(splay, key, op->hi); break;
+            case TRACE_BPLUS: checksum += bplus_range(bplus, key, op->hi, range_buffer, max_out); break;
+            case TRACE_ART: checksum += art_range(art, key, op->hi, range_buffer, max_out); break;
+            case TRACE_DELTA: checksum += delta_index_range(delta, key, op->hi, range_buffer, max_out); break;
+            default: break;
+            }
+            break;
+        }
+    }
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    result->name = trace_structure_names[s];
+    result->ns_per_op = sample->count > 0 ? seconds * 1e9 / sample->count : 0;
+    result->checksum = checksum;
+
+    free_avl_tree(avl);
+    free_rbt_tree(rbt);
+    free_wavl_tree(wavl);
+    free_splay_tree(splay);
+    if (bplus != NULL)
+        bplus_free(bplus);
+    if (swiss != NULL)
+        swiss_free(swiss);
+    if (art != NULL)
+        art_free(art);
+    if (lsm != NULL)
+        lsm_free(lsm);
+    if (adaptive != NULL)
+        adaptive_free(adaptive);
+    if (delta != NULL)
+        delta_index_free(delta);
+}
+
+int trace_replay(const struct TraceSample* sample, const struct TraceProfile* profile,
+                 struct TraceReplayResult* results, int max_results) {
+    int* range_buffer = (int*)malloc((sample->count > 0 ? sample->count : 1) * sizeof(int));
+    int n = 0;
+    for (int s = 0; s < TRACE_STRUCTURES && n < max_results; s++) {
+        struct TraceReplayResult* result = &results[n++];
+        memset(result, 0, sizeof(*result));
+        result->name = trace_structure_names[s];
+        int needs_delete = profile->counts[TRACE_DELETE] > 0 && !trace_has_delete[s];
+        int needs_range = profile->counts[TRACE_RANGE] > 0 && !trace_has_range[s];
+        if (needs_delete || needs_range) {
+            result->missing = needs_delete && needs_range ? "нет удаления и диапазонов"
+                              : needs_delete ? "нет удаления" : "нет диапазонов";
+            continue;
+        }
+        result->supported = 1;
+        trace_replay_one(sample, (enum TraceStructure)s, range_buffer, result);
+    }
+    free(range_buffer);
+    return n;
+}
+
+// ==================== ТЕСТ 30: ВЫБОР СТРУКТУРЫ ПО ЖУРНАЛУ ====================
+
+// Журнал сенсоров: время растет, изредка "показания за период"
+static void trace_write_sensors(FILE* f, int ops, long long* counts) {
+    int now = 1000000;
+    for (int i = 0; i < ops; i++) {
+        int r = rand() % 100;
+        if (r < 85) {
+            // Показания приходят почти по порядку, с небольшим опозданием
+            now += 1 + rand() % 3;
+            fprintf(f, "I %d\n", now - rand() % 8);
+            counts[TRACE_INSERT]++;
+        } else if (r < 95) {
+            int from = now - 200 - rand() % 5000;
+            fprintf(f, "R %d %d\n", from, from + 200);
+            counts[TRACE_RANGE]++;
+        } else {
+            fprintf(f, "S %d\n", now - rand() % 100000);
+            counts[TRACE_SEARCH]++;
+        }
+    }
+}
+
+// Кеш: 80% запросов к 1% горячих ключей, вставки и удаления случайных
+static void trace_write_cache(FILE* f, int ops, int key_range, long long* counts) {
+    int hot = key_range / 100;
+    for (int i = 0; i < ops; i++) {
+        int r = rand() % 100;
+        int key = rand() % 5 != 0 ? rand() % hot : rand() % key_range;
+        if (r < 80) {
+            fprintf(f, "S %d\n", key);
+            counts[TRACE_SEARCH]++;
+        } else if (r < 90) {
+            fprintf(f, "I %d\n", key);
+            counts[TRACE_INSERT]++;
+        } else {
+            fprintf(f, "D %d\n", key);
+            counts[TRACE_DELETE]++;
+        }
+    }
+}
+
+static void trace_print_profile(const struct TraceProfile* profile) {
+    double ops = profile->ops > 0 ? (double)profile->ops : 1;
+    printf("Операций: %lld (ошибочных строк: %lld)\n", profile->ops, profile->bad_lines);
+    printf("Смесь: поиск %.1f%%, вставка %.1f%%, удаление %.1f%%, диапазон %.1f%% (ширина %.0f)\n",
+           100.0 * profile->counts[TRACE_SEARCH] / ops, 100.0 * profile->counts[TRACE_INSERT] / ops,
+           100.0 * profile->counts[TRACE_DELETE] / ops, 100.0 * profile->counts[TRACE_RANGE] / ops,
+           profile->avg_range_width);
+    printf("Ключи: %d..%d, различных ~%.0f, рабочий набор ~%.0f\n", profile->min_key,
+           profile->max_key, profile->distinct_keys, profile->working_set_keys);
+    printf("Монотонность вставок: %.1f%%, на %d%% самых частых ключей: %.1f%% обращений\n",
+           100.0 * profile->insert_monotonic, TRACE_HOT_KEYS_PERCENT, 100.0 * profile->hot_keys_share);
+    printf("Выборка: %lld операций (%.2f%% ключей)\n", profile->sample_ops,
+           100.0 * profile->sample_rate);
+}
+
+// Самая быстрая структура среди умеющих все операции журнала
+int trace_measured_winner(const struct TraceReplayResult* results, int count) {
+    int best = -1;
+    for (int i = 0; i < count; i++) {
+        if (results[i].supported && (best < 0 || results[i].ns_per_op < results[best].ns_per_op))
+            best = i;
+    }
+    return best;
+}
+
+void test_trace_profile() {
+    printf("=== ТЕСТ 30: Профиль нагрузки по журналу операций и замер на выборке ===\n\n");
+
+    const int OPS = 4000000;
+    const int SAMPLE = 500000;
+    const char* dir = getenv("TMPDIR");
+    if (dir == NULL || dir[0] == '\0')
+        dir = "/tmp";
+    char path[512];
+    snprintf(path, sizeof(path), "%s/trace_profile_%d.log", dir, (int)getpid());
+
+    srand(time(NULL));
+    const char* titles[] = {"Журнал сенсоров (умный дом)", "Журнал кеша с горячими ключами"};
+    for (int t = 0; t < 2; t++) {
+        long long counts[4] = {0, 0, 0, 0};
+        FILE* f = fopen(path, "w");
+        if (f == NULL) {
+            printf("Не удалось создать %s, тест пропущен\n\n", path);
+            return;
+        }
+        if (t == 0)
+            trace_write_sensors(f, OPS, counts);
+        else
+            trace_write_cache(f, OPS, 4000000, counts);
+        long file_bytes = ftell(f);
+        fclose(f);
+
+        struct TraceProfile profile;
+        struct TraceSample* sample = NULL;
+        double start_ms = wall_time_ms();
+        trace_profile_file(path, SAMPLE, &profile, &sample);
+        double profile_ms = wall_time_ms() - start_ms;
+
+        printf("%s: %.1f МиБ, разбор за %.0f мс (%.0f МиБ/с), выборка не больше %d операций\n",
+               titles[t], file_bytes / 1048576.0, profile_ms,
+               file_bytes / 1048576.0 / (profile_ms / 1000.0), SAMPLE);
+        trace_print_profile(&profile);
+        int mix_ok = 1;
+        for (int k = 0; k < 4; k++)
+            mix_ok &= counts[k] == profile.counts[k];
+        printf("Смесь совпадает с записанной: %s\n\n", mix_ok ? "да" : "НЕТ");
+
+        struct TraceReplayResult results[16];
+        int n = trace_replay(sample, &profile, results, 16);
+        long long reference = -1;
+        int all_match = 1;
+        // Подписи выровнены вручную: %-Ns считает байты, а не буквы
+        printf("Структура          | нс/операция | Совпадение результатов\n");
+        printf("-------------------|-------------|-----------------------\n");
+        for (int i = 0; i < n; i++) {
+            if (!results[i].supported) {
+                printf("%-18s |           - | %s\n", results[i].name, results[i].missing);
+                continue;
+            }
+            if (reference < 0)
+                reference = results[i].checksum;
+            int match = results[i].checksum == reference;
+            all_match &= match;
+            printf("%-18s | %11.1f | %s\n", results[i].name, results[i].ns_per_op,
+                   match ? "да" : "НЕТ");
+        }
+        int winner = trace_measured_winner(results, n);
+        printf("\nИзмеренный победитель: %s (все результаты совпали: %s)\n\n",
+               winner >= 0 ? results[winner].name : "-", all_match ? "да" : "НЕТ");
+        trace_sample_free(sample);
+    }
+    unlink(path);
+
+    printf("ВЫВОД:\n");
+    printf("• Один проход по журналу с памятью, не зависящей от его длины, дает смесь\n");
+    printf("  операций, перекос, монотонность и размер рабочего набора\n");
+    printf("• Выборка по хешу ключа сохраняет судьбу каждого ключа целиком, поэтому\n");
+    printf("  результаты поиска одинаковы у всех структур\n");
+    printf("• Для своего журнала: choose_struct --trace <файл> [операций в выборке]\n\n");
+}
@@ -0,0 +1,1043 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "methods.h"
+
+// ========== ПУЛ ПОТОКОВ (FORK-JOIN) ==========
+
+struct ThreadPool {
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<struct PoolTask*> queue;
+    bool stop;
+};
+
+static void pool_run_task(struct PoolTask* task) {
+    task->run(task);
+    task->done.store(1, std::memory_order_release);
+}
+
+static void pool_worker(struct ThreadPool* pool) {
+    for (;;) {
+        struct PoolTask* task;
+        {
+            std::unique_lock<std::mutex> lock(pool->mutex);
+            pool->cv.wait(lock, [pool] { return pool->stop || !pool->queue.empty(); });
+            if (pool->queue.empty())
+                return;
+            task = pool->queue.front();
+            pool->queue.pop_front();
+        }
+        pool_run_task(task);
+    }
+}
+
+struct ThreadPool* thread_pool_create(int workers) {
+    struct ThreadPool* pool = new ThreadPool();
+    pool->stop = false;
+    for (int i = 0; i < workers; i++)
+        pool->workers.push_back(std::thread(pool_worker, pool));
+    return pool;
+}
+
+void thread_pool_destroy(struct ThreadPool* pool) {
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        pool->stop = true;
+    }
+    pool->cv.notify_all();
+    for (size_t i = 0; i < pool->workers.size(); i++)
+        pool->workers[i].join();
+    delete pool;
+}
+
+void thread_pool_fork(struct ThreadPool* pool, struct PoolTask* task) {
+    task->done.store(0, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        pool->queue.push_back(task);
+    }
+    pool->cv.notify_one();
+}
+
+void thread_pool_join(struct ThreadPool* pool, struct PoolTask* task) {
+    // Пока ждем, помогаем: берем самую свежую задачу (чаще всего - свою же)
+    while (!task->done.load(std::memory_order_acquire)) {
+        struct PoolTask* other = NULL;
+        {
+            std::lock_guard<std::mutex> lock(pool->mutex);
+            if (!pool->queue.empty()) {
+                other = pool->queue.back();
+                pool->queue.pop_back();
+            }
+        }
+        if (other != NULL)
+            pool_run_task(other);
+        else
+            std::this_thread::yield();
+    }
+}
+
+// ========== AVL: JOIN / SPLIT ==========
+
+// Ниже этой высоты поддеревья обрабатываются без порождения задач
+#define AVL_PARALLEL_HEIGHT 12
+
+static void avl_update_height(struct AVLNode* node) {
+    int hl = avl_height(node->left);
+    int hr = avl_height(node->right);
+    node->height = 1 + (hl > hr ? hl : hr);
+}
+
+static struct AVLNode* avl_make(struct AVLNode* left, struct AVLNode* k, struct AVLNode* right) {
+    k->left = left;
+    k->right = right;
+    avl_update_height(k);
+#ifdef TREE_ORDER_STATISTICS
+    avl_update_size(k);
+#endif
+    return k;
+}
+
+// Левое дерево выше правого более чем на 1: спускаемся по правому краю
+static struct AVLNode* avl_join_right(struct AVLNode* tl, struct AVLNode* k, struct AVLNode* tr) {
+    struct AVLNode* l = tl->left;
+    struct AVLNode* c = tl->right;
+
+    if (avl_height(c) <= avl_height(tr) + 1) {
+        struct AVLNode* t = avl_make(c, k, tr);
+        if (avl_height(t) <= avl_height(l) + 1)
+            return avl_make(l, tl, t);
+        return avl_rotate_left(avl_make(l, tl, avl_rotate_right(t)));
+    }
+
+    struct AVLNode* t = avl_join_right(c, k, tr);
+    avl_make(l, tl, t);
+    if (avl_height(t) <= avl_height(l) + 1)
+        return tl;
+    return avl_rotate_left(tl);
+}
+
+// Зеркальный случай: правое дерево выше
+static struct AVLNode* avl_join_left(struct AVLNode* tl, struct AVLNode* k, struct AVLNode* tr) {
+    struct AVLNode* r = tr->right;
+    struct AVLNode* c = tr->left;
+
+    if (avl_height(c) <= avl_height(tl) + 1) {
+        struct AVLNode* t = avl_make(tl, k, c);
+        if (avl_height(t) <= avl_height(r) + 1)
+            return avl_make(t, tr, r);
+        return avl_rotate_right(avl_make(avl_rotate_left(t), tr, r));
+    }
+
+    struct AVLNode* t = avl_join_left(tl, k, c);
+    avl_make(t, tr, r);
+    if (avl_height(t) <= avl_height(r) + 1)
+        return tr;
+    return avl_rotate_right(tr);
+}
+
+struct AVLNode* avl_join(struct AVLNode* left, struct AVLNode* k, struct AVLNode* right) {
+    if (avl_height(left) > avl_height(right) + 1)
+        return avl_join_right(left, k, right);
+    if (avl_height(right) > avl_height(left) + 1)
+        return avl_join_left(left, k, right);
+    return avl_make(left, k, right);
+}
+
+struct AVLNode* avl_split(struct AVLNode* root, int key,
+                          struct AVLNode** left, struct AVLNode** right) {
+    if (root == NULL) {
+        *left = *right = NULL;
+        return NULL;
+    }
+
+    struct AVLNode* l = root->left;
+    struct AVLNode* r = root->right;
+    struct AVLNode* found;
+
+    if (key == root->key) {
+        *left = l;
+        *right = r;
+        root->left = root->right = NULL;
+        root->height = 1;
+#ifdef TREE_ORDER_STATISTICS
+        root->size = 1;
+#endif
+        return root;
+    }
+
+    if (key < root->key) {
+        struct AVLNode* middle;
+        found = avl_split(l, key, left, &middle);
+        *right = avl_join(middle, root, r);
+    } else {
+        struct AVLNode* middle;
+        found = avl_split(r, key, &middle, right);
+        *left = avl_join(l, root, middle);
+    }
+    return found;
+}
+
+// Отрезает максимальный узел; остаток дерева возвращается через rest
+static struct AVLNode* avl_split_last(struct AVLNode* root, struct AVLNode** rest) {
+    if (root->right == NULL) {
+        *rest = root->left;
+        root->left = NULL;
+        root->height = 1;
+#ifdef TREE_ORDER_STATISTICS
+        root->size = 1;
+#endif
+        return root;
+    }
+    struct AVLNode* right_rest;
+    struct AVLNode* last = avl_split_last(root->right, &right_rest);
+    *rest = avl_join(root->left, root, right_rest);
+    return last;
+}
+
+// Соединение без разделяющего ключа
+static struct AVLNode* avl_join2(struct AVLNode* left, struct AVLNode* right) {
+    if (left == NULL)
+        return right;
+    struct AVLNode* rest;
+    struct AVLNode* last = avl_split_last(left, &rest);
+    return avl_join(rest, last, right);
+}
+
+// ========== AVL: ОПЕРАЦИИ НАД МНОЖЕСТВАМИ ==========
+
+enum SetOp { SET_UNION, SET_INTERSECTION, SET_DIFFERENCE };
+
+static struct AVLNode* avl_set_op(struct ThreadPool* pool, enum SetOp op,
+                                  struct AVLNode* a, struct AVLNode* b);
+
+struct AVLSetTask {
+    struct PoolTask task; // должен идти первым
+    struct ThreadPool* pool;
+    enum SetOp op;
+    struct AVLNode* a;
+    struct AVLNode* b;
+    struct AVLNode* result;
+};
+
+static void avl_set_task_run(struct PoolTask* task) {
+    struct AVLSetTask* t = (struct AVLSetTask*)task;
+    t->result = avl_set_op(t->pool, t->op, t->a, t->b);
+}
+
+// Выполняет op над парами (a1, b1) и (a2, b2), первую пару - в отдельной задаче
+static void avl_set_op_pair(struct ThreadPool* pool, enum SetOp op, int parallel,
+                            struct AVLNode* a1, struct AVLNode* b1, struct AVLNode** r1,
+                            struct AVLNode* a2, struct AVLNode* b2, struct AVLNode** r2) {
+    if (pool == NULL || !parallel) {
+        *r1 = avl_set_op(pool, op, a1, b1);
+        *r2 = avl_set_op(pool, op, a2, b2);
+        return;
+    }
+    struct AVLSetTask task;
+    task.task.run = avl_set_task_run;
+    task.pool = pool;
+    task.op = op;
+    task.a = a1;
+    task.b = b1;
+    thread_pool_fork(pool, &task.task);
+    *r2 = avl_set_op(pool, op, a2, b2);
+    thread_pool_join(pool, &task.task);
+    *r1 = task.result;
+}
+
+static struct AVLNode* avl_set_op(struct ThreadPool* pool, enum SetOp op,
+                                  struct AVLNode* a, struct AVLNode* b) {
+    if (a == NULL) {
+        if (op == SET_UNION)
+            return b;
+        free_avl_tree(b);
+        return NULL;
+    }
+    if (b == NULL) {
+        if (op == SET_INTERSECTION) {
+            free_avl_tree(a);
+            return NULL;
+        }
+        return a;
+    }
+
+    int parallel = avl_height(a) >= AVL_PARALLEL_HEIGHT && avl_height(b) >= AVL_PARALLEL_HEIGHT;
+    struct AVLNode* l;
+    struct AVLNode* r;
+
+    if (op == SET_DIFFERENCE) {
+        // Делим a по корню b: ключ корня b удаляется из результата
+        struct AVLNode *al, *ar;
+        struct AVLNode* found = avl_split(a, b->key, &al, &ar);
+        if (found != NULL)
+            tree_node_free(found, sizeof(struct AVLNode));
+        avl_set_op_pair(pool, op, parallel, al, b->left, &l, ar, b->right, &r);
+        tree_node_free(b, sizeof(struct AVLNode));
+        return avl_join2(l, r);
+    }
+
+    // Объединение и пересечение: делим b по корню a
+    struct AVLNode *bl, *br;
+    struct AVLNode* found = avl_split(b, a->key, &bl, &br);
+    avl_set_op_pair(pool, op, parallel, a->left, bl, &l, a->right, br, &r);
+
+    if (op == SET_UNION || found != NULL) {
+        if (found != NULL)
+            tree_node_free(found, sizeof(struct AVLNode));
+        return avl_join(l, a, r);
+    }
+    tree_node_free(a, sizeof(struct AVLNode));
+    return avl_join2(l, r);
+}
+
+struct AVLNode* avl_union(struct ThreadPool* pool, struct AVLNode* a, struct AVLNode* b) {
+    return avl_set_op(pool, SET_UNION, a, b);
+}
+
+struct AVLNode* avl_intersection(struct ThreadPool* pool, struct AVLNode* a, struct AVLNode* b) {
+    return avl_set_op(pool, SET_INTERSECTION, a, b);
+}
+
+struct AVLNode* avl_difference(struct ThreadPool* pool, struct AVLNode* a, struct AVLNode* b) {
+    return avl_set_op(pool, SET_DIFFERENCE, a, b);
+}
+
+// ========== RBT: JOIN / SPLIT ==========
+
+// Черная высота bh - число черных узлов на пути от корня поддерева
+// до NULL (включая сам корень). Ее передаем явно, чтобы не пересчитывать.
+#define RBT_PARALLEL_BLACK_HEIGHT 9
+
+static int rbt_is_red(struct RBNode* node) {
+    return node != NULL && node->color == RED;
+}
+
+static int rbt_black_height(struct RBNode* node) {
+    int bh = 0;
+    for (; node != NULL; node = node->left)
+        if (node->color == BLACK)
+            bh++;
+    return bh;
+}
+
+static struct RBNode* rbt_make(struct RBNode* left, struct RBNode* k,
+                               struct RBNode* right, enum Color color) {
+    k->left = left;
+    k->right = right;
+    k->color = color;
+    if (left != NULL)
+        left->parent = k;
+    if (right != NULL)
+        right->parent = k;
+#ifdef TREE_ORDER_STATISTICS
+    rbt_update_size(k);
+#endif
+    return k;
+}
+
+// Повороты для отсоединенных поддеревьев: родителя нового корня
+// выставляет вызывающий код
+static struct RBNode* rbt_join_rotate_left(struct RBNode* x) {
+    struct RBNode* y = x->right;
+    x->right = y->left;
+    if (y->left != NULL)
+        y->left->parent = x;
+    y->left = x;
+    x->parent = y;
+#ifdef TREE_ORDER_STATISTICS
+    y->size = x->size;
+    rbt_update_size(x);
+#endif
+    return y;
+}
+
+static struct RBNode* rbt_join_rotate_right(struct RBNode* y) {
+    struct RBNode* x = y->left;
+    y->left = x->right;
+    if (x->right != NULL)
+        x->right->parent = y;
+    x->right = y;
+    y->parent = x;
+#ifdef TREE_ORDER_STATISTICS
+    x->size = y->size;
+    rbt_update_size(y);
+#endif
+    return x;
+}
+
+static struct RBNode* rbt_join_right(struct RBNode* tl, int bhl, struct RBNode* k,
+                                     struct RBNode* tr, int bhr) {
+    if (!rbt_is_red(tl) && bhl == bhr)
+        return rbt_make(tl, k, tr, RED);
+
+    int bh_child = bhl - (rbt_is_red(tl) ? 0 : 1);
+    struct RBNode* t = rbt_join_right(tl->right, bh_child, k, tr, bhr);
+    tl->right = t;
+    t->parent = tl;
+#ifdef TREE_ORDER_STATISTICS
+    rbt_update_size(tl);
+#endif
+
+    // Два красных подряд на правом краю - исправляем поворотом
+    if (!rbt_is_red(tl) && rbt_is_red(t) && rbt_is_red(t->right)) {
+        t->right->color = BLACK;
+        return rbt_join_rotate_left(tl);
+    }
+    return tl;
+}
+
+static struct RBNode* rbt_join_left(struct RBNode* tl, int bhl, struct RBNode* k,
+                                    struct RBNode* tr, int bhr) {
+    if (!rbt_is_red(tr) && bhl == bhr)
+        return rbt_make(tl, k, tr, RED);
+
+    int bh_child = bhr - (rbt_is_red(tr) ? 0 : 1);
+    struct RBNode* t = rbt_join_left(tl, bhl, k, tr->left, bh_child);
+    tr->left = t;
+    t->parent = tr;
+#ifdef TREE_ORDER_STATISTICS
+    rbt_update_size(tr);
+#endif
+
+    if (!rbt_is_red(tr) && rbt_is_red(t) && rbt_is_red(t->left)) {
+        t->left->color = BLACK;
+        return rbt_join_rotate_right(tr);
+    }
+    return tr;
+}
+
+static struct RBNode* rbt_join_bh(struct RBNode* tl, int bhl, struct RBNode* k,
+                                  struct RBNode* tr, int bhr, int* bh_out) {
+    // Корни входных деревьев делаем черными (это всегда допустимо)
+    if (rbt_is_red(tl)) {
+        tl->color = BLACK;
+        bhl++;
+    }
+    if (rbt_is_red(tr)) {
+        tr->color = BLACK;
+        bhr++;
+    }
+
+    struct RBNode* t;
+    if (bhl > bhr) {
+        t = rbt_join_right(tl, bhl, k, tr, bhr);
+        *bh_out = bhl;
+    } else if (bhr > bhl) {
+        t = rbt_join_left(tl, bhl, k, tr, bhr);
+        *bh_out = bhr;
+    } else {
+        t = rbt_make(tl, k, tr, RED);
+        *bh_out = bhl;
+    }
+
+    if (rbt_is_red(t) && (rbt_is_red(t->left) || rbt_is_red(t->right))) {
+        t->color = BLACK;
+        (*bh_out)++;
+    }
+    t->parent = NULL;
+    return t;
+}
+
+static struct RBNode* rbt_split_bh(struct RBNode* root, int bh, int key,
+                                   struct RBNode** left, int* bhl,
+                                   struct RBNode** right, int* bhr) {
+    if (root == NULL) {
+        *left = *right = NULL;
+        *bhl = *bhr = 0;
+        return NULL;
+    }
+
+    int bh_child = bh - (rbt_is_red(root) ? 0 : 1);
+    struct RBNode* l = root->left;
+    struct RBNode* r = root->right;
+    if (l != NULL)
+        l->parent = NULL;
+    if (r != NULL)
+        r->parent = NULL;
+    struct RBNode* found;
+
+    if (key == root->key) {
+        *left = l;
+        *right = r;
+        *bhl = *bhr = bh_child;
+        root->left = root->right = root->parent = NULL;
+#ifdef TREE_ORDER_STATISTICS
+        root->size = 1;
+#endif
+        return root;
+    }
+
+    if (key < root->key) {
+        struct RBNode* middle;
+        int bh_middle;
+        found = rbt_split_bh(l, bh_child, key, left, bhl, &middle, &bh_middle);
+        *right = rbt_join_bh(middle, bh_middle, root, r, bh_child, bhr);
+    } else {
+        struct RBNode* middle;
+        int bh_middle;
+        found = rbt_split_bh(r, bh_child, key, &middle, &bh_middle, right, bhr);
+        *left = rbt_join_bh(l, bh_child, root, middle, bh_middle, bhl);
+    }
+    return found;
+}
+
+static struct RBNode* rbt_split_last(struct RBNode* root, int bh,
+                                     struct RBNode** rest, int* bh_rest) {
+    int bh_child = bh - (rbt_is_red(root) ? 0 : 1);
+    if (root->right == NULL) {
+        *rest = root->left;
+        *bh_rest = bh_child;
+        if (*rest != NULL)
+            (*rest)->parent = NULL;
+        root->left = root->parent = NULL;
+#ifdef TREE_ORDER_STATISTICS
+        root->size = 1;
+#endif
+        return root;
+    }
+    struct RBNode* l = root->left;
+    if (l != NULL)
+        l->parent = NULL;
+    root->right->parent = NULL;
+
+    struct RBNode* right_rest;
+    int bh_right_rest;
+    struct RBNode* last = rbt_split_last(root->right, bh_child, &right_rest, &bh_right_rest);
+    *rest = rbt_join_bh(l, bh_child, root, right_rest, bh_right_rest, bh_rest);
+    return last;
+}
+
+static struct RBNode* rbt_join2_bh(struct RBNode* left, int bhl,
+                                   struct RBNode* right, int bhr, int* bh_out) {
+    if (left == NULL) {
+        *bh_out = bhr;
+        return right;
+    }
+    struct RBNode* rest;
+    int bh_rest;
+    struct RBNode* last = rbt_split_last(left, bhl, &rest, &bh_rest);
+    return rbt_join_bh(rest, bh_rest, last, right, bhr, bh_out);
+}
+
+struct RBNode* rbt_join(struct RBNode* left, struct RBNode* k, struct RBNode* right) {
+    int bh;
+    struct RBNode* t = rbt_join_bh(left, rbt_black_height(left), k,
+                                   right, rbt_black_height(right), &bh);
+    t->color = BLACK;
+    return t;
+}
+
+struct RBNode* rbt_split(struct RBNode* root, int key,
+                         struct RBNode** left, struct RBNode** right) {
+    int bhl, bhr;
+    struct RBNode* found = rbt_split_bh(root, rbt_black_height(root), key,
+                                        left, &bhl, right, &bhr);
+    if (*left != NULL)
+        (*left)->color = BLACK;
+    if (*right != NULL)
+        (*right)->color = BLACK;
+    return found;
+}
+
+// ========== RBT: ОПЕРАЦИИ НАД МНОЖЕСТВАМИ ==========
+
+static struct RBNode* rbt_set_op(struct ThreadPool* pool, enum SetOp op,
+                                 struct RBNode* a, int bha,
+                                 struct RBNode* b, int bhb, int* bh_out);
+
+struct RBSetTask {
+    struct PoolTask task; // должен идти первым
+    struct ThreadPool* pool;
+    enum SetOp op;
+    struct RBNode* a;
+    int bha;
+    struct RBNode* b;
+    int bhb;
+    struct RBNode* result;
+    int bh_result;
+};
+
+static void rbt_set_task_run(struct PoolTask* task) {
+    struct RBSetTask* t = (struct RBSetTask*)task;
+    t->result = rbt_set_op(t->pool, t->op, t->a, t->bha, t->b, t->bhb, &t->bh_result);
+}
+
+static void rbt_set_op_pair(struct ThreadPool* pool, enum SetOp op, int parallel,
+                            struct RBNode* a1, int bha1, struct RBNode* b1, int bhb1,
+                            struct RBNode** r1, int* bhr1,
+                            struct RBNode* a2, int bha2, struct RBNode* b2, int bhb2,
+                            struct RBNode** r2, int* bhr2) {
+    if (pool == NULL || !parallel) {
+        *r1 = rbt_set_op(pool, op, a1, bha1, b1, bhb1, bhr1);
+        *r2 = rbt_set_op(pool, op, a2, bha2, b2, bhb2, bhr2);
+        return;
+    }
+    struct RBSetTask task;
+    task.task.run = rbt_set_task_run;
+    task.pool = pool;
+    task.op = op;
+    task.a = a1;
+    task.bha = bha1;
+    task.b = b1;
+    task.bhb = bhb1;
+    thread_pool_fork(pool, &task.task);
+    *r2 = rbt_set_op(pool, op, a2, bha2, b2, bhb2, bhr2);
+    thread_pool_join(pool, &task.task);
+    *r1 = task.result;
+    *bhr1 = task.bh_result;
+}
+
+static struct RBNode* rbt_set_op(struct ThreadPool* pool, enum SetOp op,
+                                 struct RBNode* a, int bha,
+                                 struct RBNode* b, int bhb, int* bh_out) {
+    if (a == NULL) {
+        if (op == SET_UNION) {
+            *bh_out = bhb;
+            return b;
+        }
+        free_rbt_tree(b);
+        *bh_out = 0;
+        return NULL;
+    }
+    if (b == NULL) {
+        if (op == SET_INTERSECTION) {
+            free_rbt_tree(a);
+            *bh_out = 0;
+            return NULL;
+        }
+        *bh_out = bha;
+        return a;
+    }
+
+    int parallel = bha >= RBT_PARALLEL_BLACK_HEIGHT && bhb >= RBT_PARALLEL_BLACK_HEIGHT;
+    struct RBNode *l, *r;
+    int bh_l, bh_r;
+
+    if (op == SET_DIFFERENCE) {
+        int bhb_child = bhb - (rbt_is_red(b) ? 0 : 1);
+        struct RBNode *al, *ar;
+        int bh_al, bh_ar;
+        struct RBNode* found = rbt_split_bh(a, bha, b->key, &al, &bh_al, &ar, &bh_ar);
+        if (found != NULL)
+            tree_node_free(found, sizeof(struct RBNode));
+        struct RBNode* b_left = b->left;
+        struct RBNode* b_right = b->right;
+        if (b_left != NULL)
+            b_left->parent = NULL;
+        if (b_right != NULL)
+            b_right->parent = NULL;
+        tree_node_free(b, sizeof(struct RBNode));
+        rbt_set_op_pair(pool, op, parallel,
+                        al, bh_al, b_left, bhb_child, &l, &bh_l,
+                        ar, bh_ar, b_right, bhb_child, &r, &bh_r);
+        return rbt_join2_bh(l, bh_l, r, bh_r, bh_out);
+    }
+
+    int bha_child = bha - (rbt_is_red(a) ? 0 : 1);
+    struct RBNode* a_left = a->left;
+    struct RBNode* a_right = a->right;
+    if (a_left != NULL)
+        a_left->parent = NULL;
+    if (a_right != NULL)
+        a_right->parent = NULL;
+
+    struct RBNode *bl, *br;
+    int bh_bl, bh_br;
+    struct RBNode* found = rbt_split_bh(b, bhb, a->key, &bl, &bh_bl, &br, &bh_br);
+    rbt_set_op_pair(pool, op, parallel,
+                    a_left, bha_child, bl, bh_bl, &l, &bh_l,
+                    a_right, bha_child, br, bh_br, &r, &bh_r);
+
+    if (op == SET_UNION || found != NULL) {
+        if (found != NULL)
+            tree_node_free(found, sizeof(struct RBNode));
+        return rbt_join_bh(l, bh_l, a, r, bh_r, bh_out);
+    }
+    tree_node_free(a, sizeof(struct RBNode));
+    return rbt_join2_bh(l, bh_l, r, bh_r, bh_out);
+}
+
+static struct RBNode* rbt_set_op_root(struct ThreadPool* pool, enum SetOp op,
+                                      struct RBNode* a, struct RBNode* b) {
+    int bh;
+    struct RBNode* t = rbt_set_op(pool, op, a, rbt_black_height(a), b, rbt_black_height(b), &bh);
+    if (t != NULL) {
+        t->color = BLACK;
+        t->parent = NULL;
+    }
+    return t;
+}
+
+struct RBNode* rbt_union(struct ThreadPool* pool, struct RBNode* a, struct RBNode* b) {
+    return rbt_set_op_root(pool, SET_UNION, a, b);
+}
+
+struct RBNode* rbt_intersection(struct ThreadPool* pool, struct RBNode* a, struct RBNode* b) {
+    return rbt_set_op_root(pool, SET_INTERSECTION, a, b);
+}
+
+struct RBNode* rbt_difference(struct ThreadPool* pool, struct RBNode* a, struct RBNode* b) {
+    return rbt_set_op_root(pool, SET_DIFFERENCE, a, b);
+}
+
+// ========== ПАРАЛЛЕЛЬНОЕ ПОСТРОЕНИЕ ИЗ НЕОТСОРТИРОВАННЫХ ДАННЫХ ==========
+// Вход делится на блоки, каждый блок вставляется в свое дерево
+// отдельной задачей, затем деревья попарно сливаются через union.
+
+struct BuildTask {
+    struct PoolTask task; // должен идти первым
+    struct ThreadPool* pool;
+    const int* keys;
+    int n;
+    int chunk;
+    int is_rbt;
+    void* result;
+};
+
+static void* build_range(struct ThreadPool* pool, const int* keys, int n, int chunk, int is_rbt);
+
+static void build_task_run(struct PoolTask* task) {
+    struct BuildTask* t = (struct BuildTask*)task;
+    t->result = build_range(t->pool, t->keys, t->n, t->chunk, t->is_rbt);
+}
+
+static void* build_range(struct ThreadPool* pool, const int* keys, int n, int chunk, int is_rbt) {
+    if (n <= chunk) {
+        int rotations = 0;
+        int recolorings = 0;
+        if (is_rbt) {
+            struct RBNode* root = NULL;
+            for (int i = 0; i < n; i++)
+                root = rbt_insert(root, keys[i], &rotations, &recolorings);
+            return root;
+        }
+        struct AVLNode* root = NULL;
+        for (int i = 0; i < n; i++)
+            root = avl_insert(root, keys[i], &rotations);
+        return root;
+    }
+
+    int half = n / 2;
+    struct BuildTask task;
+    task.task.run = build_task_run;
+    task.pool = pool;
+    task.keys = keys;
+    task.n = half;
+    task.chunk = chunk;
+    task.is_rbt = is_rbt;
+    thread_pool_fork(pool, &task.task);
+    void* right = build_range(pool, keys + half, n - half, chunk, is_rbt);
+    thread_pool_join(pool, &task.task);
+
+    if (is_rbt)
+        return rbt_union(pool, (struct RBNode*)task.result, (struct RBNode*)right);
+    return avl_union(pool, (struct AVLNode*)task.result, (struct AVLNode*)right);
+}
+
+static int build_chunk_size(int n) {
+    int chunk = n / 64;
+    return chunk < 4096 ? 4096 : chunk;
+}
+
+struct AVLNode* avl_build_parallel(struct ThreadPool* pool, const int* keys, int n) {
+    return (struct AVLNode*)build_range(pool, keys, n, build_chunk_size(n), 0);
+}
+
+struct RBNode* rbt_build_parallel(struct ThreadPool* pool, const int* keys, int n) {
+    return (struct RBNode*)build_range(pool, keys, n, build_chunk_size(n), 1);
+}
+
+// ========== ПРОВЕРКА ИНВАРИАНТОВ ==========
+
+// Возвращает высоту поддерева или -1 при нарушении
+static int avl_check(struct AVLNode* node, long long lo, long long hi) {
+    if (node == NULL)
+        return 0;
+    if (node->key <= lo || node->key >= hi)
+        return -1;
+    int hl = avl_check(node->left, lo, node->key);
+    int hr = avl_check(node->right, node->key, hi);
+    if (hl < 0 || hr < 0 || hl - hr > 1 || hr - hl > 1)
+        return -1;
+    int h = 1 + (hl > hr ? hl : hr);
+#ifdef TREE_ORDER_STATISTICS
+    if (node->size != 1 + avl_size(node->left) + avl_size(node->right))
+        return -1;
+#endif
+    return node->height == h ? h : -1;
+}
+
+int avl_is_valid(struct AVLNode* root) {
+    return avl_check(root, -(1LL << 40), 1LL << 40) >= 0;
+}
+
+// Возвращает черную высоту поддерева или -1 при нарушении
+static int rbt_check(struct RBNode* node, long long lo, long long hi) {
+    if (node == NULL)
+        return 0;
+    if (node->key <= lo || node->key >= hi)
+        return -1;
+    if (node->left != NULL && node->left->parent != node)
+        return -1;
+    if (node->right != NULL && node->right->parent != node)
+        return -1;
+    if (rbt_is_red(node) && (rbt_is_red(node->left) || rbt_is_red(node->right)))
+        return -1;
+    int bl = rbt_check(node->left, lo, node->key);
+    int br = rbt_check(node->right, node->key, hi);
+    if (bl < 0 || bl != br)
+        return -1;
+#ifdef TREE_ORDER_STATISTICS
+    if (node->size != 1 + rbt_size(node->left) + rbt_size(node->right))
+        return -1;
+#endif
+    return bl + (node->color == BLACK ? 1 : 0);
+}
+
+int rbt_is_valid(struct RBNode* root) {
+    if (root == NULL)
+        return 1;
+    return root->parent == NULL && root->color == BLACK &&
+           rbt_check(root, -(1LL << 40), 1LL << 40) >= 0;
+}
+
+// ==================== ТЕСТ 8: ОПЕРАЦИИ НАД МНОЖЕСТВАМИ ====================
+
+static struct AVLNode* avl_copy(struct AVLNode* node) {
+    if (node == NULL)
+        return NULL;
+    struct AVLNode* copy = (struct AVLNode*)tree_node_alloc(sizeof(struct AVLNode));
+    copy->key = node->key;
+    copy->height = node->height;
+#ifdef TREE_ORDER_STATISTICS
+    copy->size = node->size;
+#endif
+    copy->left = avl_copy(node->left);
+    copy->right = avl_copy(node->right);
+    return copy;
+}
+
+static struct RBNode* rbt_copy(struct RBNode* node, struct RBNode* parent) {
+    if (node == NULL)
+        return NULL;
+    struct RBNode* copy = (struct RBNode*)tree_node_alloc(sizeof(struct RBNode));
+    copy->key = node->key;
+    copy->color = node->color;
+#ifdef TREE_ORDER_STATISTICS
+    copy->size = node->size;
+#endif
+    copy->parent = parent;
+    copy->left = rbt_copy(node->left, copy);
+    copy->right = rbt_copy(node->right, copy);
+    return copy;
+}
+
+// Базовый вариант: обход src по порядку и вставка/фильтрация ключей в dst.
+// mode: 0 - вставить все, 1 - только найденные в filter, 2 - только ненайденные
+static struct AVLNode* avl_insert_from(struct AVLNode* dst, struct AVLNode* src,
+                                       struct AVLNode* filter, int mode, int* rotations) {
+    if (src == NULL)
+        return dst;
+    dst = avl_insert_from(dst, src->left, filter, mode, rotations);
+    if (mode == 0 || (avl_search(filter, src->key) != NULL) == (mode == 1))
+        dst = avl_insert(dst, src->key, rotations);
+    return avl_insert_from(dst, src->right, filter, mode, rotations);
+}
+
+static struct RBNode* rbt_insert_from(struct RBNode* dst, struct RBNode* src,
+                                      struct RBNode* filter, int mode,
+                                      int* rotations, int* recolorings) {
+    if (src == NULL)
+        return dst;
+    dst = rbt_insert_from(dst, src->left, filter, mode, rotations, recolorings);
+    if (mode == 0 || (rbt_search(filter, src->key) != NULL) == (mode == 1))
+        dst = rbt_insert(dst, src->key, rotations, recolorings);
+    return rbt_insert_from(dst, src->right, filter, mode, rotations, recolorings);
+}
+
+static int compare_ints(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+static int unique_sorted(int* keys, int n) {
+    qsort(keys, n, sizeof(int), compare_ints);
+    int m = 0;
+    for (int i = 0; i < n; i++)
+        if (m == 0 || keys[m - 1] != keys[i])
+            keys[m++] = keys[i];
+    return m;
+}
+
+// Ожидаемые размеры результата по отсортированным уникальным массивам
+static void expected_sizes(const int* a, int na, const int* b, int nb,
+                           int* uni, int* inter, int* diff) {
+    int i = 0, j = 0, common = 0;
+    while (i < na && j < nb) {
+        if (a[i] < b[j]) i++;
+        else if (a[i] > b[j]) j++;
+        else { common++; i++; j++; }
+    }
+    *uni = na + nb - common;
+    *inter = common;
+    *diff = na - common;
+}
+
+static void print_set_row(const char* tree, const char* op, int size,
+                          double base_ms, double join_ms, int ok) {
+    printf("%-4s | %-12s | %-9d | %-14.3f | %-14.3f | %-8.2f | %s\n",
+           tree, op, size, base_ms, join_ms,
+           join_ms > 0 ? base_ms / join_ms : 0.0, ok ? "OK" : "ОШИБКА");
+}
+
+void test_set_operations() {
+    printf("=== ТЕСТ 8: Join/split и параллельные операции над множествами ===\n\n");
+
+    int threads = (int)std::thread::hardware_concurrency();
+    if (threads < 1)
+        threads = 1;
+    struct ThreadPool* pool = thread_pool_create(threads - 1);
+    printf("Потоков в пуле: %d\n", threads);
+    printf("Базовый вариант: обход второго дерева и avl_insert/rbt_insert в первое\n");
+    printf("(для пересечения/разности - с avl_search/rbt_search по второму дереву)\n\n");
+
+    const int SIZES[] = {100000, 1000000};
+    const int NUM_SIZES = sizeof(SIZES) / sizeof(SIZES[0]);
+    const char* op_names[] = {"union", "intersection", "difference"};
+
+    printf("%-4s | %-12s | %-9s | %-14s | %-14s | %-8s | %s\n",
+           "Тип", "Операция", "Ключей", "Вставки (ms)", "Join (ms)", "Ускор.", "Проверка");
+    printf("-----|--------------|-----------|----------------|----------------|----------|---------\n");
+
+    srand(time(NULL));
+
+    for (int s = 0; s < NUM_SIZES; s++) {
+        int n = SIZES[s];
+        int* keys_a = (int*)malloc(n * sizeof(int));
+        int* keys_b = (int*)malloc(n * sizeof(int));
+        for (int i = 0; i < n; i++) {
+            keys_a[i] = rand() % (n * 4);
+            keys_b[i] = rand() % (n * 4);
+        }
+
+        int rotations = 0;
+        int recolorings = 0;
+        struct AVLNode* avl_a = NULL;
+        struct AVLNode* avl_b = NULL;
+        struct RBNode* rbt_a = NULL;
+        struct RBNode* rbt_b = NULL;
+        for (int i = 0; i < n; i++) {
+            avl_a = avl_insert(avl_a, keys_a[i], &rotations);
+            avl_b = avl_insert(avl_b, keys_b[i], &rotations);
+            rbt_a = rbt_insert(rbt_a, keys_a[i], &rotations, &recolorings);
+            rbt_b = rbt_insert(rbt_b, keys_b[i], &rotations, &recolorings);
+        }
+
+        // Ожидаемые размеры считаем независимо от деревьев
+        int* sorted_a = (int*)malloc(n * sizeof(int));
+        int* sorted_b = (int*)malloc(n * sizeof(int));
+        for (int i = 0; i < n; i++) {
+            sorted_a[i] = keys_a[i];
+            sorted_b[i] = keys_b[i];
+        }
+        int na = unique_sorted(sorted_a, n);
+        int nb = unique_sorted(sorted_b, n);
+        int expected[3];
+        expected_sizes(sorted_a, na, sorted_b, nb, &expected[0], &expected[1], &expected[2]);
+
+        for (int op = 0; op < 3; op++) {
+            // AVL: вставками
+            struct AVLNode* base = op == 0 ? avl_copy(avl_a) : NULL;
+            double start = wall_time_ms();
+            base = avl_insert_from(base, op == 0 ? avl_b : avl_a, avl_b, op, &rotations);
+            double base_ms = wall_time_ms() - start;
+            int ok = count_avl_nodes(base) == expected[op];
+            free_avl_tree(base);
+
+            // AVL: join/split
+            struct AVLNode* a = avl_copy(avl_a);
+            struct AVLNode* b = avl_copy(avl_b);
+            start = wall_time_ms();
+            struct AVLNode* result = op == 0 ? avl_union(pool, a, b)
+                                   : op == 1 ? avl_intersection(pool, a, b)
+                                             : avl_difference(pool, a, b);
+            double join_ms = wall_time_ms() - start;
+            ok = ok && avl_is_valid(result) && count_avl_nodes(result) == expected[op];
+            free_avl_tree(result);
+            print_set_row("AVL", op_names[op], n, base_ms, join_ms, ok);
+
+            // RBT: вставками
+            struct RBNode* rbase = op == 0 ? rbt_copy(rbt_a, NULL) : NULL;
+            start = wall_time_ms();
+            rbase = rbt_insert_from(rbase, op == 0 ? rbt_b : rbt_a, rbt_b, op,
+                                    &rotations, &recolorings);
+            base_ms = wall_time_ms() - start;
+            ok = count_rbt_nodes(rbase) == expected[op];
+            free_rbt_tree(rbase);
+
+            // RBT: join/split
+            struct RBNode* ra = rbt_copy(rbt_a, NULL);
+            struct RBNode* rb = rbt_copy(rbt_b, NULL);
+            start = wall_time_ms();
+            struct RBNode* rresult = op == 0 ? rbt_union(pool, ra, rb)
+                                   : op == 1 ? rbt_intersection(pool, ra, rb)
+                                             : rbt_difference(pool, ra, rb);
+            join_ms = wall_time_ms() - start;
+            ok = ok && rbt_is_valid(rresult) && count_rbt_nodes(rresult) == expected[op];
+            free_rbt_tree(rresult);
+            print_set_row("RBT", op_names[op], n, base_ms, join_ms, ok);
+        }
+
+        // Построение из неотсортированного массива
+        double start = wall_time_ms();
+        struct AVLNode* avl_seq = NULL;
+        for (int i = 0; i < n; i++)
+            avl_seq = avl_insert(avl_seq, keys_a[i], &rotations);
+        double base_ms = wall_time_ms() - start;
+        start = wall_time_ms();
+        struct AVLNode* avl_par = avl_build_parallel(pool, keys_a, n);
+        double join_ms = wall_time_ms() - start;
+        print_set_row("AVL", "build", n, base_ms, join_ms,
+                      avl_is_valid(avl_par) && count_avl_nodes(avl_par) == na);
+        free_avl_tree(avl_seq);
+        free_avl_tree(avl_par);
+
+        start = wall_time_ms();
+        struct RBNode* rbt_seq = NULL;
+        for (int i = 0; i < n; i++)
+            rbt_seq = rbt_insert(rbt_seq, keys_a[i], &rotations, &recolorings);
+        base_ms = wall_time_ms() - start;
+        start = wall_time_ms();
+        struct RBNode* rbt_par = rbt_build_parallel(pool, keys_a, n);
+        join_ms = wall_time_ms() - start;
+        print_set_row("RBT", "build", n, base_ms, join_ms,
+                      rbt_is_valid(rbt_par) && count_rbt_nodes(rbt_par) == na);
+        free_rbt_tree(rbt_seq);
+        free_rbt_tree(rbt_par);
+
+        free_avl_tree(avl_a);
+        free_avl_tree(avl_b);
+        free_rbt_tree(rbt_a);
+        free_rbt_tree(rbt_b);
+        free(keys_a);
+        free(keys_b);
+        free(sorted_a);
+        free(sorted_b);
+    }
+
+    thread_pool_destroy(pool);
+
+    printf("\nВЫВОД: join/split сливают деревья за O(m log(n/m + 1)) вместо O(m log n)\n");
+    printf("       и естественно распараллеливаются рекурсией fork-join\n\n");
+}
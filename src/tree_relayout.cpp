@@ -0,0 +1,411 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <unordered_map>
+#include <vector>
+
+#include "methods.h"
+
+// ========== ПЕРЕРАСКЛАДКА ЖИВОГО ДЕРЕВА (DFS / vEB) ==========
+// Узлы копируются в блоки по 2 MB в нужном порядке. Каждый шаг переносит
+// ровно один узел: копия получает те же ключ и потомков, ссылка родителя
+// (и parent у детей RBT) переставляется на копию. Поэтому между шагами
+// дерево всегда корректно, и в нем можно искать и вставлять.
+//
+// В стеке заданий хранятся адреса полей-ссылок только внутри уже
+// перенесенных в текущем проходе узлов (или адрес корня), а такие узлы
+// до конца прохода не освобождаются - ссылки не "протухают".
+//
+// Блоки зарегистрированы в хранилище узлов: узел, освобожденный обычным
+// tree_node_free (удаление, free_avl_tree), уменьшает счетчик живых узлов
+// своего блока, и опустевший блок освобождается целиком.
+
+#define RELAYOUT_CHUNK_BYTES NODE_STORAGE_BLOCK_BYTES
+
+enum RelayoutTaskKind { TASK_DFS, TASK_VEB, TASK_DESCEND };
+
+struct RelayoutTask {
+    void** link;
+    enum RelayoutTaskKind kind;
+    int height;  // TASK_VEB: сколько уровней раскладываем
+    int depth;   // TASK_DESCEND: сколько уровней осталось спуститься
+    int bottom;  // TASK_DESCEND: высота нижних поддеревьев
+};
+
+struct RelayoutChunk {
+    char* base;
+    int pass;  // в каком проходе блок заполнялся
+    int live;  // сколько узлов в блоке еще принадлежит дереву
+};
+
+struct TreeRelayout {
+    int is_rbt;
+    size_t node_size;
+    void** root_ref;
+    enum RelayoutOrder order;
+    int pass;
+    std::vector<struct RelayoutTask> stack;
+    std::unordered_map<uintptr_t, struct RelayoutChunk*> chunks;
+    struct RelayoutChunk* current;
+    size_t used; // занято байт в current
+    long long moved;
+};
+
+static struct RelayoutChunk* relayout_chunk_of(struct TreeRelayout* r, void* node) {
+    uintptr_t base = (uintptr_t)node & ~(uintptr_t)(RELAYOUT_CHUNK_BYTES - 1);
+    std::unordered_map<uintptr_t, struct RelayoutChunk*>::iterator it = r->chunks.find(base);
+    return it == r->chunks.end() ? NULL : it->second;
+}
+
+static void relayout_free_chunk(struct TreeRelayout* r, struct RelayoutChunk* chunk) {
+    node_storage_unregister_block(chunk->base);
+    r->chunks.erase((uintptr_t)chunk->base);
+    free(chunk->base);
+    free(chunk);
+}
+
+// Узел блока освобожден кодом дерева через tree_node_free
+static void relayout_release_node(void* owner, void* node) {
+    struct TreeRelayout* r = (struct TreeRelayout*)owner;
+    struct RelayoutChunk* chunk = relayout_chunk_of(r, node);
+    if (--chunk->live == 0 && chunk != r->current)
+        relayout_free_chunk(r, chunk);
+}
+
+static void* relayout_alloc(struct TreeRelayout* r) {
+    if (r->current == NULL || r->used + r->node_size > RELAYOUT_CHUNK_BYTES) {
+        // Заполненный блок, из которого уже все перенесли, больше не нужен
+        if (r->current != NULL && r->current->live == 0)
+            relayout_free_chunk(r, r->current);
+        struct RelayoutChunk* chunk = (struct RelayoutChunk*)malloc(sizeof(struct RelayoutChunk));
+        chunk->base = (char*)aligned_alloc(RELAYOUT_CHUNK_BYTES, RELAYOUT_CHUNK_BYTES);
+        chunk->pass = r->pass;
+        chunk->live = 0;
+        r->chunks[(uintptr_t)chunk->base] = chunk;
+        node_storage_register_block(chunk->base, r, relayout_release_node);
+        r->current = chunk;
+        r->used = 0;
+    }
+    void* slot = r->current->base + r->used;
+    r->used += r->node_size;
+    r->current->live++;
+    return slot;
+}
+
+static void** relayout_left_link(struct TreeRelayout* r, void* node) {
+    if (r->is_rbt)
+        return (void**)&((struct RBNode*)node)->left;
+    return (void**)&((struct AVLNode*)node)->left;
+}
+
+static void** relayout_right_link(struct TreeRelayout* r, void* node) {
+    if (r->is_rbt)
+        return (void**)&((struct RBNode*)node)->right;
+    return (void**)&((struct AVLNode*)node)->right;
+}
+
+// Переносит узел *link в текущий блок (если он еще не перенесен в этом проходе)
+static void* relayout_move(struct TreeRelayout* r, void** link) {
+    void* old = *link;
+    struct RelayoutChunk* chunk = relayout_chunk_of(r, old);
+    if (chunk != NULL && chunk->pass == r->pass)
+        return old;
+
+    void* copy = relayout_alloc(r);
+    memcpy(copy, old, r->node_size);
+    if (r->is_rbt) {
+        struct RBNode* node = (struct RBNode*)copy;
+        if (node->left != NULL)
+            node->left->parent = node;
+        if (node->right != NULL)
+            node->right->parent = node;
+    }
+    *link = copy;
+
+    if (chunk == NULL) {
+        tree_node_free(old, r->node_size);
+    } else if (--chunk->live == 0 && chunk != r->current) {
+        relayout_free_chunk(r, chunk);
+    }
+    r->moved++;
+    return copy;
+}
+
+static void relayout_push(struct TreeRelayout* r, void** link, enum RelayoutTaskKind kind,
+                          int height, int depth, int bottom) {
+    struct RelayoutTask task;
+    task.link = link;
+    task.kind = kind;
+    task.height = height;
+    task.depth = depth;
+    task.bottom = bottom;
+    r->stack.push_back(task);
+}
+
+static struct TreeRelayout* relayout_create(void** root_ref, int is_rbt, size_t node_size,
+                                            enum RelayoutOrder order) {
+    struct TreeRelayout* r = new TreeRelayout();
+    r->is_rbt = is_rbt;
+    r->node_size = node_size;
+    r->root_ref = root_ref;
+    r->order = order;
+    r->pass = 0;
+    r->current = NULL;
+    r->used = 0;
+    r->moved = 0;
+    return r;
+}
+
+struct TreeRelayout* avl_relayout_create(struct AVLNode** root, enum RelayoutOrder order) {
+    return relayout_create((void**)root, 0, sizeof(struct AVLNode), order);
+}
+
+struct TreeRelayout* rbt_relayout_create(struct RBNode** root, enum RelayoutOrder order) {
+    return relayout_create((void**)root, 1, sizeof(struct RBNode), order);
+}
+
+void tree_relayout_start(struct TreeRelayout* r) {
+    r->pass++;
+    r->stack.clear();
+    // Новый проход пишет в свежий блок
+    if (r->current != NULL && r->current->live == 0)
+        relayout_free_chunk(r, r->current);
+    r->current = NULL;
+
+    void* root = *r->root_ref;
+    if (root == NULL)
+        return;
+
+    if (r->order == RELAYOUT_DFS) {
+        relayout_push(r, r->root_ref, TASK_DFS, 0, 0, 0);
+        return;
+    }
+
+    // Оценка высоты сверху: для AVL она хранится в корне, для RBT
+    // не больше удвоенной черной высоты. Запас - на рост дерева во время прохода.
+    int height;
+    if (r->is_rbt) {
+        int black_height = 0;
+        for (struct RBNode* node = (struct RBNode*)root; node != NULL; node = node->left)
+            if (node->color == BLACK)
+                black_height++;
+        height = 2 * black_height + 1;
+    } else {
+        height = avl_height((struct AVLNode*)root);
+    }
+    relayout_push(r, r->root_ref, TASK_VEB, height + 2, 0, 0);
+}
+
+int tree_relayout_step(struct TreeRelayout* r, int max_steps) {
+    while (max_steps > 0 && !r->stack.empty()) {
+        struct RelayoutTask task = r->stack.back();
+        r->stack.pop_back();
+        if (*task.link == NULL)
+            continue;
+        max_steps--;
+
+        if (task.kind == TASK_DFS) {
+            void* node = relayout_move(r, task.link);
+            relayout_push(r, relayout_right_link(r, node), TASK_DFS, 0, 0, 0);
+            relayout_push(r, relayout_left_link(r, node), TASK_DFS, 0, 0, 0);
+        } else if (task.kind == TASK_VEB) {
+            if (task.height <= 1) {
+                relayout_move(r, task.link);
+            } else {
+                // Сначала верхняя половина уровней, затем нижние поддеревья слева направо
+                int top = task.height / 2;
+                relayout_push(r, task.link, TASK_DESCEND, 0, top, task.height - top);
+                relayout_push(r, task.link, TASK_VEB, top, 0, 0);
+            }
+        } else {
+            if (task.depth == 0) {
+                relayout_push(r, task.link, TASK_VEB, task.bottom, 0, 0);
+            } else {
+                // Узел верхней части уже перенесен, если дерево не менялось;
+                // иначе переносим его сейчас, чтобы не хранить ссылку в старый узел
+                void* node = relayout_move(r, task.link);
+                relayout_push(r, relayout_right_link(r, node), TASK_DESCEND, 0,
+                              task.depth - 1, task.bottom);
+                relayout_push(r, relayout_left_link(r, node), TASK_DESCEND, 0,
+                              task.depth - 1, task.bottom);
+            }
+        }
+    }
+    return r->stack.empty();
+}
+
+void tree_relayout_run(struct TreeRelayout* r) {
+    tree_relayout_start(r);
+    while (!tree_relayout_step(r, 1 << 20)) {
+    }
+}
+
+long long tree_relayout_moved(struct TreeRelayout* r) {
+    return r->moved;
+}
+
+void tree_relayout_destroy(struct TreeRelayout* r) {
+    // Узлы блоков возвращаются через relayout_release_node, остальные - в free
+    if (r->is_rbt)
+        free_rbt_tree((struct RBNode*)*r->root_ref);
+    else
+        free_avl_tree((struct AVLNode*)*r->root_ref);
+    *r->root_ref = NULL;
+    std::vector<struct RelayoutChunk*> chunks;
+    for (std::unordered_map<uintptr_t, struct RelayoutChunk*>::iterator it = r->chunks.begin();
+         it != r->chunks.end(); ++it)
+        chunks.push_back(it->second);
+    for (size_t i = 0; i < chunks.size(); i++)
+        relayout_free_chunk(r, chunks[i]);
+    delete r;
+}
+
+// ==================== ТЕСТ 10: ПЕРЕРАСКЛАДКА БОЛЬШИХ ДЕРЕВЬЕВ ====================
+
+static double avl_lookup_ns(struct AVLNode* root, const int* queries, int count, int* found) {
+    clock_t start = clock();
+    *found = 0;
+    for (int i = 0; i < count; i++)
+        *found += avl_search(root, queries[i]) != NULL;
+    return (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / count;
+}
+
+static double rbt_lookup_ns(struct RBNode* root, const int* queries, int count, int* found) {
+    clock_t start = clock();
+    *found = 0;
+    for (int i = 0; i < count; i++)
+        *found += rbt_search(root, queries[i]) != NULL;
+    return (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / count;
+}
+
+static double relayout_pass_ms(struct TreeRelayout* r, enum RelayoutOrder order) {
+    r->order = order;
+    clock_t start = clock();
+    tree_relayout_run(r);
+    return (double)(clock() - start) * 1000 / CLOCKS_PER_SEC;
+}
+
+void test_tree_relayout() {
+    printf("=== ТЕСТ 10: Перераскладка живого дерева в DFS / vEB порядок ===\n\n");
+
+    const int N = 1 << 21;
+    const int NUM_LOOKUPS = 2000000;
+    const int STEP = 1000;        // заданий перераскладки за шаг
+    const int INSERTS_PER_STEP = 50; // вставок между шагами
+
+    srand(time(NULL));
+    int* queries = (int*)malloc(NUM_LOOKUPS * sizeof(int));
+    for (int i = 0; i < NUM_LOOKUPS; i++)
+        queries[i] = rand() % (N * 2);
+
+    struct AVLNode* avl_root = NULL;
+    struct RBNode* rbt_root = NULL;
+    int rotations = 0;
+    int recolorings = 0;
+    for (int i = 0; i < N; i++) {
+        int key = rand() % (N * 2);
+        avl_root = avl_insert(avl_root, key, &rotations);
+        rbt_root = rbt_insert(rbt_root, key, &rotations, &recolorings);
+    }
+
+    printf("Деревья по %d случайных вставок, %d поисков\n\n", N, NUM_LOOKUPS);
+    printf("%-4s | %-24s | %-12s | %-12s | %s\n",
+           "Тип", "Раскладка", "Поиск (ns)", "Проход (ms)", "Проверка");
+    printf("-----|--------------------------|--------------|--------------|---------\n");
+
+    int found_before, found;
+    double ns = avl_lookup_ns(avl_root, queries, NUM_LOOKUPS, &found_before);
+    printf("%-4s | %-24s | %-12.1f | %-12s | %s\n", "AVL", "malloc (исходная)", ns, "-", "-");
+
+    struct TreeRelayout* avl_relayout = avl_relayout_create(&avl_root, RELAYOUT_DFS);
+    double pass_ms = relayout_pass_ms(avl_relayout, RELAYOUT_DFS);
+    ns = avl_lookup_ns(avl_root, queries, NUM_LOOKUPS, &found);
+    printf("%-4s | %-24s | %-12.1f | %-12.3f | %s\n", "AVL", "DFS (прямой обход)", ns, pass_ms,
+           found == found_before && avl_is_valid(avl_root) ? "OK" : "ОШИБКА");
+
+    pass_ms = relayout_pass_ms(avl_relayout, RELAYOUT_VEB);
+    ns = avl_lookup_ns(avl_root, queries, NUM_LOOKUPS, &found);
+    printf("%-4s | %-24s | %-12.1f | %-12.3f | %s\n", "AVL", "vEB", ns, pass_ms,
+           found == found_before && avl_is_valid(avl_root) ? "OK" : "ОШИБКА");
+
+    // Инкрементальный режим: шаги перераскладки чередуются со вставками
+    for (int i = 0; i < N / 8; i++)
+        avl_root = avl_insert(avl_root, rand() % (N * 2), &rotations);
+    avl_relayout->order = RELAYOUT_VEB;
+    tree_relayout_start(avl_relayout);
+    int steps = 0;
+    clock_t start = clock();
+    while (!tree_relayout_step(avl_relayout, STEP)) {
+        for (int i = 0; i < INSERTS_PER_STEP; i++)
+            avl_root = avl_insert(avl_root, rand() % (N * 2), &rotations);
+        steps++;
+    }
+    pass_ms = (double)(clock() - start) * 1000 / CLOCKS_PER_SEC;
+    ns = avl_lookup_ns(avl_root, queries, NUM_LOOKUPS, &found);
+    printf("%-4s | %-24s | %-12.1f | %-12.3f | %s\n", "AVL", "vEB по шагам + вставки", ns, pass_ms,
+           avl_is_valid(avl_root) ? "OK" : "ОШИБКА");
+
+    // После прохода дерево обычное: удаления освобождают узлы блоков через
+    // tree_node_free, free_avl_tree - тоже
+    start = clock();
+    for (int i = 0; i < N / 2; i++)
+        avl_root = avl_delete(avl_root, rand() % (N * 2), &rotations);
+    pass_ms = (double)(clock() - start) * 1000 / CLOCKS_PER_SEC;
+    ns = avl_lookup_ns(avl_root, queries, NUM_LOOKUPS, &found);
+    printf("%-4s | %-24s | %-12.1f | %-12.3f | %s\n", "AVL", "vEB, затем удаления", ns, pass_ms,
+           avl_is_valid(avl_root) ? "OK" : "ОШИБКА");
+    free_avl_tree(avl_root);
+    avl_root = NULL;
+    tree_relayout_destroy(avl_relayout);
+
+    ns = rbt_lookup_ns(rbt_root, queries, NUM_LOOKUPS, &found_before);
+    printf("%-4s | %-24s | %-12.1f | %-12s | %s\n", "RBT", "malloc (исходная)", ns, "-", "-");
+
+    struct TreeRelayout* rbt_relayout = rbt_relayout_create(&rbt_root, RELAYOUT_DFS);
+    pass_ms = relayout_pass_ms(rbt_relayout, RELAYOUT_DFS);
+    ns = rbt_lookup_ns(rbt_root, queries, NUM_LOOKUPS, &found);
+    printf("%-4s | %-24s | %-12.1f | %-12.3f | %s\n", "RBT", "DFS (прямой обход)", ns, pass_ms,
+           found == found_before && rbt_is_valid(rbt_root) ? "OK" : "ОШИБКА");
+
+    pass_ms = relayout_pass_ms(rbt_relayout, RELAYOUT_VEB);
+    ns = rbt_lookup_ns(rbt_root, queries, NUM_LOOKUPS, &found);
+    printf("%-4s | %-24s | %-12.1f | %-12.3f | %s\n", "RBT", "vEB", ns, pass_ms,
+           found == found_before && rbt_is_valid(rbt_root) ? "OK" : "ОШИБКА");
+
+    for (int i = 0; i < N / 8; i++)
+        rbt_root = rbt_insert(rbt_root, rand() % (N * 2), &rotations, &recolorings);
+    rbt_relayout->order = RELAYOUT_VEB;
+    tree_relayout_start(rbt_relayout);
+    start = clock();
+    while (!tree_relayout_step(rbt_relayout, STEP)) {
+        for (int i = 0; i < INSERTS_PER_STEP; i++)
+            rbt_root = rbt_insert(rbt_root, rand() % (N * 2), &rotations, &recolorings);
+    }
+    pass_ms = (double)(clock() - start) * 1000 / CLOCKS_PER_SEC;
+    ns = rbt_lookup_ns(rbt_root, queries, NUM_LOOKUPS, &found);
+    printf("%-4s | %-24s | %-12.1f | %-12.3f | %s\n", "RBT", "vEB по шагам + вставки", ns, pass_ms,
+           rbt_is_valid(rbt_root) ? "OK" : "ОШИБКА");
+
+    start = clock();
+    for (int i = 0; i < N / 2; i++)
+        rbt_root = rbt_delete(rbt_root, rand() % (N * 2), &rotations, &recolorings);
+    pass_ms = (double)(clock() - start) * 1000 / CLOCKS_PER_SEC;
+    ns = rbt_lookup_ns(rbt_root, queries, NUM_LOOKUPS, &found);
+    printf("%-4s | %-24s | %-12.1f | %-12.3f | %s\n", "RBT", "vEB, затем удаления", ns, pass_ms,
+           rbt_is_valid(rbt_root) ? "OK" : "ОШИБКА");
+    free_rbt_tree(rbt_root);
+    rbt_root = NULL;
+    tree_relayout_destroy(rbt_relayout);
+
+    printf("\nИнкрементальный проход: шаги по %d заданий, между шагами %d вставок (%d шагов для AVL)\n",
+           STEP, INSERTS_PER_STEP, steps);
+
+    free(queries);
+
+    printf("\nВЫВОД: форма дерева не меняется, но соседние по пути поиска узлы\n");
+    printf("       оказываются в одних кеш-линиях и страницах; удаление и\n");
+    printf("       free_avl_tree/free_rbt_tree работают с перенесенными узлами\n\n");
+}
@@ -0,0 +1,464 @@
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "methods.h"
+
+// ========== СОХРАНЕНИЕ И ЗАГРУЗКА AVL/RBT ==========
+// Формат: заголовок, затем узлы в прямом порядке (корень, левое, правое
+// поддерево) блоками по SERIAL_BLOCK узлов: сначала ключи блока, затем
+// по байту метаданных на узел:
+//   биты 0-1 - есть левый/правый сын,
+//   биты 2-7 - высота (AVL) или цвет (RBT, 1 - черный).
+// Прямой порядок с флагами однозначно задает форму дерева, поэтому
+// загрузка повторяет сохраненное дерево узел в узел за один линейный
+// проход - без сравнений ключей и поворотов. 5 байт на узел.
+
+#define SERIAL_MAGIC 0x45455254u  // "TREE"
+#define SERIAL_VERSION 1
+#define SERIAL_KIND_AVL 1
+#define SERIAL_KIND_RBT 2
+#define SERIAL_BLOCK 65536
+#define SERIAL_MAX_DEPTH 128      // выше не бывает ни у AVL, ни у RBT с int-ключами
+
+#define SERIAL_HAS_LEFT 1
+#define SERIAL_HAS_RIGHT 2
+#define SERIAL_META_SHIFT 2
+
+struct SerialHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t kind;
+    uint32_t reserved;
+    uint64_t count;
+};
+
+// Буфер блока: ключи и метаданные до SERIAL_BLOCK узлов
+struct SerialBlock {
+    int32_t keys[SERIAL_BLOCK];
+    uint8_t meta[SERIAL_BLOCK];
+    int fill;
+};
+
+static int serial_flush(FILE* file, struct SerialBlock* block) {
+    if (block->fill == 0)
+        return 0;
+    int ok = fwrite(block->keys, sizeof(int32_t), block->fill, file) == (size_t)block->fill &&
+             fwrite(block->meta, 1, block->fill, file) == (size_t)block->fill;
+    block->fill = 0;
+    return ok ? 0 : -1;
+}
+
+static FILE* serial_create(const char* path, uint32_t kind, uint64_t count) {
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) {
+        perror("tree_save: fopen");
+        return NULL;
+    }
+    struct SerialHeader header = {SERIAL_MAGIC, SERIAL_VERSION, kind, 0, count};
+    if (fwrite(&header, sizeof(header), 1, file) != 1) {
+        perror("tree_save: fwrite");
+        fclose(file);
+        return NULL;
+    }
+    return file;
+}
+
+// Дописать последний блок и дождаться записи на диск: после перезапуска
+// файл должен быть целым
+static int serial_finish(FILE* file, struct SerialBlock* block, int status) {
+    if (status == 0)
+        status = serial_flush(file, block);
+    if (status == 0 && (fflush(file) != 0 || fsync(fileno(file)) != 0))
+        status = -1;
+    if (fclose(file) != 0)
+        status = -1;
+    if (status != 0)
+        perror("tree_save");
+    return status;
+}
+
+int avl_save(struct AVLNode* root, const char* path) {
+    FILE* file = serial_create(path, SERIAL_KIND_AVL, count_avl_nodes(root));
+    if (file == NULL)
+        return -1;
+
+    struct SerialBlock* block = (struct SerialBlock*)malloc(sizeof(struct SerialBlock));
+    block->fill = 0;
+    // Прямой обход со стеком: правый сын ждет, пока обходится левое поддерево
+    struct AVLNode* stack[SERIAL_MAX_DEPTH];
+    int top = 0;
+    int status = 0;
+    if (root != NULL)
+        stack[top++] = root;
+    while (top > 0 && status == 0) {
+        struct AVLNode* node = stack[--top];
+        block->keys[block->fill] = node->key;
+        block->meta[block->fill] = (node->left != NULL ? SERIAL_HAS_LEFT : 0) |
+                                   (node->right != NULL ? SERIAL_HAS_RIGHT : 0) |
+                                   (node->height << SERIAL_META_SHIFT);
+        if (++block->fill == SERIAL_BLOCK)
+            status = serial_flush(file, block);
+        if (node->right != NULL)
+            stack[top++] = node->right;
+        if (node->left != NULL)
+            stack[top++] = node->left;
+    }
+
+    status = serial_finish(file, block, status);
+    free(block);
+    return status;
+}
+
+int rbt_save(struct RBNode* root, const char* path) {
+    FILE* file = serial_create(path, SERIAL_KIND_RBT, count_rbt_nodes(root));
+    if (file == NULL)
+        return -1;
+
+    struct SerialBlock* block = (struct SerialBlock*)malloc(sizeof(struct SerialBlock));
+    block->fill = 0;
+    struct RBNode* stack[SERIAL_MAX_DEPTH];
+    int top = 0;
+    int status = 0;
+    if (root != NULL)
+        stack[top++] = root;
+    while (top > 0 && status == 0) {
+        struct RBNode* node = stack[--top];
+        block->keys[block->fill] = node->key;
+        block->meta[block->fill] = (node->left != NULL ? SERIAL_HAS_LEFT : 0) |
+                                   (node->right != NULL ? SERIAL_HAS_RIGHT : 0) |
+                                   ((node->color == BLACK) << SERIAL_META_SHIFT);
+        if (++block->fill == SERIAL_BLOCK)
+            status = serial_flush(file, block);
+        if (node->right != NULL)
+            stack[top++] = node->right;
+        if (node->left != NULL)
+            stack[top++] = node->left;
+    }
+
+    status = serial_finish(file, block, status);
+    free(block);
+    return status;
+}
+
+// Читает заголовок; возвращает файл, готовый к чтению узлов, или NULL
+static FILE* serial_open(const char* path, uint32_t kind, uint64_t* count) {
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        perror("tree_load: fopen");
+        return NULL;
+    }
+    struct SerialHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || header.magic != SERIAL_MAGIC ||
+        header.version != SERIAL_VERSION || header.kind != kind || header.count > INT32_MAX) {
+        fprintf(stderr, "tree_load: %s - не файл дерева нужного типа\n", path);
+        fclose(file);
+        return NULL;
+    }
+    *count = header.count;
+    return file;
+}
+
+static int serial_read_block(FILE* file, struct SerialBlock* block, uint64_t remaining) {
+    int n = remaining < SERIAL_BLOCK ? (int)remaining : SERIAL_BLOCK;
+    if (fread(block->keys, sizeof(int32_t), n, file) != (size_t)n ||
+        fread(block->meta, 1, n, file) != (size_t)n)
+        return -1;
+    block->fill = n;
+    return 0;
+}
+
+#ifdef TREE_ORDER_STATISTICS
+// Размеры поддеревьев в файле не хранятся - восстанавливаются обратным обходом
+static int avl_restore_sizes(struct AVLNode* node) {
+    if (node == NULL)
+        return 0;
+    node->size = 1 + avl_restore_sizes(node->left) + avl_restore_sizes(node->right);
+    return node->size;
+}
+
+static int rbt_restore_sizes(struct RBNode* node) {
+    if (node == NULL)
+        return 0;
+    node->size = 1 + rbt_restore_sizes(node->left) + rbt_restore_sizes(node->right);
+    return node->size;
+}
+#endif
+
+int avl_load(const char* path, struct AVLNode** root) {
+    *root = NULL;
+    uint64_t count;
+    FILE* file = serial_open(path, SERIAL_KIND_AVL, &count);
+    if (file == NULL)
+        return -1;
+
+    struct SerialBlock* block = (struct SerialBlock*)malloc(sizeof(struct SerialBlock));
+    // Стек незаполненных ссылок на сыновей: очередной узел прямого
+    // порядка всегда занимает верхнюю
+    struct AVLNode** slots[SERIAL_MAX_DEPTH];
+    int top = 0;
+    int status = 0;
+    if (count > 0)
+        slots[top++] = root;
+
+    for (uint64_t done = 0; done < count && status == 0; ) {
+        if (serial_read_block(file, block, count - done) != 0) {
+            status = -1;
+            break;
+        }
+        for (int i = 0; i < block->fill; i++) {
+            if (top == 0) {
+                status = -1;
+                break;
+            }
+            uint8_t meta = block->meta[i];
+            struct AVLNode* node = (struct AVLNode*)tree_node_alloc(sizeof(struct AVLNode));
+            node->key = block->keys[i];
+            node->height = meta >> SERIAL_META_SHIFT;
+            node->left = NULL;
+            node->right = NULL;
+            *slots[--top] = node;
+            if (top + 2 > SERIAL_MAX_DEPTH) {
+                status = -1;
+                break;
+            }
+            if (meta & SERIAL_HAS_RIGHT)
+                slots[top++] = &node->right;
+            if (meta & SERIAL_HAS_LEFT)
+                slots[top++] = &node->left;
+        }
+        done += block->fill;
+    }
+    if (top != 0)
+        status = -1;
+
+    free(block);
+    fclose(file);
+    if (status != 0) {
+        fprintf(stderr, "tree_load: %s поврежден\n", path);
+        free_avl_tree(*root);
+        *root = NULL;
+        return -1;
+    }
+#ifdef TREE_ORDER_STATISTICS
+    avl_restore_sizes(*root);
+#endif
+    return (int)count;
+}
+
+int rbt_load(const char* path, struct RBNode** root) {
+    *root = NULL;
+    uint64_t count;
+    FILE* file = serial_open(path, SERIAL_KIND_RBT, &count);
+    if (file == NULL)
+        return -1;
+
+    struct SerialBlock* block = (struct SerialBlock*)malloc(sizeof(struct SerialBlock));
+    // Вместе со ссылкой храним родителя будущего узла
+    struct RBNode** slots[SERIAL_MAX_DEPTH];
+    struct RBNode* parents[SERIAL_MAX_DEPTH];
+    int top = 0;
+    int status = 0;
+    if (count > 0) {
+        slots[top] = root;
+        parents[top++] = NULL;
+    }
+
+    for (uint64_t done = 0; done < count && status == 0; ) {
+        if (serial_read_block(file, block, count - done) != 0) {
+            status = -1;
+            break;
+        }
+        for (int i = 0; i < block->fill; i++) {
+            if (top == 0) {
+                status = -1;
+                break;
+            }
+            uint8_t meta = block->meta[i];
+            struct RBNode* node = (struct RBNode*)tree_node_alloc(sizeof(struct RBNode));
+            node->key = block->keys[i];
+            node->color = (meta >> SERIAL_META_SHIFT) & 1 ? BLACK : RED;
+            node->left = NULL;
+            node->right = NULL;
+            top--;
+            node->parent = parents[top];
+            *slots[top] = node;
+            if (top + 2 > SERIAL_MAX_DEPTH) {
+                status = -1;
+                break;
+            }
+            if (meta & SERIAL_HAS_RIGHT) {
+                slots[top] = &node->right;
+                parents[top++] = node;
+            }
+            if (meta & SERIAL_HAS_LEFT) {
+                slots[top] = &node->left;
+                parents[top++] = node;
+            }
+        }
+        done += block->fill;
+    }
+    if (top != 0)
+        status = -1;
+
+    free(block);
+    fclose(file);
+    if (status != 0) {
+        fprintf(stderr, "tree_load: %s поврежден\n", path);
+        free_rbt_tree(*root);
+        *root = NULL;
+        return -1;
+    }
+#ifdef TREE_ORDER_STATISTICS
+    rbt_restore_sizes(*root);
+#endif
+    return (int)count;
+}
+
+// ==================== ТЕСТ 24: ХОЛОДНЫЙ СТАРТ ИЗ ФАЙЛА ====================
+
+// Выбросить файл из страничного кеша, чтобы загрузка читала диск
+static void serial_drop_cache(const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd >= 0) {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+}
+
+static long long serial_file_bytes(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (file == NULL)
+        return -1;
+    fseek(file, 0, SEEK_END);
+    long long bytes = ftell(file);
+    fclose(file);
+    return bytes;
+}
+
+void test_tree_serialize() {
+    printf("=== ТЕСТ 24: Холодный старт - загрузка AVL/RBT из файла против повторной вставки ===\n\n");
+
+    const int SIZES[] = {1000000, 10000000, 100000000};
+    const int NUM_SIZES = sizeof(SIZES) / sizeof(SIZES[0]);
+    const int QUERIES = 1000000;
+    // Узел в malloc с заголовком; ключи и запросы - отдельно
+    const double BYTES_PER_KEY = sizeof(struct RBNode) + 16 + 2 * sizeof(int);
+
+    long long phys_bytes = (long long)sysconf(_SC_PHYS_PAGES) * sysconf(_SC_PAGESIZE);
+    const char* dir = getenv("TMPDIR");
+    if (dir == NULL || dir[0] == '\0')
+        dir = "/tmp";
+    char path[256];
+    snprintf(path, sizeof(path), "%s/tree_serialize_%d.bin", dir, (int)getpid());
+
+    srand(time(NULL));
+
+    printf("Загрузка: файл вытеснен из страничного кеша, время - настенное, до готового дерева\n");
+    printf("Повторная вставка: те же ключи в исходном (случайном) порядке\n\n");
+    printf("Ключей     | Дерево | Файл МБ | Сохр. мс | Загрузка мс | Вставка мс | Ускорение | Проверка\n");
+    printf("-----------|--------|---------|----------|-------------|------------|-----------|---------\n");
+
+    int all_ok = 1;
+    double best_speedup = 0;
+    double worst_speedup = 1e9;
+    for (int s = 0; s < NUM_SIZES; s++) {
+        int n = SIZES[s];
+        if (n * BYTES_PER_KEY > phys_bytes / 2) {
+            printf("%10d | пропущено: нужно ~%.1f ГБ - больше половины ОЗУ (%.1f ГБ)\n", n,
+                   n * BYTES_PER_KEY / 1e9, phys_bytes / 1e9);
+            continue;
+        }
+
+        int* keys = (int*)malloc((size_t)n * sizeof(int));
+        for (int i = 0; i < n; i++)
+            keys[i] = (int)(((long long)rand() * RAND_MAX + rand()) % ((long long)n * 4));
+        int* queries = (int*)malloc(QUERIES * sizeof(int));
+        for (int i = 0; i < QUERIES; i++)
+            queries[i] = (int)(((long long)rand() * RAND_MAX + rand()) % ((long long)n * 4));
+
+        for (int t = 0; t < 2; t++) {
+            int rotations = 0;
+            int recolorings = 0;
+            struct AVLNode* avl_root = NULL;
+            struct RBNode* rbt_root = NULL;
+
+            double start = wall_time_ms();
+            for (int i = 0; i < n; i++) {
+                if (t == 0)
+                    avl_root = avl_insert(avl_root, keys[i], &rotations);
+                else
+                    rbt_root = rbt_insert(rbt_root, keys[i], &rotations, &recolorings);
+            }
+            double insert_ms = wall_time_ms() - start;
+
+            long long expected = 0;
+            for (int i = 0; i < QUERIES; i++)
+                expected += t == 0 ? avl_search(avl_root, queries[i]) != NULL
+                                   : rbt_search(rbt_root, queries[i]) != NULL;
+            int expected_height = t == 0 ? avl_height(avl_root) : 0;
+
+            start = wall_time_ms();
+            int saved = t == 0 ? avl_save(avl_root, path) : rbt_save(rbt_root, path);
+            double save_ms = wall_time_ms() - start;
+            long long file_bytes = serial_file_bytes(path);
+            int expected_count = t == 0 ? count_avl_nodes(avl_root) : count_rbt_nodes(rbt_root);
+            if (t == 0)
+                free_avl_tree(avl_root);
+            else
+                free_rbt_tree(rbt_root);
+            avl_root = NULL;
+            rbt_root = NULL;
+
+            serial_drop_cache(path);
+            start = wall_time_ms();
+            int loaded = t == 0 ? avl_load(path, &avl_root) : rbt_load(path, &rbt_root);
+            double load_ms = wall_time_ms() - start;
+
+            long long found = 0;
+            for (int i = 0; i < QUERIES; i++)
+                found += t == 0 ? avl_search(avl_root, queries[i]) != NULL
+                                : rbt_search(rbt_root, queries[i]) != NULL;
+            int ok = saved == 0 && loaded == expected_count && found == expected;
+            if (t == 0)
+                ok &= avl_is_valid(avl_root) && avl_height(avl_root) == expected_height;
+            else
+                ok &= rbt_is_valid(rbt_root);
+            all_ok &= ok;
+
+            double speedup = insert_ms / load_ms;
+            if (speedup > best_speedup)
+                best_speedup = speedup;
+            if (speedup < worst_speedup)
+                worst_speedup = speedup;
+
+            printf("%10d | %-6s | %7.1f | %8.1f | %11.1f | %10.1f | %8.1fx | %s\n",
+                   n, t == 0 ? "AVL" : "RBT", file_bytes / (1024.0 * 1024.0), save_ms,
+                   load_ms, insert_ms, speedup, ok ? "ok" : "ОШИБКА");
+
+            if (t == 0)
+                free_avl_tree(avl_root);
+            else
+                free_rbt_tree(rbt_root);
+            unlink(path);
+        }
+        free(keys);
+        free(queries);
+    }
+
+    printf("\nПроверка (число узлов, высота, инварианты, результаты поиска): %s\n\n",
+           all_ok ? "ok" : "ОШИБКА");
+
+    printf("ВЫВОД:\n");
+    printf("• Загрузка из файла быстрее повторной вставки в %.1f-%.1f раз: узлы создаются\n",
+           worst_speedup, best_speedup);
+    printf("  подряд в прямом порядке, без сравнений ключей, поворотов и перекрашиваний\n");
+    printf("• Файл - 5 байт на узел (ключ + байт с формой и высотой/цветом); размеры\n");
+    printf("  поддеревьев для rank/select восстанавливаются одним обратным обходом\n");
+    printf("• Загруженное дерево совпадает с сохраненным узел в узел, поэтому поиск\n");
+    printf("  после перезапуска работает так же, как до него\n\n");
+}
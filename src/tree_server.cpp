@@ -0,0 +1,1036 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "methods.h"
+
+// ========== СЕРВЕР ДЕРЕВА НА UNIX-СОКЕТЕ ==========
+// За границей сервиса каждый запрос платит системным вызовом, пробуждением
+// потока и копированием - это дороже самого поиска в дереве. Сервер читает
+// из сокетов все, что накопилось, собирает пакет до max_batch запросов от
+// всех клиентов и применяет его к дереву одним проходом: идущие подряд
+// поиски выполняются пакетным поиском с предвыборкой (avl_search_batch),
+// изменения - по порядку. Ответы копятся в буфере клиента и уходят одним
+// send на пакет; клиент не ждет ответа перед следующим запросом (конвейер).
+//
+// Один поток и epoll: дерево не нужно защищать блокировками, а при
+// нагрузке пакеты растут сами - чем дольше обрабатывался предыдущий,
+// тем больше запросов успевает прийти.
+
+#define TREE_SERVER_IN_BUFFER (64 * 1024)
+#define TREE_SERVER_OUT_LIMIT (1 << 20) // больше неотправленного - клиента не читаем
+#define TREE_SERVER_SEARCH_GROUP 16
+
+struct TreeConnection {
+    int fd;
+    unsigned events; // текущая подписка epoll
+    int closed;      // клиент отключился: закрыть до сбора пакета
+    int read_closed; // клиент закрыл запись: ответить на принятое и закрыть
+    char* in;
+    int in_len;
+    char* out;
+    size_t out_len;
+    size_t out_sent;
+    size_t out_cap;
+};
+
+struct TreeBatchItem {
+    struct TreeConnection* conn;
+    struct TreeRequest request;
+};
+
+struct TreeServer {
+    int listen_fd;
+    int epoll_fd;
+    char path[sizeof(((struct sockaddr_un*)0)->sun_path)];
+    int is_rbt;
+    int max_batch;
+    struct AVLNode* avl;
+    struct RBNode* rbt;
+    struct TreeConnection** conns;
+    int conn_count;
+    int conn_capacity;
+    int next_conn; // с кого начинать сбор пакета - по кругу, чтобы никто не голодал
+    struct TreeBatchItem* batch;
+    int* search_keys;
+    struct AVLNode** avl_found;
+    struct RBNode** rbt_found;
+    int range_buffer[TREE_SERVER_MAX_RANGE];
+    std::atomic<bool> stop;
+    std::atomic<long long> batches;
+    std::atomic<long long> requests;
+};
+
+static int server_set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags < 0 ? -1 : fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+static int server_make_address(const char* path, struct sockaddr_un* addr) {
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr->sun_path)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    strcpy(addr->sun_path, path);
+    return 0;
+}
+
+struct TreeServer* tree_server_create(const char* path, int is_rbt, int max_batch) {
+    struct sockaddr_un addr;
+    if (server_make_address(path, &addr) != 0)
+        return NULL;
+    // Удаляем только оставшийся от прошлого запуска сокет, не чужой файл
+    struct stat st;
+    if (lstat(path, &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            errno = EEXIST;
+            return NULL;
+        }
+        unlink(path);
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        return NULL;
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return NULL;
+    }
+    // Файл сокета уже создан bind - при ошибке дальше его нужно удалить
+    if (listen(fd, 128) != 0 || server_set_nonblocking(fd) != 0) {
+        int saved = errno;
+        close(fd);
+        unlink(path);
+        errno = saved;
+        return NULL;
+    }
+    int epoll_fd = epoll_create1(0);
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.ptr = NULL; // NULL - слушающий сокет
+    if (epoll_fd < 0 || epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+        int saved = errno;
+        close(fd);
+        if (epoll_fd >= 0)
+            close(epoll_fd);
+        unlink(path);
+        errno = saved;
+        return NULL;
+    }
+
+    if (max_batch < 1)
+        max_batch = 1;
+    struct TreeServer* server = (struct TreeServer*)calloc(1, sizeof(struct TreeServer));
+    server->listen_fd = fd;
+    server->epoll_fd = epoll_fd;
+    strcpy(server->path, path);
+    server->is_rbt = is_rbt;
+    server->max_batch = max_batch;
+    server->batch = (struct TreeBatchItem*)malloc(max_batch * sizeof(struct TreeBatchItem));
+    server->search_keys = (int*)malloc(max_batch * sizeof(int));
+    server->avl_found = (struct AVLNode**)malloc(max_batch * sizeof(struct AVLNode*));
+    server->rbt_found = (struct RBNode**)malloc(max_batch * sizeof(struct RBNode*));
+    server->stop = false;
+    server->batches = 0;
+    server->requests = 0;
+    return server;
+}
+
+static void server_close_connection(struct TreeServer* server, int at) {
+    struct TreeConnection* conn = server->conns[at];
+    close(conn->fd); // закрытие само снимает fd с epoll
+    free(conn->in);
+    free(conn->out);
+    free(conn);
+    server->conns[at] = server->conns[--server->conn_count];
+}
+
+static void server_accept(struct TreeServer* server) {
+    for (;;) {
+        int fd = accept(server->listen_fd, NULL, NULL);
+        if (fd < 0)
+            return; // EAGAIN - очередь подключений пуста
+        server_set_nonblocking(fd);
+        struct TreeConnection* conn = (struct TreeConnection*)calloc(1, sizeof(struct TreeConnection));
+        conn->fd = fd;
+        conn->in = (char*)malloc(TREE_SERVER_IN_BUFFER);
+        conn->out_cap = 4096;
+        conn->out = (char*)malloc(conn->out_cap);
+        conn->events = EPOLLIN;
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.ptr = conn;
+        if (epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            close(fd);
+            free(conn->in);
+            free(conn->out);
+            free(conn);
+            continue;
+        }
+        if (server->conn_count == server->conn_capacity) {
+            server->conn_capacity = server->conn_capacity ? server->conn_capacity * 2 : 16;
+            server->conns = (struct TreeConnection**)realloc(
+                server->conns, server->conn_capacity * sizeof(struct TreeConnection*));
+        }
+        server->conns[server->conn_count++] = conn;
+    }
+}
+
+static void server_reply(struct TreeConnection* conn, const void* data, size_t bytes) {
+    if (conn->out_len + bytes > conn->out_cap) {
+        while (conn->out_len + bytes > conn->out_cap)
+            conn->out_cap *= 2;
+        conn->out = (char*)realloc(conn->out, conn->out_cap);
+    }
+    memcpy(conn->out + conn->out_len, data, bytes);
+    conn->out_len += bytes;
+}
+
+static void server_reply_int(struct TreeConnection* conn, int value) {
+    server_reply(conn, &value, sizeof(value));
+}
+
+static int server_avl_collect(struct AVLNode* node, int lo, int hi, int* out, int found) {
+    if (node == NULL || found >= TREE_SERVER_MAX_RANGE)
+        return found;
+    if (node->key > lo)
+        found = server_avl_collect(node->left, lo, hi, out, found);
+    if (node->key >= lo && node->key <= hi && found < TREE_SERVER_MAX_RANGE)
+        out[found++] = node->key;
+    if (node->key < hi)
+        found = server_avl_collect(node->right, lo, hi, out, found);
+    return found;
+}
+
+static int server_rbt_collect(struct RBNode* node, int lo, int hi, int* out, int found) {
+    if (node == NULL || found >= TREE_SERVER_MAX_RANGE)
+        return found;
+    if (node->key > lo)
+        found = server_rbt_collect(node->left, lo, hi, out, found);
+    if (node->key >= lo && node->key <= hi && found < TREE_SERVER_MAX_RANGE)
+        out[found++] = node->key;
+    if (node->key < hi)
+        found = server_rbt_collect(node->right, lo, hi, out, found);
+    return found;
+}
+
+// Изменение или диапазон: по одному, в порядке пакета
+static void server_apply_one(struct TreeServer* server, struct TreeConnection* conn,
+                             const struct TreeRequest* request) {
+    int rotations = 0;
+    int recolorings = 0;
+    int key = request->key;
+    int present = server->is_rbt ? rbt_search(server->rbt, key) != NULL
+                                 : avl_search(server->avl, key) != NULL;
+    switch (request->op) {
+    case TREE_OP_INSERT:
+        if (!present) {
+            if (server->is_rbt)
+                server->rbt = rbt_insert(server->rbt, key, &rotations, &recolorings);
+            else
+                server->avl = avl_insert(server->avl, key, &rotations);
+        }
+        server_reply_int(conn, !present);
+        break;
+    case TREE_OP_DELETE:
+        if (present) {
+            if (server->is_rbt)
+                server->rbt = rbt_delete(server->rbt, key, &rotations, &recolorings);
+            else
+                server->avl = avl_delete(server->avl, key, &rotations);
+        }
+        server_reply_int(conn, present);
+        break;
+    case TREE_OP_RANGE: {
+        int found = 0;
+        if (key <= request->hi)
+            found = server->is_rbt
+                        ? server_rbt_collect(server->rbt, key, request->hi, server->range_buffer, 0)
+                        : server_avl_collect(server->avl, key, request->hi, server->range_buffer, 0);
+        server_reply_int(conn, found);
+        server_reply(conn, server->range_buffer, found * sizeof(int));
+        break;
+    }
+    default:
+        server_reply_int(conn, -1); // неизвестная операция
+        break;
+    }
+}
+
+// Один проход по пакету: серии поисков - пакетным поиском, остальное по порядку.
+// Ответы пишутся в порядке запросов, поэтому у каждого клиента порядок сохраняется
+static void server_apply_batch(struct TreeServer* server, int count) {
+    int i = 0;
+    while (i < count) {
+        int run = 0;
+        while (i + run < count && server->batch[i + run].request.op == TREE_OP_SEARCH) {
+            server->search_keys[run] = server->batch[i + run].request.key;
+            run++;
+        }
+        if (run == 0) {
+            server_apply_one(server, server->batch[i].conn, &server->batch[i].request);
+            i++;
+            continue;
+        }
+        if (server->is_rbt)
+            rbt_search_batch(server->rbt, server->search_keys, run, server->rbt_found,
+                             TREE_SERVER_SEARCH_GROUP);
+        else
+            avl_search_batch(server->avl, server->search_keys, run, server->avl_found,
+                             TREE_SERVER_SEARCH_GROUP);
+        for (int j = 0; j < run; j++) {
+            int found = server->is_rbt ? server->rbt_found[j] != NULL : server->avl_found[j] != NULL;
+            server_reply_int(server->batch[i + j].conn, found);
+        }
+        i += run;
+    }
+}
+
+// Забирает готовые запросы из входных буферов, начиная с next_conn; 1 - остались еще
+static int server_collect_batch(struct TreeServer* server, int* count) {
+    int n = 0;
+    int leftover = 0;
+    for (int k = 0; k < server->conn_count; k++) {
+        int at = (server->next_conn + k) % server->conn_count;
+        struct TreeConnection* conn = server->conns[at];
+        int pos = 0;
+        while (conn->in_len - pos >= (int)sizeof(struct TreeRequest)) {
+            if (n == server->max_batch) {
+                leftover = 1;
+                break;
+            }
+            server->batch[n].conn = conn;
+            memcpy(&server->batch[n].request, conn->in + pos, sizeof(struct TreeRequest));
+            pos += sizeof(struct TreeRequest);
+            n++;
+        }
+        // Указатель на conn в пакете остается, байты запросов уже скопированы
+        memmove(conn->in, conn->in + pos, conn->in_len - pos);
+        conn->in_len -= pos;
+        if (leftover) {
+            server->next_conn = at;
+            break;
+        }
+    }
+    if (!leftover && server->conn_count > 0)
+        server->next_conn = (server->next_conn + 1) % server->conn_count;
+    *count = n;
+    return leftover;
+}
+
+static void server_update_events(struct TreeServer* server, struct TreeConnection* conn) {
+    size_t pending = conn->out_len - conn->out_sent;
+    unsigned events = 0;
+    if (!conn->read_closed && pending < TREE_SERVER_OUT_LIMIT && conn->in_len < TREE_SERVER_IN_BUFFER)
+        events |= EPOLLIN;
+    if (pending > 0)
+        events |= EPOLLOUT;
+    if (events == conn->events)
+        return;
+    struct epoll_event event;
+    event.events = events;
+    event.data.ptr = conn;
+    epoll_ctl(server->epoll_fd, EPOLL_CTL_MOD, conn->fd, &event);
+    conn->events = events;
+}
+
+// 0 - ок, -1 - клиент отключился
+static int server_flush(struct TreeConnection* conn) {
+    while (conn->out_sent < conn->out_len) {
+        ssize_t sent = send(conn->fd, conn->out + conn->out_sent, conn->out_len - conn->out_sent,
+                            MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (sent < 0)
+            return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1;
+        conn->out_sent += sent;
+    }
+    conn->out_len = 0;
+    conn->out_sent = 0;
+    return 0;
+}
+
+void tree_server_run(struct TreeServer* server) {
+    struct epoll_event events[64];
+    int leftover = 0;
+    while (!server->stop.load(std::memory_order_relaxed)) {
+        // Таймаут - чтобы заметить stop; остаток пакета - обработать без ожидания
+        int ready = epoll_wait(server->epoll_fd, events, 64, leftover ? 0 : 50);
+        if (ready < 0 && errno != EINTR)
+            break;
+        for (int e = 0; e < ready; e++) {
+            struct TreeConnection* conn = (struct TreeConnection*)events[e].data.ptr;
+            if (conn == NULL) {
+                server_accept(server);
+                continue;
+            }
+            if (events[e].events & EPOLLIN) {
+                if (conn->read_closed || conn->in_len == TREE_SERVER_IN_BUFFER)
+                    continue;
+                ssize_t got = recv(conn->fd, conn->in + conn->in_len,
+                                   TREE_SERVER_IN_BUFFER - conn->in_len, MSG_DONTWAIT);
+                if (got > 0)
+                    conn->in_len += got;
+                else if (got == 0)
+                    conn->read_closed = 1; // принятые запросы еще обработаем
+                else if (errno != EAGAIN && errno != EWOULDBLOCK)
+                    conn->closed = 1;
+            } else if (events[e].events & (EPOLLHUP | EPOLLERR)) {
+                conn->closed = 1;
+            }
+        }
+        // Отключившихся закрываем до сбора пакета - на них не останется ссылок
+        for (int at = server->conn_count - 1; at >= 0; at--)
+            if (server->conns[at]->closed)
+                server_close_connection(server, at);
+
+        int count = 0;
+        leftover = server_collect_batch(server, &count);
+        if (count > 0) {
+            server_apply_batch(server, count);
+            server->batches.fetch_add(1, std::memory_order_relaxed);
+            server->requests.fetch_add(count, std::memory_order_relaxed);
+        }
+        for (int at = server->conn_count - 1; at >= 0; at--) {
+            struct TreeConnection* conn = server->conns[at];
+            if (server_flush(conn) != 0) {
+                server_close_connection(server, at);
+                continue;
+            }
+            // Закрывший запись клиент: все полные запросы отвечены и отправлены
+            if (conn->read_closed && conn->in_len < (int)sizeof(struct TreeRequest) &&
+                conn->out_len == 0) {
+                server_close_connection(server, at);
+                continue;
+            }
+            server_update_events(server, conn);
+        }
+    }
+}
+
+void tree_server_stop(struct TreeServer* server) {
+    server->stop.store(true, std::memory_order_relaxed);
+}
+
+void tree_server_stats(struct TreeServer* server, long long* batches, long long* requests) {
+    *batches = server->batches.load(std::memory_order_relaxed);
+    *requests = server->requests.load(std::memory_order_relaxed);
+}
+
+void tree_server_free(struct TreeServer* server) {
+    while (server->conn_count > 0)
+        server_close_connection(server, server->conn_count - 1);
+    close(server->listen_fd);
+    close(server->epoll_fd);
+    unlink(server->path);
+    free_avl_tree(server->avl);
+    free_rbt_tree(server->rbt);
+    free(server->conns);
+    free(server->batch);
+    free(server->search_keys);
+    free(server->avl_found);
+    free(server->rbt_found);
+    free(server);
+}
+
+// ========== ГЕНЕРАТОР НАГРУЗКИ ==========
+// Замкнутый цикл: клиент шлет пакет из batch запросов и ждет все ответы -
+// так меряется предельная пропускная способность, но клиент сам замедляется
+// вместе с сервером. Открытый цикл: запросы уходят по расписанию (пуассоновский
+// поток с заданной частотой) независимо от ответов, задержка считается от
+// момента по расписанию - иначе очередь перед сервером не попала бы в замер.
+//
+// Смесь запросов: 80% поиск, 10% вставка, 5% удаление, 5% диапазон.
+
+#define LOAD_RANGE_WIDTH 64
+#define LOAD_IN_BUFFER (64 * 1024)
+
+// Клиенты подключаются и готовят запросы до общего старта
+struct LoadStart {
+    std::atomic<int> ready;
+    std::atomic<bool> go;
+    double start_ms; // от него идет расписание открытого цикла
+};
+
+struct LoadClient {
+    const struct LoadConfig* config;
+    struct LoadStart* start;
+    unsigned seed;
+    double* latency_us;
+    long long done;
+    double end_ms;
+    int error;
+};
+
+static unsigned load_next(unsigned* state) {
+    unsigned x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static int load_connect(const char* path) {
+    struct sockaddr_un addr;
+    if (server_make_address(path, &addr) != 0)
+        return -1;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void load_wait_start(struct LoadStart* start) {
+    start->ready.fetch_add(1);
+    while (!start->go.load(std::memory_order_acquire))
+        std::this_thread::yield();
+}
+
+static void load_client_main(struct LoadClient* client) {
+    const struct LoadConfig* config = client->config;
+    int total = config->ops_per_client;
+    unsigned rng = client->seed;
+    int fd = load_connect(config->path);
+    if (fd < 0) {
+        client->error = 1;
+        load_wait_start(client->start);
+        return;
+    }
+
+    struct TreeRequest* requests = (struct TreeRequest*)malloc(total * sizeof(struct TreeRequest));
+    double* sched = (double*)malloc(total * sizeof(double));
+    for (int i = 0; i < total; i++) {
+        unsigned r = load_next(&rng) % 100;
+        requests[i].key = (int)(load_next(&rng) % (unsigned)config->key_range);
+        requests[i].hi = requests[i].key;
+        if (r < 80) {
+            requests[i].op = TREE_OP_SEARCH;
+        } else if (r < 90) {
+            requests[i].op = TREE_OP_INSERT;
+        } else if (r < 95) {
+            requests[i].op = TREE_OP_DELETE;
+        } else {
+            requests[i].op = TREE_OP_RANGE;
+            requests[i].hi = requests[i].key + LOAD_RANGE_WIDTH;
+        }
+    }
+    // Открытый цикл: экспоненциальные интервалы со средним 1 / частота клиента,
+    // пока - от нуля; к общему старту расписание сдвигается после него
+    double per_client_rate = config->rate / config->clients;
+    double t = 0;
+    for (int i = 0; config->open_loop && i < total; i++) {
+        double u = (load_next(&rng) + 1.0) / 4294967297.0;
+        t += -log(u) * 1000.0 / per_client_rate;
+        sched[i] = t;
+    }
+
+    load_wait_start(client->start);
+    for (int i = 0; config->open_loop && i < total; i++)
+        sched[i] += client->start->start_ms;
+
+    char* in = (char*)malloc(LOAD_IN_BUFFER);
+    int in_len = 0;
+    int sent_requests = 0; // поставлено в отправку
+    size_t send_pos = 0;
+    size_t send_end = 0;
+    int received = 0;
+    while (received < total) {
+        double now = wall_time_ms();
+        if (send_pos == send_end) {
+            int first = sent_requests;
+            if (!config->open_loop) {
+                // Замкнутый цикл: следующий пакет - когда пришли все ответы
+                if (received == sent_requests) {
+                    int n = total - sent_requests < config->batch ? total - sent_requests : config->batch;
+                    for (int i = 0; i < n; i++)
+                        sched[sent_requests + i] = now;
+                    sent_requests += n;
+                }
+            } else {
+                while (sent_requests < total && sched[sent_requests] <= now &&
+                       sent_requests - first < config->batch)
+                    sent_requests++;
+            }
+            send_pos = first * sizeof(struct TreeRequest);
+            send_end = sent_requests * sizeof(struct TreeRequest);
+        }
+        if (send_pos < send_end) {
+            ssize_t sent = send(fd, (char*)requests + send_pos, send_end - send_pos,
+                                MSG_NOSIGNAL | MSG_DONTWAIT);
+            if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+                client->error = 1;
+                break;
+            }
+            if (sent > 0)
+                send_pos += sent;
+        }
+
+        // Ждать ответа, возможности отправить или следующего запроса по расписанию
+        struct pollfd pfd;
+        pfd.fd = fd;
+        pfd.events = POLLIN | (send_pos < send_end ? POLLOUT : 0);
+        struct timespec timeout;
+        struct timespec* timeout_ptr = NULL;
+        if (config->open_loop && send_pos == send_end && sent_requests < total) {
+            double wait_ms = sched[sent_requests] - wall_time_ms();
+            if (wait_ms < 0)
+                wait_ms = 0;
+            timeout.tv_sec = (time_t)(wait_ms / 1000);
+            timeout.tv_nsec = (long)((wait_ms - timeout.tv_sec * 1000.0) * 1e6);
+            timeout_ptr = &timeout;
+        }
+        if (received == sent_requests && send_pos == send_end && timeout_ptr == NULL)
+            continue; // замкнутый цикл: ответы получены, сразу следующий пакет
+        if (ppoll(&pfd, 1, timeout_ptr, NULL) < 0 && errno != EINTR) {
+            client->error = 1;
+            break;
+        }
+        if (!(pfd.revents & (POLLIN | POLLHUP | POLLERR)))
+            continue;
+
+        ssize_t got = recv(fd, in + in_len, LOAD_IN_BUFFER - in_len, MSG_DONTWAIT);
+        if (got == 0 || (got < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+            client->error = 1;
+            break;
+        }
+        if (got < 0)
+            continue;
+        in_len += got;
+        double arrived = wall_time_ms();
+        int pos = 0;
+        while (received < sent_requests && in_len - pos >= (int)sizeof(int)) {
+            int status;
+            memcpy(&status, in + pos, sizeof(int));
+            int bytes = sizeof(int);
+            if (requests[received].op == TREE_OP_RANGE)
+                bytes += (status > 0 ? status : 0) * sizeof(int);
+            if (status < 0 || status > TREE_SERVER_MAX_RANGE) {
+                client->error = 1;
+                break;
+            }
+            if (in_len - pos < bytes)
+                break;
+            pos += bytes;
+            client->latency_us[received] = (arrived - sched[received]) * 1000.0;
+            received++;
+        }
+        if (client->error)
+            break;
+        memmove(in, in + pos, in_len - pos);
+        in_len -= pos;
+    }
+    client->done = received;
+    client->end_ms = wall_time_ms();
+    close(fd);
+    free(in);
+    free(requests);
+    free(sched);
+}
+
+static int compare_doubles(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double load_percentile(const double* sorted, long long count, double p) {
+    if (count == 0)
+        return 0;
+    long long at = (long long)(p * (count - 1) + 0.5);
+    return sorted[at];
+}
+
+int load_run(const struct LoadConfig* config, struct LoadResult* result) {
+    memset(result, 0, sizeof(*result));
+    int clients = config->clients;
+    long long total = (long long)clients * config->ops_per_client;
+    double* latency = (double*)malloc((total > 0 ? total : 1) * sizeof(double));
+    std::vector<struct LoadClient> state(clients);
+    std::vector<std::thread> workers;
+    struct LoadStart start;
+    start.ready = 0;
+    start.go = false;
+    start.start_ms = 0;
+    for (int i = 0; i < clients; i++) {
+        struct LoadClient* client = &state[i];
+        memset(client, 0, sizeof(*client));
+        client->config = config;
+        client->start = &start;
+        client->seed = 2463534242u + 7919u * (unsigned)i;
+        client->latency_us = latency + (long long)i * config->ops_per_client;
+        workers.push_back(std::thread(load_client_main, client));
+    }
+    while (start.ready.load() < clients)
+        std::this_thread::yield();
+    start.start_ms = wall_time_ms();
+    start.go.store(true, std::memory_order_release);
+    for (int i = 0; i < clients; i++)
+        workers[i].join();
+    double start_ms = start.start_ms;
+
+    double end_ms = start_ms;
+    long long done = 0;
+    int errors = 0;
+    for (int i = 0; i < clients; i++) {
+        if (state[i].end_ms > end_ms)
+            end_ms = state[i].end_ms;
+        // Ответы ушедшего с ошибкой клиента в проценти не попадают
+        if (state[i].error)
+            errors++;
+        else
+            memmove(latency + done, state[i].latency_us, state[i].done * sizeof(double));
+        done += state[i].error ? 0 : state[i].done;
+    }
+    qsort(latency, done, sizeof(double), compare_doubles);
+    result->requests = done;
+    result->seconds = (end_ms - start_ms) / 1000.0;
+    result->throughput = result->seconds > 0 ? done / result->seconds : 0;
+    result->p50_us = load_percentile(latency, done, 0.5);
+    result->p99_us = load_percentile(latency, done, 0.99);
+    result->p999_us = load_percentile(latency, done, 0.999);
+    result->max_us = done > 0 ? latency[done - 1] : 0;
+    result->errors = errors;
+    free(latency);
+    return errors == 0 ? 0 : -1;
+}
+
+// Полный буфер или ошибка; для синхронной проверки протокола
+static int load_send_all(int fd, const void* data, size_t bytes) {
+    const char* p = (const char*)data;
+    while (bytes > 0) {
+        ssize_t sent = send(fd, p, bytes, MSG_NOSIGNAL);
+        if (sent <= 0)
+            return -1;
+        p += sent;
+        bytes -= sent;
+    }
+    return 0;
+}
+
+static int load_recv_all(int fd, void* data, size_t bytes) {
+    char* p = (char*)data;
+    while (bytes > 0) {
+        ssize_t got = recv(fd, p, bytes, 0);
+        if (got <= 0)
+            return -1;
+        p += got;
+        bytes -= got;
+    }
+    return 0;
+}
+
+int load_prefill(const char* path, int keys) {
+    int fd = load_connect(path);
+    if (fd < 0)
+        return -1;
+    const int CHUNK = 256;
+    struct TreeRequest requests[256];
+    int replies[256];
+    int ok = 1;
+    // Ключи 0..2*keys-1 становятся ровно четными: четные вставляются, нечетные
+    // удаляются - сервер мог остаться после прошлого прогона нагрузки
+    for (int first = 0; first < 2 * keys && ok; first += CHUNK) {
+        int n = 2 * keys - first < CHUNK ? 2 * keys - first : CHUNK;
+        for (int i = 0; i < n; i++) {
+            requests[i].key = first + i;
+            requests[i].op = requests[i].key % 2 == 0 ? TREE_OP_INSERT : TREE_OP_DELETE;
+            requests[i].hi = requests[i].key;
+        }
+        ok &= load_send_all(fd, requests, n * sizeof(struct TreeRequest)) == 0 &&
+              load_recv_all(fd, replies, n * sizeof(int)) == 0;
+    }
+    // Поиск четного и нечетного ключа в одном конвейере
+    for (int i = 0; i < CHUNK && ok; i++) {
+        requests[i].op = TREE_OP_SEARCH;
+        requests[i].key = (int)(((long long)i * 7919 % keys) * 2 + i % 2);
+        requests[i].hi = requests[i].key;
+    }
+    if (ok) {
+        ok &= load_send_all(fd, requests, CHUNK * sizeof(struct TreeRequest)) == 0 &&
+              load_recv_all(fd, replies, CHUNK * sizeof(int)) == 0;
+        for (int i = 0; i < CHUNK && ok; i++)
+            ok &= replies[i] == (i % 2 == 0);
+    }
+    // Диапазон длиннее TREE_SERVER_MAX_RANGE обрезается
+    struct TreeRequest range = {TREE_OP_RANGE, 0, 2 * keys - 1};
+    int range_keys[TREE_SERVER_MAX_RANGE];
+    int count = -1;
+    if (ok)
+        ok &= load_send_all(fd, &range, sizeof(range)) == 0 && load_recv_all(fd, &count, sizeof(int)) == 0;
+    int expected = keys < TREE_SERVER_MAX_RANGE ? keys : TREE_SERVER_MAX_RANGE;
+    ok &= count == expected;
+    if (ok)
+        ok &= load_recv_all(fd, range_keys, count * sizeof(int)) == 0;
+    for (int i = 0; i < expected && ok; i++)
+        ok &= range_keys[i] == 2 * i;
+    close(fd);
+    return ok ? 0 : 1;
+}
+
+// Конвейер запросов, затем shutdown(SHUT_WR): сервер должен ответить на все
+// и только потом закрыть соединение. Ключи - четные из load_prefill
+static int load_half_close(const char* path, int keys, int requests_count) {
+    int fd = load_connect(path);
+    if (fd < 0)
+        return -1;
+    struct TreeRequest* requests =
+        (struct TreeRequest*)malloc(requests_count * sizeof(struct TreeRequest));
+    for (int i = 0; i < requests_count; i++) {
+        requests[i].op = TREE_OP_SEARCH;
+        requests[i].key = (int)((long long)i * 7919 % keys) * 2;
+        requests[i].hi = requests[i].key;
+    }
+    int ok = load_send_all(fd, requests, requests_count * sizeof(struct TreeRequest)) == 0 &&
+             shutdown(fd, SHUT_WR) == 0;
+    int* replies = (int*)malloc((requests_count + 1) * sizeof(int));
+    size_t received = 0;
+    size_t expected = requests_count * sizeof(int);
+    while (ok) {
+        // Читаем до EOF: лишний ответ тоже ошибка
+        ssize_t got = recv(fd, (char*)replies + received, expected + sizeof(int) - received, 0);
+        if (got <= 0) {
+            ok = got == 0;
+            break;
+        }
+        received += got;
+        ok = received <= expected;
+    }
+    ok &= received == expected;
+    for (int i = 0; i < requests_count && ok; i++)
+        ok &= replies[i] == 1;
+    free(requests);
+    free(replies);
+    close(fd);
+    return ok ? 0 : 1;
+}
+
+// ========== РЕЖИМЫ КОМАНДНОЙ СТРОКИ ==========
+
+static struct TreeServer* tree_server_signal_target = NULL;
+
+static void tree_server_on_signal(int) {
+    if (tree_server_signal_target != NULL)
+        tree_server_stop(tree_server_signal_target);
+}
+
+int tree_server_main(int argc, char** argv) {
+    if (argc < 1) {
+        fprintf(stderr, "использование: app --serve <путь к сокету> [avl|rbt] [макс. пакет]\n");
+        return 1;
+    }
+    int is_rbt = argc >= 2 && strcmp(argv[1], "rbt") == 0;
+    int max_batch = argc >= 3 ? atoi(argv[2]) : 1024;
+    struct TreeServer* server = tree_server_create(argv[0], is_rbt, max_batch);
+    if (server == NULL) {
+        perror(argv[0]);
+        return 1;
+    }
+    tree_server_signal_target = server;
+    signal(SIGINT, tree_server_on_signal);
+    signal(SIGTERM, tree_server_on_signal);
+    printf("Сервер %s слушает %s, пакет до %d запросов (Ctrl+C - остановка)\n",
+           is_rbt ? "RBT" : "AVL", argv[0], max_batch);
+    fflush(stdout);
+    tree_server_run(server);
+
+    long long batches = 0;
+    long long requests = 0;
+    tree_server_stats(server, &batches, &requests);
+    printf("Обработано запросов: %lld, пакетов: %lld (в среднем %.1f)\n", requests, batches,
+           batches > 0 ? (double)requests / batches : 0);
+    tree_server_free(server);
+    return 0;
+}
+
+static void load_print_header() {
+    printf("Клиенты | Пакет | Kзапр/с | p50 мкс | p99 мкс | p99.9 мкс | Макс мкс\n");
+    printf("--------|-------|---------|---------|---------|-----------|---------\n");
+}
+
+static void load_print_row(const struct LoadConfig* config, const struct LoadResult* result) {
+    printf("%7d | %5d | %7.1f | %7.1f | %7.1f | %9.1f | %8.0f%s\n", config->clients, config->batch,
+           result->throughput / 1000, result->p50_us, result->p99_us, result->p999_us,
+           result->max_us, result->errors ? "  ОШИБКА" : "");
+}
+
+int load_generator_main(int argc, char** argv) {
+    if (argc < 2 || (strcmp(argv[1], "closed") != 0 && strcmp(argv[1], "open") != 0)) {
+        fprintf(stderr, "использование: app --load <путь к сокету> <closed|open> [клиентов] [пакет]\n"
+                        "                [запросов на клиента] [запросов/с для open] [ключей]\n");
+        return 1;
+    }
+    struct LoadConfig config;
+    config.path = argv[0];
+    config.open_loop = strcmp(argv[1], "open") == 0;
+    config.clients = argc >= 3 ? atoi(argv[2]) : 4;
+    config.batch = argc >= 4 ? atoi(argv[3]) : 16;
+    config.ops_per_client = argc >= 5 ? atoi(argv[4]) : 100000;
+    config.rate = argc >= 6 ? atof(argv[5]) : 100000;
+    config.key_range = argc >= 7 ? atoi(argv[6]) : 1000000;
+    if (config.clients < 1 || config.batch < 1 || config.ops_per_client < 1 || config.rate <= 0 ||
+        config.key_range < 2) {
+        fprintf(stderr, "все параметры должны быть положительными, ключей - не меньше 2\n");
+        return 1;
+    }
+
+    // Половина диапазона ключей заранее в дереве: поиск попадает в половине случаев
+    int prefill = load_prefill(config.path, config.key_range / 2);
+    if (prefill < 0) {
+        perror(config.path);
+        return 1;
+    }
+    printf("Заполнение %d ключами и проверка ответов: %s\n\n", config.key_range / 2,
+           prefill == 0 ? "ok" : "ОШИБКА");
+
+    struct LoadResult result;
+    load_run(&config, &result);
+    printf("%s цикл%s\n", config.open_loop ? "Открытый" : "Замкнутый",
+           config.open_loop ? "" : ": пакет отправляется после всех ответов предыдущего");
+    if (config.open_loop)
+        printf("Заданная частота: %.0f запросов/с\n", config.rate);
+    load_print_header();
+    load_print_row(&config, &result);
+    return prefill == 0 && result.errors == 0 ? 0 : 1;
+}
+
+// ==================== ТЕСТ 32: СЕРВЕР ДЕРЕВА И КОНВЕЙЕР ЗАПРОСОВ ====================
+
+void test_tree_server() {
+    printf("=== ТЕСТ 32: Сервер AVL на Unix-сокете: пакеты, конвейер, нагрузка ===\n\n");
+
+    const int PREFILL = 500000;
+    const int OPS_TOTAL = 200000;
+    const char* tmp = getenv("TMPDIR");
+    char path[108];
+    int len = snprintf(path, sizeof(path), "%s/tree_server_%d.sock", tmp != NULL ? tmp : "/tmp",
+                       (int)getpid());
+    if (len < 0 || len >= (int)sizeof(path)) {
+        // Длинный TMPDIR не влезает в sun_path - берем /tmp
+        snprintf(path, sizeof(path), "/tmp/tree_server_%d.sock", (int)getpid());
+    }
+    struct TreeServer* server = tree_server_create(path, 0, 1024);
+    if (server == NULL) {
+        perror(path);
+        printf("Сервер не запустился, тест пропущен\n\n");
+        return;
+    }
+    std::thread server_thread(tree_server_run, server);
+
+    int prefill = load_prefill(path, PREFILL);
+    printf("Заполнение %d ключами через сокет и проверка ответов: %s\n", PREFILL,
+           prefill == 0 ? "ok" : "ОШИБКА");
+    // Запросов больше, чем входит в буфер соединения и в один пакет сервера
+    const int HALF_CLOSE_REQUESTS = 20000;
+    int half_close = load_half_close(path, PREFILL, HALF_CLOSE_REQUESTS);
+    printf("Клиент закрыл запись после %d запросов - ответы на все получены: %s\n",
+           HALF_CLOSE_REQUESTS, half_close == 0 ? "ok" : "ОШИБКА");
+    printf("Смесь: 80%% поиск, 10%% вставка, 5%% удаление, 5%% диапазон (%d ключей)\n",
+           LOAD_RANGE_WIDTH);
+    printf("Ядер доступно: %d; сервер и клиенты - потоки одного процесса\n\n", parallel_core_count());
+
+    struct LoadConfig config;
+    config.path = path;
+    config.rate = 0;
+    config.key_range = 2 * PREFILL;
+
+    // Замкнутый цикл: пакет клиента x число клиентов
+    const int client_counts[] = {1, 4, 16};
+    const int batch_sizes[] = {1, 16, 128};
+    double throughput[3][3];
+    double p50[3][3];
+    double server_batch[3][3];
+    int all_ok = prefill == 0 && half_close == 0;
+    printf("Замкнутый цикл (%d запросов на прогон)\n", OPS_TOTAL);
+    printf("Клиенты | Пакет | Kзапр/с | p50 мкс | p99 мкс | p99.9 мкс | Макс мкс | Пакет сервера\n");
+    printf("--------|-------|---------|---------|---------|-----------|----------|--------------\n");
+    for (int c = 0; c < 3; c++) {
+        for (int b = 0; b < 3; b++) {
+            config.clients = client_counts[c];
+            config.batch = batch_sizes[b];
+            config.ops_per_client = OPS_TOTAL / config.clients;
+            config.open_loop = 0;
+            long long batches_before, requests_before, batches_after, requests_after;
+            tree_server_stats(server, &batches_before, &requests_before);
+            struct LoadResult result;
+            all_ok &= load_run(&config, &result) == 0;
+            tree_server_stats(server, &batches_after, &requests_after);
+            server_batch[c][b] = batches_after > batches_before
+                                     ? (double)(requests_after - requests_before) /
+                                           (batches_after - batches_before) : 0;
+            throughput[c][b] = result.throughput;
+            p50[c][b] = result.p50_us;
+            printf("%7d | %5d | %7.1f | %7.1f | %7.1f | %9.1f | %8.0f | %13.1f\n", config.clients,
+                   config.batch, result.throughput / 1000, result.p50_us, result.p99_us,
+                   result.p999_us, result.max_us, server_batch[c][b]);
+        }
+    }
+    printf("\n");
+
+    // Открытый цикл: частота - доля от замкнутого цикла с теми же 4 клиентами и пакетом 16
+    double reference = throughput[1][1];
+    const double loads[] = {0.25, 0.5, 0.8, 1.2};
+    double open_p99[4];
+    printf("Открытый цикл: 4 клиента, пакет до 16, пуассоновский поток;\n");
+    printf("нагрузка - доля от %.1f Kзапр/с замкнутого цикла с теми же параметрами\n", reference / 1000);
+    // При перегрузке задержки доходят до сотен миллисекунд - колонки шире
+    printf("Нагрузка | Запросов/с | Kзапр/с |   p50 мкс |   p99 мкс | p99.9 мкс |  Макс мкс\n");
+    printf("---------|------------|---------|-----------|-----------|-----------|----------\n");
+    for (int l = 0; l < 4; l++) {
+        config.clients = 4;
+        config.batch = 16;
+        config.open_loop = 1;
+        config.rate = reference * loads[l];
+        // Прогон не дольше ~0.5 с: при перегрузке очередь растет все время прогона
+        long long ops = (long long)(config.rate * 0.5);
+        if (ops > OPS_TOTAL)
+            ops = OPS_TOTAL;
+        config.ops_per_client = (int)(ops / config.clients) + 1;
+        struct LoadResult result;
+        all_ok &= load_run(&config, &result) == 0;
+        open_p99[l] = result.p99_us;
+        printf("%7.0f%% | %10.0f | %7.1f | %9.1f | %9.1f | %9.1f | %9.0f\n", loads[l] * 100,
+               config.rate, result.throughput / 1000, result.p50_us, result.p99_us, result.p999_us,
+               result.max_us);
+    }
+    printf("\nПроверка (ответы разобраны, ошибок соединения нет): %s\n\n", all_ok ? "ok" : "ОШИБКА");
+
+    tree_server_stop(server);
+    server_thread.join();
+    tree_server_free(server);
+
+    printf("ВЫВОД:\n");
+    printf("• Один клиент: пакет 128 дает %.1fx пропускной способности пакета 1 - системные\n",
+           throughput[0][2] / throughput[0][0]);
+    printf("  вызовы и пробуждения делятся на весь пакет, дерево почти не меняется\n");
+    printf("• Цена пакета - задержка: p50 у одного клиента %.1f мкс при пакете 1 и %.1f при 128,\n",
+           p50[0][0], p50[0][2]);
+    printf("  ответ на первый запрос ждет, пока сервер пройдет весь пакет\n");
+    printf("• 16 клиентов с пакетом 1 сервер сам собирает в пакеты по %.1f запроса (%.1f Kзапр/с):\n",
+           server_batch[2][0], throughput[2][0] / 1000);
+    printf("  пока обрабатывался прошлый, накопились запросы от остальных\n");
+    printf("• Открытый цикл: p99 %.0f мкс при 25%% нагрузки и %.0f мкс при 120%% - после\n",
+           open_p99[0], open_p99[3]);
+    printf("  насыщения очередь растет весь прогон. Замкнутый цикл этого не покажет: там\n");
+    printf("  клиент сам замедляется вместе с сервером\n");
+    printf("• Отдельный сервер: app --serve <сокет>, нагрузка: app --load <сокет> <closed|open>\n\n");
+}
@@ -0,0 +1,406 @@
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "methods.h"
+
+// ========== WAVL ДЕРЕВО (WEAK AVL, RANK-BALANCED) ==========
+// Вместо высоты узел хранит ранг. Разность рангов родителя и сына равна
+// 1 или 2 (у отсутствующего сына ранг -1), лист имеет ранг 0. Пока нет
+// удалений, ранг совпадает с высотой и дерево - это в точности AVL.
+// Удаления ослабляют баланс до высоты 2 log n, как у RBT, но:
+//   - вставка и удаление делают не больше двух поворотов;
+//   - повышения/понижения рангов в среднем O(1) на операцию.
+
+static int wavl_rank(struct WAVLNode* node) {
+    return node ? node->rank : -1;
+}
+
+static struct WAVLNode* wavl_create_node(int key) {
+    struct WAVLNode* node = (struct WAVLNode*)malloc(sizeof(struct WAVLNode));
+    node->key = key;
+    node->rank = 0;
+    node->left = node->right = NULL;
+    return node;
+}
+
+static struct WAVLNode* wavl_rotate_right(struct WAVLNode* y) {
+    struct WAVLNode* x = y->left;
+    y->left = x->right;
+    x->right = y;
+    return x;
+}
+
+static struct WAVLNode* wavl_rotate_left(struct WAVLNode* x) {
+    struct WAVLNode* y = x->right;
+    x->right = y->left;
+    y->left = x;
+    return y;
+}
+
+// После вставки в поддерево сын x мог получить ранг x (0-сын)
+static struct WAVLNode* wavl_fix_insert(struct WAVLNode* x, int* rotations) {
+    if (wavl_rank(x->left) == x->rank) {
+        struct WAVLNode* c = x->left;
+
+        // Брат - 1-сын: повышаем x, нарушение уходит выше
+        if (x->rank - wavl_rank(x->right) == 1) {
+            x->rank++;
+            return x;
+        }
+
+        // Внешний внук - 1-сын: один поворот
+        if (c->rank - wavl_rank(c->left) == 1) {
+            (*rotations)++;
+            x->rank--;
+            return wavl_rotate_right(x);
+        }
+
+        // Двойной поворот: внутренний внук поднимается наверх
+        (*rotations) += 2;
+        struct WAVLNode* t = c->right;
+        x->left = wavl_rotate_left(c);
+        t->rank++;
+        c->rank--;
+        x->rank--;
+        return wavl_rotate_right(x);
+    }
+
+    if (wavl_rank(x->right) == x->rank) {
+        // Зеркальные случаи
+        struct WAVLNode* c = x->right;
+
+        if (x->rank - wavl_rank(x->left) == 1) {
+            x->rank++;
+            return x;
+        }
+
+        if (c->rank - wavl_rank(c->right) == 1) {
+            (*rotations)++;
+            x->rank--;
+            return wavl_rotate_left(x);
+        }
+
+        (*rotations) += 2;
+        struct WAVLNode* t = c->left;
+        x->right = wavl_rotate_right(c);
+        t->rank++;
+        c->rank--;
+        x->rank--;
+        return wavl_rotate_left(x);
+    }
+
+    return x;
+}
+
+// После удаления из поддерева: x - лист ранга 1 (2,2-лист) или один
+// из сыновей стал 3-сыном
+static struct WAVLNode* wavl_fix_delete(struct WAVLNode* x, int* rotations) {
+    if (x->left == NULL && x->right == NULL) {
+        x->rank = 0;
+        return x;
+    }
+
+    if (x->rank - wavl_rank(x->left) == 3) {
+        struct WAVLNode* s = x->right;
+
+        // Брат - 2-сын: понижаем x
+        if (x->rank - s->rank == 2) {
+            x->rank--;
+            return x;
+        }
+
+        // Брат - 2,2-узел: понижаем обоих
+        if (s->rank - wavl_rank(s->left) == 2 && s->rank - wavl_rank(s->right) == 2) {
+            x->rank--;
+            s->rank--;
+            return x;
+        }
+
+        // Внешний сын брата - 1-сын: один поворот
+        if (s->rank - wavl_rank(s->right) == 1) {
+            (*rotations)++;
+            struct WAVLNode* root = wavl_rotate_left(x);
+            s->rank++;
+            x->rank--;
+            if (x->left == NULL && x->right == NULL)
+                x->rank--;
+            return root;
+        }
+
+        // Двойной поворот
+        (*rotations) += 2;
+        struct WAVLNode* t = s->left;
+        x->right = wavl_rotate_right(s);
+        t->rank += 2;
+        s->rank--;
+        x->rank -= 2;
+        return wavl_rotate_left(x);
+    }
+
+    if (x->rank - wavl_rank(x->right) == 3) {
+        // Зеркальные случаи
+        struct WAVLNode* s = x->left;
+
+        if (x->rank - s->rank == 2) {
+            x->rank--;
+            return x;
+        }
+
+        if (s->rank - wavl_rank(s->left) == 2 && s->rank - wavl_rank(s->right) == 2) {
+            x->rank--;
+            s->rank--;
+            return x;
+        }
+
+        if (s->rank - wavl_rank(s->left) == 1) {
+            (*rotations)++;
+            struct WAVLNode* root = wavl_rotate_right(x);
+            s->rank++;
+            x->rank--;
+            if (x->left == NULL && x->right == NULL)
+                x->rank--;
+            return root;
+        }
+
+        (*rotations) += 2;
+        struct WAVLNode* t = s->right;
+        x->left = wavl_rotate_left(s);
+        t->rank += 2;
+        s->rank--;
+        x->rank -= 2;
+        return wavl_rotate_right(x);
+    }
+
+    return x;
+}
+
+struct WAVLNode* wavl_insert(struct WAVLNode* node, int key, int* rotations) {
+    if (node == NULL)
+        return wavl_create_node(key);
+
+    // Нарушение возможно только со стороны вставки; брат читается лишь
+    // при нарушении - на большей части пути это экономит промах кеша
+    if (key < node->key) {
+        node->left = wavl_insert(node->left, key, rotations);
+        if (node->left->rank != node->rank)
+            return node;
+    } else if (key > node->key) {
+        node->right = wavl_insert(node->right, key, rotations);
+        if (node->right->rank != node->rank)
+            return node;
+    } else {
+        return node;
+    }
+
+    return wavl_fix_insert(node, rotations);
+}
+
+struct WAVLNode* wavl_delete(struct WAVLNode* node, int key, int* rotations) {
+    if (node == NULL)
+        return NULL;
+
+    if (key < node->key) {
+        node->left = wavl_delete(node->left, key, rotations);
+        if (node->rank - wavl_rank(node->left) < 3 && (node->rank == 0 || node->left || node->right))
+            return node;
+    } else if (key > node->key) {
+        node->right = wavl_delete(node->right, key, rotations);
+        if (node->rank - wavl_rank(node->right) < 3 && (node->rank == 0 || node->left || node->right))
+            return node;
+    } else if (node->left == NULL || node->right == NULL) {
+        struct WAVLNode* child = node->left ? node->left : node->right;
+        free(node);
+        return child;
+    } else {
+        // Два сына: ключ заменяется минимальным из правого поддерева
+        struct WAVLNode* min = node->right;
+        while (min->left != NULL)
+            min = min->left;
+        node->key = min->key;
+        node->right = wavl_delete(node->right, min->key, rotations);
+    }
+
+    return wavl_fix_delete(node, rotations);
+}
+
+struct WAVLNode* wavl_search(struct WAVLNode* node, int key) {
+    while (node != NULL && node->key != key)
+        node = key < node->key ? node->left : node->right;
+    return node;
+}
+
+int wavl_height(struct WAVLNode* node) {
+    if (node == NULL)
+        return 0;
+    int hl = wavl_height(node->left);
+    int hr = wavl_height(node->right);
+    return 1 + (hl > hr ? hl : hr);
+}
+
+void free_wavl_tree(struct WAVLNode* root) {
+    if (root == NULL)
+        return;
+    free_wavl_tree(root->left);
+    free_wavl_tree(root->right);
+    free(root);
+}
+
+int count_wavl_nodes(struct WAVLNode* root) {
+    if (root == NULL) return 0;
+    return 1 + count_wavl_nodes(root->left) + count_wavl_nodes(root->right);
+}
+
+static int wavl_check(struct WAVLNode* node, long long lo, long long hi) {
+    if (node == NULL)
+        return 1;
+    if (node->key <= lo || node->key >= hi)
+        return 0;
+    int dl = node->rank - wavl_rank(node->left);
+    int dr = node->rank - wavl_rank(node->right);
+    if (dl < 1 || dl > 2 || dr < 1 || dr > 2)
+        return 0;
+    if (node->left == NULL && node->right == NULL && node->rank != 0)
+        return 0;
+    return wavl_check(node->left, lo, node->key) && wavl_check(node->right, node->key, hi);
+}
+
+int wavl_is_valid(struct WAVLNode* root) {
+    return wavl_check(root, (long long)INT_MIN - 1, (long long)INT_MAX + 1);
+}
+
+// ==================== ТЕСТ 22: WAVL НА СМЕШАННЫХ НАГРУЗКАХ ====================
+
+static int rbt_tree_height(struct RBNode* node) {
+    if (node == NULL)
+        return 0;
+    int hl = rbt_tree_height(node->left);
+    int hr = rbt_tree_height(node->right);
+    return 1 + (hl > hr ? hl : hr);
+}
+
+void test_wavl_tree() {
+    printf("=== ТЕСТ 22: WAVL против AVL и RBT на нагрузках с удалениями ===\n\n");
+
+    const int N = 1000000;
+    const int OPS = 2000000;
+    const char* WORKLOADS[] = {
+        "только вставка",
+        "50% вставка / 50% удаление",
+        "70% поиск / 20% вст / 10% уд"
+    };
+
+    srand(time(NULL));
+
+    int* keys = (int*)malloc(N * sizeof(int));
+    for (int i = 0; i < N; i++)
+        keys[i] = rand() % (N * 4);
+    int* ops = (int*)malloc(OPS * sizeof(int));
+    int* op_keys = (int*)malloc(OPS * sizeof(int));
+
+    printf("Нагрузка                     | Дерево | ns/оп    | Поворотов/изм | Высота | Проверка\n");
+    printf("-----------------------------|--------|----------|---------------|--------|---------\n");
+
+    int all_ok = 1;
+    for (int w = 0; w < 3; w++) {
+        // 0 - поиск, 1 - вставка, 2 - удаление
+        int updates = 0;
+        for (int i = 0; i < OPS; i++) {
+            int r = rand() % 100;
+            if (w == 0)
+                ops[i] = 1;
+            else if (w == 1)
+                ops[i] = r < 50 ? 1 : 2;
+            else
+                ops[i] = r < 70 ? 0 : (r < 90 ? 1 : 2);
+            op_keys[i] = rand() % (N * 4);
+            updates += ops[i] != 0;
+        }
+
+        // Стартовое дерево из N ключей (для "только вставка" - пустое)
+        struct AVLNode* avl_root = NULL;
+        struct RBNode* rbt_root = NULL;
+        struct WAVLNode* wavl_root = NULL;
+        int rotations = 0;
+        int recolorings = 0;
+        if (w > 0) {
+            for (int i = 0; i < N; i++) {
+                avl_root = avl_insert(avl_root, keys[i], &rotations);
+                rbt_root = rbt_insert(rbt_root, keys[i], &rotations, &recolorings);
+                wavl_root = wavl_insert(wavl_root, keys[i], &rotations);
+            }
+        }
+
+        int avl_rotations = 0;
+        long long avl_found = 0;
+        clock_t start = clock();
+        for (int i = 0; i < OPS; i++) {
+            if (ops[i] == 0)
+                avl_found += avl_search(avl_root, op_keys[i]) != NULL;
+            else if (ops[i] == 1)
+                avl_root = avl_insert(avl_root, op_keys[i], &avl_rotations);
+            else
+                avl_root = avl_delete(avl_root, op_keys[i], &avl_rotations);
+        }
+        double avl_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / OPS;
+
+        int rbt_rotations = 0;
+        int rbt_recolorings = 0;
+        long long rbt_found = 0;
+        start = clock();
+        for (int i = 0; i < OPS; i++) {
+            if (ops[i] == 0)
+                rbt_found += rbt_search(rbt_root, op_keys[i]) != NULL;
+            else if (ops[i] == 1)
+                rbt_root = rbt_insert(rbt_root, op_keys[i], &rbt_rotations, &rbt_recolorings);
+            else
+                rbt_root = rbt_delete(rbt_root, op_keys[i], &rbt_rotations, &rbt_recolorings);
+        }
+        double rbt_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / OPS;
+
+        int wavl_rotations = 0;
+        long long wavl_found = 0;
+        start = clock();
+        for (int i = 0; i < OPS; i++) {
+            if (ops[i] == 0)
+                wavl_found += wavl_search(wavl_root, op_keys[i]) != NULL;
+            else if (ops[i] == 1)
+                wavl_root = wavl_insert(wavl_root, op_keys[i], &wavl_rotations);
+            else
+                wavl_root = wavl_delete(wavl_root, op_keys[i], &wavl_rotations);
+        }
+        double wavl_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / OPS;
+
+        int n = count_avl_nodes(avl_root);
+        int ok = avl_found == rbt_found && avl_found == wavl_found &&
+                 count_rbt_nodes(rbt_root) == n && count_wavl_nodes(wavl_root) == n &&
+                 avl_is_valid(avl_root) && rbt_is_valid(rbt_root) && wavl_is_valid(wavl_root);
+        all_ok &= ok;
+
+        // Повороты RBT при вставке не считаются (см. rbt_fix_violation)
+        printf("%-28s | %-6s | %-8.1f | %-13.3f | %-6d | %s\n", WORKLOADS[w], "AVL", avl_ns,
+               (double)avl_rotations / updates, avl_height(avl_root), ok ? "OK" : "ОШИБКА");
+        printf("%-28s | %-6s | %-8.1f | %-13s | %-6d |\n", "", "RBT", rbt_ns, "-",
+               rbt_tree_height(rbt_root));
+        printf("%-28s | %-6s | %-8.1f | %-13.3f | %-6d |\n", "", "WAVL", wavl_ns,
+               (double)wavl_rotations / updates, wavl_height(wavl_root));
+
+        free_avl_tree(avl_root);
+        free_rbt_tree(rbt_root);
+        free_wavl_tree(wavl_root);
+    }
+
+    free(keys);
+    free(ops);
+    free(op_keys);
+
+    printf("\nПроверка инвариантов: %s\n", all_ok ? "OK" : "ОШИБКА");
+    printf("Узел: AVL %d байт, RBT %d байт, WAVL %d байт\n",
+           (int)sizeof(struct AVLNode), (int)sizeof(struct RBNode), (int)sizeof(struct WAVLNode));
+
+    printf("\nВЫВОД: без удалений WAVL - это AVL с теми же высотой и поворотами, но быстрее:\n");
+    printf("       ранг брата читается только при нарушении. С удалениями WAVL обгоняет AVL\n");
+    printf("       и держит его высоту, но итеративное удаление RBT с указателем на родителя\n");
+    printf("       остается быстрее рекурсивных удалений\n\n");
+}